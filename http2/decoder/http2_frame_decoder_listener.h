@@ -81,6 +81,16 @@ class Http2FrameDecoderListener {
   // If header.IsEndStream() == true, this is the last data for the stream.
   virtual void OnDataEnd() = 0;
 
+  // Called instead of OnDataStart, OnDataPayload and OnDataEnd for an unpadded
+  // DATA frame whose entire payload was available at once, so that the frame
+  // is reported with a single call.
+  // |data| The start of the |len| bytes of the frame's payload.
+  // The default implementation makes the three calls, with OnDataPayload only
+  // called if |len| is not zero.
+  virtual void OnDataFrame(const Http2FrameHeader& header,
+                           const char* data,
+                           size_t len);
+
   // Called once the common frame header has been decoded for a HEADERS frame,
   // before examining the frame's payload, after which:
   //   OnPadLength will be called if header.IsPadded() is true, i.e. if the
@@ -233,6 +233,16 @@ void LoggingHttp2FrameDecoderListener::OnDataEnd() {
   }
 }
 
+void LoggingHttp2FrameDecoderListener::OnDataFrame(
+    const Http2FrameHeader& header,
+    const char* data,
+    size_t len) {
+  HTTP2_VLOG(1) << "OnDataFrame: " << header << "; len=" << len;
+  if (wrapped_ != nullptr) {
+    wrapped_->OnDataFrame(header, data, len);
+  }
+}
+
 void LoggingHttp2FrameDecoderListener::OnHeadersStart(
     const Http2FrameHeader& header) {
   HTTP2_VLOG(1) << "OnHeadersStart: " << header;
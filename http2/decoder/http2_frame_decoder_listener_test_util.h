@@ -89,6 +89,9 @@ class LoggingHttp2FrameDecoderListener : public Http2FrameDecoderListener {
   void OnDataStart(const Http2FrameHeader& header) override;
   void OnDataPayload(const char* data, size_t len) override;
   void OnDataEnd() override;
+  void OnDataFrame(const Http2FrameHeader& header,
+                   const char* data,
+                   size_t len) override;
   void OnHeadersStart(const Http2FrameHeader& header) override;
   void OnHeadersPriority(const Http2PriorityFields& priority) override;
   void OnHpackFragment(const char* data, size_t len) override;
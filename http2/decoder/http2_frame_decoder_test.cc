@@ -924,6 +924,131 @@ TEST_F(Http2FrameDecoderTest, WindowUpdateTooLong) {
   EXPECT_TRUE(DecodePayloadExpectingFrameSizeError(kFrameData, header));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Tests of decoding several frames from one buffer.
+
+// Counts the calls made for DATA frames.
+class DataFrameCountingListener : public Http2FrameDecoderNoOpListener {
+ public:
+  void OnDataStart(const Http2FrameHeader& header) override { ++data_starts_; }
+  void OnDataFrame(const Http2FrameHeader& header,
+                   const char* data,
+                   size_t len) override {
+    ++data_frames_;
+    data_.append(data, len);
+  }
+
+  size_t data_starts_ = 0;
+  size_t data_frames_ = 0;
+  Http2String data_;
+};
+
+// Decodes as many frames as |db| holds, and returns the status of the last
+// call to DecodeFrame.
+DecodeStatus DecodeFrames(Http2FrameDecoder* decoder, DecodeBuffer* db) {
+  DecodeStatus status;
+  do {
+    status = decoder->DecodeFrame(db);
+  } while (status == DecodeStatus::kDecodeDone && db->HasData());
+  return status;
+}
+
+// Frames whose payload is complete in the buffer take the fast paths, which
+// must report the same as the resumable ones.
+TEST_F(Http2FrameDecoderTest, DecodeCompleteFrames) {
+  const char kFrameData[] = {
+      '\x00', '\x00', '\x03',          // Payload length: 3
+      '\x00',                          // DATA
+      '\x00',                          // Flags: none
+      '\x00', '\x00', '\x00', '\x01',  // Stream ID: 1
+      'a',    'b',    'c',             // Data
+      '\x00', '\x00', '\x0c',          // Payload length: 12
+      '\x01',                          // HEADERS
+      '\x2c',                          // Flags: END_HEADERS | PADDED | PRIORITY
+      '\x00', '\x00', '\x00', '\x03',  // Stream ID: 3
+      '\x03',                          // Pad Len
+      '\x80', '\x00', '\x00', '\x01',  // Parent: 1 (Exclusive)
+      '\x10',                          // Weight: 17
+      'd',    'e',    'f',             // HPACK fragment
+      '\x00', '\x00', '\x00',          // Padding
+      '\x00', '\x00', '\x05',          // Payload length: 5
+      '\x00',                          // DATA
+      '\x09',                          // Flags: END_STREAM | PADDED
+      '\x00', '\x00', '\x00', '\x01',  // Stream ID: 1
+      '\x02',                          // Pad Len
+      'g',    'h',                     // Data
+      '\x00', '\x00',                  // Padding
+      '\x00', '\x00', '\x04',          // Payload length: 4
+      '\x00',                          // DATA
+      '\x00',                          // Flags: none
+      '\x00', '\x00', '\x00', '\x05',  // Stream ID: 5
+      'i',    'j',                     // Start of the data
+  };
+  decoder_.set_listener(&collector_);
+  DecodeBuffer db(kFrameData, sizeof kFrameData);
+  EXPECT_EQ(DecodeStatus::kDecodeInProgress, DecodeFrames(&decoder_, &db));
+  EXPECT_EQ(0u, db.Remaining());
+  EXPECT_TRUE(collector_.IsInProgress());
+  ASSERT_EQ(3u, collector_.size());
+
+  FrameParts data(Http2FrameHeader(3, Http2FrameType::DATA, 0, 1), "abc");
+  EXPECT_TRUE(data.VerifyEquals(*collector_.frame(0)));
+
+  FrameParts headers(
+      Http2FrameHeader(12, Http2FrameType::HEADERS,
+                       Http2FrameFlag::END_HEADERS | Http2FrameFlag::PADDED |
+                           Http2FrameFlag::PRIORITY,
+                       3),
+      "def", 4);
+  headers.SetOptPriority(Http2PriorityFields(1, 17, true));
+  EXPECT_TRUE(headers.VerifyEquals(*collector_.frame(1)));
+
+  FrameParts padded_data(
+      Http2FrameHeader(5, Http2FrameType::DATA,
+                       Http2FrameFlag::END_STREAM | Http2FrameFlag::PADDED, 1),
+      "gh", 3);
+  EXPECT_TRUE(padded_data.VerifyEquals(*collector_.frame(2)));
+
+  // The rest of the last frame.
+  const char kRest[] = {'k', 'l'};
+  DecodeBuffer rest(kRest, sizeof kRest);
+  EXPECT_EQ(DecodeStatus::kDecodeDone, DecodeFrames(&decoder_, &rest));
+  EXPECT_FALSE(collector_.IsInProgress());
+  ASSERT_EQ(4u, collector_.size());
+  FrameParts split_data(Http2FrameHeader(4, Http2FrameType::DATA, 0, 5),
+                        "ijkl");
+  EXPECT_TRUE(split_data.VerifyEquals(*collector_.frame(3)));
+}
+
+// Unpadded DATA frames whose payload is complete are reported with a single
+// call to OnDataFrame.
+TEST_F(Http2FrameDecoderTest, ReportCompleteDataFrames) {
+  const char kFrameData[] = {
+      '\x00', '\x00', '\x03',          // Payload length: 3
+      '\x00',                          // DATA
+      '\x00',                          // Flags: none
+      '\x00', '\x00', '\x00', '\x01',  // Stream ID: 1
+      'a',    'b',    'c',             // Data
+      '\x00', '\x00', '\x00',          // Payload length: 0
+      '\x00',                          // DATA
+      '\x01',                          // Flags: END_STREAM
+      '\x00', '\x00', '\x00', '\x01',  // Stream ID: 1
+      '\x00', '\x00', '\x02',          // Payload length: 2
+      '\x00',                          // DATA
+      '\x00',                          // Flags: none
+      '\x00', '\x00', '\x00', '\x03',  // Stream ID: 3
+      'd',                             // Start of the data
+  };
+  DataFrameCountingListener listener;
+  Http2FrameDecoder decoder(&listener);
+  DecodeBuffer db(kFrameData, sizeof kFrameData);
+  EXPECT_EQ(DecodeStatus::kDecodeInProgress, DecodeFrames(&decoder, &db));
+  EXPECT_EQ(2u, listener.data_frames_);
+  EXPECT_EQ("abc", listener.data_);
+  // The incomplete frame takes the resumable path.
+  EXPECT_EQ(1u, listener.data_starts_);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace http2
@@ -56,18 +56,35 @@ DecodeStatus DataPayloadDecoder::StartDecodingPayload(FrameDecoderState* state,
       HTTP2_DVLOG(2) << "StartDecodingPayload all present";
       // Note that we don't cache the listener field so that the callee can
       // replace it if the frame is bad.
-      // If this case is common enough, consider combining the 3 callbacks
-      // into one.
-      state->listener()->OnDataStart(frame_header);
-      if (total_length > 0) {
-        state->listener()->OnDataPayload(db->cursor(), total_length);
-        db->AdvanceCursor(total_length);
-      }
-      state->listener()->OnDataEnd();
+      state->listener()->OnDataFrame(frame_header, db->cursor(), total_length);
+      db->AdvanceCursor(total_length);
       return DecodeStatus::kDecodeDone;
     }
     payload_state_ = PayloadState::kReadPayload;
   } else {
+    if (db->Remaining() == total_length && total_length > 0) {
+      // All of the payload is present, so the Pad Length field can be read
+      // without recording any state. Invalid padding is reported by
+      // ResumeDecodingPayload.
+      const uint32_t pad_length = static_cast<uint8_t>(*db->cursor());
+      if (pad_length + 1 <= total_length) {
+        HTTP2_DVLOG(2) << "StartDecodingPayload padded, all present";
+        const size_t data_length = total_length - pad_length - 1;
+        db->AdvanceCursor(1);
+        state->listener()->OnDataStart(frame_header);
+        state->listener()->OnPadLength(pad_length);
+        if (data_length > 0) {
+          state->listener()->OnDataPayload(db->cursor(), data_length);
+          db->AdvanceCursor(data_length);
+        }
+        if (pad_length > 0) {
+          state->listener()->OnPadding(db->cursor(), pad_length);
+          db->AdvanceCursor(pad_length);
+        }
+        state->listener()->OnDataEnd();
+        return DecodeStatus::kDecodeDone;
+      }
+    }
     payload_state_ = PayloadState::kReadPadLength;
   }
   state->InitializeRemainders();
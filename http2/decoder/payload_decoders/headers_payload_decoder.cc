@@ -7,6 +7,7 @@
 #include <stddef.h>
 
 #include "net/third_party/quiche/src/http2/decoder/decode_buffer.h"
+#include "net/third_party/quiche/src/http2/decoder/decode_http2_structures.h"
 #include "net/third_party/quiche/src/http2/decoder/http2_frame_decoder_listener.h"
 #include "net/third_party/quiche/src/http2/http2_constants.h"
 #include "net/third_party/quiche/src/http2/http2_structures.h"
@@ -83,6 +84,9 @@ DecodeStatus HeadersPayloadDecoder::StartDecodingPayload(
       return DecodeStatus::kDecodeDone;
     }
     payload_state_ = PayloadState::kReadPayload;
+  } else if (db->Remaining() == total_length &&
+             DecodeCompletePayload(state, db)) {
+    return DecodeStatus::kDecodeDone;
   } else if (frame_header.IsPadded()) {
     payload_state_ = PayloadState::kReadPadLength;
   } else {
@@ -94,6 +98,53 @@ DecodeStatus HeadersPayloadDecoder::StartDecodingPayload(
   return ResumeDecodingPayload(state, db);
 }
 
+bool HeadersPayloadDecoder::DecodeCompletePayload(FrameDecoderState* state,
+                                                  DecodeBuffer* db) {
+  const Http2FrameHeader& frame_header = state->frame_header();
+  const uint32_t total_length = frame_header.payload_length;
+  DCHECK_EQ(db->Remaining(), total_length);
+
+  // Check that the fixed fields and the padding fit in the payload, leaving
+  // invalid frames to ResumeDecodingPayload, which reports the error.
+  uint32_t pad_length = 0;
+  uint32_t fields_length = 0;
+  if (frame_header.IsPadded()) {
+    if (total_length == 0) {
+      return false;
+    }
+    pad_length = static_cast<uint8_t>(*db->cursor());
+    fields_length += 1;
+  }
+  if (frame_header.HasPriority()) {
+    fields_length += Http2PriorityFields::EncodedSize();
+  }
+  if (fields_length + pad_length > total_length) {
+    return false;
+  }
+
+  HTTP2_DVLOG(2) << "DecodeCompletePayload pad_length=" << pad_length;
+  const size_t fragment_length = total_length - fields_length - pad_length;
+  state->listener()->OnHeadersStart(frame_header);
+  if (frame_header.IsPadded()) {
+    db->AdvanceCursor(1);
+    state->listener()->OnPadLength(pad_length);
+  }
+  if (frame_header.HasPriority()) {
+    DoDecode(&priority_fields_, db);
+    state->listener()->OnHeadersPriority(priority_fields_);
+  }
+  if (fragment_length > 0) {
+    state->listener()->OnHpackFragment(db->cursor(), fragment_length);
+    db->AdvanceCursor(fragment_length);
+  }
+  if (pad_length > 0) {
+    state->listener()->OnPadding(db->cursor(), pad_length);
+    db->AdvanceCursor(pad_length);
+  }
+  state->listener()->OnHeadersEnd();
+  return true;
+}
+
 DecodeStatus HeadersPayloadDecoder::ResumeDecodingPayload(
     FrameDecoderState* state,
     DecodeBuffer* db) {
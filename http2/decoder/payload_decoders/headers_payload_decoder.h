@@ -58,6 +58,12 @@ class HTTP2_EXPORT_PRIVATE HeadersPayloadDecoder {
  private:
   friend class test::HeadersPayloadDecoderPeer;
 
+  // Decodes a padded or prioritized payload that is entirely in |db|, without
+  // going through the states above. Returns false, without consuming any
+  // input or calling the listener, if the padding or the priority fields do
+  // not fit in the payload.
+  bool DecodeCompletePayload(FrameDecoderState* state, DecodeBuffer* db);
+
   PayloadState payload_state_;
   Http2PriorityFields priority_fields_;
 };
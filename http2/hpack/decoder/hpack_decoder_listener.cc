@@ -14,8 +14,8 @@ HpackDecoderNoOpListener::~HpackDecoderNoOpListener() = default;
 
 void HpackDecoderNoOpListener::OnHeaderListStart() {}
 void HpackDecoderNoOpListener::OnHeader(HpackEntryType entry_type,
-                                        const HpackString& name,
-                                        const HpackString& value) {}
+                                        Http2StringPiece name,
+                                        Http2StringPiece value) {}
 void HpackDecoderNoOpListener::OnHeaderListEnd() {}
 void HpackDecoderNoOpListener::OnHeaderErrorDetected(
     Http2StringPiece error_message) {}
@@ -8,7 +8,6 @@
 #ifndef QUICHE_HTTP2_HPACK_DECODER_HPACK_DECODER_LISTENER_H_
 #define QUICHE_HTTP2_HPACK_DECODER_HPACK_DECODER_LISTENER_H_
 
-#include "net/third_party/quiche/src/http2/hpack/hpack_string.h"
 #include "net/third_party/quiche/src/http2/hpack/http2_hpack_constants.h"
 #include "net/third_party/quiche/src/http2/platform/api/http2_export.h"
 #include "net/third_party/quiche/src/http2/platform/api/http2_string_piece.h"
@@ -27,10 +26,12 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderListener {
 
   // Called for each header name-value pair that is decoded, in the order they
   // appear in the HPACK block. Multiple values for a given key will be emitted
-  // as multiple calls to OnHeader.
+  // as multiple calls to OnHeader. |name| and |value| refer to decoder buffers
+  // or table entries, and are only valid for the duration of the call, so that
+  // listeners can copy them straight into their own storage.
   virtual void OnHeader(HpackEntryType entry_type,
-                        const HpackString& name,
-                        const HpackString& value) = 0;
+                        Http2StringPiece name,
+                        Http2StringPiece value) = 0;
 
   // OnHeaderListEnd is called after successfully decoding an HPACK block into
   // an HTTP/2 header list. Will only be called once per block, even if it
@@ -52,8 +53,8 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderNoOpListener
 
   void OnHeaderListStart() override;
   void OnHeader(HpackEntryType entry_type,
-                const HpackString& name,
-                const HpackString& value) override;
+                Http2StringPiece name,
+                Http2StringPiece value) override;
   void OnHeaderListEnd() override;
   void OnHeaderErrorDetected(Http2StringPiece error_message) override;
 
@@ -10,19 +10,6 @@
 #include "net/third_party/quiche/src/http2/platform/api/http2_macros.h"
 
 namespace http2 {
-namespace {
-
-HpackString ExtractHpackString(HpackDecoderStringBuffer* string_buffer) {
-  if (string_buffer->IsBuffered()) {
-    return HpackString(string_buffer->ReleaseString());
-  } else {
-    auto result = HpackString(string_buffer->str());
-    string_buffer->Reset();
-    return result;
-  }
-}
-
-}  // namespace
 
 HpackDecoderState::HpackDecoderState(HpackDecoderListener* listener)
     : listener_(HTTP2_DIE_IF_NULL(listener)),
@@ -90,8 +77,9 @@ void HpackDecoderState::OnIndexedHeader(size_t index) {
   allow_dynamic_table_size_update_ = false;
   const HpackStringPair* entry = decoder_tables_.Lookup(index);
   if (entry != nullptr) {
-    listener_->OnHeader(HpackEntryType::kIndexedHeader, entry->name,
-                        entry->value);
+    listener_->OnHeader(HpackEntryType::kIndexedHeader,
+                        entry->name.ToStringPiece(),
+                        entry->value.ToStringPiece());
   } else {
     ReportError("Invalid index.");
   }
@@ -114,11 +102,14 @@ void HpackDecoderState::OnNameIndexAndLiteralValue(
   allow_dynamic_table_size_update_ = false;
   const HpackStringPair* entry = decoder_tables_.Lookup(name_index);
   if (entry != nullptr) {
-    HpackString value(ExtractHpackString(value_buffer));
-    listener_->OnHeader(entry_type, entry->name, value);
+    // Strings are only copied if inserted into the dynamic table.  Resetting
+    // rather than releasing the buffer keeps its capacity for the next string.
+    const Http2StringPiece value = value_buffer->str();
+    listener_->OnHeader(entry_type, entry->name.ToStringPiece(), value);
     if (entry_type == HpackEntryType::kIndexedLiteralHeader) {
-      decoder_tables_.Insert(entry->name, value);
+      decoder_tables_.Insert(entry->name.ToStringPiece(), value);
     }
+    value_buffer->Reset();
   } else {
     ReportError("Invalid name index.");
   }
@@ -138,12 +129,14 @@ void HpackDecoderState::OnLiteralNameAndValue(
     return;
   }
   allow_dynamic_table_size_update_ = false;
-  HpackString name(ExtractHpackString(name_buffer));
-  HpackString value(ExtractHpackString(value_buffer));
+  const Http2StringPiece name = name_buffer->str();
+  const Http2StringPiece value = value_buffer->str();
   listener_->OnHeader(entry_type, name, value);
   if (entry_type == HpackEntryType::kIndexedLiteralHeader) {
     decoder_tables_.Insert(name, value);
   }
+  name_buffer->Reset();
+  value_buffer->Reset();
 }
 
 void HpackDecoderState::OnDynamicTableSizeUpdate(size_t size_limit) {
@@ -41,8 +41,8 @@ class MockHpackDecoderListener : public HpackDecoderListener {
   MOCK_METHOD0(OnHeaderListStart, void());
   MOCK_METHOD3(OnHeader,
                void(HpackEntryType entry_type,
-                    const HpackString& name,
-                    const HpackString& value));
+                    Http2StringPiece name,
+                    Http2StringPiece value));
   MOCK_METHOD0(OnHeaderListEnd, void());
   MOCK_METHOD1(OnHeaderErrorDetected, void(Http2StringPiece error_message));
 };
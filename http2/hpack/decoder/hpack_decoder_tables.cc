@@ -51,8 +51,8 @@ const HpackStringPair* HpackDecoderStaticTable::Lookup(size_t index) const {
 }
 
 HpackDecoderDynamicTable::HpackDecoderTableEntry::HpackDecoderTableEntry(
-    const HpackString& name,
-    const HpackString& value)
+    Http2StringPiece name,
+    Http2StringPiece value)
     : HpackStringPair(name, value) {}
 
 HpackDecoderDynamicTable::HpackDecoderDynamicTable()
@@ -69,10 +69,9 @@ void HpackDecoderDynamicTable::DynamicTableSizeUpdate(size_t size_limit) {
 
 // TODO(jamessynge): Check somewhere before here that names received from the
 // peer are valid (e.g. are lower-case, no whitespace, etc.).
-bool HpackDecoderDynamicTable::Insert(const HpackString& name,
-                                      const HpackString& value) {
-  HpackDecoderTableEntry entry(name, value);
-  size_t entry_size = entry.size();
+bool HpackDecoderDynamicTable::Insert(Http2StringPiece name,
+                                      Http2StringPiece value) {
+  const size_t entry_size = 32 + name.size() + value.size();
   HTTP2_DVLOG(2) << "InsertEntry of size=" << entry_size
                  << "\n     name: " << name << "\n    value: " << value;
   if (entry_size > size_limit_) {
@@ -84,15 +83,20 @@ bool HpackDecoderDynamicTable::Insert(const HpackString& name,
     return false;  // Not inserted because too large.
   }
   ++insert_count_;
+  // Construct the entry before evicting anything, because |name| may refer to
+  // an entry about to be evicted.  The new entry is at the front, and is not
+  // evicted since it is not larger than the table.
+  table_.emplace_front(name, value);
+  HpackDecoderTableEntry& entry = table_.front();
+  DCHECK_EQ(entry_size, entry.size());
+  entry.time_added = 0;
   if (debug_listener_ != nullptr) {
     entry.time_added = debug_listener_->OnEntryInserted(entry, insert_count_);
     HTTP2_DVLOG(2) << "OnEntryInserted returned time_added=" << entry.time_added
                    << " for insert_count_=" << insert_count_;
   }
-  size_t insert_limit = size_limit_ - entry_size;
-  EnsureSizeNoMoreThan(insert_limit);
-  table_.push_front(entry);
   current_size_ += entry_size;
+  EnsureSizeNoMoreThan(size_limit_);
   HTTP2_DVLOG(2) << "InsertEntry: current_size_=" << current_size_;
   DCHECK_GE(current_size_, entry_size);
   DCHECK_LE(current_size_, size_limit_);
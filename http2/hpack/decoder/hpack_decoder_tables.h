@@ -107,8 +107,9 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderDynamicTable {
   void DynamicTableSizeUpdate(size_t size_limit);
 
   // Returns true if inserted, false if too large (at which point the
-  // dynamic table will be empty.)
-  bool Insert(const HpackString& name, const HpackString& value);
+  // dynamic table will be empty.)  |name| and |value| are copied once, directly
+  // into the new entry; |name| may refer to an entry of this table.
+  bool Insert(Http2StringPiece name, Http2StringPiece value);
 
   // If index is valid, returns a pointer to the entry, otherwise returns
   // nullptr.
@@ -120,7 +121,7 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderDynamicTable {
  private:
   friend class test::HpackDecoderTablesPeer;
   struct HpackDecoderTableEntry : public HpackStringPair {
-    HpackDecoderTableEntry(const HpackString& name, const HpackString& value);
+    HpackDecoderTableEntry(Http2StringPiece name, Http2StringPiece value);
     int64_t time_added;
   };
 
@@ -167,9 +168,7 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderTables {
 
   // Returns true if inserted, false if too large (at which point the
   // dynamic table will be empty.)
-  // TODO(jamessynge): Add methods for moving the string(s) into the table,
-  // or for otherwise avoiding unnecessary copies.
-  bool Insert(const HpackString& name, const HpackString& value) {
+  bool Insert(Http2StringPiece name, Http2StringPiece value) {
     return dynamic_table_.Insert(name, value);
   }
 
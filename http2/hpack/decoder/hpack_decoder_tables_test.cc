@@ -206,7 +206,7 @@ class HpackDecoderTablesTest : public HpackDecoderStaticTableTest {
   // move up by 1 index.
   AssertionResult Insert(const Http2String& name, const Http2String& value) {
     size_t old_count = num_dynamic_entries();
-    if (tables_.Insert(HpackString(name), HpackString(value))) {
+    if (tables_.Insert(name, value)) {
       VERIFY_GT(current_dynamic_size(), 0u);
       VERIFY_GT(num_dynamic_entries(), 0u);
     } else {
@@ -261,6 +261,25 @@ TEST_F(HpackDecoderTablesTest, RandomDynamicTable) {
   }
 }
 
+// The name of a new entry may refer to an entry that is evicted to make room
+// for it.
+TEST(HpackDecoderTablesInsertTest, NameOfEvictedEntry) {
+  HpackDecoderTables tables;
+  // Room for a single entry.
+  tables.DynamicTableSizeUpdate(50);
+  ASSERT_TRUE(tables.Insert("name", "value1"));
+  const HpackStringPair* entry = tables.Lookup(kFirstDynamicTableIndex);
+  ASSERT_NE(nullptr, entry);
+
+  ASSERT_TRUE(tables.Insert(entry->name.ToStringPiece(), "value2"));
+  entry = tables.Lookup(kFirstDynamicTableIndex);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ("name", entry->name.ToStringPiece());
+  EXPECT_EQ("value2", entry->value.ToStringPiece());
+  EXPECT_EQ(nullptr, tables.Lookup(kFirstDynamicTableIndex + 1));
+  EXPECT_EQ(42u, tables.current_header_table_size());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace http2
@@ -67,8 +67,8 @@ class MockHpackDecoderListener : public HpackDecoderListener {
   MOCK_METHOD0(OnHeaderListStart, void());
   MOCK_METHOD3(OnHeader,
                void(HpackEntryType entry_type,
-                    const HpackString& name,
-                    const HpackString& value));
+                    Http2StringPiece name,
+                    Http2StringPiece value));
   MOCK_METHOD0(OnHeaderListEnd, void());
   MOCK_METHOD1(OnHeaderErrorDetected, void(Http2StringPiece error_message));
 };
@@ -96,13 +96,12 @@ class HpackDecoderTest : public ::testing::TestWithParam<bool>,
   // appear in the HPACK block. Multiple values for a given key will be emitted
   // as multiple calls to OnHeader.
   void OnHeader(HpackEntryType entry_type,
-                const HpackString& name,
-                const HpackString& value) override {
+                Http2StringPiece name,
+                Http2StringPiece value) override {
     ASSERT_TRUE(saw_start_);
     ASSERT_FALSE(saw_end_);
-    //     header_entries_.push_back({entry_type, name.ToString(),
-    //     value.ToString()});
-    header_entries_.emplace_back(entry_type, name.ToString(), value.ToString());
+    header_entries_.emplace_back(entry_type, Http2String(name),
+                                 Http2String(value));
   }
 
   // OnHeaderBlockEnd is called after successfully decoding an HPACK block. Will
@@ -345,6 +345,58 @@ struct ShortCodeInfo {
     {0x7a, 7},  // Match: 0b1111011, Symbol: z
 };
 
+// Number of leading bits of the bit buffer used to index kMultiSymbolTable.
+// 12 bits fit two symbols with 5 or 6 bit long codes, which make up most of
+// the symbols in typical header values, while keeping the table (4 bytes per
+// entry) small enough to stay in L1 cache.
+constexpr HuffmanAccumulatorBitCount kMultiSymbolLookupBitCount = 12;
+constexpr size_t kMultiSymbolTableSize = 1 << kMultiSymbolLookupBitCount;
+constexpr size_t kMaxSymbolsPerLookup = 2;
+
+// Decoding of the leading kMultiSymbolLookupBitCount bits of the bit buffer:
+// the symbols of all the complete codes they start with, up to
+// kMaxSymbolsPerLookup.  |symbol_count| is zero if the first code is longer
+// than kMultiSymbolLookupBitCount bits.
+struct MultiSymbolInfo {
+  uint8_t bit_count;     // Number of bits taken up by the decoded codes.
+  uint8_t symbol_count;  // Number of decoded symbols.
+  char symbols[kMaxSymbolsPerLookup];
+};
+
+// Builds the table, using the canonical decoding above for every possible
+// value of the leading bits.  The trailing bits of each lookup value are
+// padded with zeros, which does not affect the decoding of the codes that
+// fit, because no code is a prefix of another one.
+const MultiSymbolInfo* BuildMultiSymbolTable() {
+  MultiSymbolInfo* table = new MultiSymbolInfo[kMultiSymbolTableSize];
+  for (size_t value = 0; value < kMultiSymbolTableSize; ++value) {
+    MultiSymbolInfo& info = table[value];
+    info.bit_count = 0;
+    info.symbol_count = 0;
+    while (info.symbol_count < kMaxSymbolsPerLookup) {
+      const HuffmanCode code_prefix = static_cast<HuffmanCode>(
+          value << (kHuffmanCodeBitCount - kMultiSymbolLookupBitCount +
+                    info.bit_count));
+      const PrefixInfo prefix_info = PrefixToInfo(code_prefix);
+      if (info.bit_count + prefix_info.code_length >
+          kMultiSymbolLookupBitCount) {
+        break;
+      }
+      const uint32_t canonical = prefix_info.DecodeToCanonical(code_prefix);
+      DCHECK_LT(canonical, 256u);
+      info.symbols[info.symbol_count++] =
+          static_cast<char>(kCanonicalToSymbol[canonical]);
+      info.bit_count += prefix_info.code_length;
+    }
+  }
+  return table;
+}
+
+const MultiSymbolInfo* MultiSymbolTable() {
+  static const MultiSymbolInfo* const table = BuildMultiSymbolTable();
+  return table;
+}
+
 }  // namespace
 
 HuffmanBitBuffer::HuffmanBitBuffer() {
@@ -420,21 +472,23 @@ bool HpackHuffmanDecoder::Decode(Http2StringPiece input, Http2String* output) {
   // Fill bit_buffer_ from input.
   input.remove_prefix(bit_buffer_.AppendBytes(input));
 
+  const MultiSymbolInfo* const multi_symbol_table = MultiSymbolTable();
+
   while (true) {
     HTTP2_DVLOG(3) << "Enter Decode Loop, bit_buffer_: " << bit_buffer_;
-    if (bit_buffer_.count() >= 7) {
-      // Get high 7 bits of the bit buffer, see if that contains a complete
-      // code of 5, 6 or 7 bits.
-      uint8_t short_code =
-          bit_buffer_.value() >> (kHuffmanAccumulatorBitCount - 7);
-      DCHECK_LT(short_code, 128);
-      if (short_code < kShortCodeTableSize) {
-        ShortCodeInfo info = kShortCodeTable[short_code];
-        bit_buffer_.ConsumeBits(info.length);
-        output->push_back(static_cast<char>(info.symbol));
+    if (bit_buffer_.count() >= kMultiSymbolLookupBitCount) {
+      // Get high 12 bits of the bit buffer, and decode all the complete codes
+      // they start with in a single lookup.
+      const MultiSymbolInfo& info =
+          multi_symbol_table[bit_buffer_.value() >>
+                             (kHuffmanAccumulatorBitCount -
+                              kMultiSymbolLookupBitCount)];
+      if (info.symbol_count > 0) {
+        output->append(info.symbols, info.symbol_count);
+        bit_buffer_.ConsumeBits(info.bit_count);
         continue;
       }
-      // The code is more than 7 bits long. Use PrefixToInfo, etc. to decode
+      // The code is more than 12 bits long. Use PrefixToInfo, etc. to decode
       // longer codes.
     } else {
       // We may have (mostly) drained bit_buffer_. If we can top it up, try
@@ -444,6 +498,21 @@ bool HpackHuffmanDecoder::Decode(Http2StringPiece input, Http2String* output) {
         input.remove_prefix(byte_count);
         continue;
       }
+      if (bit_buffer_.count() >= 7) {
+        // The input is drained.  Get high 7 bits of the bit buffer, see if
+        // that contains a complete code of 5, 6 or 7 bits.
+        uint8_t short_code =
+            bit_buffer_.value() >> (kHuffmanAccumulatorBitCount - 7);
+        DCHECK_LT(short_code, 128);
+        if (short_code < kShortCodeTableSize) {
+          ShortCodeInfo info = kShortCodeTable[short_code];
+          bit_buffer_.ConsumeBits(info.length);
+          output->push_back(static_cast<char>(info.symbol));
+          continue;
+        }
+        // The code is more than 7 bits long. Use PrefixToInfo, etc. to decode
+        // longer codes.
+      }
     }
 
     HuffmanCode code_prefix = bit_buffer_.value() >> kExtraAccumulatorBitCount;
@@ -12,11 +12,25 @@
 namespace http2 {
 
 size_t ExactHuffmanSize(Http2StringPiece plain) {
-  size_t bits = 0;
-  for (const uint8_t c : plain) {
-    bits += HuffmanSpecTables::kCodeLengths[c];
+  // Sum code lengths with independent accumulators, so that table lookups of
+  // consecutive bytes do not depend on each other.
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(plain.data());
+  const size_t size = plain.size();
+  size_t bits0 = 0;
+  size_t bits1 = 0;
+  size_t bits2 = 0;
+  size_t bits3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    bits0 += HuffmanSpecTables::kCodeLengths[data[i]];
+    bits1 += HuffmanSpecTables::kCodeLengths[data[i + 1]];
+    bits2 += HuffmanSpecTables::kCodeLengths[data[i + 2]];
+    bits3 += HuffmanSpecTables::kCodeLengths[data[i + 3]];
   }
-  return (bits + 7) / 8;
+  for (; i < size; ++i) {
+    bits0 += HuffmanSpecTables::kCodeLengths[data[i]];
+  }
+  return (bits0 + bits1 + bits2 + bits3 + 7) / 8;
 }
 
 size_t BoundedHuffmanSize(Http2StringPiece plain) {
@@ -63,48 +77,46 @@ size_t BoundedHuffmanSize(Http2StringPiece plain) {
 
 void HuffmanEncode(Http2StringPiece plain, Http2String* huffman) {
   DCHECK(huffman != nullptr);
-  huffman->clear();         // Note that this doesn't release memory.
-  uint64_t bit_buffer = 0;  // High-bit is next bit to output. Not clear if that
-                            // is more performant than having the low-bit be the
-                            // last to be output.
-  size_t bits_unused = 64;  // Number of bits available for the next code.
+  // Size the output up front, so that bytes can be stored directly instead of
+  // appended one at a time.  Note that clear() doesn't release memory.
+  huffman->clear();
+  huffman->resize(ExactHuffmanSize(plain));
+  char* out = &(*huffman)[0];
+
+  // Codes are accumulated in the low bits of bit_buffer, and written out 32
+  // bits at a time.  Since at most 31 bits are pending before a code of at most
+  // 30 bits is added, bit_buffer never overflows.
+  uint64_t bit_buffer = 0;
+  size_t bits_used = 0;
   for (uint8_t c : plain) {
-    size_t code_length = HuffmanSpecTables::kCodeLengths[c];
-    if (bits_unused < code_length) {
-      // There isn't enough room in bit_buffer for the code of c.
-      // Flush until bits_unused > 56 (i.e. 64 - 8).
-      do {
-        char h = static_cast<char>(bit_buffer >> 56);
-        bit_buffer <<= 8;
-        bits_unused += 8;
-        // Perhaps would be more efficient if we populated an array of chars,
-        // so we don't have to call push_back each time. Reconsider if used
-        // for production.
-        huffman->push_back(h);
-      } while (bits_unused <= 56);
+    const size_t code_length = HuffmanSpecTables::kCodeLengths[c];
+    bit_buffer =
+        (bit_buffer << code_length) | HuffmanSpecTables::kRightCodes[c];
+    bits_used += code_length;
+    if (bits_used < 32) {
+      continue;
     }
-    uint64_t code = HuffmanSpecTables::kRightCodes[c];
-    size_t shift_by = bits_unused - code_length;
-    bit_buffer |= (code << shift_by);
-    bits_unused -= code_length;
+    bits_used -= 32;
+    const uint32_t word = static_cast<uint32_t>(bit_buffer >> bits_used);
+    out[0] = static_cast<char>(word >> 24);
+    out[1] = static_cast<char>(word >> 16);
+    out[2] = static_cast<char>(word >> 8);
+    out[3] = static_cast<char>(word);
+    out += 4;
   }
-  // bit_buffer contains (64-bits_unused) bits that still need to be flushed.
   // Output whole bytes until we don't have any whole bytes left.
-  size_t bits_used = 64 - bits_unused;
   while (bits_used >= 8) {
-    char h = static_cast<char>(bit_buffer >> 56);
-    bit_buffer <<= 8;
     bits_used -= 8;
-    huffman->push_back(h);
+    *out++ = static_cast<char>(bit_buffer >> bits_used);
   }
   if (bits_used > 0) {
     // We have less than a byte left to output. The spec calls for padding out
     // the final byte with the leading bits of the EOS symbol (30 1-bits).
     constexpr uint64_t leading_eos_bits = 0b11111111;
-    bit_buffer |= (leading_eos_bits << (56 - bits_used));
-    char h = static_cast<char>(bit_buffer >> 56);
-    huffman->push_back(h);
+    *out++ = static_cast<char>((bit_buffer << (8 - bits_used)) |
+                               (leading_eos_bits >> bits_used));
   }
+  DCHECK(out == &(*huffman)[0] + huffman->size());
 }
 
 }  // namespace http2
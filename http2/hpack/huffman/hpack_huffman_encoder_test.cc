@@ -92,5 +92,14 @@ TEST(HuffmanEncoderTest, EncodedSizeAgreesWithEncodeString) {
   }
 }
 
+TEST(HuffmanEncoderTest, ReuseOutputString) {
+  Http2String huffman_encoded(100, 'x');
+  HuffmanEncode("www.example.com", &huffman_encoded);
+  EXPECT_EQ(Http2HexDecode("f1e3c2e5f23a6ba0ab90f4ff"), huffman_encoded);
+
+  HuffmanEncode("", &huffman_encoded);
+  EXPECT_TRUE(huffman_encoded.empty());
+}
+
 }  // namespace
 }  // namespace http2
@@ -128,6 +128,17 @@ TEST_F(HpackHuffmanTranscoderTest, RoundTripRandomBytes) {
   }
 }
 
+// Long strings are mostly decoded several symbols at a time.
+TEST_F(HpackHuffmanTranscoderTest, RoundTripLongStrings) {
+  for (size_t length : {100, 1000, 4000}) {
+    const Http2String s = RandomAsciiNonControlString(length);
+    ASSERT_TRUE(TranscodeAndValidateSeveralWays(s))
+        << "Unable to decode:\n\n"
+        << Http2HexDump(s) << "\n\noutput_buffer_:\n"
+        << Http2HexDump(output_buffer_);
+  }
+}
+
 // Two parameters: decoder choice, and the character to round-trip.
 class HpackHuffmanTranscoderAdjacentCharTest
     : public HpackHuffmanTranscoderTest,
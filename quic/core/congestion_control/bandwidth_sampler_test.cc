@@ -148,6 +148,7 @@ TEST_F(BandwidthSamplerTest, SendTimeState) {
   EXPECT_EQ(PacketsToBytes(1), send_time_state.total_bytes_sent);
   EXPECT_EQ(0u, send_time_state.total_bytes_acked);
   EXPECT_EQ(0u, send_time_state.total_bytes_lost);
+  EXPECT_EQ(PacketsToBytes(1), send_time_state.bytes_in_flight);
   EXPECT_EQ(PacketsToBytes(1), sampler_.total_bytes_acked());
 
   // Lose packet 2.
@@ -155,6 +156,7 @@ TEST_F(BandwidthSamplerTest, SendTimeState) {
   EXPECT_EQ(PacketsToBytes(2), send_time_state.total_bytes_sent);
   EXPECT_EQ(0u, send_time_state.total_bytes_acked);
   EXPECT_EQ(0u, send_time_state.total_bytes_lost);
+  EXPECT_EQ(PacketsToBytes(2), send_time_state.bytes_in_flight);
   EXPECT_EQ(PacketsToBytes(1), sampler_.total_bytes_lost());
 
   // Lose packet 3.
@@ -162,6 +164,7 @@ TEST_F(BandwidthSamplerTest, SendTimeState) {
   EXPECT_EQ(PacketsToBytes(3), send_time_state.total_bytes_sent);
   EXPECT_EQ(0u, send_time_state.total_bytes_acked);
   EXPECT_EQ(0u, send_time_state.total_bytes_lost);
+  EXPECT_EQ(PacketsToBytes(3), send_time_state.bytes_in_flight);
   EXPECT_EQ(PacketsToBytes(2), sampler_.total_bytes_lost());
 
   // Send packets 6-10.
@@ -182,9 +185,12 @@ TEST_F(BandwidthSamplerTest, SendTimeState) {
     if (i <= 5) {
       EXPECT_EQ(0u, send_time_state.total_bytes_acked);
       EXPECT_EQ(0u, send_time_state.total_bytes_lost);
+      EXPECT_EQ(PacketsToBytes(i), send_time_state.bytes_in_flight);
     } else {
       EXPECT_EQ(PacketsToBytes(1), send_time_state.total_bytes_acked);
       EXPECT_EQ(PacketsToBytes(2), send_time_state.total_bytes_lost);
+      // Packets 4 and 5 and 6 through |i| were in flight when |i| was sent.
+      EXPECT_EQ(PacketsToBytes(i - 3), send_time_state.bytes_in_flight);
     }
     clock_.AdvanceTime(time_between_packets);
   }
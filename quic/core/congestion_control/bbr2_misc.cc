@@ -0,0 +1,302 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/bbr2_misc.h"
+
+#include <algorithm>
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/bandwidth_sampler.h"
+#include "net/third_party/quiche/src/quic/core/quic_bandwidth.h"
+#include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+Bbr2Params::Bbr2Params(QuicByteCount cwnd_min, QuicByteCount cwnd_max)
+    : cwnd_limits(cwnd_min, cwnd_max) {}
+
+RoundTripCounter::RoundTripCounter() : round_trip_count_(0) {}
+
+void RoundTripCounter::OnPacketSent(QuicPacketNumber packet_number) {
+  DCHECK(!last_sent_packet_.IsInitialized() ||
+         last_sent_packet_ < packet_number);
+  last_sent_packet_ = packet_number;
+}
+
+bool RoundTripCounter::OnPacketsAcked(QuicPacketNumber last_acked_packet) {
+  if (!end_of_round_trip_.IsInitialized() ||
+      last_acked_packet > end_of_round_trip_) {
+    round_trip_count_++;
+    end_of_round_trip_ = last_sent_packet_;
+    return true;
+  }
+  return false;
+}
+
+void RoundTripCounter::RestartRound() {
+  end_of_round_trip_ = last_sent_packet_;
+}
+
+MinRttFilter::MinRttFilter(QuicTime::Delta initial_min_rtt,
+                           QuicTime initial_min_rtt_timestamp)
+    : min_rtt_(initial_min_rtt),
+      min_rtt_timestamp_(initial_min_rtt_timestamp) {}
+
+void MinRttFilter::Update(QuicTime::Delta sample_rtt, QuicTime now) {
+  if (sample_rtt < min_rtt_ || min_rtt_timestamp_ == QuicTime::Zero()) {
+    min_rtt_ = sample_rtt;
+    min_rtt_timestamp_ = now;
+  }
+}
+
+void MinRttFilter::ForceUpdate(QuicTime::Delta sample_rtt, QuicTime now) {
+  min_rtt_ = sample_rtt;
+  min_rtt_timestamp_ = now;
+}
+
+Bbr2NetworkModel::Bbr2NetworkModel(const Bbr2Params* params,
+                                   QuicTime::Delta initial_rtt,
+                                   QuicTime initial_rtt_timestamp,
+                                   float cwnd_gain,
+                                   float pacing_gain)
+    : params_(params),
+      min_rtt_filter_(initial_rtt, initial_rtt_timestamp),
+      max_ack_height_filter_(params->initial_max_ack_height_filter_window,
+                             0,
+                             0),
+      aggregation_epoch_start_time_(QuicTime::Zero()),
+      aggregation_epoch_bytes_(0),
+      cwnd_gain_(cwnd_gain),
+      pacing_gain_(pacing_gain) {}
+
+void Bbr2NetworkModel::OnPacketSent(QuicTime sent_time,
+                                    QuicByteCount bytes_in_flight,
+                                    QuicPacketNumber packet_number,
+                                    QuicByteCount bytes,
+                                    HasRetransmittableData is_retransmittable) {
+  round_trip_counter_.OnPacketSent(packet_number);
+
+  if (!aggregation_epoch_start_time_.IsInitialized()) {
+    aggregation_epoch_start_time_ = sent_time;
+  }
+
+  bandwidth_sampler_.OnPacketSent(sent_time, packet_number, bytes,
+                                  bytes_in_flight, is_retransmittable);
+}
+
+void Bbr2NetworkModel::OnCongestionEventStart(
+    QuicTime event_time,
+    const AckedPacketVector& acked_packets,
+    const LostPacketVector& lost_packets,
+    Bbr2CongestionEvent* congestion_event) {
+  const QuicByteCount prior_bytes_acked = total_bytes_acked();
+  const QuicByteCount prior_bytes_lost = total_bytes_lost();
+
+  congestion_event->event_time = event_time;
+  congestion_event->end_of_round_trip = false;
+
+  if (!acked_packets.empty()) {
+    congestion_event->end_of_round_trip = round_trip_counter_.OnPacketsAcked(
+        acked_packets.rbegin()->packet_number);
+  }
+
+  for (const LostPacket& packet : lost_packets) {
+    const SendTimeState send_time_state =
+        bandwidth_sampler_.OnPacketLost(packet.packet_number);
+    if (send_time_state.is_valid) {
+      congestion_event->last_packet_send_state = send_time_state;
+    }
+  }
+
+  for (const AckedPacket& packet : acked_packets) {
+    const BandwidthSample sample = bandwidth_sampler_.OnPacketAcknowledged(
+        event_time, packet.packet_number);
+    if (!sample.state_at_send.is_valid) {
+      // From the sampler's perspective, the packet has never been sent, or
+      // the packet has been acked or marked as lost previously.
+      continue;
+    }
+
+    congestion_event->last_packet_send_state = sample.state_at_send;
+    congestion_event->last_sample_is_app_limited =
+        sample.state_at_send.is_app_limited;
+    if (!sample.rtt.IsZero()) {
+      congestion_event->sample_min_rtt =
+          std::min(congestion_event->sample_min_rtt, sample.rtt);
+    }
+    if (!sample.state_at_send.is_app_limited ||
+        sample.bandwidth > MaxBandwidth()) {
+      max_bandwidth_filter_.Update(sample.bandwidth);
+    }
+    if (sample.bandwidth > congestion_event->sample_max_bandwidth) {
+      congestion_event->sample_max_bandwidth = sample.bandwidth;
+    }
+  }
+
+  if (!congestion_event->sample_min_rtt.IsInfinite()) {
+    min_rtt_filter_.Update(congestion_event->sample_min_rtt, event_time);
+  }
+
+  congestion_event->bytes_acked = total_bytes_acked() - prior_bytes_acked;
+  congestion_event->bytes_lost = total_bytes_lost() - prior_bytes_lost;
+
+  if (congestion_event->bytes_lost > 0) {
+    bytes_lost_in_round_ += congestion_event->bytes_lost;
+    loss_events_in_round_++;
+  }
+  bytes_acked_in_round_ += congestion_event->bytes_acked;
+
+  // |bandwidth_latest_| and |inflight_latest_| only increase within a round.
+  if (congestion_event->sample_max_bandwidth > bandwidth_latest_) {
+    bandwidth_latest_ = congestion_event->sample_max_bandwidth;
+  }
+  if (bytes_acked_in_round_ > inflight_latest_) {
+    inflight_latest_ = bytes_acked_in_round_;
+  }
+
+  if (congestion_event->bytes_acked > 0) {
+    UpdateAckAggregationBytes(event_time, congestion_event->bytes_acked);
+  }
+}
+
+void Bbr2NetworkModel::AdaptLowerBounds(
+    const Bbr2CongestionEvent& congestion_event) {
+  if (!congestion_event.end_of_round_trip ||
+      congestion_event.is_probing_for_bandwidth) {
+    return;
+  }
+
+  if (bytes_lost_in_round_ > 0) {
+    if (bandwidth_lo_.IsInfinite()) {
+      bandwidth_lo_ = MaxBandwidth();
+    }
+    bandwidth_lo_ =
+        std::max(bandwidth_latest_, bandwidth_lo_ * (1.0f - Params().beta));
+    QUIC_DVLOG(3) << "bandwidth_lo_ updated to " << bandwidth_lo_
+                  << ", bandwidth_latest_ is " << bandwidth_latest_;
+
+    if (inflight_lo_ == inflight_lo_default()) {
+      inflight_lo_ = congestion_event.prior_cwnd;
+    }
+    inflight_lo_ = std::max<QuicByteCount>(
+        inflight_latest_, inflight_lo_ * (1.0f - Params().beta));
+  }
+}
+
+void Bbr2NetworkModel::OnCongestionEventFinish(
+    QuicPacketNumber least_unacked_packet,
+    const Bbr2CongestionEvent& congestion_event) {
+  if (congestion_event.end_of_round_trip) {
+    bytes_lost_in_round_ = 0;
+    loss_events_in_round_ = 0;
+    bytes_acked_in_round_ = 0;
+    bandwidth_latest_ = QuicBandwidth::Zero();
+    inflight_latest_ = 0;
+  }
+
+  bandwidth_sampler_.RemoveObsoletePackets(least_unacked_packet);
+}
+
+void Bbr2NetworkModel::UpdateNetworkParameters(QuicBandwidth bandwidth,
+                                               QuicTime::Delta rtt) {
+  if (!bandwidth.IsZero()) {
+    max_bandwidth_filter_.Update(bandwidth);
+  }
+
+  if (!rtt.IsZero()) {
+    min_rtt_filter_.Update(rtt, MinRttTimestamp());
+  }
+}
+
+bool Bbr2NetworkModel::MaybeExpireMinRtt(
+    const Bbr2CongestionEvent& congestion_event) {
+  if (congestion_event.event_time <
+      (MinRttTimestamp() + Params().probe_rtt_period)) {
+    return false;
+  }
+  if (congestion_event.sample_min_rtt.IsInfinite()) {
+    return false;
+  }
+  QUIC_DVLOG(3) << "Replacing expired min rtt of " << min_rtt_filter_.Get()
+                << " by " << congestion_event.sample_min_rtt << "  @ "
+                << congestion_event.event_time;
+  min_rtt_filter_.ForceUpdate(congestion_event.sample_min_rtt,
+                              congestion_event.event_time);
+  return true;
+}
+
+void Bbr2NetworkModel::RestartRound() {
+  round_trip_counter_.RestartRound();
+}
+
+bool Bbr2NetworkModel::IsCongestionWindowLimited(
+    const Bbr2CongestionEvent& congestion_event) const {
+  // The sender stops once bytes in flight reach the CWND, so allow for the
+  // last packet not fitting into the window.
+  return congestion_event.prior_bytes_in_flight + kDefaultTCPMSS >=
+         congestion_event.prior_cwnd;
+}
+
+bool Bbr2NetworkModel::IsInflightTooHigh(
+    const Bbr2CongestionEvent& congestion_event) const {
+  const SendTimeState& send_state = congestion_event.last_packet_send_state;
+  if (!send_state.is_valid) {
+    // Not enough information.
+    return false;
+  }
+
+  const QuicByteCount inflight_at_send = send_state.bytes_in_flight;
+  if (inflight_at_send > 0 && bytes_lost_in_round_ > 0) {
+    const QuicByteCount lost_in_round_threshold =
+        inflight_at_send * Params().loss_threshold;
+    if (bytes_lost_in_round_ > lost_in_round_threshold) {
+      QUIC_DVLOG(3) << "Inflight too high: bytes_lost_in_round:"
+                    << bytes_lost_in_round_
+                    << ", lost_in_round_threshold:" << lost_in_round_threshold
+                    << ", inflight_at_send:" << inflight_at_send;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+QuicByteCount Bbr2NetworkModel::inflight_hi_with_headroom() const {
+  if (inflight_hi_ == inflight_hi_default()) {
+    return inflight_hi_;
+  }
+  const QuicByteCount headroom = inflight_hi_ * Params().inflight_hi_headroom;
+  return inflight_hi_ > headroom ? inflight_hi_ - headroom : 0;
+}
+
+void Bbr2NetworkModel::ResetLowerBounds() {
+  bandwidth_lo_ = QuicBandwidth::Infinite();
+  inflight_lo_ = inflight_lo_default();
+}
+
+void Bbr2NetworkModel::UpdateAckAggregationBytes(
+    QuicTime ack_time,
+    QuicByteCount newly_acked_bytes) {
+  // Compute how many bytes are expected to be delivered, assuming max
+  // bandwidth is correct.
+  const QuicByteCount expected_bytes_acked =
+      MaxBandwidth() * (ack_time - aggregation_epoch_start_time_);
+  // Reset the current aggregation epoch as soon as the ack arrival rate is
+  // less than or equal to the max bandwidth.
+  if (aggregation_epoch_bytes_ <= expected_bytes_acked) {
+    // Reset to start measuring a new aggregation epoch.
+    aggregation_epoch_bytes_ = newly_acked_bytes;
+    aggregation_epoch_start_time_ = ack_time;
+    return;
+  }
+
+  // Compute how many extra bytes were delivered vs max bandwidth.
+  // Include the bytes most recently acknowledged to account for stretch acks.
+  aggregation_epoch_bytes_ += newly_acked_bytes;
+  max_ack_height_filter_.Update(aggregation_epoch_bytes_ - expected_bytes_acked,
+                                RoundTripCount());
+}
+
+}  // namespace quic
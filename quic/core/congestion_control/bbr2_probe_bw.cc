@@ -0,0 +1,351 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/bbr2_probe_bw.h"
+
+#include <algorithm>
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/bbr2_misc.h"
+#include "net/third_party/quiche/src/quic/core/congestion_control/bbr2_sender.h"
+#include "net/third_party/quiche/src/quic/core/quic_bandwidth.h"
+#include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+void Bbr2ProbeBwMode::Enter(QuicTime now,
+                            const Bbr2CongestionEvent* /*congestion_event*/) {
+  // Both the first entry from DRAIN and the re-entry from PROBE_RTT start a
+  // new cycle.  After PROBE_RTT, bytes in flight are already below the
+  // PROBE_DOWN target, so PROBE_CRUISE is entered upon the next ack.
+  EnterProbeDown(now);
+}
+
+Bbr2Mode Bbr2ProbeBwMode::OnCongestionEvent(
+    QuicByteCount prior_in_flight,
+    QuicTime event_time,
+    const AckedPacketVector& /*acked_packets*/,
+    const LostPacketVector& /*lost_packets*/,
+    const Bbr2CongestionEvent& congestion_event) {
+  DCHECK(cycle_.phase != CyclePhase::PROBE_NOT_STARTED);
+
+  if (congestion_event.end_of_round_trip) {
+    if (cycle_.cycle_start_time != event_time) {
+      ++cycle_.rounds_since_probe;
+    }
+    if (cycle_.phase_start_time != event_time) {
+      ++cycle_.rounds_in_phase;
+    }
+  }
+
+  switch (cycle_.phase) {
+    case CyclePhase::PROBE_UP:
+      UpdateProbeUp(prior_in_flight, congestion_event);
+      break;
+    case CyclePhase::PROBE_DOWN:
+      UpdateProbeDown(prior_in_flight, congestion_event);
+      break;
+    case CyclePhase::PROBE_CRUISE:
+      UpdateProbeCruise(congestion_event);
+      break;
+    case CyclePhase::PROBE_REFILL:
+      UpdateProbeRefill(congestion_event);
+      break;
+    case CyclePhase::PROBE_NOT_STARTED:
+      QUIC_BUG << "PROBE_BW received a congestion event before it is entered.";
+      break;
+  }
+
+  model_->set_pacing_gain(PacingGainForPhase(cycle_.phase));
+  model_->set_cwnd_gain(Params().probe_bw_cwnd_gain);
+
+  return Bbr2Mode::PROBE_BW;
+}
+
+Limits<QuicByteCount> Bbr2ProbeBwMode::GetCwndLimits() const {
+  if (cycle_.phase == CyclePhase::PROBE_CRUISE) {
+    return NoGreaterThan(
+        std::min(model_->inflight_lo(), model_->inflight_hi_with_headroom()));
+  }
+
+  return NoGreaterThan(std::min(model_->inflight_lo(), model_->inflight_hi()));
+}
+
+bool Bbr2ProbeBwMode::IsProbingForBandwidth() const {
+  return cycle_.phase == CyclePhase::PROBE_REFILL ||
+         cycle_.phase == CyclePhase::PROBE_UP;
+}
+
+void Bbr2ProbeBwMode::UpdateProbeDown(
+    QuicByteCount /*prior_in_flight*/,
+    const Bbr2CongestionEvent& congestion_event) {
+  DCHECK(cycle_.phase == CyclePhase::PROBE_DOWN);
+
+  if (cycle_.rounds_in_phase == 1 && congestion_event.end_of_round_trip) {
+    // All packets sent during the preceding PROBE_UP have been acked or lost,
+    // so the bandwidth samples of this cycle's probe are in the filter.
+    if (!cycle_.has_advanced_max_bw) {
+      QUIC_DVLOG(3) << sender_ << " Advancing max bw filter after one round in "
+                    << "PROBE_DOWN.";
+      model_->AdvanceMaxBandwidthFilter();
+      cycle_.has_advanced_max_bw = true;
+    }
+  }
+
+  model_->AdaptLowerBounds(congestion_event);
+
+  if (IsTimeToProbeBandwidth(congestion_event)) {
+    EnterProbeRefill(congestion_event.event_time);
+    return;
+  }
+
+  // The queue built during PROBE_UP is drained once bytes in flight drop to
+  // the estimated BDP, leaving headroom below inflight_hi.
+  const QuicByteCount inflight_target =
+      std::min(model_->BDP(model_->MaxBandwidth()),
+               model_->inflight_hi_with_headroom());
+  if (congestion_event.bytes_in_flight <= inflight_target) {
+    QUIC_DVLOG(3) << sender_ << " Exiting PROBE_DOWN. bytes_in_flight:"
+                  << congestion_event.bytes_in_flight
+                  << ", inflight_target:" << inflight_target << "  @ "
+                  << congestion_event.event_time;
+    EnterProbeCruise(congestion_event.event_time);
+  }
+}
+
+void Bbr2ProbeBwMode::UpdateProbeCruise(
+    const Bbr2CongestionEvent& congestion_event) {
+  DCHECK(cycle_.phase == CyclePhase::PROBE_CRUISE);
+  model_->AdaptLowerBounds(congestion_event);
+
+  if (IsTimeToProbeBandwidth(congestion_event)) {
+    EnterProbeRefill(congestion_event.event_time);
+  }
+}
+
+void Bbr2ProbeBwMode::UpdateProbeRefill(
+    const Bbr2CongestionEvent& congestion_event) {
+  DCHECK(cycle_.phase == CyclePhase::PROBE_REFILL);
+
+  // Refill the pipe for one round trip with the lower bounds reset, so that
+  // bandwidth samples taken in PROBE_UP are not limited by them.
+  if (cycle_.rounds_in_phase > 0 && congestion_event.end_of_round_trip) {
+    EnterProbeUp(congestion_event.event_time);
+  }
+}
+
+void Bbr2ProbeBwMode::UpdateProbeUp(
+    QuicByteCount prior_in_flight,
+    const Bbr2CongestionEvent& congestion_event) {
+  DCHECK(cycle_.phase == CyclePhase::PROBE_UP);
+
+  if (model_->IsInflightTooHigh(congestion_event)) {
+    if (!congestion_event.last_sample_is_app_limited) {
+      // The loss rate exceeded the threshold, so the path cannot hold as much
+      // as was in flight when the lossy packet was sent.
+      const QuicByteCount inflight_at_send =
+          congestion_event.last_packet_send_state.bytes_in_flight;
+      const QuicByteCount inflight_target =
+          sender_->GetTargetBytesInflight() * (1.0f - Params().beta);
+      model_->set_inflight_hi(std::max(inflight_at_send, inflight_target));
+      QUIC_DVLOG(3) << sender_ << " Probing too high. inflight_hi set to "
+                    << model_->inflight_hi() << "  @ "
+                    << congestion_event.event_time;
+    }
+    EnterProbeDown(congestion_event.event_time);
+    return;
+  }
+
+  ProbeInflightHighUpward(congestion_event);
+
+  // Stop probing once a queue has been standing for at least one min_rtt:
+  // more bandwidth, if available, would already have been measured.
+  if (HasPhaseLasted(model_->MinRtt(), congestion_event)) {
+    const QuicByteCount queuing_threshold =
+        model_->BDP(model_->MaxBandwidth(),
+                    Params().probe_bw_probe_inflight_gain) +
+        model_->QueueingThresholdExtraBytes();
+    if (prior_in_flight >= queuing_threshold) {
+      QUIC_DVLOG(3) << sender_ << " Exiting PROBE_UP due to queuing. "
+                    << "prior_in_flight:" << prior_in_flight
+                    << ", queuing_threshold:" << queuing_threshold << "  @ "
+                    << congestion_event.event_time;
+      EnterProbeDown(congestion_event.event_time);
+    }
+  }
+}
+
+void Bbr2ProbeBwMode::ProbeInflightHighUpward(
+    const Bbr2CongestionEvent& congestion_event) {
+  DCHECK(cycle_.phase == CyclePhase::PROBE_UP);
+  if (model_->inflight_hi() == Bbr2NetworkModel::inflight_hi_default() ||
+      !model_->IsCongestionWindowLimited(congestion_event) ||
+      congestion_event.prior_cwnd < model_->inflight_hi()) {
+    // inflight_hi is not the limiting factor, do not raise it.
+    return;
+  }
+
+  // Increase inflight_hi by the number of probe_up_bytes within
+  // probe_up_acked.
+  cycle_.probe_up_acked += congestion_event.bytes_acked;
+  if (cycle_.probe_up_acked >= cycle_.probe_up_bytes) {
+    uint64_t delta = cycle_.probe_up_acked / cycle_.probe_up_bytes;
+    cycle_.probe_up_acked -= delta * cycle_.probe_up_bytes;
+    model_->set_inflight_hi(model_->inflight_hi() + delta * kDefaultTCPMSS);
+  }
+
+  if (congestion_event.end_of_round_trip) {
+    RaiseInflightHighSlope();
+  }
+}
+
+void Bbr2ProbeBwMode::RaiseInflightHighSlope() {
+  // Double the growth of inflight_hi every round, starting from one packet.
+  uint64_t growth_this_round = uint64_t{1} << cycle_.probe_up_rounds;
+  cycle_.probe_up_rounds = std::min<uint64_t>(cycle_.probe_up_rounds + 1, 30);
+  uint64_t probe_up_bytes = sender_->GetCongestionWindow() / growth_this_round;
+  cycle_.probe_up_bytes =
+      std::max<QuicByteCount>(probe_up_bytes, kDefaultTCPMSS);
+}
+
+bool Bbr2ProbeBwMode::IsTimeToProbeBandwidth(
+    const Bbr2CongestionEvent& congestion_event) const {
+  return HasCycleLasted(cycle_.probe_wait_time, congestion_event) ||
+         IsTimeToProbeForRenoCoexistence(1.0, congestion_event);
+}
+
+bool Bbr2ProbeBwMode::IsTimeToProbeForRenoCoexistence(
+    double probe_wait_fraction,
+    const Bbr2CongestionEvent& /*congestion_event*/) const {
+  uint64_t rounds = Params().probe_bw_probe_max_rounds;
+  if (Params().probe_bw_probe_reno_gain > 0.0) {
+    QuicByteCount target_bytes_inflight = sender_->GetTargetBytesInflight();
+    uint64_t reno_rounds = Params().probe_bw_probe_reno_gain *
+                           target_bytes_inflight / kDefaultTCPMSS;
+    rounds = std::min(rounds, reno_rounds);
+  }
+  return cycle_.rounds_since_probe >= (rounds * probe_wait_fraction);
+}
+
+bool Bbr2ProbeBwMode::HasCycleLasted(
+    QuicTime::Delta duration,
+    const Bbr2CongestionEvent& congestion_event) const {
+  return (congestion_event.event_time - cycle_.cycle_start_time) > duration;
+}
+
+bool Bbr2ProbeBwMode::HasPhaseLasted(
+    QuicTime::Delta duration,
+    const Bbr2CongestionEvent& congestion_event) const {
+  return (congestion_event.event_time - cycle_.phase_start_time) > duration;
+}
+
+void Bbr2ProbeBwMode::EnterProbeDown(QuicTime now) {
+  QUIC_DVLOG(2) << sender_ << " Phase change: " << cycle_.phase << " ==> "
+                << CyclePhase::PROBE_DOWN << "  @ " << now;
+  cycle_.phase = CyclePhase::PROBE_DOWN;
+  cycle_.rounds_in_phase = 0;
+  cycle_.phase_start_time = now;
+
+  // Pick the time and the number of rounds to wait before the next probe.
+  cycle_.rounds_since_probe =
+      sender_->RandomUint64(Params().probe_bw_max_probe_rand_rounds);
+  cycle_.probe_wait_time =
+      Params().probe_bw_probe_base_duration +
+      QuicTime::Delta::FromMicroseconds(sender_->RandomUint64(
+          Params().probe_bw_probe_max_rand_duration.ToMicroseconds()));
+
+  cycle_.probe_up_bytes = std::numeric_limits<QuicByteCount>::max();
+  cycle_.has_advanced_max_bw = false;
+  cycle_.cycle_start_time = now;
+  model_->RestartRound();
+}
+
+void Bbr2ProbeBwMode::EnterProbeCruise(QuicTime now) {
+  QUIC_DVLOG(2) << sender_ << " Phase change: " << cycle_.phase << " ==> "
+                << CyclePhase::PROBE_CRUISE << "  @ " << now;
+  cycle_.phase = CyclePhase::PROBE_CRUISE;
+  cycle_.rounds_in_phase = 0;
+  cycle_.phase_start_time = now;
+}
+
+void Bbr2ProbeBwMode::EnterProbeRefill(QuicTime now) {
+  QUIC_DVLOG(2) << sender_ << " Phase change: " << cycle_.phase << " ==> "
+                << CyclePhase::PROBE_REFILL << "  @ " << now;
+  cycle_.phase = CyclePhase::PROBE_REFILL;
+  cycle_.rounds_in_phase = 0;
+  cycle_.phase_start_time = now;
+
+  model_->ResetLowerBounds();
+  cycle_.probe_up_rounds = 0;
+  cycle_.probe_up_acked = 0;
+  model_->RestartRound();
+}
+
+void Bbr2ProbeBwMode::EnterProbeUp(QuicTime now) {
+  DCHECK(cycle_.phase == CyclePhase::PROBE_REFILL);
+  QUIC_DVLOG(2) << sender_ << " Phase change: " << cycle_.phase << " ==> "
+                << CyclePhase::PROBE_UP << "  @ " << now;
+  cycle_.phase = CyclePhase::PROBE_UP;
+  cycle_.rounds_in_phase = 0;
+  cycle_.phase_start_time = now;
+
+  RaiseInflightHighSlope();
+  model_->RestartRound();
+}
+
+float Bbr2ProbeBwMode::PacingGainForPhase(CyclePhase phase) const {
+  if (phase == CyclePhase::PROBE_UP) {
+    return Params().probe_bw_probe_up_pacing_gain;
+  }
+  if (phase == CyclePhase::PROBE_DOWN) {
+    return Params().probe_bw_probe_down_pacing_gain;
+  }
+  return Params().probe_bw_default_pacing_gain;
+}
+
+// static
+const char* Bbr2ProbeBwMode::CyclePhaseToString(CyclePhase phase) {
+  switch (phase) {
+    case CyclePhase::PROBE_NOT_STARTED:
+      return "PROBE_NOT_STARTED";
+    case CyclePhase::PROBE_UP:
+      return "PROBE_UP";
+    case CyclePhase::PROBE_DOWN:
+      return "PROBE_DOWN";
+    case CyclePhase::PROBE_CRUISE:
+      return "PROBE_CRUISE";
+    case CyclePhase::PROBE_REFILL:
+      return "PROBE_REFILL";
+  }
+  return "<Invalid CyclePhase>";
+}
+
+Bbr2ProbeBwMode::DebugState Bbr2ProbeBwMode::ExportDebugState() const {
+  DebugState s;
+  s.phase = cycle_.phase;
+  s.cycle_start_time = cycle_.cycle_start_time;
+  s.phase_start_time = cycle_.phase_start_time;
+  return s;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const Bbr2ProbeBwMode::DebugState& state) {
+  os << "[PROBE_BW] phase: " << state.phase << "\n";
+  os << "[PROBE_BW] cycle_start_time: " << state.cycle_start_time << "\n";
+  os << "[PROBE_BW] phase_start_time: " << state.phase_start_time << "\n";
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const Bbr2ProbeBwMode::CyclePhase phase) {
+  return os << Bbr2ProbeBwMode::CyclePhaseToString(phase);
+}
+
+const Bbr2Params& Bbr2ProbeBwMode::Params() const {
+  return sender_->Params();
+}
+
+}  // namespace quic
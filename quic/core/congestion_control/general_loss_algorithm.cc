@@ -9,6 +9,7 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_flag_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 
 namespace quic {
 
@@ -24,6 +25,14 @@ static const size_t kMinLossDelayMs = 5;
 static const int kDefaultLossDelayShift = 2;
 // Default fraction of an RTT when doing adaptive loss detection.
 static const int kDefaultAdaptiveLossDelayShift = 4;
+// Default fraction of an RTT when adapting to reordering, which is RACK's
+// initial reordering window of 1/8 RTT.
+static const int kDefaultAdaptiveReorderingLossDelayShift = 3;
+
+// When adapting to reordering, the loss timer is delayed by this much so that
+// packets sent in a burst are declared lost together, in a single congestion
+// event, instead of one alarm per packet.
+static const int64_t kLossTimerBatchingDelayMs = 1;
 
 }  // namespace
 
@@ -40,9 +49,14 @@ void GeneralLossAlgorithm::SetLossDetectionType(LossDetectionType loss_type) {
   loss_detection_timeout_ = QuicTime::Zero();
   largest_sent_on_spurious_retransmit_.Clear();
   loss_type_ = loss_type;
-  reordering_shift_ = loss_type == kAdaptiveTime
-                          ? kDefaultAdaptiveLossDelayShift
-                          : kDefaultLossDelayShift;
+  if (loss_type == kAdaptiveTime) {
+    reordering_shift_ = kDefaultAdaptiveLossDelayShift;
+  } else if (loss_type == kAdaptiveReordering) {
+    reordering_shift_ = kDefaultAdaptiveReorderingLossDelayShift;
+  } else {
+    reordering_shift_ = kDefaultLossDelayShift;
+  }
+  reordering_threshold_ = kNumberOfNacksBeforeRetransmission;
   if (GetQuicReloadableFlag(quic_eighth_rtt_loss_detection) &&
       loss_type == kTime) {
     QUIC_RELOADABLE_FLAG_COUNT(quic_eighth_rtt_loss_detection);
@@ -64,6 +78,9 @@ void GeneralLossAlgorithm::DetectLosses(
     const AckedPacketVector& packets_acked,
     LostPacketVector* packets_lost) {
   loss_detection_timeout_ = QuicTime::Zero();
+  if (loss_type_ == kAdaptiveReordering) {
+    DetectReordering(unacked_packets, time, rtt_stats, packets_acked);
+  }
   if (!packets_acked.empty() &&
       packets_acked.front().packet_number == least_in_flight_) {
     if (GetQuicReloadableFlag(quic_fix_packets_acked)) {
@@ -127,6 +144,11 @@ void GeneralLossAlgorithm::DetectLosses(
         packets_lost->push_back(LostPacket(packet_number, it->bytes_sent));
         continue;
       }
+    } else if (loss_type_ == kAdaptiveReordering) {
+      if (largest_newly_acked - packet_number >= reordering_threshold_) {
+        packets_lost->push_back(LostPacket(packet_number, it->bytes_sent));
+        continue;
+      }
     } else if (loss_type_ == kLazyFack) {
       // Require two in order acks to invoke FACK, which avoids spuriously
       // retransmitting packets when one packet is reordered by a large amount.
@@ -150,10 +172,16 @@ void GeneralLossAlgorithm::DetectLosses(
         unacked_packets.GetLargestSentRetransmittableOfPacketNumberSpace(
             packet_number_space_);
     if (largest_sent_retransmittable_packet <= largest_newly_acked ||
-        loss_type_ == kTime || loss_type_ == kAdaptiveTime) {
+        loss_type_ == kTime || loss_type_ == kAdaptiveTime ||
+        loss_type_ == kAdaptiveReordering) {
       QuicTime when_lost = it->sent_time + loss_delay;
       if (time < when_lost) {
         loss_detection_timeout_ = when_lost;
+        if (loss_type_ == kAdaptiveReordering) {
+          loss_detection_timeout_ =
+              when_lost +
+              QuicTime::Delta::FromMilliseconds(kLossTimerBatchingDelayMs);
+        }
         if (!least_in_flight_.IsInitialized()) {
           // At this point, packet_number is in flight and not detected as lost.
           least_in_flight_ = packet_number;
@@ -191,6 +219,11 @@ void GeneralLossAlgorithm::SpuriousRetransmitDetected(
     QuicTime time,
     const RttStats& rtt_stats,
     QuicPacketNumber spurious_retransmission) {
+  if (loss_type_ == kAdaptiveReordering) {
+    AdaptToReordering(unacked_packets, time, rtt_stats, spurious_retransmission,
+                      largest_previously_acked_);
+    return;
+  }
   if (loss_type_ != kAdaptiveTime || reordering_shift_ == 0) {
     return;
   }
@@ -224,6 +257,68 @@ void GeneralLossAlgorithm::SpuriousRetransmitDetected(
   } while (proposed_extra_time < extra_time_needed && reordering_shift_ > 0);
 }
 
+void GeneralLossAlgorithm::DetectReordering(
+    const QuicUnackedPacketMap& unacked_packets,
+    QuicTime time,
+    const RttStats& rtt_stats,
+    const AckedPacketVector& packets_acked) {
+  if (!largest_previously_acked_.IsInitialized()) {
+    return;
+  }
+  // |packets_acked| is sorted, so only its prefix can be reordered.
+  for (const AckedPacket& acked : packets_acked) {
+    if (acked.packet_number >= largest_previously_acked_) {
+      break;
+    }
+    if (unacked_packets.GetPacketNumberSpace(acked.packet_number) !=
+        packet_number_space_) {
+      continue;
+    }
+    AdaptToReordering(unacked_packets, time, rtt_stats, acked.packet_number,
+                      largest_previously_acked_);
+  }
+}
+
+void GeneralLossAlgorithm::AdaptToReordering(
+    const QuicUnackedPacketMap& unacked_packets,
+    QuicTime time,
+    const RttStats& rtt_stats,
+    QuicPacketNumber packet_number,
+    QuicPacketNumber largest_acked) {
+  if (!largest_acked.IsInitialized() || largest_acked <= packet_number) {
+    return;
+  }
+  // Packet threshold: |packet_number| is lost once |reordering_threshold_|
+  // larger packets are acked, so it needs to exceed the observed distance.
+  const QuicPacketCount reordering = largest_acked - packet_number + 1;
+  if (reordering > reordering_threshold_ &&
+      reordering_threshold_ < kMaxReorderingThreshold) {
+    reordering_threshold_ = reordering < kMaxReorderingThreshold
+                                ? reordering
+                                : kMaxReorderingThreshold;
+    QUIC_DVLOG(1) << "Packet reordering threshold increased to "
+                  << reordering_threshold_;
+  }
+
+  // Time threshold: allow for the time the packet has been outstanding beyond
+  // an RTT.
+  if (reordering_shift_ == 0 ||
+      packet_number < unacked_packets.GetLeastUnacked()) {
+    return;
+  }
+  const QuicTime::Delta max_rtt =
+      std::max(rtt_stats.previous_srtt(), rtt_stats.latest_rtt());
+  const QuicTime::Delta extra_time_needed =
+      time - unacked_packets.GetTransmissionInfo(packet_number).sent_time -
+      max_rtt;
+  while ((max_rtt >> reordering_shift_) <= extra_time_needed &&
+         reordering_shift_ > 0) {
+    --reordering_shift_;
+    QUIC_DVLOG(1) << "Loss delay increased to max_rtt + max_rtt >> "
+                  << reordering_shift_;
+  }
+}
+
 void GeneralLossAlgorithm::SetPacketNumberSpace(
     PacketNumberSpace packet_number_space) {
   if (packet_number_space_ < NUM_PACKET_NUMBER_SPACES) {
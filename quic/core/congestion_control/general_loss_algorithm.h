@@ -19,10 +19,16 @@ namespace quic {
 // Class which can be configured to implement's TCP's approach of detecting loss
 // when 3 nacks have been received for a packet or with a time threshold.
 // Also implements TCP's early retransmit(RFC5827).
+// In kAdaptiveReordering mode, a packet is lost once either its packet or its
+// time threshold is exceeded, as in RACK, and both thresholds grow whenever a
+// packet is acked after a later packet.
 class QUIC_EXPORT_PRIVATE GeneralLossAlgorithm : public LossDetectionInterface {
  public:
   // TCP retransmits after 3 nacks.
   static const QuicPacketCount kNumberOfNacksBeforeRetransmission = 3;
+  // Upper bound of the adaptive packet threshold, same as Linux's default
+  // tcp_max_reordering.
+  static const QuicPacketCount kMaxReorderingThreshold = 300;
 
   GeneralLossAlgorithm();
   explicit GeneralLossAlgorithm(LossDetectionType loss_type);
@@ -47,7 +53,8 @@ class QUIC_EXPORT_PRIVATE GeneralLossAlgorithm : public LossDetectionInterface {
   // Returns a non-zero value when the early retransmit timer is active.
   QuicTime GetLossTimeout() const override;
 
-  // Increases the loss detection threshold for time loss detection.
+  // Increases the loss detection threshold for time loss detection, and the
+  // packet threshold in kAdaptiveReordering mode.
   void SpuriousRetransmitDetected(
       const QuicUnackedPacketMap& unacked_packets,
       QuicTime time,
@@ -58,7 +65,26 @@ class QUIC_EXPORT_PRIVATE GeneralLossAlgorithm : public LossDetectionInterface {
 
   int reordering_shift() const { return reordering_shift_; }
 
+  QuicPacketCount reordering_threshold() const { return reordering_threshold_; }
+
  private:
+  // In kAdaptiveReordering mode, widens the thresholds for every packet in
+  // |packets_acked| that was acked after a larger packet of the same packet
+  // number space.
+  void DetectReordering(const QuicUnackedPacketMap& unacked_packets,
+                        QuicTime time,
+                        const RttStats& rtt_stats,
+                        const AckedPacketVector& packets_acked);
+
+  // Widens the thresholds enough that |packet_number| would not have been
+  // declared lost, given that |largest_acked| was acked before it and it is
+  // acked or found spuriously retransmitted at |time|.
+  void AdaptToReordering(const QuicUnackedPacketMap& unacked_packets,
+                         QuicTime time,
+                         const RttStats& rtt_stats,
+                         QuicPacketNumber packet_number,
+                         QuicPacketNumber largest_acked);
+
   QuicTime loss_detection_timeout_;
   // Largest sent packet when a spurious retransmit is detected.
   // Prevents increasing the reordering threshold multiple times per epoch.
@@ -70,6 +96,9 @@ class QUIC_EXPORT_PRIVATE GeneralLossAlgorithm : public LossDetectionInterface {
   // loss.  Fraction calculated by shifting max(SRTT, latest_rtt) to the right
   // by reordering_shift.
   int reordering_shift_;
+  // Number of larger packets that must be acked before a packet is declared
+  // lost.  Only adapted in kAdaptiveReordering mode.
+  QuicPacketCount reordering_threshold_;
   // The largest newly acked from the previous call to DetectLosses.
   QuicPacketNumber largest_previously_acked_;
   // The least in flight packet. Loss detection should start from this. Please
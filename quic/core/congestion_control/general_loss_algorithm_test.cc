@@ -552,6 +552,96 @@ TEST_F(GeneralLossAlgorithmTest, IncreaseThresholdUponSpuriousLoss) {
   EXPECT_EQ(1, loss_algorithm_.reordering_shift());
 }
 
+TEST_F(GeneralLossAlgorithmTest, AdaptiveReorderingPacketThreshold) {
+  loss_algorithm_.SetLossDetectionType(kAdaptiveReordering);
+  EXPECT_EQ(3, loss_algorithm_.reordering_shift());
+  EXPECT_EQ(3u, loss_algorithm_.reordering_threshold());
+  const size_t kNumSentPackets = 10;
+  for (size_t i = 1; i <= kNumSentPackets; ++i) {
+    SendDataPacket(i);
+  }
+  AckedPacketVector packets_acked;
+  // Packets 1 and 2 exceed the default packet threshold.
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(5));
+  packets_acked.push_back(AckedPacket(
+      QuicPacketNumber(5), kMaxOutgoingPacketSize, QuicTime::Zero()));
+  VerifyLosses(5, packets_acked, {1, 2});
+  packets_acked.clear();
+  // The loss timer of packet 3 is batched.
+  EXPECT_EQ(1.125 * rtt_stats_.smoothed_rtt() +
+                QuicTime::Delta::FromMilliseconds(1),
+            loss_algorithm_.GetLossTimeout() - clock_.Now());
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(1));
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(2));
+
+  // Packet 1 is acked after packet 5, so the threshold grows to 5 packets.
+  packets_acked.push_back(AckedPacket(
+      QuicPacketNumber(1), kMaxOutgoingPacketSize, QuicTime::Zero()));
+  VerifyLosses(5, packets_acked, std::vector<uint64_t>{});
+  packets_acked.clear();
+  EXPECT_EQ(5u, loss_algorithm_.reordering_threshold());
+  // The ack was not late, so the time threshold does not change.
+  EXPECT_EQ(3, loss_algorithm_.reordering_shift());
+
+  // Acking packet 9 only declares the packets 5 or more below it lost.
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(9));
+  packets_acked.push_back(AckedPacket(
+      QuicPacketNumber(9), kMaxOutgoingPacketSize, QuicTime::Zero()));
+  VerifyLosses(9, packets_acked, {3, 4});
+  packets_acked.clear();
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(3));
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(4));
+
+  // The rest is lost together once the time threshold passes.
+  clock_.AdvanceTime(loss_algorithm_.GetLossTimeout() - clock_.Now());
+  VerifyLosses(9, packets_acked, {6, 7, 8});
+  EXPECT_EQ(QuicTime::Zero(), loss_algorithm_.GetLossTimeout());
+}
+
+TEST_F(GeneralLossAlgorithmTest, AdaptiveReorderingTimeThreshold) {
+  loss_algorithm_.SetLossDetectionType(kAdaptiveReordering);
+  SendDataPacket(1);
+  SendDataPacket(2);
+  AckedPacketVector packets_acked;
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(2));
+  packets_acked.push_back(AckedPacket(
+      QuicPacketNumber(2), kMaxOutgoingPacketSize, QuicTime::Zero()));
+  VerifyLosses(2, packets_acked, std::vector<uint64_t>{});
+  packets_acked.clear();
+
+  // Packet 1 is acked 1.2 RTTs after it was sent, 0.2 RTTs later than
+  // expected, so the time threshold grows from 1/8 to 1/4 RTT.
+  clock_.AdvanceTime(1.2 * rtt_stats_.smoothed_rtt());
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(1));
+  packets_acked.push_back(AckedPacket(
+      QuicPacketNumber(1), kMaxOutgoingPacketSize, QuicTime::Zero()));
+  VerifyLosses(2, packets_acked, std::vector<uint64_t>{});
+  EXPECT_EQ(2, loss_algorithm_.reordering_shift());
+  EXPECT_EQ(3u, loss_algorithm_.reordering_threshold());
+}
+
+TEST_F(GeneralLossAlgorithmTest, AdaptiveReorderingSpuriousRetransmit) {
+  loss_algorithm_.SetLossDetectionType(kAdaptiveReordering);
+  const size_t kNumSentPackets = 4;
+  for (size_t i = 1; i <= kNumSentPackets; ++i) {
+    SendDataPacket(i);
+  }
+  AckedPacketVector packets_acked;
+  unacked_packets_.RemoveFromInFlight(QuicPacketNumber(4));
+  packets_acked.push_back(AckedPacket(
+      QuicPacketNumber(4), kMaxOutgoingPacketSize, QuicTime::Zero()));
+  VerifyLosses(4, packets_acked, {1});
+
+  loss_algorithm_.SpuriousRetransmitDetected(unacked_packets_, clock_.Now(),
+                                             rtt_stats_, QuicPacketNumber(1));
+  EXPECT_EQ(4u, loss_algorithm_.reordering_threshold());
+
+  // Resetting the loss detection type forgets the learned thresholds.
+  loss_algorithm_.SetLossDetectionType(kAdaptiveReordering);
+  EXPECT_EQ(3u, loss_algorithm_.reordering_threshold());
+  EXPECT_EQ(3, loss_algorithm_.reordering_shift());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -110,6 +110,8 @@ const char* CongestionControlTypeToString(CongestionControlType cc_type) {
       return "RENO_BYTES";
     case kBBR:
       return "BBR";
+    case kBBRv2:
+      return "BBRv2";
     case kPCC:
       return "PCC";
     default:
@@ -142,7 +144,7 @@ std::string TestParamToString(
 std::vector<TestParams> GetTestParams() {
   std::vector<TestParams> params;
   for (const CongestionControlType congestion_control_type :
-       {kBBR, kCubicBytes, kRenoBytes, kPCC}) {
+       {kBBR, kBBRv2, kCubicBytes, kRenoBytes, kPCC}) {
     params.push_back(TestParams(congestion_control_type));
   }
   return params;
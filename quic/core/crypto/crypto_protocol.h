@@ -78,7 +78,21 @@ const QuicTag kIFWA = TAG('I', 'F', 'W', 'a');   // Set initial size
                                                  // of stream flow control
                                                  // receive window to
                                                  // 1MB. (2^0xa KB).
+const QuicTag kSBMB = TAG('S', 'B', 'M', 'B');   // Pool the stream send
+                                                 // buffers of the session
+                                                 // and limit them to 1MB.
+const QuicTag kDNUF = TAG('D', 'N', 'U', 'F');   // Defer BLOCKED and
+                                                 // STREAMS_BLOCKED frames
+                                                 // until other data is
+                                                 // sent.
+const QuicTag kBDPW = TAG('B', 'D', 'P', 'W');   // Size receive windows
+                                                 // from the bandwidth-
+                                                 // delay product.
+const QuicTag kCZMB = TAG('C', 'Z', 'M', 'B');   // Compact zombie streams
+                                                 // and closed stream
+                                                 // containers.
 const QuicTag kTBBR = TAG('T', 'B', 'B', 'R');   // Reduced Buffer Bloat TCP
+const QuicTag kB2ON = TAG('B', '2', 'O', 'N');   // Enable BBRv2
 const QuicTag k1RTT = TAG('1', 'R', 'T', 'T');   // STARTUP in BBR for 1 RTT
 const QuicTag k2RTT = TAG('2', 'R', 'T', 'T');   // STARTUP in BBR for 2 RTTs
 const QuicTag kLRTT = TAG('L', 'R', 'T', 'T');   // Exit STARTUP in BBR on loss
@@ -131,6 +145,9 @@ const QuicTag k1RTO = TAG('1', 'R', 'T', 'O');   // Send 1 packet upon RTO
 const QuicTag kNRTO = TAG('N', 'R', 'T', 'O');   // CWND reduction on loss
 const QuicTag kTIME = TAG('T', 'I', 'M', 'E');   // Time based loss detection
 const QuicTag kATIM = TAG('A', 'T', 'I', 'M');   // Adaptive time loss detection
+const QuicTag kRACK = TAG('R', 'A', 'C', 'K');   // Loss detection with packet
+                                                 // and time thresholds adapted
+                                                 // to observed reordering.
 const QuicTag kMIN1 = TAG('M', 'I', 'N', '1');   // Min CWND of 1 packet
 const QuicTag kMIN4 = TAG('M', 'I', 'N', '4');   // Min CWND of 4 packets,
                                                  // with a min rate of 1 BDP.
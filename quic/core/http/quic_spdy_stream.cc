@@ -13,6 +13,7 @@
 #include "net/third_party/quiche/src/quic/core/http/spdy_utils.h"
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_decoder.h"
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_encoder.h"
+#include "net/third_party/quiche/src/quic/core/quic_stream_sequencer_buffer.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/core/quic_versions.h"
 #include "net/third_party/quiche/src/quic/core/quic_write_blocked_list.h"
@@ -32,6 +33,13 @@ using spdy::SpdyPriority;
 
 namespace quic {
 
+namespace {
+
+// Maximum number of readable regions ReadBodyIntoMemSlices() copies at once.
+const size_t kMaxBodyRegionsPerRead = 16;
+
+}  // namespace
+
 // Visitor of HttpDecoder that passes data frame to QuicSpdyStream and closes
 // the connection on unexpected frames.
 class QuicSpdyStream::HttpDecoderVisitor : public HttpDecoder::Visitor {
@@ -413,6 +421,33 @@ void QuicSpdyStream::MarkConsumed(size_t num_bytes) {
   }
 }
 
+QuicByteCount QuicSpdyStream::ReadBodyIntoMemSlices(
+    QuicBufferAllocator* allocator,
+    QuicByteCount max_bytes,
+    QuicMemSliceStorage* storage) {
+  DCHECK(FinishedReadingHeaders());
+  iovec iov[kMaxBodyRegionsPerRead];
+  const int num_regions = GetReadableRegions(iov, QUIC_ARRAYSIZE(iov));
+  QuicByteCount bytes_read = 0;
+  int num_used = 0;
+  while (num_used < num_regions && bytes_read < max_bytes) {
+    iov[num_used].iov_len =
+        std::min<QuicByteCount>(iov[num_used].iov_len, max_bytes - bytes_read);
+    bytes_read += iov[num_used].iov_len;
+    ++num_used;
+  }
+  if (bytes_read == 0) {
+    *storage = QuicMemSliceStorage(nullptr, 0, nullptr, 0);
+    return 0;
+  }
+  // A readable region never spans more than one sequencer buffer block, so
+  // each region is copied into a single slice.
+  *storage = QuicMemSliceStorage(iov, num_used, allocator,
+                                 QuicStreamSequencerBuffer::kBlockSizeBytes);
+  MarkConsumed(bytes_read);
+  return bytes_read;
+}
+
 bool QuicSpdyStream::IsDoneReading() const {
   bool done_reading_headers = FinishedReadingHeaders();
   bool done_reading_body = sequencer()->IsClosed();
@@ -690,6 +725,18 @@ void QuicSpdyStream::OnClose() {
   }
 }
 
+void QuicSpdyStream::ReleaseStateWhileWaitingForAcks() {
+  QuicStream::ReleaseStateWhileWaitingForAcks();
+  // |ack_listener_| and |unacked_frame_headers_offsets_| are kept, as they are
+  // needed when the remaining data gets acked.
+  header_list_.Clear();
+  // clear() would keep the storage of the block.
+  received_trailers_ = SpdyHeaderBlock();
+  if (!blocked_on_decoding_headers_) {
+    qpack_decoded_headers_accumulator_.reset();
+  }
+}
+
 void QuicSpdyStream::OnCanWrite() {
   QuicStream::OnCanWrite();
 
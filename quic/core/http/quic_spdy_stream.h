@@ -25,6 +25,7 @@
 #include "net/third_party/quiche/src/quic/core/quic_stream_sequencer.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice_storage.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_socket_address.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_framer.h"
 
@@ -72,6 +73,7 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream
 
   // QuicStream implementation
   void OnClose() override;
+  void ReleaseStateWhileWaitingForAcks() override;
 
   // Override to maybe close the write side after writing.
   void OnCanWrite() override;
@@ -165,6 +167,15 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream
   virtual int GetReadableRegions(iovec* iov, size_t iov_len) const;
   void MarkConsumed(size_t num_bytes);
 
+  // Copies up to |max_bytes| of readable body data into reference counted
+  // QuicMemSlices allocated by |allocator|, stores them in |storage| and marks
+  // the data consumed.  Returns the number of bytes read.  The slices outlive
+  // the stream, and can be handed to WriteMemSlices() of another stream, which
+  // takes them over without copying: a proxy copies each body byte once.
+  QuicByteCount ReadBodyIntoMemSlices(QuicBufferAllocator* allocator,
+                                      QuicByteCount max_bytes,
+                                      QuicMemSliceStorage* storage);
+
   // Returns true if header contains a valid 3-digit status and parse the status
   // code to |status_code|.
   static bool ParseHeaderStatusCode(const spdy::SpdyHeaderBlock& header,
@@ -11,6 +11,7 @@
 #include "net/third_party/quiche/src/quic/core/http/http_encoder.h"
 #include "net/third_party/quiche/src/quic/core/http/spdy_utils.h"
 #include "net/third_party/quiche/src/quic/core/quic_connection.h"
+#include "net/third_party/quiche/src/quic/core/quic_simple_buffer_allocator.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream_sequencer_buffer.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/core/quic_versions.h"
@@ -492,6 +493,39 @@ TEST_P(QuicSpdyStreamTest, ProcessHeadersAndBodyReadv) {
   EXPECT_EQ(body, std::string(buffer, bytes_read));
 }
 
+TEST_P(QuicSpdyStreamTest, ProcessHeadersAndBodyIntoMemSlices) {
+  Initialize(!kShouldProcessData);
+
+  std::string body = "this is the body";
+  std::string data = HasFrameHeader() ? DataFrame(body) : body;
+
+  ProcessHeaders(false, headers_);
+  QuicStreamFrame frame(GetNthClientInitiatedBidirectionalId(0), false, 0,
+                        QuicStringPiece(data));
+  stream_->OnStreamFrame(frame);
+  stream_->ConsumeHeaderList();
+
+  SimpleBufferAllocator allocator;
+  QuicMemSliceStorage storage(nullptr, 0, nullptr, 0);
+  EXPECT_EQ(4u, stream_->ReadBodyIntoMemSlices(&allocator, 4, &storage));
+  EXPECT_EQ(4u, storage.ToSpan().total_length());
+  EXPECT_EQ("this", storage.ToSpan().GetData(0));
+
+  QuicMemSliceStorage storage2(nullptr, 0, nullptr, 0);
+  EXPECT_EQ(body.length() - 4,
+            stream_->ReadBodyIntoMemSlices(&allocator, 1024, &storage2));
+  EXPECT_EQ(" is the body", storage2.ToSpan().GetData(0));
+  EXPECT_FALSE(stream_->HasBytesToRead());
+  EXPECT_EQ(body.length(), stream_->total_body_bytes_read());
+
+  // The slices stay valid after the stream data is gone.
+  QuicStreamPeer::CloseReadSide(stream_);
+  EXPECT_EQ("this", storage.ToSpan().GetData(0));
+
+  EXPECT_EQ(0u, stream_->ReadBodyIntoMemSlices(&allocator, 1024, &storage));
+  EXPECT_TRUE(storage.ToSpan().empty());
+}
+
 TEST_P(QuicSpdyStreamTest, ProcessHeadersAndLargeBodySmallReadv) {
   Initialize(kShouldProcessData);
   std::string body(12 * 1024, 'a');
@@ -14,6 +14,7 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_map_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_header_validator.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
 
 using spdy::SpdyHeaderBlock;
@@ -57,16 +58,16 @@ bool SpdyUtils::ExtractContentLengthFromHeaders(int64_t* content_length,
 bool SpdyUtils::CopyAndValidateHeaders(const QuicHeaderList& header_list,
                                        int64_t* content_length,
                                        SpdyHeaderBlock* headers) {
+  spdy::SpdyHeaderValidator validator;
+  validator.StartHeaderBlock();
   for (const auto& p : header_list) {
     const std::string& name = p.first;
-    if (name.empty()) {
-      QUIC_DLOG(ERROR) << "Header name must not be empty.";
-      return false;
-    }
-
-    if (QuicTextUtils::ContainsUpperCase(name)) {
-      QUIC_DLOG(ERROR) << "Malformed header: Header name " << name
-                       << " contains upper-case characters.";
+    const spdy::SpdyHeaderValidator::Result result =
+        validator.ValidateHeader(name, p.second);
+    if (result != spdy::SpdyHeaderValidator::Result::kOk) {
+      QUIC_DLOG(ERROR) << "Malformed header: "
+                       << spdy::SpdyHeaderValidator::ResultToString(result)
+                       << ", header name: '" << name << "'";
       return false;
     }
 
@@ -87,6 +88,8 @@ bool SpdyUtils::CopyAndValidateTrailers(const QuicHeaderList& header_list,
                                         size_t* final_byte_offset,
                                         SpdyHeaderBlock* trailers) {
   bool found_final_byte_offset = false;
+  spdy::SpdyHeaderValidator validator;
+  validator.StartHeaderBlock();
   for (const auto& p : header_list) {
     const std::string& name = p.first;
 
@@ -106,9 +109,12 @@ bool SpdyUtils::CopyAndValidateTrailers(const QuicHeaderList& header_list,
       return false;
     }
 
-    if (QuicTextUtils::ContainsUpperCase(name)) {
-      QUIC_DLOG(ERROR) << "Malformed header: Header name " << name
-                       << " contains upper-case characters.";
+    const spdy::SpdyHeaderValidator::Result result =
+        validator.ValidateHeader(name, p.second);
+    if (result != spdy::SpdyHeaderValidator::Result::kOk) {
+      QUIC_DLOG(ERROR) << "Malformed trailer: "
+                       << spdy::SpdyHeaderValidator::ResultToString(result)
+                       << ", header name: '" << name << "'";
       return false;
     }
 
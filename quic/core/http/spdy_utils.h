@@ -27,6 +27,9 @@ class QUIC_EXPORT_PRIVATE SpdyUtils {
                                               spdy::SpdyHeaderBlock* headers);
 
   // Copies a list of headers to a SpdyHeaderBlock.
+  // Returns false if a header field is invalid according to
+  // spdy::SpdyHeaderValidator, or if the content-length header cannot be
+  // parsed.
   static bool CopyAndValidateHeaders(const QuicHeaderList& header_list,
                                      int64_t* content_length,
                                      spdy::SpdyHeaderBlock* headers);
@@ -39,8 +42,8 @@ class QUIC_EXPORT_PRIVATE SpdyUtils {
   // Returns true if parsing is successful.  Returns false if the presence of
   // kFinalOffsetHeaderKey does not match the value of
   // |expect_final_byte_offset|, the kFinalOffsetHeaderKey value cannot be
-  // parsed, any other pseudo-header is present, an empty header key is present,
-  // or a header key contains an uppercase character.
+  // parsed, any other pseudo-header is present, or a header field is invalid
+  // according to spdy::SpdyHeaderValidator.
   static bool CopyAndValidateTrailers(const QuicHeaderList& header_list,
                                       bool expect_final_byte_offset,
                                       size_t* final_byte_offset,
@@ -93,6 +93,32 @@ TEST_F(CopyAndValidateHeaders, UpperCaseName) {
       SpdyUtils::CopyAndValidateHeaders(*headers, &content_length, &block));
 }
 
+TEST_F(CopyAndValidateHeaders, InvalidNameCharacter) {
+  auto headers = FromList({{"foo", "foovalue"}, {"bar baz", "barvalue"}});
+  int64_t content_length = -1;
+  SpdyHeaderBlock block;
+  ASSERT_FALSE(
+      SpdyUtils::CopyAndValidateHeaders(*headers, &content_length, &block));
+}
+
+TEST_F(CopyAndValidateHeaders, InvalidValueCharacter) {
+  auto headers = FromList({{"foo", "foovalue"}, {"bar", "bar\r\nbaz: 1"}});
+  int64_t content_length = -1;
+  SpdyHeaderBlock block;
+  ASSERT_FALSE(
+      SpdyUtils::CopyAndValidateHeaders(*headers, &content_length, &block));
+}
+
+TEST_F(CopyAndValidateHeaders, PseudoHeaderAfterRegularHeader) {
+  auto headers = FromList({{":status", "200"},
+                           {"content-length", "11"},
+                           {":path", "/index.html"}});
+  int64_t content_length = -1;
+  SpdyHeaderBlock block;
+  ASSERT_FALSE(
+      SpdyUtils::CopyAndValidateHeaders(*headers, &content_length, &block));
+}
+
 TEST_F(CopyAndValidateHeaders, MultipleContentLengths) {
   auto headers = FromList({{"content-length", "9"},
                            {"foo", "foovalue"},
@@ -286,6 +312,15 @@ TEST_F(CopyAndValidateTrailers, PseudoHeaderInTrailers) {
       *trailers, kExpectFinalByteOffset, &final_byte_offset, &block));
 }
 
+TEST_F(CopyAndValidateTrailers, InvalidValueCharacter) {
+  auto trailers =
+      FromList({{"key", "value\n"}, {kFinalOffsetHeaderKey, "1234"}});
+  size_t final_byte_offset = 0;
+  SpdyHeaderBlock block;
+  EXPECT_FALSE(SpdyUtils::CopyAndValidateTrailers(
+      *trailers, kExpectFinalByteOffset, &final_byte_offset, &block));
+}
+
 TEST_F(CopyAndValidateTrailers, DuplicateTrailers) {
   // Duplicate trailers are allowed, and their values are concatenated into a
   // single string delimted with '\0'. Some of the duplicate headers
@@ -0,0 +1,410 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/qpack/offline/header_compression_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <utility>
+
+#include "net/third_party/quiche/src/http2/decoder/decode_buffer.h"
+#include "net/third_party/quiche/src/http2/hpack/decoder/hpack_decoder.h"
+#include "net/third_party/quiche/src/http2/hpack/decoder/hpack_decoder_listener.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_decoder.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_encoder.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_progressive_decoder.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_stream_sender_delegate.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_str_cat.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_constants.h"
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_encoder.h"
+
+namespace quic {
+
+namespace {
+
+int64_t NowInNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Accumulates time and allocations spent in the measured sections.
+class Meter {
+ public:
+  explicit Meter(const std::function<uint64_t()>& allocation_counter)
+      : allocation_counter_(allocation_counter),
+        nanoseconds_(0),
+        allocations_(0),
+        start_nanoseconds_(0),
+        start_allocations_(0) {}
+
+  void Start() {
+    start_allocations_ = allocation_counter_ ? allocation_counter_() : 0;
+    start_nanoseconds_ = NowInNanoseconds();
+  }
+
+  void Stop() {
+    nanoseconds_ += NowInNanoseconds() - start_nanoseconds_;
+    if (allocation_counter_) {
+      allocations_ += allocation_counter_() - start_allocations_;
+    }
+  }
+
+  int64_t nanoseconds() const { return nanoseconds_; }
+  uint64_t allocations() const { return allocations_; }
+
+ private:
+  const std::function<uint64_t()>& allocation_counter_;
+  int64_t nanoseconds_;
+  uint64_t allocations_;
+  int64_t start_nanoseconds_;
+  uint64_t start_allocations_;
+};
+
+// Collects data written on a QPACK encoder or decoder stream.
+class BufferingStreamSenderDelegate : public QpackStreamSenderDelegate {
+ public:
+  ~BufferingStreamSenderDelegate() override = default;
+
+  void WriteStreamData(QuicStringPiece data) override {
+    buffer_.append(data.data(), data.size());
+    total_bytes_ += data.size();
+  }
+
+  // Returns and clears data written since the last call.
+  std::string TakeData() {
+    std::string data;
+    data.swap(buffer_);
+    return data;
+  }
+
+  uint64_t total_bytes() const { return total_bytes_; }
+
+ private:
+  std::string buffer_;
+  uint64_t total_bytes_ = 0;
+};
+
+// Collects HPACK decoded header fields into a header list.
+class HpackHeaderCollector : public http2::HpackDecoderListener {
+ public:
+  ~HpackHeaderCollector() override = default;
+
+  void OnHeaderListStart() override {
+    header_list_.clear();
+    error_detected_ = false;
+  }
+  void OnHeader(http2::HpackEntryType /*entry_type*/,
+                http2::Http2StringPiece name,
+                http2::Http2StringPiece value) override {
+    header_list_.AppendValueOrAddHeader(name, value);
+  }
+  void OnHeaderListEnd() override {}
+  void OnHeaderErrorDetected(http2::Http2StringPiece error_message) override {
+    QUIC_LOG(ERROR) << "HPACK decoding error: " << error_message;
+    error_detected_ = true;
+  }
+
+  const spdy::SpdyHeaderBlock& header_list() const { return header_list_; }
+  bool error_detected() const { return error_detected_; }
+
+ private:
+  spdy::SpdyHeaderBlock header_list_;
+  bool error_detected_ = false;
+};
+
+// Collects QPACK decoded header fields into a header list, and reports
+// encoder and decoder stream errors.
+class QpackHeaderCollector
+    : public QpackProgressiveDecoder::HeadersHandlerInterface,
+      public QpackEncoder::DecoderStreamErrorDelegate,
+      public QpackDecoder::EncoderStreamErrorDelegate {
+ public:
+  ~QpackHeaderCollector() override = default;
+
+  void Reset() {
+    header_list_.clear();
+    decoding_completed_ = false;
+    error_detected_ = false;
+  }
+
+  // QpackProgressiveDecoder::HeadersHandlerInterface implementation.
+  void OnHeaderDecoded(QuicStringPiece name, QuicStringPiece value) override {
+    header_list_.AppendValueOrAddHeader(name, value);
+  }
+  void OnDecodingCompleted() override { decoding_completed_ = true; }
+  void OnDecodingErrorDetected(QuicStringPiece error_message) override {
+    QUIC_LOG(ERROR) << "QPACK decoding error: " << error_message;
+    error_detected_ = true;
+  }
+
+  // QpackEncoder::DecoderStreamErrorDelegate implementation.
+  void OnDecoderStreamError(QuicStringPiece error_message) override {
+    QUIC_LOG(ERROR) << "QPACK decoder stream error: " << error_message;
+    error_detected_ = true;
+  }
+
+  // QpackDecoder::EncoderStreamErrorDelegate implementation.
+  void OnEncoderStreamError(QuicStringPiece error_message) override {
+    QUIC_LOG(ERROR) << "QPACK encoder stream error: " << error_message;
+    error_detected_ = true;
+  }
+
+  const spdy::SpdyHeaderBlock& header_list() const { return header_list_; }
+  bool succeeded() const { return decoding_completed_ && !error_detected_; }
+
+ private:
+  spdy::SpdyHeaderBlock header_list_;
+  bool decoding_completed_ = false;
+  bool error_detected_ = false;
+};
+
+// Fills in the corpus statistics of |result|.
+void CountCorpus(const std::vector<spdy::SpdyHeaderBlock>& header_lists,
+                 HeaderCompressionBenchmarkResult* result) {
+  result->header_lists = header_lists.size();
+  for (const auto& header_list : header_lists) {
+    result->header_fields += header_list.size();
+    for (const auto& header : header_list) {
+      result->uncompressed_bytes += header.first.size() + header.second.size();
+    }
+  }
+}
+
+// Turns the totals accumulated over all iterations into per-iteration,
+// per-header and per-block averages.  |round_trip_errors| stays a total, so
+// that a single error is not rounded away.
+void Average(const HeaderCompressionBenchmarkOptions& options,
+             const Meter& encode_meter,
+             const Meter& decode_meter,
+             HeaderCompressionBenchmarkResult* result) {
+  const double iterations = options.iterations;
+  const double headers = iterations * result->header_fields;
+  const double blocks = iterations * result->header_lists;
+
+  result->compressed_bytes /= options.iterations;
+  result->encoder_stream_bytes /= options.iterations;
+  result->decoder_stream_bytes /= options.iterations;
+
+  if (headers > 0) {
+    result->encode_ns_per_header = encode_meter.nanoseconds() / headers;
+    result->decode_ns_per_header = decode_meter.nanoseconds() / headers;
+  }
+  if (blocks > 0) {
+    result->encode_allocations_per_block = encode_meter.allocations() / blocks;
+    result->decode_allocations_per_block = decode_meter.allocations() / blocks;
+  }
+}
+
+std::string CodecName(HeaderCompressionCodec codec) {
+  switch (codec) {
+    case HeaderCompressionCodec::kHpack:
+      return "hpack";
+    case HeaderCompressionCodec::kQpack:
+      return "qpack";
+  }
+  return "unknown";
+}
+
+}  // namespace
+
+bool ParseQifHeaderLists(QuicStringPiece data,
+                         std::vector<spdy::SpdyHeaderBlock>* header_lists) {
+  spdy::SpdyHeaderBlock header_list;
+  bool header_list_empty = true;
+  while (!data.empty()) {
+    QuicStringPiece::size_type endline = data.find('\n');
+    if (endline == QuicStringPiece::npos) {
+      endline = data.size();
+    }
+    QuicStringPiece line = data.substr(0, endline);
+    data = data.substr(std::min(endline + 1, data.size()));
+
+    if (!line.empty() && line[0] == '#') {
+      continue;
+    }
+
+    if (line.empty()) {
+      // Empty line indicates end of header list.
+      if (!header_list_empty) {
+        header_lists->push_back(std::move(header_list));
+        header_list = spdy::SpdyHeaderBlock();
+        header_list_empty = true;
+      }
+      continue;
+    }
+
+    auto pieces = QuicTextUtils::Split(line, '\t');
+    if (pieces.size() != 2) {
+      QUIC_LOG(ERROR) << "Header key and value must be separated by TAB.";
+      return false;
+    }
+
+    header_list.AppendValueOrAddHeader(pieces[0], pieces[1]);
+    header_list_empty = false;
+  }
+
+  // Tolerate a missing empty line after the last header list.
+  if (!header_list_empty) {
+    header_lists->push_back(std::move(header_list));
+  }
+
+  return true;
+}
+
+double HeaderCompressionBenchmarkResult::CompressionRatio() const {
+  const uint64_t total_compressed_bytes =
+      compressed_bytes + encoder_stream_bytes + decoder_stream_bytes;
+  if (total_compressed_bytes == 0) {
+    return 0;
+  }
+  return static_cast<double>(uncompressed_bytes) / total_compressed_bytes;
+}
+
+HeaderCompressionBenchmarkResult RunHpackBenchmark(
+    const std::vector<spdy::SpdyHeaderBlock>& header_lists,
+    const HeaderCompressionBenchmarkOptions& options) {
+  DCHECK_LT(0u, options.iterations);
+
+  HeaderCompressionBenchmarkResult result;
+  result.codec = HeaderCompressionCodec::kHpack;
+  CountCorpus(header_lists, &result);
+
+  Meter encode_meter(options.allocation_counter);
+  Meter decode_meter(options.allocation_counter);
+
+  for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    spdy::HpackEncoder encoder(spdy::ObtainHpackHuffmanTable());
+    encoder.ApplyHeaderTableSizeSetting(options.dynamic_table_capacity);
+    if (options.hpack_adaptive_indexing) {
+      encoder.EnableAdaptiveIndexing();
+    }
+
+    HpackHeaderCollector collector;
+    http2::HpackDecoder decoder(&collector,
+                                std::numeric_limits<uint32_t>::max());
+    decoder.ApplyHeaderTableSizeSetting(options.dynamic_table_capacity);
+
+    for (const auto& header_list : header_lists) {
+      std::string encoded_headers;
+
+      encode_meter.Start();
+      encoder.EncodeHeaderSet(header_list, &encoded_headers);
+      encode_meter.Stop();
+
+      result.compressed_bytes += encoded_headers.size();
+
+      decode_meter.Start();
+      http2::DecodeBuffer db(encoded_headers);
+      const bool success = decoder.StartDecodingBlock() &&
+                           decoder.DecodeFragment(&db) &&
+                           decoder.EndDecodingBlock();
+      decode_meter.Stop();
+
+      if (!success || collector.error_detected() ||
+          collector.header_list() != header_list) {
+        ++result.round_trip_errors;
+      }
+    }
+  }
+
+  Average(options, encode_meter, decode_meter, &result);
+  return result;
+}
+
+HeaderCompressionBenchmarkResult RunQpackBenchmark(
+    const std::vector<spdy::SpdyHeaderBlock>& header_lists,
+    const HeaderCompressionBenchmarkOptions& options) {
+  DCHECK_LT(0u, options.iterations);
+
+  HeaderCompressionBenchmarkResult result;
+  result.codec = HeaderCompressionCodec::kQpack;
+  CountCorpus(header_lists, &result);
+
+  Meter encode_meter(options.allocation_counter);
+  Meter decode_meter(options.allocation_counter);
+
+  for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+    QpackHeaderCollector collector;
+    BufferingStreamSenderDelegate encoder_stream;
+    BufferingStreamSenderDelegate decoder_stream;
+
+    QpackEncoder encoder(&collector, &encoder_stream);
+    QpackDecoder decoder(&collector, &decoder_stream);
+    if (options.dynamic_table_capacity > 0) {
+      encoder.SetMaximumDynamicTableCapacity(options.dynamic_table_capacity);
+      encoder.SetMaximumBlockedStreams(options.maximum_blocked_streams);
+      decoder.SetMaximumDynamicTableCapacity(options.dynamic_table_capacity);
+    }
+
+    QuicStreamId stream_id = 0;
+    for (const auto& header_list : header_lists) {
+      collector.Reset();
+
+      encode_meter.Start();
+      std::string encoded_headers =
+          encoder.EncodeHeaderList(stream_id, &header_list);
+      encode_meter.Stop();
+
+      result.compressed_bytes += encoded_headers.size();
+
+      decode_meter.Start();
+      decoder.DecodeEncoderStreamData(encoder_stream.TakeData());
+      auto progressive_decoder =
+          decoder.CreateProgressiveDecoder(stream_id, &collector);
+      progressive_decoder->Decode(encoded_headers);
+      progressive_decoder->EndHeaderBlock();
+      decode_meter.Stop();
+
+      // Processing acknowledgements is part of the encoder's work.
+      encode_meter.Start();
+      encoder.DecodeDecoderStreamData(decoder_stream.TakeData());
+      encode_meter.Stop();
+
+      if (!collector.succeeded() || collector.header_list() != header_list) {
+        ++result.round_trip_errors;
+      }
+
+      // Client-initiated bidirectional streams.
+      stream_id += 4;
+    }
+
+    result.encoder_stream_bytes += encoder_stream.total_bytes();
+    result.decoder_stream_bytes += decoder_stream.total_bytes();
+  }
+
+  Average(options, encode_meter, decode_meter, &result);
+  return result;
+}
+
+std::string HeaderCompressionResultsToCsv(
+    const std::vector<std::string>& corpus_names,
+    const std::vector<HeaderCompressionBenchmarkResult>& results) {
+  DCHECK_EQ(corpus_names.size(), results.size());
+
+  std::string csv =
+      "corpus,codec,header_lists,header_fields,uncompressed_bytes,"
+      "compressed_bytes,encoder_stream_bytes,decoder_stream_bytes,"
+      "compression_ratio,encode_ns_per_header,decode_ns_per_header,"
+      "encode_allocations_per_block,decode_allocations_per_block,"
+      "round_trip_errors\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const HeaderCompressionBenchmarkResult& result = results[i];
+    csv = QuicStrCat(
+        csv, corpus_names[i], ",", CodecName(result.codec), ",",
+        result.header_lists, ",", result.header_fields, ",",
+        result.uncompressed_bytes, ",", result.compressed_bytes, ",",
+        result.encoder_stream_bytes, ",", result.decoder_stream_bytes, ",",
+        result.CompressionRatio(), ",", result.encode_ns_per_header, ",",
+        result.decode_ns_per_header, ",", result.encode_allocations_per_block,
+        ",", result.decode_allocations_per_block, ",",
+        result.round_trip_errors, "\n");
+  }
+  return csv;
+}
+
+}  // namespace quic
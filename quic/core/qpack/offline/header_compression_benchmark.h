@@ -0,0 +1,90 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QPACK_OFFLINE_HEADER_COMPRESSION_BENCHMARK_H_
+#define QUICHE_QUIC_CORE_QPACK_OFFLINE_HEADER_COMPRESSION_BENCHMARK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_header_block.h"
+
+namespace quic {
+
+// Parses |data| in the QIF format of the QPACK Offline Interop: one header
+// field per line, name and value separated by a TAB, each header list
+// followed by an empty line.  Lines starting with '#' are ignored.  Returns
+// false if |data| is malformed.
+bool ParseQifHeaderLists(QuicStringPiece data,
+                         std::vector<spdy::SpdyHeaderBlock>* header_lists);
+
+enum class HeaderCompressionCodec { kHpack, kQpack };
+
+struct HeaderCompressionBenchmarkOptions {
+  // SETTINGS_HEADER_TABLE_SIZE for HPACK, maximum dynamic table capacity for
+  // QPACK.
+  uint64_t dynamic_table_capacity = 4096;
+  // Maximum number of blocked streams, QPACK only.
+  uint64_t maximum_blocked_streams = 100;
+  // Whether the HPACK encoder uses HpackAdaptiveIndexingPolicy.
+  bool hpack_adaptive_indexing = false;
+  // Number of times the corpus is replayed, each time on a fresh connection.
+  size_t iterations = 1;
+  // If set, returns the number of heap allocations made by the process so
+  // far.  Allocations are not reported otherwise.
+  std::function<uint64_t()> allocation_counter;
+};
+
+// Results of replaying a corpus, averaged over all iterations.
+struct HeaderCompressionBenchmarkResult {
+  HeaderCompressionCodec codec = HeaderCompressionCodec::kHpack;
+  // Number of header lists and header fields in the corpus.
+  size_t header_lists = 0;
+  size_t header_fields = 0;
+  // Sum of the length of all header names and values in the corpus.
+  uint64_t uncompressed_bytes = 0;
+  // Size of the encoded header blocks.
+  uint64_t compressed_bytes = 0;
+  // Data sent on the QPACK encoder and decoder streams.
+  uint64_t encoder_stream_bytes = 0;
+  uint64_t decoder_stream_bytes = 0;
+  double encode_ns_per_header = 0;
+  double decode_ns_per_header = 0;
+  double encode_allocations_per_block = 0;
+  double decode_allocations_per_block = 0;
+  // Number of header lists that failed to decode, or decoded to something
+  // different from the corpus, over all iterations.
+  size_t round_trip_errors = 0;
+
+  // Ratio of |uncompressed_bytes| to all compressed bytes, including the
+  // QPACK encoder and decoder streams.
+  double CompressionRatio() const;
+};
+
+// Replays |header_lists| through spdy::HpackEncoder and http2::HpackDecoder.
+HeaderCompressionBenchmarkResult RunHpackBenchmark(
+    const std::vector<spdy::SpdyHeaderBlock>& header_lists,
+    const HeaderCompressionBenchmarkOptions& options);
+
+// Replays |header_lists| through QpackEncoder and QpackDecoder, each header
+// list on a different request stream.  Encoder stream data is delivered to the
+// decoder before the header block, and decoder stream data is delivered back
+// to the encoder right after, therefore no stream is ever blocked.
+HeaderCompressionBenchmarkResult RunQpackBenchmark(
+    const std::vector<spdy::SpdyHeaderBlock>& header_lists,
+    const HeaderCompressionBenchmarkOptions& options);
+
+// Formats |results| as CSV, one row per result, preceded by a header row.
+// |corpus_names| holds the corpus name of each result.
+std::string HeaderCompressionResultsToCsv(
+    const std::vector<std::string>& corpus_names,
+    const std::vector<HeaderCompressionBenchmarkResult>& results);
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QPACK_OFFLINE_HEADER_COMPRESSION_BENCHMARK_H_
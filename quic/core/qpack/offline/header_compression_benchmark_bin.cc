@@ -0,0 +1,153 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays header lists from QIF files through HPACK and QPACK and prints
+// compressed sizes, encoding and decoding time per header field, and heap
+// allocations per header block.
+//
+// Usage: header_compression_benchmark [--codecs=hpack,qpack]
+//            [--dynamic_table_capacity=4096] [--max_blocked_streams=100]
+//            [--hpack_adaptive_indexing] [--iterations=N] qif_file ...
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/qpack/offline/header_compression_benchmark.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_file_utils.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(std::string,
+                              codecs,
+                              "hpack,qpack",
+                              "Comma-separated codecs to benchmark.  One of: "
+                              "hpack, qpack.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              dynamic_table_capacity,
+                              4096,
+                              "HPACK header table size and QPACK maximum "
+                              "dynamic table capacity, in bytes.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              max_blocked_streams,
+                              100,
+                              "Maximum number of QPACK blocked streams.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(bool,
+                              hpack_adaptive_indexing,
+                              false,
+                              "If true, the HPACK encoder only indexes header "
+                              "fields likely to be reused.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              iterations,
+                              10,
+                              "Number of times each corpus is replayed.");
+
+namespace {
+
+// Counts every heap allocation made by the process.
+std::atomic<uint64_t> g_allocation_count(0);
+
+}  // namespace
+
+void* operator new(size_t size) {
+  ++g_allocation_count;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept {
+  std::free(p);
+}
+
+namespace quic {
+namespace {
+
+int RunBenchmark(const std::vector<std::string>& filenames) {
+  bool run_hpack = false;
+  bool run_qpack = false;
+  for (QuicStringPiece codec :
+       QuicTextUtils::Split(GetQuicFlag(FLAGS_codecs), ',')) {
+    QuicTextUtils::RemoveLeadingAndTrailingWhitespace(&codec);
+    if (codec == "hpack") {
+      run_hpack = true;
+    } else if (codec == "qpack") {
+      run_qpack = true;
+    } else {
+      std::cerr << "Unknown codec \"" << codec << "\" in --codecs\n";
+      return 1;
+    }
+  }
+
+  const int32_t dynamic_table_capacity =
+      GetQuicFlag(FLAGS_dynamic_table_capacity);
+  const int32_t max_blocked_streams = GetQuicFlag(FLAGS_max_blocked_streams);
+  const int32_t iterations = GetQuicFlag(FLAGS_iterations);
+  if (dynamic_table_capacity < 0 || max_blocked_streams < 0 ||
+      iterations <= 0) {
+    std::cerr << "Invalid --dynamic_table_capacity, --max_blocked_streams or "
+                 "--iterations\n";
+    return 1;
+  }
+
+  HeaderCompressionBenchmarkOptions options;
+  options.dynamic_table_capacity = dynamic_table_capacity;
+  options.maximum_blocked_streams = max_blocked_streams;
+  options.iterations = iterations;
+  options.hpack_adaptive_indexing = GetQuicFlag(FLAGS_hpack_adaptive_indexing);
+  options.allocation_counter = []() -> uint64_t { return g_allocation_count; };
+
+  std::vector<std::string> corpus_names;
+  std::vector<HeaderCompressionBenchmarkResult> results;
+  for (const std::string& filename : filenames) {
+    std::string data;
+    ReadFileContents(filename, &data);
+    std::vector<spdy::SpdyHeaderBlock> header_lists;
+    if (data.empty() || !ParseQifHeaderLists(data, &header_lists)) {
+      std::cerr << "Failed to read header lists from " << filename << "\n";
+      return 1;
+    }
+
+    if (run_hpack) {
+      corpus_names.push_back(filename);
+      results.push_back(RunHpackBenchmark(header_lists, options));
+    }
+    if (run_qpack) {
+      corpus_names.push_back(filename);
+      results.push_back(RunQpackBenchmark(header_lists, options));
+    }
+  }
+
+  std::cout << HeaderCompressionResultsToCsv(corpus_names, results);
+  return 0;
+}
+
+}  // namespace
+}  // namespace quic
+
+int main(int argc, char* argv[]) {
+  const char* usage = "Usage: header_compression_benchmark [options] qif_file";
+  std::vector<std::string> args =
+      quic::QuicParseCommandLineFlags(usage, argc, argv);
+  if (args.empty()) {
+    quic::QuicPrintCommandLineFlagHelp(usage);
+    return 1;
+  }
+
+  return quic::RunBenchmark(args);
+}
@@ -0,0 +1,130 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/qpack/offline/header_compression_benchmark.h"
+
+#include <string>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+const char kCorpus[] =
+    "# Two requests to the same origin.\n"
+    ":method\tGET\n"
+    ":path\t/index.html\n"
+    ":authority\twww.example.org\n"
+    "user-agent\tbenchmark/1.0\n"
+    "cookie\tfoo=bar; baz=qux\n"
+    "\n"
+    ":method\tGET\n"
+    ":path\t/style.css\n"
+    ":authority\twww.example.org\n"
+    "user-agent\tbenchmark/1.0\n"
+    "cookie\tfoo=bar; baz=qux\n"
+    "\n";
+
+class HeaderCompressionBenchmarkTest : public QuicTest {
+ protected:
+  HeaderCompressionBenchmarkTest() {
+    EXPECT_TRUE(ParseQifHeaderLists(kCorpus, &header_lists_));
+  }
+
+  std::vector<spdy::SpdyHeaderBlock> header_lists_;
+};
+
+TEST_F(HeaderCompressionBenchmarkTest, ParseQif) {
+  ASSERT_EQ(2u, header_lists_.size());
+  EXPECT_EQ("/style.css", header_lists_[1][":path"]);
+  EXPECT_EQ("foo=bar; baz=qux", header_lists_[1]["cookie"]);
+
+  // The empty line after the last header list is optional.
+  std::vector<spdy::SpdyHeaderBlock> header_lists;
+  EXPECT_TRUE(ParseQifHeaderLists("foo\tbar\n\nfoo\tbaz", &header_lists));
+  ASSERT_EQ(2u, header_lists.size());
+  EXPECT_EQ("baz", header_lists[1]["foo"]);
+
+  EXPECT_FALSE(ParseQifHeaderLists("foo bar\n\n", &header_lists));
+}
+
+TEST_F(HeaderCompressionBenchmarkTest, Hpack) {
+  HeaderCompressionBenchmarkOptions options;
+  options.iterations = 2;
+  HeaderCompressionBenchmarkResult result =
+      RunHpackBenchmark(header_lists_, options);
+
+  EXPECT_EQ(HeaderCompressionCodec::kHpack, result.codec);
+  EXPECT_EQ(2u, result.header_lists);
+  EXPECT_EQ(10u, result.header_fields);
+  EXPECT_EQ(0u, result.round_trip_errors);
+  EXPECT_LT(0u, result.compressed_bytes);
+  EXPECT_LT(result.compressed_bytes, result.uncompressed_bytes);
+  EXPECT_EQ(0u, result.encoder_stream_bytes);
+  // Allocations are not counted without a counter.
+  EXPECT_EQ(0, result.encode_allocations_per_block);
+}
+
+TEST_F(HeaderCompressionBenchmarkTest, HpackAdaptiveIndexing) {
+  HeaderCompressionBenchmarkOptions options;
+  options.hpack_adaptive_indexing = true;
+  HeaderCompressionBenchmarkResult result =
+      RunHpackBenchmark(header_lists_, options);
+
+  EXPECT_EQ(0u, result.round_trip_errors);
+  EXPECT_LT(result.compressed_bytes, result.uncompressed_bytes);
+}
+
+TEST_F(HeaderCompressionBenchmarkTest, Qpack) {
+  HeaderCompressionBenchmarkOptions options;
+  // Every measured section appears to allocate once.
+  uint64_t allocation_count = 0;
+  options.allocation_counter = [&allocation_count]() {
+    return allocation_count++;
+  };
+  HeaderCompressionBenchmarkResult result =
+      RunQpackBenchmark(header_lists_, options);
+
+  EXPECT_EQ(HeaderCompressionCodec::kQpack, result.codec);
+  EXPECT_EQ(0u, result.round_trip_errors);
+  // Entries are inserted into the dynamic table, and header blocks are
+  // acknowledged.
+  EXPECT_LT(0u, result.encoder_stream_bytes);
+  EXPECT_LT(0u, result.decoder_stream_bytes);
+  EXPECT_LT(0, result.encode_allocations_per_block);
+  EXPECT_LT(0, result.CompressionRatio());
+}
+
+TEST_F(HeaderCompressionBenchmarkTest, QpackStaticTableOnly) {
+  HeaderCompressionBenchmarkOptions options;
+  options.dynamic_table_capacity = 0;
+  HeaderCompressionBenchmarkResult result =
+      RunQpackBenchmark(header_lists_, options);
+
+  EXPECT_EQ(0u, result.round_trip_errors);
+  EXPECT_EQ(0u, result.encoder_stream_bytes);
+}
+
+TEST_F(HeaderCompressionBenchmarkTest, Csv) {
+  HeaderCompressionBenchmarkOptions options;
+  std::vector<HeaderCompressionBenchmarkResult> results = {
+      RunHpackBenchmark(header_lists_, options),
+      RunQpackBenchmark(header_lists_, options)};
+  std::string csv =
+      HeaderCompressionResultsToCsv({"corpus.qif", "corpus.qif"}, results);
+
+  // Header plus one row per result.
+  std::vector<QuicStringPiece> lines = QuicTextUtils::Split(csv, '\n');
+  ASSERT_GE(lines.size(), 3u);
+  EXPECT_TRUE(QuicTextUtils::StartsWith(lines[0], "corpus,codec,"));
+  EXPECT_TRUE(QuicTextUtils::StartsWith(lines[1], "corpus.qif,hpack,2,10,"));
+  EXPECT_TRUE(QuicTextUtils::StartsWith(lines[2], "corpus.qif,qpack,2,10,"));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
@@ -4,22 +4,36 @@
 
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_encoder.h"
 
+#include <algorithm>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_constants.h"
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_instruction_encoder.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_required_insert_count.h"
 #include "net/third_party/quiche/src/quic/core/qpack/value_splitting_header_list.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 
 namespace quic {
 
+namespace {
+
+// Fraction of the dynamic table capacity, taken up by the oldest entries, that
+// is kept draining: these entries are duplicated rather than referenced.
+const float kDrainingFraction = 0.25;
+
+}  // namespace
+
 QpackEncoder::QpackEncoder(
     DecoderStreamErrorDelegate* decoder_stream_error_delegate,
     QpackStreamSenderDelegate* encoder_stream_sender_delegate)
     : decoder_stream_error_delegate_(decoder_stream_error_delegate),
       decoder_stream_receiver_(this),
-      encoder_stream_sender_(encoder_stream_sender_delegate) {
+      encoder_stream_sender_(encoder_stream_sender_delegate),
+      maximum_blocked_streams_(0),
+      known_received_count_(0) {
   DCHECK(decoder_stream_error_delegate_);
   DCHECK(encoder_stream_sender_delegate);
 }
@@ -27,55 +41,175 @@ QpackEncoder::QpackEncoder(
 QpackEncoder::~QpackEncoder() {}
 
 std::string QpackEncoder::EncodeHeaderList(
-    QuicStreamId /* stream_id */,
+    QuicStreamId stream_id,
     const spdy::SpdyHeaderBlock* header_list) {
-  QpackInstructionEncoder instruction_encoder;
-  std::string encoded_headers;
+  // The dynamic table is not used if the decoder has not allowed it.
+  const bool dynamic_table_enabled = header_table_.max_entries() > 0;
 
-  // TODO(bnc): Implement dynamic entries and set Required Insert Count and
-  // Delta Base accordingly.
-  instruction_encoder.set_varint(0);
-  instruction_encoder.set_varint2(0);
-  instruction_encoder.set_s_bit(false);
+  // Entries acknowledged by the decoder can be referenced without blocking.
+  // Other entries, including the ones inserted while encoding this header
+  // list, can only be referenced if blocking this stream is allowed.
+  const bool blocking_allowed =
+      dynamic_table_enabled &&
+      (IsStreamBlocked(stream_id) ||
+       blocked_stream_count() < maximum_blocked_streams_);
 
-  instruction_encoder.Encode(QpackPrefixInstruction(), &encoded_headers);
+  // Entries before |draining_index| are duplicated rather than referenced
+  // whenever possible, so that they can be evicted to make room for new ones.
+  const uint64_t draining_index =
+      header_table_.draining_index(kDrainingFraction);
+
+  // Entries at or after |smallest_blocking_index| must not be evicted, because
+  // they are referenced by unacknowledged header blocks, or by this one.
+  uint64_t smallest_blocking_index = SmallestBlockingIndex();
 
+  // Smallest absolute index and Required Insert Count of dynamic table entries
+  // referenced by this header block.
+  uint64_t min_referenced_index = std::numeric_limits<uint64_t>::max();
+  uint64_t required_insert_count = 0;
+
+  // First pass: insert entries into the dynamic table if needed, and choose a
+  // representation for each header field.
+  std::vector<Representation> representations;
   for (const auto& header : ValueSplittingHeaderList(header_list)) {
     QuicStringPiece name = header.first;
     QuicStringPiece value = header.second;
 
-    bool is_static;
-    uint64_t index;
+    bool is_static = false;
+    uint64_t index = 0;
 
     auto match_type =
         header_table_.FindHeaderField(name, value, &is_static, &index);
 
+    // Entries that have not been acknowledged can only be referenced if this
+    // stream is allowed to become blocked.
+    if (match_type != QpackHeaderTable::MatchType::kNoMatch && !is_static &&
+        index >= known_received_count_ && !blocking_allowed) {
+      match_type = QpackHeaderTable::MatchType::kNoMatch;
+    }
+
+    // A new entry can be inserted if it is referenced without exceeding the
+    // blocked stream limit, and if that does not evict any entry that is
+    // referenced by an unacknowledged header block.
+    const bool can_insert =
+        blocking_allowed &&
+        QpackEntry::Size(name, value) <=
+            header_table_.MaxInsertSizeWithoutEvictingGivenEntry(
+                smallest_blocking_index);
+
+    Representation representation;
+    representation.name = name;
+    representation.value = value;
+    representation.is_static = is_static;
+    representation.index = index;
+
     switch (match_type) {
       case QpackHeaderTable::MatchType::kNameAndValue:
-        DCHECK(is_static) << "Dynamic table entries not supported yet.";
+        representation.type = Representation::Type::kIndexed;
+        if (is_static) {
+          break;
+        }
+
+        // Duplicate draining entries, so that the old copy can be evicted.
+        if (index < draining_index && can_insert) {
+          encoder_stream_sender_.SendDuplicate(
+              header_table_.inserted_entry_count() - index - 1);
+          const QpackEntry* entry = header_table_.InsertEntry(name, value);
+          DCHECK(entry);
+          representation.index = entry->InsertionIndex();
+        }
+
+        break;
+      case QpackHeaderTable::MatchType::kName:
+        if (can_insert) {
+          encoder_stream_sender_.SendInsertWithNameReference(
+              is_static,
+              is_static ? index
+                        : header_table_.inserted_entry_count() - index - 1,
+              value);
+          const QpackEntry* entry = header_table_.InsertEntry(name, value);
+          DCHECK(entry);
+          representation.type = Representation::Type::kIndexed;
+          representation.is_static = false;
+          representation.index = entry->InsertionIndex();
+          break;
+        }
+
+        representation.type = Representation::Type::kNameReference;
+        if (!is_static && index < draining_index) {
+          representation.type = Representation::Type::kLiteral;
+        }
+
+        break;
+      case QpackHeaderTable::MatchType::kNoMatch:
+        if (can_insert) {
+          encoder_stream_sender_.SendInsertWithoutNameReference(name, value);
+          const QpackEntry* entry = header_table_.InsertEntry(name, value);
+          DCHECK(entry);
+          representation.type = Representation::Type::kIndexed;
+          representation.is_static = false;
+          representation.index = entry->InsertionIndex();
+          break;
+        }
+
+        representation.type = Representation::Type::kLiteral;
+
+        break;
+    }
+
+    if (representation.type != Representation::Type::kLiteral &&
+        !representation.is_static) {
+      min_referenced_index =
+          std::min(min_referenced_index, representation.index);
+      smallest_blocking_index =
+          std::min(smallest_blocking_index, representation.index);
+      required_insert_count =
+          std::max(required_insert_count, representation.index + 1);
+    }
+
+    representations.push_back(representation);
+  }
+
+  // Second pass: serialize the header block.  Base is set to Required Insert
+  // Count, so that every dynamic table reference uses relative indexing.
+  QpackInstructionEncoder instruction_encoder;
+  std::string encoded_headers;
+
+  instruction_encoder.set_varint(QpackEncodeRequiredInsertCount(
+      required_insert_count, header_table_.max_entries()));
+  instruction_encoder.set_varint2(0);
+  instruction_encoder.set_s_bit(false);
 
-        instruction_encoder.set_s_bit(is_static);
+  instruction_encoder.Encode(QpackPrefixInstruction(), &encoded_headers);
+
+  for (const auto& representation : representations) {
+    const uint64_t index =
+        representation.is_static
+            ? representation.index
+            : required_insert_count - representation.index - 1;
+
+    switch (representation.type) {
+      case Representation::Type::kIndexed:
+        instruction_encoder.set_s_bit(representation.is_static);
         instruction_encoder.set_varint(index);
 
         instruction_encoder.Encode(QpackIndexedHeaderFieldInstruction(),
                                    &encoded_headers);
 
         break;
-      case QpackHeaderTable::MatchType::kName:
-        DCHECK(is_static) << "Dynamic table entries not supported yet.";
-
-        instruction_encoder.set_s_bit(is_static);
+      case Representation::Type::kNameReference:
+        instruction_encoder.set_s_bit(representation.is_static);
         instruction_encoder.set_varint(index);
-        instruction_encoder.set_value(value);
+        instruction_encoder.set_value(representation.value);
 
         instruction_encoder.Encode(
             QpackLiteralHeaderFieldNameReferenceInstruction(),
             &encoded_headers);
 
         break;
-      case QpackHeaderTable::MatchType::kNoMatch:
-        instruction_encoder.set_name(name);
-        instruction_encoder.set_value(value);
+      case Representation::Type::kLiteral:
+        instruction_encoder.set_name(representation.name);
+        instruction_encoder.set_value(representation.value);
 
         instruction_encoder.Encode(QpackLiteralHeaderFieldInstruction(),
                                    &encoded_headers);
@@ -84,6 +218,13 @@ std::string QpackEncoder::EncodeHeaderList(
     }
   }
 
+  // The decoder acknowledges every header block, therefore all of them need
+  // to be tracked to match acknowledgements with Required Insert Counts.
+  if (dynamic_table_enabled) {
+    unacknowledged_header_blocks_[stream_id].push_back(
+        {required_insert_count, min_referenced_index});
+  }
+
   return encoded_headers;
 }
 
@@ -91,16 +232,92 @@ void QpackEncoder::DecodeDecoderStreamData(QuicStringPiece data) {
   decoder_stream_receiver_.Decode(data);
 }
 
-void QpackEncoder::OnInsertCountIncrement(uint64_t /*increment*/) {
-  // TODO(bnc): Implement dynamic table management for encoding.
+void QpackEncoder::SetMaximumDynamicTableCapacity(
+    uint64_t maximum_dynamic_table_capacity) {
+  header_table_.SetMaximumDynamicTableCapacity(maximum_dynamic_table_capacity);
+}
+
+void QpackEncoder::SetMaximumBlockedStreams(uint64_t maximum_blocked_streams) {
+  maximum_blocked_streams_ = maximum_blocked_streams;
+}
+
+uint64_t QpackEncoder::blocked_stream_count() const {
+  uint64_t blocked_stream_count = 0;
+  for (const auto& stream : unacknowledged_header_blocks_) {
+    if (IsStreamBlocked(stream.first)) {
+      ++blocked_stream_count;
+    }
+  }
+  return blocked_stream_count;
+}
+
+void QpackEncoder::OnInsertCountIncrement(uint64_t increment) {
+  if (increment == 0) {
+    OnErrorDetected("Invalid increment value 0.");
+    return;
+  }
+
+  if (increment >
+      header_table_.inserted_entry_count() - known_received_count_) {
+    OnErrorDetected("Increment value raises known received count too high.");
+    return;
+  }
+
+  known_received_count_ += increment;
+}
+
+void QpackEncoder::OnHeaderAcknowledgement(QuicStreamId stream_id) {
+  if (header_table_.max_entries() == 0) {
+    // Header blocks are not tracked if the dynamic table is not in use.
+    return;
+  }
+
+  auto it = unacknowledged_header_blocks_.find(stream_id);
+  if (it == unacknowledged_header_blocks_.end()) {
+    OnErrorDetected("Header Acknowledgement received for stream without "
+                    "outstanding header blocks.");
+    return;
+  }
+
+  DCHECK(!it->second.empty());
+  known_received_count_ = std::max(known_received_count_,
+                                   it->second.front().required_insert_count);
+
+  it->second.pop_front();
+  if (it->second.empty()) {
+    unacknowledged_header_blocks_.erase(it);
+  }
+}
+
+void QpackEncoder::OnStreamCancellation(QuicStreamId stream_id) {
+  unacknowledged_header_blocks_.erase(stream_id);
 }
 
-void QpackEncoder::OnHeaderAcknowledgement(QuicStreamId /*stream_id*/) {
-  // TODO(bnc): Implement dynamic table management for encoding.
+bool QpackEncoder::IsStreamBlocked(QuicStreamId stream_id) const {
+  auto it = unacknowledged_header_blocks_.find(stream_id);
+  if (it == unacknowledged_header_blocks_.end()) {
+    return false;
+  }
+
+  for (const auto& header_block : it->second) {
+    if (header_block.required_insert_count > known_received_count_) {
+      return true;
+    }
+  }
+  return false;
 }
 
-void QpackEncoder::OnStreamCancellation(QuicStreamId /*stream_id*/) {
-  // TODO(bnc): Implement dynamic table management for encoding.
+uint64_t QpackEncoder::SmallestBlockingIndex() const {
+  uint64_t smallest_blocking_index = header_table_.inserted_entry_count();
+  for (const auto& stream : unacknowledged_header_blocks_) {
+    for (const auto& header_block : stream.second) {
+      if (header_block.required_insert_count > 0) {
+        smallest_blocking_index = std::min(smallest_blocking_index,
+                                           header_block.min_referenced_index);
+      }
+    }
+  }
+  return smallest_blocking_index;
 }
 
 void QpackEncoder::OnErrorDetected(QuicStringPiece error_message) {
@@ -13,6 +13,7 @@
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_encoder_stream_sender.h"
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_header_table.h"
 #include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
 
@@ -25,6 +26,15 @@ class SpdyHeaderBlock;
 namespace quic {
 
 // QPACK encoder class.  Exactly one instance should exist per QUIC connection.
+//
+// The dynamic table is only used once SetMaximumDynamicTableCapacity() is
+// called with a non-zero value.  Header fields are then inserted into the
+// dynamic table through the encoder stream and referenced from header blocks.
+// Entries referenced by header blocks that have not been acknowledged are never
+// evicted.  Entries that have not been acknowledged yet are only referenced on
+// streams that are already blocked, or if the number of blocked streams is
+// below the limit set by SetMaximumBlockedStreams().  Entries close to being
+// evicted are duplicated instead of referenced, so that they can drain.
 class QUIC_EXPORT_PRIVATE QpackEncoder
     : public QpackDecoderStreamReceiver::Delegate {
  public:
@@ -49,6 +59,23 @@ class QUIC_EXPORT_PRIVATE QpackEncoder
   // Decode data received on the decoder stream.
   void DecodeDecoderStreamData(QuicStringPiece data);
 
+  // Set maximum dynamic table capacity to |maximum_dynamic_table_capacity|,
+  // measured in bytes.  Called when SETTINGS_QPACK_MAX_TABLE_CAPACITY is
+  // received.  Must be called at most once, before any header list is encoded.
+  void SetMaximumDynamicTableCapacity(uint64_t maximum_dynamic_table_capacity);
+
+  // Set maximum number of streams that can be blocked on dynamic table
+  // insertions.  Called when SETTINGS_QPACK_BLOCKED_STREAMS is received.
+  // Initial value is zero.
+  void SetMaximumBlockedStreams(uint64_t maximum_blocked_streams);
+
+  // Number of dynamic table entries the decoder is known to have received.
+  uint64_t known_received_count() const { return known_received_count_; }
+
+  // Number of streams with unacknowledged header blocks referencing entries
+  // beyond |known_received_count_|.
+  uint64_t blocked_stream_count() const;
+
   // QpackDecoderStreamReceiver::Delegate implementation
   void OnInsertCountIncrement(uint64_t increment) override;
   void OnHeaderAcknowledgement(QuicStreamId stream_id) override;
@@ -56,10 +83,53 @@ class QUIC_EXPORT_PRIVATE QpackEncoder
   void OnErrorDetected(QuicStringPiece error_message) override;
 
  private:
+  // Header block sent on a stream, waiting for Header Acknowledgement.
+  struct HeaderBlockInfo {
+    // Required Insert Count of the header block.  Zero if the header block
+    // does not reference the dynamic table.
+    uint64_t required_insert_count;
+    // Smallest absolute index of referenced dynamic table entries.  Only
+    // meaningful if |required_insert_count| is non-zero.
+    uint64_t min_referenced_index;
+  };
+
+  // Header field representation chosen by the first pass of
+  // EncodeHeaderList(), serialized by the second pass once Base is known.
+  struct Representation {
+    enum class Type { kIndexed, kNameReference, kLiteral };
+
+    Type type;
+    bool is_static;
+    // Absolute index for dynamic table entries.
+    uint64_t index;
+    QuicStringPiece name;
+    QuicStringPiece value;
+  };
+
+  // Returns true if |stream_id| has an unacknowledged header block referencing
+  // entries beyond |known_received_count_|.
+  bool IsStreamBlocked(QuicStreamId stream_id) const;
+
+  // Returns the smallest absolute index of entries referenced by
+  // unacknowledged header blocks, or inserted_entry_count() if there is none.
+  // Entries at or after this index must not be evicted.
+  uint64_t SmallestBlockingIndex() const;
+
   DecoderStreamErrorDelegate* const decoder_stream_error_delegate_;
   QpackDecoderStreamReceiver decoder_stream_receiver_;
   QpackEncoderStreamSender encoder_stream_sender_;
   QpackHeaderTable header_table_;
+
+  uint64_t maximum_blocked_streams_;
+
+  // Number of entries acknowledged by the decoder, either explicitly by Insert
+  // Count Increment, or implicitly by Header Acknowledgement.
+  uint64_t known_received_count_;
+
+  // Header blocks not yet acknowledged, in the order they were sent on each
+  // stream.  Only tracked while the dynamic table is in use.
+  QuicUnorderedMap<QuicStreamId, QuicDeque<HeaderBlockInfo>>
+      unacknowledged_header_blocks_;
 };
 
 }  // namespace quic
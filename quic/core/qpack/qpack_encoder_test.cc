@@ -7,6 +7,7 @@
 #include <string>
 
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_encoder_test_utils.h"
+#include "net/third_party/quiche/src/quic/core/qpack/qpack_test_utils.h"
 #include "net/third_party/quiche/src/quic/core/qpack/qpack_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
@@ -148,6 +149,153 @@ TEST_F(QpackEncoderTest, SplitAlongNullCharacter) {
             output);
 }
 
+class QpackEncoderDynamicTableTest : public QuicTest {
+ protected:
+  QpackEncoderDynamicTableTest()
+      : encoder_(&decoder_stream_error_delegate_,
+                 &encoder_stream_sender_delegate_) {}
+  ~QpackEncoderDynamicTableTest() override = default;
+
+  std::string Encode(QuicStreamId stream_id,
+                     QuicStringPiece name,
+                     QuicStringPiece value) {
+    spdy::SpdyHeaderBlock header_list;
+    header_list[name] = value;
+    return encoder_.EncodeHeaderList(stream_id, &header_list);
+  }
+
+  void ExpectEncoderStreamData(QuicStringPiece hex_data) {
+    EXPECT_CALL(encoder_stream_sender_delegate_,
+                WriteStreamData(Eq(QuicTextUtils::HexDecode(hex_data))));
+  }
+
+  StrictMock<MockDecoderStreamErrorDelegate> decoder_stream_error_delegate_;
+  StrictMock<MockQpackStreamSenderDelegate> encoder_stream_sender_delegate_;
+  QpackEncoder encoder_;
+};
+
+TEST_F(QpackEncoderDynamicTableTest, InsertAndReference) {
+  encoder_.SetMaximumDynamicTableCapacity(4096);
+  encoder_.SetMaximumBlockedStreams(1);
+
+  // Insert Without Name Reference, then reference the new entry.
+  ExpectEncoderStreamData("6294e703626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("020080"), Encode(1, "foo", "bar"));
+  EXPECT_EQ(1u, encoder_.blocked_stream_count());
+
+  // Insert With Name Reference to the static table.
+  ExpectEncoderStreamData("c003626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("030080"), Encode(1, ":authority", "bar"));
+  EXPECT_EQ(1u, encoder_.blocked_stream_count());
+
+  // Stream 3 is not allowed to become blocked, therefore the unacknowledged
+  // entry is not referenced.
+  EXPECT_EQ(QuicTextUtils::HexDecode("00002a94e703626172"),
+            Encode(3, "foo", "bar"));
+
+  // Header Acknowledgement for the first header block on stream 1.
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("81"));
+  EXPECT_EQ(1u, encoder_.known_received_count());
+  EXPECT_EQ(1u, encoder_.blocked_stream_count());
+
+  // Header Acknowledgement for the second header block on stream 1.
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("81"));
+  EXPECT_EQ(2u, encoder_.known_received_count());
+  EXPECT_EQ(0u, encoder_.blocked_stream_count());
+
+  // Acknowledged entries can be referenced on any stream.
+  EXPECT_EQ(QuicTextUtils::HexDecode("020080"), Encode(3, "foo", "bar"));
+  EXPECT_EQ(0u, encoder_.blocked_stream_count());
+}
+
+TEST_F(QpackEncoderDynamicTableTest, NoBlockedStreamsAllowed) {
+  encoder_.SetMaximumDynamicTableCapacity(4096);
+
+  // Nothing is inserted if no stream is allowed to become blocked.
+  EXPECT_EQ(QuicTextUtils::HexDecode("00002a94e703626172"),
+            Encode(1, "foo", "bar"));
+  EXPECT_EQ(0u, encoder_.blocked_stream_count());
+}
+
+TEST_F(QpackEncoderDynamicTableTest, DoNotEvictBlockingEntries) {
+  // Room for two entries of size 38.
+  encoder_.SetMaximumDynamicTableCapacity(80);
+  encoder_.SetMaximumBlockedStreams(3);
+
+  ExpectEncoderStreamData("6294e703626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("020080"), Encode(1, "foo", "bar"));
+  ExpectEncoderStreamData("4362617203626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("030080"), Encode(2, "bar", "bar"));
+
+  // Inserting another entry would evict entries referenced by unacknowledged
+  // header blocks.
+  EXPECT_EQ(QuicTextUtils::HexDecode("00002362617a03626172"),
+            Encode(3, "baz", "bar"));
+
+  // Once the header block on stream 1 is acknowledged, its entry can be
+  // evicted.
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("81"));
+  ExpectEncoderStreamData("4362617a03626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("040080"), Encode(3, "baz", "bar"));
+  EXPECT_EQ(2u, encoder_.blocked_stream_count());
+}
+
+TEST_F(QpackEncoderDynamicTableTest, DuplicateDrainingEntry) {
+  // Room for two entries of size 38.
+  encoder_.SetMaximumDynamicTableCapacity(80);
+  encoder_.SetMaximumBlockedStreams(1);
+
+  ExpectEncoderStreamData("6294e703626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("020080"), Encode(1, "foo", "bar"));
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("81"));
+
+  ExpectEncoderStreamData("4362617203626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("030080"), Encode(1, "bar", "bar"));
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("81"));
+
+  // The oldest entry is draining, so it is duplicated rather than referenced.
+  ExpectEncoderStreamData("01");
+  EXPECT_EQ(QuicTextUtils::HexDecode("040080"), Encode(1, "foo", "bar"));
+}
+
+TEST_F(QpackEncoderDynamicTableTest, StreamCancellation) {
+  encoder_.SetMaximumDynamicTableCapacity(4096);
+  encoder_.SetMaximumBlockedStreams(1);
+
+  ExpectEncoderStreamData("6294e703626172");
+  EXPECT_EQ(QuicTextUtils::HexDecode("020080"), Encode(1, "foo", "bar"));
+  EXPECT_EQ(1u, encoder_.blocked_stream_count());
+
+  // Stream Cancellation for stream 1.
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("41"));
+  EXPECT_EQ(0u, encoder_.blocked_stream_count());
+  EXPECT_EQ(0u, encoder_.known_received_count());
+}
+
+TEST_F(QpackEncoderDynamicTableTest, InvalidInsertCountIncrement) {
+  EXPECT_CALL(decoder_stream_error_delegate_,
+              OnDecoderStreamError(Eq("Invalid increment value 0.")));
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("00"));
+}
+
+TEST_F(QpackEncoderDynamicTableTest, InsertCountIncrementTooLarge) {
+  EXPECT_CALL(
+      decoder_stream_error_delegate_,
+      OnDecoderStreamError(
+          Eq("Increment value raises known received count too high.")));
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("01"));
+}
+
+TEST_F(QpackEncoderDynamicTableTest, UnexpectedHeaderAcknowledgement) {
+  encoder_.SetMaximumDynamicTableCapacity(4096);
+
+  EXPECT_CALL(decoder_stream_error_delegate_,
+              OnDecoderStreamError(Eq("Header Acknowledgement received for "
+                                      "stream without outstanding header "
+                                      "blocks.")));
+  encoder_.DecodeDecoderStreamData(QuicTextUtils::HexDecode("81"));
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -12,7 +12,6 @@ namespace quic {
 QpackHeaderTable::QpackHeaderTable()
     : static_entries_(ObtainQpackStaticTable().GetStaticEntries()),
       static_index_(ObtainQpackStaticTable().GetStaticIndex()),
-      static_name_index_(ObtainQpackStaticTable().GetStaticNameIndex()),
       dynamic_table_size_(0),
       dynamic_table_capacity_(0),
       maximum_dynamic_table_capacity_(0),
@@ -49,19 +48,17 @@ QpackHeaderTable::MatchType QpackHeaderTable::FindHeaderField(
     QuicStringPiece value,
     bool* is_static,
     uint64_t* index) const {
-  QpackEntry query(name, value);
-
   // Look for exact match in static table.
-  auto index_it = static_index_.find(&query);
-  if (index_it != static_index_.end()) {
-    DCHECK((*index_it)->IsStatic());
-    *index = (*index_it)->InsertionIndex();
+  size_t static_index = static_index_.Find(name, value);
+  if (static_index != QpackStaticIndex::kNotFound) {
+    *index = static_index;
     *is_static = true;
     return MatchType::kNameAndValue;
   }
 
   // Look for exact match in dynamic table.
-  index_it = dynamic_index_.find(&query);
+  QpackEntry query(name, value);
+  auto index_it = dynamic_index_.find(&query);
   if (index_it != dynamic_index_.end()) {
     DCHECK(!(*index_it)->IsStatic());
     *index = (*index_it)->InsertionIndex();
@@ -70,16 +67,15 @@ QpackHeaderTable::MatchType QpackHeaderTable::FindHeaderField(
   }
 
   // Look for name match in static table.
-  auto name_index_it = static_name_index_.find(name);
-  if (name_index_it != static_name_index_.end()) {
-    DCHECK(name_index_it->second->IsStatic());
-    *index = name_index_it->second->InsertionIndex();
+  static_index = static_index_.FindName(name);
+  if (static_index != QpackStaticIndex::kNotFound) {
+    *index = static_index;
     *is_static = true;
     return MatchType::kName;
   }
 
   // Look for name match in dynamic table.
-  name_index_it = dynamic_name_index_.find(name);
+  auto name_index_it = dynamic_name_index_.find(name);
   if (name_index_it != dynamic_name_index_.end()) {
     DCHECK(!name_index_it->second->IsStatic());
     *index = name_index_it->second->InsertionIndex();
@@ -167,6 +163,53 @@ void QpackHeaderTable::SetMaximumDynamicTableCapacity(
   max_entries_ = maximum_dynamic_table_capacity / 32;
 }
 
+uint64_t QpackHeaderTable::MaxInsertSizeWithoutEvictingGivenEntry(
+    uint64_t index) const {
+  DCHECK_LE(dropped_entry_count_, index);
+  DCHECK_LE(index, inserted_entry_count());
+
+  // Initialize to current available capacity.
+  uint64_t max_insert_size = dynamic_table_capacity_ - dynamic_table_size_;
+
+  uint64_t entry_index = dropped_entry_count_;
+  for (const auto& entry : dynamic_entries_) {
+    if (entry_index >= index) {
+      break;
+    }
+    ++entry_index;
+    max_insert_size += entry.Size();
+  }
+
+  return max_insert_size;
+}
+
+uint64_t QpackHeaderTable::draining_index(float draining_fraction) const {
+  DCHECK_LE(0.0, draining_fraction);
+  DCHECK_LE(draining_fraction, 1.0);
+
+  const uint64_t required_space = draining_fraction * dynamic_table_capacity_;
+  uint64_t space_above_draining_index =
+      dynamic_table_capacity_ - dynamic_table_size_;
+
+  if (dynamic_entries_.empty() ||
+      space_above_draining_index >= required_space) {
+    return dropped_entry_count_;
+  }
+
+  auto it = dynamic_entries_.begin();
+  uint64_t entry_index = dropped_entry_count_;
+  while (space_above_draining_index < required_space) {
+    space_above_draining_index += it->Size();
+    ++it;
+    ++entry_index;
+    if (it == dynamic_entries_.end()) {
+      return inserted_entry_count();
+    }
+  }
+
+  return entry_index;
+}
+
 void QpackHeaderTable::RegisterObserver(Observer* observer,
                                         uint64_t required_insert_count) {
   DCHECK_GT(required_insert_count, 0u);
@@ -99,6 +99,22 @@ class QUIC_EXPORT_PRIVATE QpackHeaderTable {
   // The number of entries dropped from the dynamic table.
   uint64_t dropped_entry_count() const { return dropped_entry_count_; }
 
+  uint64_t dynamic_table_capacity() const { return dynamic_table_capacity_; }
+  uint64_t dynamic_table_size() const { return dynamic_table_size_; }
+
+  // Returns the size of the largest entry that could be inserted into the
+  // dynamic table without evicting entry |index|, or any entry inserted after
+  // it.  |index| must not be larger than inserted_entry_count(), and must not
+  // refer to an entry that has already been evicted.  Used by the encoder to
+  // avoid evicting entries that unacknowledged header blocks still reference.
+  uint64_t MaxInsertSizeWithoutEvictingGivenEntry(uint64_t index) const;
+
+  // Returns the absolute index of the oldest entry that is not draining, that
+  // is, the entries with a lower index take up |draining_fraction| of the
+  // dynamic table capacity and are the next ones to be evicted.  The encoder
+  // avoids referencing draining entries so that they can be evicted.
+  uint64_t draining_index(float draining_fraction) const;
+
  private:
   // Evict entries from the dynamic table until table size is less than or equal
   // to current value of |dynamic_table_capacity_|.
@@ -106,17 +122,15 @@ class QUIC_EXPORT_PRIVATE QpackHeaderTable {
 
   // Static Table
 
-  // |static_entries_|, |static_index_|, |static_name_index_| are owned by
-  // QpackStaticTable singleton.
+  // |static_entries_| and |static_index_| are owned by QpackStaticTable
+  // singleton.
 
   // Tracks QpackEntries by index.
   const EntryTable& static_entries_;
 
-  // Tracks the unique static entry for a given header name and value.
-  const UnorderedEntrySet& static_index_;
-
-  // Tracks the first static entry for a given header name.
-  const NameToEntryMap& static_name_index_;
+  // Tracks the unique static entry for a given header name and value, and the
+  // first static entry for a given header name.
+  const spdy::HpackStaticIndex& static_index_;
 
   // Dynamic Table
 
@@ -99,7 +99,7 @@ class QpackHeaderTableTest : public QuicTest {
   }
   uint64_t dropped_entry_count() const { return table_.dropped_entry_count(); }
 
- private:
+ protected:
   QpackHeaderTable table_;
 };
 
@@ -287,6 +287,79 @@ TEST_F(QpackHeaderTableTest, EvictByInsertion) {
   ExpectToFailInsertingEntry("foobar", "foobar");
 }
 
+TEST_F(QpackHeaderTableTest, MaxInsertSizeWithoutEvictingGivenEntry) {
+  const uint64_t dynamic_table_capacity = 100;
+  EXPECT_TRUE(SetDynamicTableCapacity(dynamic_table_capacity));
+
+  // Empty table can take an entry up to its capacity.
+  EXPECT_EQ(dynamic_table_capacity,
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(0));
+
+  const uint64_t entry_size1 = QpackEntry::Size("foo", "bar");
+  InsertEntry("foo", "bar");
+  EXPECT_EQ(dynamic_table_capacity - entry_size1,
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(0));
+  // Table can take an entry up to its capacity if all entries are allowed to
+  // be evicted.
+  EXPECT_EQ(dynamic_table_capacity,
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(1));
+
+  const uint64_t entry_size2 = QpackEntry::Size("baz", "foobar");
+  InsertEntry("baz", "foobar");
+  EXPECT_EQ(dynamic_table_capacity - entry_size1 - entry_size2,
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(0));
+  EXPECT_EQ(dynamic_table_capacity - entry_size2,
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(1));
+  EXPECT_EQ(dynamic_table_capacity,
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(2));
+
+  // Third entry evicts first one.
+  InsertEntry("bar", "baz");
+  EXPECT_EQ(1u, dropped_entry_count());
+  EXPECT_EQ(dynamic_table_capacity - table_.dynamic_table_size(),
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(1));
+  EXPECT_EQ(dynamic_table_capacity - QpackEntry::Size("bar", "baz"),
+            table_.MaxInsertSizeWithoutEvictingGivenEntry(2));
+}
+
+TEST_F(QpackHeaderTableTest, DrainingIndex) {
+  EXPECT_TRUE(SetDynamicTableCapacity(4 * QpackEntry::Size("foo", "bar")));
+
+  // Empty table: no draining entry.
+  EXPECT_EQ(0u, table_.draining_index(0.0));
+  EXPECT_EQ(0u, table_.draining_index(1.0));
+
+  // Table with one entry.
+  InsertEntry("foo", "bar");
+  // Any entry can be referenced if none of the table is draining.
+  EXPECT_EQ(0u, table_.draining_index(0.0));
+  // No entry can be referenced if all of the table is draining.
+  EXPECT_EQ(1u, table_.draining_index(1.0));
+  // Make sure that entry is not draining as long as there is enough free space.
+  EXPECT_EQ(0u, table_.draining_index(0.25));
+  EXPECT_EQ(0u, table_.draining_index(0.5));
+
+  // Table with two entries is at half capacity.
+  InsertEntry("foo", "bar");
+  // Any entry can be referenced if at most half of the table is draining,
+  // because the free space makes up for it.
+  EXPECT_EQ(0u, table_.draining_index(0.0));
+  EXPECT_EQ(0u, table_.draining_index(0.5));
+  // No entry can be referenced if all of the table is draining.
+  EXPECT_EQ(2u, table_.draining_index(1.0));
+
+  // Table with four entries is full.
+  InsertEntry("foo", "bar");
+  InsertEntry("foo", "bar");
+  // Any entry can be referenced if none of the table is draining.
+  EXPECT_EQ(0u, table_.draining_index(0.0));
+  // In a full table with identically sized entries, |draining_fraction| of all
+  // entries are draining.
+  EXPECT_EQ(2u, table_.draining_index(0.5));
+  // No entry can be referenced if all of the table is draining.
+  EXPECT_EQ(4u, table_.draining_index(1.0));
+}
+
 TEST_F(QpackHeaderTableTest, EvictByUpdateTableSize) {
   // Entry size is 3 + 3 + 32 = 38.
   InsertEntry("foo", "bar");
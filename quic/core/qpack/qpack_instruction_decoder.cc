@@ -281,13 +281,13 @@ void QpackInstructionDecoder::DoReadStringDone() {
   if (is_huffman_encoded_) {
     huffman_decoder_.Reset();
     // HpackHuffmanDecoder::Decode() cannot perform in-place decoding.
-    std::string decoded_value;
-    huffman_decoder_.Decode(*string, &decoded_value);
+    huffman_decoded_string_.clear();
+    huffman_decoder_.Decode(*string, &huffman_decoded_string_);
     if (!huffman_decoder_.InputProperlyTerminated()) {
       OnError("Error in Huffman-encoded string.");
       return;
     }
-    *string = std::move(decoded_value);
+    string->swap(huffman_decoded_string_);
   }
 
   ++field_;
@@ -126,6 +126,9 @@ class QUIC_EXPORT_PRIVATE QpackInstructionDecoder {
 
   // Decoder instance for decoding Huffman encoded strings.
   http2::HpackHuffmanDecoder huffman_decoder_;
+  // Buffer Huffman encoded strings are decoded into, swapped with |name_| or
+  // |value_| afterwards, so that neither loses its capacity.
+  std::string huffman_decoded_string_;
 
   // True if a decoding error has been detected either by
   // QpackInstructionDecoder or by Delegate.
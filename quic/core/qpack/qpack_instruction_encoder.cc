@@ -131,9 +131,10 @@ void QpackInstructionEncoder::DoStartString() {
 
   string_to_write_ =
       (field_->type == QpackInstructionFieldType::kName) ? name_ : value_;
-  http2::HuffmanEncode(string_to_write_, &huffman_encoded_string_);
-
-  if (huffman_encoded_string_.size() < string_to_write_.size()) {
+  // Only encode the string if Huffman encoding makes it shorter.
+  if (http2::BoundedHuffmanSize(string_to_write_) < string_to_write_.size()) {
+    http2::HuffmanEncode(string_to_write_, &huffman_encoded_string_);
+    DCHECK_LT(huffman_encoded_string_.size(), string_to_write_.size());
     DCHECK_EQ(0, byte_ & (1 << field_->param));
 
     byte_ |= (1 << field_->param);
@@ -14,6 +14,7 @@
 namespace quic {
 
 using QpackStaticEntry = spdy::HpackStaticEntry;
+using QpackStaticIndex = spdy::HpackStaticIndex;
 using QpackStaticTable = spdy::HpackStaticTable;
 
 // QPACK static table defined at
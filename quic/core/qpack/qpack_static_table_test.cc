@@ -21,22 +21,31 @@ TEST(QpackStaticTableTest, Initialize) {
   QpackStaticTable table;
   EXPECT_FALSE(table.IsInitialized());
 
-  table.Initialize(QpackStaticTableVector().data(),
-                   QpackStaticTableVector().size());
+  QpackStaticIndex static_index(QpackStaticTableVector().data(),
+                                QpackStaticTableVector().size());
+  ASSERT_TRUE(static_index.IsValid());
+  table.Initialize(static_index);
   EXPECT_TRUE(table.IsInitialized());
 
   auto static_entries = table.GetStaticEntries();
   EXPECT_EQ(QpackStaticTableVector().size(), static_entries.size());
 
-  auto static_index = table.GetStaticIndex();
-  EXPECT_EQ(QpackStaticTableVector().size(), static_index.size());
+  const QpackStaticIndex& index = table.GetStaticIndex();
+  EXPECT_EQ(QpackStaticTableVector().size(), index.size());
 
-  auto static_name_index = table.GetStaticNameIndex();
   std::set<QuicStringPiece> names;
-  for (auto entry : static_index) {
-    names.insert(entry->name());
+  for (const auto& entry : static_entries) {
+    names.insert(entry.name());
   }
-  EXPECT_EQ(names.size(), static_name_index.size());
+  EXPECT_EQ(names.size(), index.name_count());
+}
+
+// Entries with the same name are not always adjacent in the QPACK static table.
+TEST(QpackStaticTableTest, FindName) {
+  const QpackStaticIndex& index = ObtainQpackStaticTable().GetStaticIndex();
+  EXPECT_EQ(24u, index.FindName(":status"));
+  EXPECT_EQ(63u, index.Find(":status", "100"));
+  EXPECT_EQ(QpackStaticIndex::kNotFound, index.Find(":status", "999"));
 }
 
 // Test that ObtainQpackStaticTable returns the same instance every time.
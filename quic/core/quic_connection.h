@@ -702,6 +702,12 @@ class QUIC_EXPORT_PRIVATE QuicConnection
     bool flush_and_set_pending_retransmission_alarm_on_delete_;
   };
 
+  // Returns true if a ScopedPacketFlusher is in scope, so that frames sent now
+  // share packets with the other frames sent in that scope.
+  bool PacketFlusherAttached() const {
+    return packet_generator_.PacketFlusherAttached();
+  }
+
   QuicPacketWriter* writer() { return writer_; }
   const QuicPacketWriter* writer() const { return writer_; }
 
@@ -4,6 +4,7 @@
 
 #include "net/third_party/quiche/src/quic/core/quic_control_frame_manager.h"
 
+#include <algorithm>
 #include <string>
 
 #include "net/third_party/quiche/src/quic/core/quic_constants.h"
@@ -14,8 +15,21 @@
 
 namespace quic {
 
+namespace {
+
+// Returns true if |frame| only informs the peer, which is not expected to
+// act on it, so that sending it can wait for other data.
+bool IsNonUrgentFrame(const QuicFrame& frame) {
+  return frame.type == BLOCKED_FRAME || frame.type == STREAMS_BLOCKED_FRAME;
+}
+
+}  // namespace
+
 QuicControlFrameManager::QuicControlFrameManager(QuicSession* session)
-    : last_control_frame_id_(kInvalidControlFrameId),
+    : defer_non_urgent_frames_(false),
+      num_coalesced_frames_(0),
+      num_packets_saved_(0),
+      last_control_frame_id_(kInvalidControlFrameId),
       least_unacked_(1),
       least_unsent_(1),
       session_(session) {}
@@ -25,10 +39,33 @@ QuicControlFrameManager::~QuicControlFrameManager() {
     DeleteFrame(&control_frames_.front());
     control_frames_.pop_front();
   }
+  while (!deferred_frames_.empty()) {
+    DeleteFrame(&deferred_frames_.front());
+    deferred_frames_.pop_front();
+  }
 }
 
 void QuicControlFrameManager::WriteOrBufferQuicFrame(QuicFrame frame) {
+  const bool defer = defer_non_urgent_frames_ && IsNonUrgentFrame(frame);
+  if (defer && !HasBufferedFrames() &&
+      !session_->connection()->PacketFlusherAttached()) {
+    // Written right away, |frame| would have been sent in a packet of its own.
+    ++num_packets_saved_;
+  }
+  if (CoalesceWithUnsentFrame(frame)) {
+    QUIC_DVLOG(1) << "Coalesced control frame: " << frame;
+    ++num_coalesced_frames_;
+    DeleteFrame(&frame);
+    return;
+  }
+  if (defer) {
+    deferred_frames_.push_back(frame);
+    return;
+  }
   const bool had_buffered_frames = HasBufferedFrames();
+  // Deferred frames go out along with this one.
+  QueueDeferredFrames();
+  SetControlFrameId(++last_control_frame_id_, &frame);
   control_frames_.emplace_back(frame);
   if (had_buffered_frames) {
     return;
@@ -36,13 +73,92 @@ void QuicControlFrameManager::WriteOrBufferQuicFrame(QuicFrame frame) {
   WriteBufferedFrames();
 }
 
+bool QuicControlFrameManager::CoalesceWithUnsentFrame(const QuicFrame& frame) {
+  auto coalesce = [&frame](QuicFrame* unsent) {
+    if (unsent->type != frame.type) {
+      return false;
+    }
+    switch (frame.type) {
+      case WINDOW_UPDATE_FRAME:
+        if (unsent->window_update_frame->stream_id !=
+            frame.window_update_frame->stream_id) {
+          return false;
+        }
+        unsent->window_update_frame->byte_offset =
+            std::max(unsent->window_update_frame->byte_offset,
+                     frame.window_update_frame->byte_offset);
+        return true;
+      case BLOCKED_FRAME:
+        return unsent->blocked_frame->stream_id ==
+               frame.blocked_frame->stream_id;
+      case MAX_STREAMS_FRAME:
+        if (unsent->max_streams_frame.unidirectional !=
+            frame.max_streams_frame.unidirectional) {
+          return false;
+        }
+        unsent->max_streams_frame.stream_count =
+            std::max(unsent->max_streams_frame.stream_count,
+                     frame.max_streams_frame.stream_count);
+        return true;
+      case STREAMS_BLOCKED_FRAME:
+        if (unsent->streams_blocked_frame.unidirectional !=
+            frame.streams_blocked_frame.unidirectional) {
+          return false;
+        }
+        unsent->streams_blocked_frame.stream_count =
+            std::max(unsent->streams_blocked_frame.stream_count,
+                     frame.streams_blocked_frame.stream_count);
+        return true;
+      default:
+        return false;
+    }
+  };
+  for (QuicFrame& deferred : deferred_frames_) {
+    if (coalesce(&deferred)) {
+      return true;
+    }
+  }
+  for (size_t i = least_unsent_ - least_unacked_; i < control_frames_.size();
+       ++i) {
+    if (coalesce(&control_frames_[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void QuicControlFrameManager::QueueDeferredFrames() {
+  while (!deferred_frames_.empty()) {
+    QuicFrame frame = deferred_frames_.front();
+    deferred_frames_.pop_front();
+    SetControlFrameId(++last_control_frame_id_, &frame);
+    control_frames_.emplace_back(frame);
+  }
+}
+
+bool QuicControlFrameManager::HasDeferredFrames() const {
+  return !deferred_frames_.empty();
+}
+
+void QuicControlFrameManager::WriteDeferredFrames() {
+  if (!HasDeferredFrames()) {
+    return;
+  }
+  const bool had_buffered_frames = HasBufferedFrames();
+  QueueDeferredFrames();
+  if (had_buffered_frames) {
+    return;
+  }
+  WriteBufferedFrames();
+}
+
 void QuicControlFrameManager::WriteOrBufferRstStream(
     QuicStreamId id,
     QuicRstStreamErrorCode error,
     QuicStreamOffset bytes_written) {
   QUIC_DVLOG(1) << "Writing RST_STREAM_FRAME";
   WriteOrBufferQuicFrame((QuicFrame(new QuicRstStreamFrame(
-      ++last_control_frame_id_, id, error, bytes_written))));
+      kInvalidControlFrameId, id, error, bytes_written))));
 }
 
 void QuicControlFrameManager::WriteOrBufferGoAway(
@@ -51,7 +167,7 @@ void QuicControlFrameManager::WriteOrBufferGoAway(
     const std::string& reason) {
   QUIC_DVLOG(1) << "Writing GOAWAY_FRAME";
   WriteOrBufferQuicFrame(QuicFrame(new QuicGoAwayFrame(
-      ++last_control_frame_id_, error, last_good_stream_id, reason)));
+      kInvalidControlFrameId, error, last_good_stream_id, reason)));
 }
 
 void QuicControlFrameManager::WriteOrBufferWindowUpdate(
@@ -59,13 +175,13 @@ void QuicControlFrameManager::WriteOrBufferWindowUpdate(
     QuicStreamOffset byte_offset) {
   QUIC_DVLOG(1) << "Writing WINDOW_UPDATE_FRAME";
   WriteOrBufferQuicFrame(QuicFrame(
-      new QuicWindowUpdateFrame(++last_control_frame_id_, id, byte_offset)));
+      new QuicWindowUpdateFrame(kInvalidControlFrameId, id, byte_offset)));
 }
 
 void QuicControlFrameManager::WriteOrBufferBlocked(QuicStreamId id) {
   QUIC_DVLOG(1) << "Writing BLOCKED_FRAME";
   WriteOrBufferQuicFrame(
-      QuicFrame(new QuicBlockedFrame(++last_control_frame_id_, id)));
+      QuicFrame(new QuicBlockedFrame(kInvalidControlFrameId, id)));
 }
 
 void QuicControlFrameManager::WriteOrBufferStreamsBlocked(QuicStreamCount count,
@@ -73,7 +189,7 @@ void QuicControlFrameManager::WriteOrBufferStreamsBlocked(QuicStreamCount count,
   QUIC_DVLOG(1) << "Writing STREAMS_BLOCKED Frame";
   QUIC_CODE_COUNT(quic_streams_blocked_transmits);
   WriteOrBufferQuicFrame(QuicFrame(QuicStreamsBlockedFrame(
-      ++last_control_frame_id_, count, unidirectional)));
+      kInvalidControlFrameId, count, unidirectional)));
 }
 
 void QuicControlFrameManager::WriteOrBufferMaxStreams(QuicStreamCount count,
@@ -81,14 +197,14 @@ void QuicControlFrameManager::WriteOrBufferMaxStreams(QuicStreamCount count,
   QUIC_DVLOG(1) << "Writing MAX_STREAMS Frame";
   QUIC_CODE_COUNT(quic_max_streams_transmits);
   WriteOrBufferQuicFrame(QuicFrame(
-      QuicMaxStreamsFrame(++last_control_frame_id_, count, unidirectional)));
+      QuicMaxStreamsFrame(kInvalidControlFrameId, count, unidirectional)));
 }
 
 void QuicControlFrameManager::WriteOrBufferStopSending(uint16_t code,
                                                        QuicStreamId stream_id) {
   QUIC_DVLOG(1) << "Writing STOP_SENDING_FRAME";
   WriteOrBufferQuicFrame(QuicFrame(
-      new QuicStopSendingFrame(++last_control_frame_id_, stream_id, code)));
+      new QuicStopSendingFrame(kInvalidControlFrameId, stream_id, code)));
 }
 
 void QuicControlFrameManager::WritePing() {
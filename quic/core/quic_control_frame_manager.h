@@ -27,6 +27,13 @@ class QuicControlFrameManagerPeer;
 // the generator. Control frames are removed from the head of the list when they
 // get acked. Control frame manager also keeps track of lost control frames
 // which need to be retransmitted.
+//
+// Control frames which have not been sent yet are coalesced: a new
+// WINDOW_UPDATE, BLOCKED, MAX_STREAMS or STREAMS_BLOCKED frame supersedes an
+// unsent one of the same stream (or stream directionality), which is updated
+// in place instead of queuing another frame. Optionally, non-urgent frames are
+// deferred so that they share a packet with other data rather than being sent
+// in packets of their own.
 class QUIC_EXPORT_PRIVATE QuicControlFrameManager {
  public:
   explicit QuicControlFrameManager(QuicSession* session);
@@ -96,6 +103,30 @@ class QUIC_EXPORT_PRIVATE QuicControlFrameManager {
   // sent.
   bool WillingToWrite() const;
 
+  // If true, BLOCKED and STREAMS_BLOCKED frames, which are only advisory, are
+  // deferred until WriteDeferredFrames() is called or an urgent control frame
+  // is written. False by default.
+  void set_defer_non_urgent_frames(bool defer_non_urgent_frames) {
+    defer_non_urgent_frames_ = defer_non_urgent_frames;
+  }
+  bool defer_non_urgent_frames() const { return defer_non_urgent_frames_; }
+
+  // Returns true if there are deferred frames waiting for other data to be
+  // bundled with.
+  bool HasDeferredFrames() const;
+
+  // Queues deferred frames and tries to write them. Called when the packet
+  // being built carries other data, so that they do not cost a packet.
+  void WriteDeferredFrames();
+
+  // Number of frames which were merged into an unsent frame of the same kind,
+  // and thus never sent.
+  size_t num_coalesced_frames() const { return num_coalesced_frames_; }
+
+  // Number of packets which deferred frames would have been sent in on their
+  // own, had they been written right away.
+  size_t num_packets_saved() const { return num_packets_saved_; }
+
  private:
   friend class test::QuicControlFrameManagerPeer;
 
@@ -122,11 +153,29 @@ class QUIC_EXPORT_PRIVATE QuicControlFrameManager {
 
   // Writes or buffers a control frame.  Frame is buffered if there already
   // are frames waiting to be sent. If no others waiting, will try to send the
-  // frame.
+  // frame.  |frame| is assigned its control frame ID here, unless it is
+  // coalesced or deferred.
   void WriteOrBufferQuicFrame(QuicFrame frame);
 
+  // Merges |frame| into an unsent or deferred frame it supersedes. Returns
+  // false if there is no such frame.
+  bool CoalesceWithUnsentFrame(const QuicFrame& frame);
+
+  // Assigns control frame IDs to deferred frames and appends them to
+  // control_frames_.
+  void QueueDeferredFrames();
+
   QuicDeque<QuicFrame> control_frames_;
 
+  // Non-urgent frames waiting to be bundled with other data. They do not have
+  // control frame IDs yet.
+  QuicDeque<QuicFrame> deferred_frames_;
+
+  bool defer_non_urgent_frames_;
+
+  size_t num_coalesced_frames_;
+  size_t num_packets_saved_;
+
   // Id of latest saved control frame. 0 if no control frame has been saved.
   QuicControlFrameId last_control_frame_id_;
 
@@ -226,7 +226,14 @@ TEST_F(QuicControlFrameManagerTest, DonotSendPingWithBufferedFrames) {
 
 TEST_F(QuicControlFrameManagerTest, DonotRetransmitOldWindowUpdates) {
   Initialize();
-  // Send two more window updates of the same stream.
+  InSequence s;
+  // Flush all buffered control frames.
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillRepeatedly(Invoke(&ClearControlFrame));
+  manager_->OnCanWrite();
+
+  // Send two more window updates of the same stream. They are not coalesced
+  // as the previous ones have already been sent.
   manager_->WriteOrBufferWindowUpdate(kTestStreamId, 200);
   QuicWindowUpdateFrame window_update2(number_of_frames_ + 1, kTestStreamId,
                                        200);
@@ -234,11 +241,7 @@ TEST_F(QuicControlFrameManagerTest, DonotRetransmitOldWindowUpdates) {
   manager_->WriteOrBufferWindowUpdate(kTestStreamId, 300);
   QuicWindowUpdateFrame window_update3(number_of_frames_ + 2, kTestStreamId,
                                        300);
-  InSequence s;
-  // Flush all buffered control frames.
-  EXPECT_CALL(*connection_, SendControlFrame(_))
-      .WillRepeatedly(Invoke(&ClearControlFrame));
-  manager_->OnCanWrite();
+  EXPECT_EQ(0u, manager_->num_coalesced_frames());
 
   // Mark all 3 window updates as lost.
   manager_->OnControlFrameLost(QuicFrame(&window_update_));
@@ -288,6 +291,104 @@ TEST_F(QuicControlFrameManagerTest, RetransmitWindowUpdateOfDifferentStreams) {
   EXPECT_FALSE(manager_->WillingToWrite());
 }
 
+TEST_F(QuicControlFrameManagerTest, CoalesceUnsentFrames) {
+  Initialize();
+  // Superseding frames are merged into the buffered ones.
+  manager_->WriteOrBufferWindowUpdate(kTestStreamId, 200);
+  manager_->WriteOrBufferBlocked(kTestStreamId);
+  manager_->WriteOrBufferMaxStreams(10, /*unidirectional=*/false);
+  manager_->WriteOrBufferMaxStreams(20, /*unidirectional=*/false);
+  manager_->WriteOrBufferMaxStreams(5, /*unidirectional=*/true);
+  // A window update of another stream is not.
+  manager_->WriteOrBufferWindowUpdate(kTestStreamId + 2, 300);
+  EXPECT_EQ(3u, manager_->num_coalesced_frames());
+  EXPECT_EQ(number_of_frames_ + 3,
+            QuicControlFrameManagerPeer::QueueSize(manager_.get()));
+
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .Times(number_of_frames_ + 3)
+      .WillRepeatedly(Invoke([](const QuicFrame& frame) {
+        if (frame.type == WINDOW_UPDATE_FRAME &&
+            frame.window_update_frame->stream_id == kTestStreamId) {
+          EXPECT_EQ(200u, frame.window_update_frame->byte_offset);
+        }
+        if (frame.type == MAX_STREAMS_FRAME &&
+            !frame.max_streams_frame.unidirectional) {
+          EXPECT_EQ(20u, frame.max_streams_frame.stream_count);
+        }
+        return ClearControlFrame(frame);
+      }));
+  manager_->OnCanWrite();
+  EXPECT_FALSE(manager_->WillingToWrite());
+
+  // Sent frames are not coalesced.
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillOnce(Invoke(&ClearControlFrame));
+  manager_->WriteOrBufferWindowUpdate(kTestStreamId, 400);
+  EXPECT_EQ(3u, manager_->num_coalesced_frames());
+}
+
+TEST_F(QuicControlFrameManagerTest, DeferNonUrgentFrames) {
+  Initialize();
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .Times(number_of_frames_)
+      .WillRepeatedly(Invoke(&ClearControlFrame));
+  manager_->OnCanWrite();
+
+  manager_->set_defer_non_urgent_frames(true);
+  EXPECT_CALL(*connection_, SendControlFrame(_)).Times(0);
+  manager_->WriteOrBufferBlocked(kTestStreamId);
+  manager_->WriteOrBufferStreamsBlocked(3, /*unidirectional=*/false);
+  manager_->WriteOrBufferBlocked(kTestStreamId);
+  EXPECT_TRUE(manager_->HasDeferredFrames());
+  // Deferred frames do not make the manager willing to write.
+  EXPECT_FALSE(manager_->WillingToWrite());
+  EXPECT_EQ(1u, manager_->num_coalesced_frames());
+  // Each frame would have been sent in a packet of its own.
+  EXPECT_EQ(3u, manager_->num_packets_saved());
+
+  // Deferred frames are written along with the next urgent frame.
+  InSequence s;
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillOnce(Invoke([](const QuicFrame& frame) {
+        EXPECT_EQ(BLOCKED_FRAME, frame.type);
+        return ClearControlFrame(frame);
+      }));
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillOnce(Invoke([](const QuicFrame& frame) {
+        EXPECT_EQ(STREAMS_BLOCKED_FRAME, frame.type);
+        return ClearControlFrame(frame);
+      }));
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillOnce(Invoke([this](const QuicFrame& frame) {
+        EXPECT_EQ(WINDOW_UPDATE_FRAME, frame.type);
+        EXPECT_EQ(number_of_frames_ + 3, GetControlFrameId(frame));
+        return ClearControlFrame(frame);
+      }));
+  manager_->WriteOrBufferWindowUpdate(kTestStreamId, 200);
+  EXPECT_FALSE(manager_->HasDeferredFrames());
+
+  // Or when the session asks for them.
+  manager_->WriteOrBufferBlocked(kTestStreamId + 2);
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillOnce(Invoke(&ClearControlFrame));
+  manager_->WriteDeferredFrames();
+  EXPECT_FALSE(manager_->HasDeferredFrames());
+  EXPECT_EQ(4u, manager_->num_packets_saved());
+  EXPECT_FALSE(manager_->WillingToWrite());
+
+  // Frames written while a packet flusher is attached would have shared a
+  // packet anyway.
+  {
+    QuicConnection::ScopedPacketFlusher flusher(connection_);
+    manager_->WriteOrBufferBlocked(kTestStreamId + 4);
+  }
+  EXPECT_EQ(4u, manager_->num_packets_saved());
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillOnce(Invoke(&ClearControlFrame));
+  manager_->WriteDeferredFrames();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -43,9 +43,13 @@ QuicFlowController::QuicFlowController(
       receive_window_size_(receive_window_offset),
       receive_window_size_limit_(receive_window_size_limit),
       auto_tune_receive_window_(should_auto_tune_receive_window),
+      bdp_receive_window_tuning_(
+          !is_connection_flow_controller &&
+          session->flow_controller()->bdp_receive_window_tuning()),
       session_flow_controller_(session_flow_controller),
       last_blocked_send_window_offset_(0),
-      prev_window_update_time_(QuicTime::Zero()) {
+      prev_window_update_time_(QuicTime::Zero()),
+      prev_window_update_received_offset_(0) {
   DCHECK_LE(receive_window_size_, receive_window_size_limit_);
   DCHECK_EQ(is_connection_flow_controller_,
             QuicUtils::GetInvalidStreamId(
@@ -127,6 +131,9 @@ void QuicFlowController::MaybeIncreaseMaxWindowSize() {
   QuicTime now = connection_->clock()->ApproximateNow();
   QuicTime prev = prev_window_update_time_;
   prev_window_update_time_ = now;
+  const QuicByteCount bytes_received_since_last =
+      highest_received_byte_offset_ - prev_window_update_received_offset_;
+  prev_window_update_received_offset_ = highest_received_byte_offset_;
   if (!prev.IsInitialized()) {
     QUIC_DVLOG(1) << ENDPOINT << "first window update for stream " << id_;
     return;
@@ -147,14 +154,24 @@ void QuicFlowController::MaybeIncreaseMaxWindowSize() {
   // Now we can compare timing of window updates with RTT.
   QuicTime::Delta since_last = now - prev;
   QuicTime::Delta two_rtt = 2 * rtt;
+  QuicByteCount old_window = receive_window_size_;
 
-  if (since_last >= two_rtt) {
-    // If interval between window updates is sufficiently large, there
-    // is no need to increase receive_window_size_.
-    return;
+  if (bdp_receive_window_tuning_ && !since_last.IsZero() &&
+      bytes_received_since_last > 0) {
+    IncreaseWindowSizeToBdp(QuicBandwidth::FromBytesAndTimeDelta(
+                                bytes_received_since_last, since_last),
+                            rtt);
+    if (receive_window_size_ == old_window) {
+      return;
+    }
+  } else {
+    if (since_last >= two_rtt) {
+      // If interval between window updates is sufficiently large, there
+      // is no need to increase receive_window_size_.
+      return;
+    }
+    IncreaseWindowSize();
   }
-  QuicByteCount old_window = receive_window_size_;
-  IncreaseWindowSize();
 
   if (receive_window_size_ > old_window) {
     QUIC_DVLOG(1) << ENDPOINT << "New max window increase for stream " << id_
@@ -180,6 +197,33 @@ void QuicFlowController::IncreaseWindowSize() {
       std::min(receive_window_size_, receive_window_size_limit_);
 }
 
+void QuicFlowController::IncreaseWindowSizeToBdp(QuicBandwidth delivery_rate,
+                                                 QuicTime::Delta rtt) {
+  const QuicByteCount bdp_window =
+      kBdpReceiveWindowMultiplier * delivery_rate.ToBytesPerPeriod(rtt);
+  receive_window_size_ = std::max(
+      receive_window_size_, std::min(bdp_window, BdpWindowSizeLimit()));
+}
+
+QuicByteCount QuicFlowController::BdpWindowSizeLimit() const {
+  if (is_connection_flow_controller_) {
+    return receive_window_size_limit_;
+  }
+  // Leave room in the connection window for the streams to share.
+  return std::min<QuicByteCount>(
+      receive_window_size_limit_,
+      session_->flow_controller()->receive_window_size_limit() /
+          kSessionFlowControlMultiplier);
+}
+
+void QuicFlowController::EnableBdpReceiveWindowTuning(
+    QuicByteCount memory_limit) {
+  DCHECK(is_connection_flow_controller_);
+  auto_tune_receive_window_ = true;
+  bdp_receive_window_tuning_ = true;
+  receive_window_size_limit_ = std::max(memory_limit, receive_window_size_);
+}
+
 QuicByteCount QuicFlowController::WindowUpdateThreshold() {
   return receive_window_size_ / 2;
 }
@@ -196,6 +240,7 @@ void QuicFlowController::MaybeSendWindowUpdate() {
     // Treat the initial window as if it is a window update, so if 1/2 the
     // window is used in less than 2 RTTs, the window is increased.
     prev_window_update_time_ = connection_->clock()->ApproximateNow();
+    prev_window_update_received_offset_ = highest_received_byte_offset_;
   }
 
   if (available_window >= threshold) {
@@ -264,6 +309,19 @@ bool QuicFlowController::UpdateSendWindowOffset(
 }
 
 void QuicFlowController::EnsureWindowAtLeast(QuicByteCount window_size) {
+  if (bdp_receive_window_tuning_) {
+    // Grow the connection window along with the stream windows, within the
+    // memory limit.
+    if (receive_window_size_ >= window_size ||
+        receive_window_size_ >= receive_window_size_limit_) {
+      return;
+    }
+    QuicStreamOffset available_window =
+        receive_window_offset_ - bytes_consumed_;
+    receive_window_size_ = std::min(window_size, receive_window_size_limit_);
+    UpdateReceiveWindowOffsetAndSendWindowUpdate(available_window);
+    return;
+  }
   if (receive_window_size_limit_ >= window_size) {
     return;
   }
@@ -5,6 +5,7 @@
 #ifndef QUICHE_QUIC_CORE_QUIC_FLOW_CONTROLLER_H_
 #define QUICHE_QUIC_CORE_QUIC_FLOW_CONTROLLER_H_
 
+#include "net/third_party/quiche/src/quic/core/quic_bandwidth.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
 
@@ -21,6 +22,10 @@ class QuicSession;
 // stream's flow control window.
 const float kSessionFlowControlMultiplier = 1.5;
 
+// With BDP receive window tuning, how much larger the receive window is made
+// relative to the bandwidth-delay product observed by the receiver.
+const float kBdpReceiveWindowMultiplier = 2;
+
 class QUIC_EXPORT_PRIVATE QuicFlowControllerInterface {
  public:
   virtual ~QuicFlowControllerInterface() {}
@@ -105,6 +110,22 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
 
   bool auto_tune_receive_window() { return auto_tune_receive_window_; }
 
+  // Switches auto-tuning of this connection flow controller, and of the flow
+  // controllers of streams created afterwards, from doubling the window to
+  // sizing it from the bandwidth-delay product: the rate at which the peer
+  // delivered data since the previous WINDOW_UPDATE, times the smoothed RTT.  A
+  // window far too small for the path is grown to its final size in a single
+  // update, instead of once per doubling.  |memory_limit| caps the connection
+  // receive window, and therefore the data buffered by all the streams of the
+  // session; stream windows are capped accordingly.
+  void EnableBdpReceiveWindowTuning(QuicByteCount memory_limit);
+
+  bool bdp_receive_window_tuning() const { return bdp_receive_window_tuning_; }
+
+  QuicByteCount receive_window_size_limit() const {
+    return receive_window_size_limit_;
+  }
+
  private:
   friend class test::QuicFlowControllerPeer;
 
@@ -121,6 +142,14 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
   // Double the window size as long as we haven't hit the max window size.
   void IncreaseWindowSize();
 
+  // Grows the window to kBdpReceiveWindowMultiplier times the product of
+  // |delivery_rate| and |rtt|, as long as we haven't hit the max window size.
+  void IncreaseWindowSizeToBdp(QuicBandwidth delivery_rate,
+                               QuicTime::Delta rtt);
+
+  // Largest window BDP tuning may grow this flow controller to.
+  QuicByteCount BdpWindowSizeLimit() const;
+
   // The parent session/connection, used to send connection close on flow
   // control violation, and WINDOW_UPDATE and BLOCKED frames when appropriate.
   // Not owned.
@@ -186,6 +215,10 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
   // Used to dynamically enable receive window auto-tuning.
   bool auto_tune_receive_window_;
 
+  // Whether auto-tuning sizes the window from the bandwidth-delay product
+  // rather than doubling it.
+  bool bdp_receive_window_tuning_;
+
   // The session's flow controller.  null if this is stream id 0.
   // Not owned.
   QuicFlowControllerInterface* session_flow_controller_;
@@ -200,6 +233,10 @@ class QUIC_EXPORT_PRIVATE QuicFlowController
   // Keep time of the last time a window update was sent.  We use this
   // as part of the receive window auto tuning.
   QuicTime prev_window_update_time_;
+
+  // Value of highest_received_byte_offset_ at prev_window_update_time_, from
+  // which BDP tuning measures the rate at which the peer delivers data.
+  QuicByteCount prev_window_update_received_offset_;
 };
 
 }  // namespace quic
@@ -40,6 +40,10 @@ class QuicFlowControllerTest : public QuicTest {
     connection_ = new MockQuicConnection(&helper_, &alarm_factory_,
                                          Perspective::IS_CLIENT);
     session_ = QuicMakeUnique<MockQuicSession>(connection_);
+    if (bdp_memory_limit_ > 0) {
+      session_->flow_controller()->EnableBdpReceiveWindowTuning(
+          bdp_memory_limit_);
+    }
     flow_controller_ = QuicMakeUnique<QuicFlowController>(
         session_.get(), stream_id_, /*is_connection_flow_controller*/ false,
         send_window_, receive_window_, kStreamReceiveWindowLimit,
@@ -57,6 +61,8 @@ class QuicFlowControllerTest : public QuicTest {
   std::unique_ptr<MockQuicSession> session_;
   MockFlowController session_flow_controller_;
   bool should_auto_tune_receive_window_ = false;
+  // Enables BDP receive window tuning with this memory limit if not 0.
+  QuicByteCount bdp_memory_limit_ = 0;
 };
 
 TEST_F(QuicFlowControllerTest, SendingBytes) {
@@ -288,6 +294,69 @@ TEST_F(QuicFlowControllerTest, ReceivingBytesFastNoAutoTune) {
   EXPECT_EQ(new_threshold, threshold);
 }
 
+TEST_F(QuicFlowControllerTest, ReceivingBytesFastBdpTuning) {
+  should_auto_tune_receive_window_ = true;
+  bdp_memory_limit_ = kSessionReceiveWindowLimit;
+  Initialize();
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .Times(2)
+      .WillRepeatedly(Invoke(&ClearControlFrame));
+  EXPECT_CALL(session_flow_controller_, EnsureWindowAtLeast(_)).Times(2);
+
+  // Make sure clock is inititialized.
+  connection_->AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+
+  QuicSentPacketManager* manager =
+      QuicConnectionPeer::GetSentPacketManager(connection_);
+  RttStats* rtt_stats = const_cast<RttStats*>(manager->GetRttStats());
+  rtt_stats->UpdateRtt(QuicTime::Delta::FromMilliseconds(kRtt),
+                       QuicTime::Delta::Zero(), QuicTime::Zero());
+
+  // The first WINDOW_UPDATE has no delivery rate sample, the window doubles.
+  QuicByteCount threshold =
+      QuicFlowControllerPeer::WindowUpdateThreshold(flow_controller_.get());
+  QuicStreamOffset receive_offset = threshold + 1;
+  EXPECT_TRUE(flow_controller_->UpdateHighestReceivedOffset(receive_offset));
+  flow_controller_->AddBytesConsumed(threshold + 1);
+  EXPECT_EQ(2 * kInitialSessionFlowControlWindowForTest,
+            QuicFlowControllerPeer::ReceiveWindowSize(flow_controller_.get()));
+
+  // Half of the window arriving in a tenth of an RTT reveals a bandwidth-delay
+  // product far above the window, which grows to its limit at once.
+  connection_->AdvanceTime(QuicTime::Delta::FromMilliseconds(kRtt / 10));
+  threshold =
+      QuicFlowControllerPeer::WindowUpdateThreshold(flow_controller_.get());
+  receive_offset += threshold + 1;
+  EXPECT_TRUE(flow_controller_->UpdateHighestReceivedOffset(receive_offset));
+  flow_controller_->AddBytesConsumed(threshold + 1);
+  EXPECT_FALSE(flow_controller_->FlowControlViolation());
+  EXPECT_EQ(kStreamReceiveWindowLimit,
+            QuicFlowControllerPeer::ReceiveWindowSize(flow_controller_.get()));
+}
+
+TEST_F(QuicFlowControllerTest, BdpTuningSessionMemoryLimit) {
+  bdp_memory_limit_ = 8 * 1024 * 1024;
+  Initialize();
+  QuicFlowController* session_flow_controller = session_->flow_controller();
+  EXPECT_TRUE(session_flow_controller->bdp_receive_window_tuning());
+  EXPECT_TRUE(session_flow_controller->auto_tune_receive_window());
+  EXPECT_EQ(bdp_memory_limit_,
+            session_flow_controller->receive_window_size_limit());
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .Times(2)
+      .WillRepeatedly(Invoke(&ClearControlFrame));
+
+  // The connection window follows the stream windows up to the memory limit.
+  session_flow_controller->EnsureWindowAtLeast(4 * 1024 * 1024);
+  EXPECT_EQ(4u * 1024 * 1024,
+            QuicFlowControllerPeer::ReceiveWindowSize(session_flow_controller));
+  session_flow_controller->EnsureWindowAtLeast(100 * 1024 * 1024);
+  EXPECT_EQ(bdp_memory_limit_,
+            QuicFlowControllerPeer::ReceiveWindowSize(session_flow_controller));
+  // No update is sent once the limit is reached.
+  session_flow_controller->EnsureWindowAtLeast(100 * 1024 * 1024);
+}
+
 TEST_F(QuicFlowControllerTest, ReceivingBytesNormalStableFlowWindow) {
   should_auto_tune_receive_window_ = true;
   Initialize();
@@ -0,0 +1,229 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_incremental_write_scheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+QuicIncrementalWriteScheduler::QuicIncrementalWriteScheduler(int32_t quantum)
+    : quantum_(quantum),
+      ready_levels_(0),
+      num_ready_streams_(0),
+      last_popped_stream_id_(std::numeric_limits<QuicStreamId>::max()) {
+  DCHECK_LT(0, quantum_);
+}
+
+QuicIncrementalWriteScheduler::~QuicIncrementalWriteScheduler() {}
+
+void QuicIncrementalWriteScheduler::RegisterStream(QuicStreamId stream_id,
+                                                   spdy::SpdyPriority urgency,
+                                                   bool incremental) {
+  DCHECK_LE(urgency, spdy::kV3LowestPriority);
+  StreamInfo info = {urgency, incremental, /*ready=*/false, quantum_};
+  if (!stream_infos_.insert({stream_id, info}).second) {
+    QUIC_BUG << "Stream " << stream_id << " already registered";
+  }
+}
+
+void QuicIncrementalWriteScheduler::UnregisterStream(QuicStreamId stream_id) {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_BUG << "Stream " << stream_id << " not registered";
+    return;
+  }
+  if (it->second.ready) {
+    RemoveFromQueue(stream_id, it->second);
+    --num_ready_streams_;
+  }
+  stream_infos_.erase(it);
+  if (last_popped_stream_id_ == stream_id) {
+    last_popped_stream_id_ = std::numeric_limits<QuicStreamId>::max();
+  }
+}
+
+bool QuicIncrementalWriteScheduler::StreamRegistered(
+    QuicStreamId stream_id) const {
+  return stream_infos_.find(stream_id) != stream_infos_.end();
+}
+
+void QuicIncrementalWriteScheduler::UpdateStreamUrgency(
+    QuicStreamId stream_id,
+    spdy::SpdyPriority urgency) {
+  DCHECK_LE(urgency, spdy::kV3LowestPriority);
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    // Streams may be closed before their urgency is updated.
+    QUIC_DVLOG(1) << "Stream " << stream_id << " not registered";
+    return;
+  }
+  StreamInfo& info = it->second;
+  if (info.urgency == urgency) {
+    return;
+  }
+  if (info.ready) {
+    RemoveFromQueue(stream_id, info);
+    info.urgency = urgency;
+    AddToQueue(stream_id, &info, /*push_front=*/false);
+    return;
+  }
+  info.urgency = urgency;
+}
+
+void QuicIncrementalWriteScheduler::UpdateStreamIncremental(
+    QuicStreamId stream_id,
+    bool incremental) {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_DVLOG(1) << "Stream " << stream_id << " not registered";
+    return;
+  }
+  StreamInfo& info = it->second;
+  if (info.incremental == incremental) {
+    return;
+  }
+  if (info.ready) {
+    RemoveFromQueue(stream_id, info);
+    info.incremental = incremental;
+    AddToQueue(stream_id, &info, /*push_front=*/false);
+    return;
+  }
+  info.incremental = incremental;
+}
+
+void QuicIncrementalWriteScheduler::MarkStreamReady(QuicStreamId stream_id) {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_BUG << "Stream " << stream_id << " not registered";
+    return;
+  }
+  StreamInfo& info = it->second;
+  if (info.ready) {
+    return;
+  }
+  const bool continues_turn =
+      stream_id == last_popped_stream_id_ &&
+      (!info.incremental || info.deficit > 0);
+  info.ready = true;
+  ++num_ready_streams_;
+  AddToQueue(stream_id, &info, continues_turn);
+}
+
+QuicStreamId QuicIncrementalWriteScheduler::PopNextReadyStream() {
+  const spdy::SpdyPriority urgency = MostUrgentReadyLevel();
+  if (urgency > spdy::kV3LowestPriority) {
+    QUIC_BUG << "No ready streams available";
+    return std::numeric_limits<QuicStreamId>::max();
+  }
+  UrgencyLevel& level = levels_[urgency];
+  QuicDeque<QuicStreamId>* queue = level.non_incremental.empty()
+                                       ? &level.incremental
+                                       : &level.non_incremental;
+  const QuicStreamId stream_id = queue->front();
+  queue->pop_front();
+  if (level.empty()) {
+    ready_levels_ &= ~(1u << urgency);
+  }
+  stream_infos_[stream_id].ready = false;
+  --num_ready_streams_;
+  last_popped_stream_id_ = stream_id;
+  return stream_id;
+}
+
+void QuicIncrementalWriteScheduler::UpdateBytesForStream(QuicStreamId stream_id,
+                                                         size_t bytes) {
+  if (stream_id != last_popped_stream_id_) {
+    return;
+  }
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    return;
+  }
+  // Clamping to -quantum_ bounds the debt carried to the next turn.
+  const int64_t deficit =
+      static_cast<int64_t>(it->second.deficit) - static_cast<int64_t>(bytes);
+  it->second.deficit =
+      static_cast<int32_t>(std::max<int64_t>(deficit, -quantum_));
+}
+
+bool QuicIncrementalWriteScheduler::ShouldYield(QuicStreamId stream_id) const {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_BUG << "Stream " << stream_id << " not registered";
+    return false;
+  }
+  const StreamInfo& info = it->second;
+
+  // Yield to any more urgent stream.
+  if ((ready_levels_ & ((1u << info.urgency) - 1)) != 0) {
+    return true;
+  }
+
+  // Within the same urgency, yield unless this stream is next up.
+  const UrgencyLevel& level = levels_[info.urgency];
+  if (!level.non_incremental.empty()) {
+    return level.non_incremental.front() != stream_id;
+  }
+  // Non-incremental streams go before incremental ones.
+  if (level.incremental.empty() || !info.incremental) {
+    return false;
+  }
+  return level.incremental.front() != stream_id;
+}
+
+bool QuicIncrementalWriteScheduler::IsStreamReady(
+    QuicStreamId stream_id) const {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_DLOG(INFO) << "Stream " << stream_id << " not registered";
+    return false;
+  }
+  return it->second.ready;
+}
+
+void QuicIncrementalWriteScheduler::RemoveFromQueue(QuicStreamId stream_id,
+                                                    const StreamInfo& info) {
+  UrgencyLevel& level = levels_[info.urgency];
+  QuicDeque<QuicStreamId>* queue = level.QueueFor(info);
+  // Linear, but only reached when a blocked stream is closed or reprioritized.
+  auto it = std::find(queue->begin(), queue->end(), stream_id);
+  if (it == queue->end()) {
+    QUIC_BUG << "Ready stream " << stream_id << " missing from its queue";
+    return;
+  }
+  queue->erase(it);
+  if (level.empty()) {
+    ready_levels_ &= ~(1u << info.urgency);
+  }
+}
+
+void QuicIncrementalWriteScheduler::AddToQueue(QuicStreamId stream_id,
+                                               StreamInfo* info,
+                                               bool push_front) {
+  QuicDeque<QuicStreamId>* queue = levels_[info->urgency].QueueFor(*info);
+  if (push_front) {
+    queue->push_front(stream_id);
+  } else {
+    // Start a new turn, deducting the overrun of the previous one, if any.
+    info->deficit = quantum_ + std::min<int32_t>(info->deficit, 0);
+    queue->push_back(stream_id);
+  }
+  ready_levels_ |= 1u << info->urgency;
+}
+
+spdy::SpdyPriority QuicIncrementalWriteScheduler::MostUrgentReadyLevel() const {
+  spdy::SpdyPriority urgency = spdy::kV3HighestPriority;
+  while (urgency <= spdy::kV3LowestPriority &&
+         (ready_levels_ & (1u << urgency)) == 0) {
+    ++urgency;
+  }
+  return urgency;
+}
+
+}  // namespace quic
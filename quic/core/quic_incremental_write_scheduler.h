@@ -0,0 +1,109 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_INCREMENTAL_WRITE_SCHEDULER_H_
+#define QUICHE_QUIC_CORE_QUIC_INCREMENTAL_WRITE_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
+
+namespace quic {
+
+// Write scheduler for data streams following the HTTP/3 priority scheme:
+// every stream has an urgency, reusing the eight SPDY3 priority levels, and an
+// incremental bit.  Streams of a higher urgency are always served first.
+// Within an urgency, non-incremental streams are served one after the other in
+// the order they became ready, then incremental streams take turns.  A turn
+// lasts until the stream has written |quantum| bytes, after which it goes to
+// the back of the queue; bytes written in excess are deducted from its next
+// turn, up to one quantum.
+//
+// Marking a stream ready and popping the next ready stream are O(1).
+class QUIC_EXPORT_PRIVATE QuicIncrementalWriteScheduler {
+ public:
+  explicit QuicIncrementalWriteScheduler(int32_t quantum);
+  QuicIncrementalWriteScheduler(const QuicIncrementalWriteScheduler&) = delete;
+  QuicIncrementalWriteScheduler& operator=(
+      const QuicIncrementalWriteScheduler&) = delete;
+  ~QuicIncrementalWriteScheduler();
+
+  void RegisterStream(QuicStreamId stream_id,
+                      spdy::SpdyPriority urgency,
+                      bool incremental);
+  void UnregisterStream(QuicStreamId stream_id);
+  bool StreamRegistered(QuicStreamId stream_id) const;
+
+  void UpdateStreamUrgency(QuicStreamId stream_id, spdy::SpdyPriority urgency);
+  void UpdateStreamIncremental(QuicStreamId stream_id, bool incremental);
+
+  // Marks |stream_id| ready to write.  The most recently popped stream resumes
+  // its turn at the front of its queue if it is non-incremental, or if it has
+  // not used up its quantum yet.  Other streams go to the back.
+  void MarkStreamReady(QuicStreamId stream_id);
+
+  // Returns the next stream to write and marks it not ready.  Must only be
+  // called if HasReadyStreams().
+  QuicStreamId PopNextReadyStream();
+
+  // Charges |bytes| written by |stream_id| against its current turn.
+  void UpdateBytesForStream(QuicStreamId stream_id, size_t bytes);
+
+  // Returns true if a ready stream would be popped before |stream_id|.
+  bool ShouldYield(QuicStreamId stream_id) const;
+
+  bool IsStreamReady(QuicStreamId stream_id) const;
+  bool HasReadyStreams() const { return num_ready_streams_ > 0; }
+  size_t NumReadyStreams() const { return num_ready_streams_; }
+  size_t NumRegisteredStreams() const { return stream_infos_.size(); }
+
+ private:
+  struct StreamInfo {
+    spdy::SpdyPriority urgency;
+    bool incremental;
+    bool ready;
+    // Bytes left in the current turn.  Negative if the stream overran it.
+    int32_t deficit;
+  };
+
+  // Ready streams of one urgency.
+  struct UrgencyLevel {
+    QuicDeque<QuicStreamId> non_incremental;
+    QuicDeque<QuicStreamId> incremental;
+
+    bool empty() const {
+      return non_incremental.empty() && incremental.empty();
+    }
+    QuicDeque<QuicStreamId>* QueueFor(const StreamInfo& info) {
+      return info.incremental ? &incremental : &non_incremental;
+    }
+  };
+
+  // Removes a ready stream from its queue, keeping it marked ready.
+  void RemoveFromQueue(QuicStreamId stream_id, const StreamInfo& info);
+  // Adds a ready stream to its queue.
+  void AddToQueue(QuicStreamId stream_id, StreamInfo* info, bool push_front);
+
+  // Returns the most urgent level with ready streams, or
+  // spdy::kV3LowestPriority + 1 if there is none.
+  spdy::SpdyPriority MostUrgentReadyLevel() const;
+
+  const int32_t quantum_;
+  QuicUnorderedMap<QuicStreamId, StreamInfo> stream_infos_;
+  UrgencyLevel levels_[spdy::kV3LowestPriority + 1];
+  // Bit i is set if levels_[i] is not empty.
+  uint8_t ready_levels_;
+  size_t num_ready_streams_;
+  // The stream returned by the last PopNextReadyStream() call, whose turn
+  // continues if it becomes ready again.
+  QuicStreamId last_popped_stream_id_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_INCREMENTAL_WRITE_SCHEDULER_H_
@@ -0,0 +1,140 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_incremental_write_scheduler.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+using spdy::kV3HighestPriority;
+using spdy::kV3LowestPriority;
+
+namespace quic {
+namespace test {
+namespace {
+
+const int32_t kQuantum = 1000;
+
+class QuicIncrementalWriteSchedulerTest : public QuicTest {
+ public:
+  QuicIncrementalWriteSchedulerTest() : scheduler_(kQuantum) {}
+
+ protected:
+  QuicIncrementalWriteScheduler scheduler_;
+};
+
+TEST_F(QuicIncrementalWriteSchedulerTest, UrgencyOrder) {
+  scheduler_.RegisterStream(4, kV3LowestPriority, true);
+  scheduler_.RegisterStream(8, kV3HighestPriority, true);
+  scheduler_.RegisterStream(12, 3, false);
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+
+  scheduler_.MarkStreamReady(4);
+  scheduler_.MarkStreamReady(12);
+  scheduler_.MarkStreamReady(8);
+  // Marking a ready stream again has no effect.
+  scheduler_.MarkStreamReady(8);
+  EXPECT_EQ(3u, scheduler_.NumReadyStreams());
+  EXPECT_TRUE(scheduler_.IsStreamReady(4));
+
+  EXPECT_EQ(8u, scheduler_.PopNextReadyStream());
+  EXPECT_FALSE(scheduler_.IsStreamReady(8));
+  EXPECT_EQ(12u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+}
+
+TEST_F(QuicIncrementalWriteSchedulerTest, NonIncrementalFirst) {
+  scheduler_.RegisterStream(4, 3, true);
+  scheduler_.RegisterStream(8, 3, false);
+  scheduler_.RegisterStream(12, 3, false);
+  scheduler_.MarkStreamReady(4);
+  scheduler_.MarkStreamReady(8);
+  scheduler_.MarkStreamReady(12);
+
+  EXPECT_TRUE(scheduler_.ShouldYield(4));
+  EXPECT_FALSE(scheduler_.ShouldYield(8));
+  EXPECT_TRUE(scheduler_.ShouldYield(12));
+
+  // A non-incremental stream keeps writing until it is done, regardless of the
+  // quantum.
+  EXPECT_EQ(8u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(8, 10 * kQuantum);
+  scheduler_.MarkStreamReady(8);
+  EXPECT_EQ(8u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(12u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+}
+
+TEST_F(QuicIncrementalWriteSchedulerTest, RoundRobinWithQuantum) {
+  scheduler_.RegisterStream(4, 3, true);
+  scheduler_.RegisterStream(8, 3, true);
+  scheduler_.RegisterStream(12, 3, true);
+  scheduler_.MarkStreamReady(4);
+  scheduler_.MarkStreamReady(8);
+  scheduler_.MarkStreamReady(12);
+
+  // Stream 4 keeps its turn while it has not written a full quantum.
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(4, kQuantum - 1);
+  scheduler_.MarkStreamReady(4);
+  EXPECT_FALSE(scheduler_.ShouldYield(4));
+  EXPECT_TRUE(scheduler_.ShouldYield(8));
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(4, 1);
+  scheduler_.MarkStreamReady(4);
+
+  // Then the other streams take their turn.
+  EXPECT_EQ(8u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(8, kQuantum);
+  scheduler_.MarkStreamReady(8);
+  EXPECT_EQ(12u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(12, kQuantum);
+  scheduler_.MarkStreamReady(12);
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+}
+
+TEST_F(QuicIncrementalWriteSchedulerTest, OverrunShortensNextTurn) {
+  scheduler_.RegisterStream(4, 3, true);
+  scheduler_.RegisterStream(8, 3, true);
+  scheduler_.MarkStreamReady(4);
+  scheduler_.MarkStreamReady(8);
+
+  // Stream 4 overruns its turn by half a quantum.
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(4, kQuantum + kQuantum / 2);
+  scheduler_.MarkStreamReady(4);
+  EXPECT_EQ(8u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(8, kQuantum);
+  scheduler_.MarkStreamReady(8);
+
+  // Its next turn only lasts half a quantum.
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+  scheduler_.UpdateBytesForStream(4, kQuantum / 2);
+  scheduler_.MarkStreamReady(4);
+  EXPECT_EQ(8u, scheduler_.PopNextReadyStream());
+}
+
+TEST_F(QuicIncrementalWriteSchedulerTest, UpdateWhileReady) {
+  scheduler_.RegisterStream(4, 3, true);
+  scheduler_.RegisterStream(8, 3, true);
+  scheduler_.RegisterStream(12, 5, true);
+  scheduler_.MarkStreamReady(4);
+  scheduler_.MarkStreamReady(8);
+  scheduler_.MarkStreamReady(12);
+
+  scheduler_.UpdateStreamUrgency(12, kV3HighestPriority);
+  scheduler_.UpdateStreamIncremental(8, false);
+  EXPECT_EQ(3u, scheduler_.NumReadyStreams());
+  EXPECT_EQ(12u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(8u, scheduler_.PopNextReadyStream());
+
+  scheduler_.UnregisterStream(4);
+  EXPECT_FALSE(scheduler_.StreamRegistered(4));
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+  EXPECT_EQ(2u, scheduler_.NumRegisteredStreams());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
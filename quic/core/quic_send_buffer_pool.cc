@@ -0,0 +1,137 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_send_buffer_pool.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+
+namespace quic {
+
+namespace {
+
+// Every buffer is preceded by a header recording its capacity, keeping the
+// data maximally aligned.
+const size_t kHeaderSize = alignof(std::max_align_t);
+static_assert(kHeaderSize >= sizeof(size_t), "Header too small");
+
+std::atomic<QuicByteCount> g_process_buffered_bytes(0);
+std::atomic<QuicByteCount> g_process_budget(0);
+
+size_t GetCapacity(const char* buffer) {
+  size_t capacity;
+  memcpy(&capacity, buffer - kHeaderSize, sizeof(capacity));
+  return capacity;
+}
+
+}  // namespace
+
+QuicSendBufferPool::QuicSendBufferPool()
+    : QuicSendBufferPool(kDefaultSendBufferChunkSize,
+                         kDefaultMaxFreeSendBufferChunks) {}
+
+QuicSendBufferPool::QuicSendBufferPool(size_t chunk_size,
+                                       size_t max_free_chunks)
+    : chunk_size_(chunk_size),
+      max_free_chunks_(max_free_chunks),
+      buffered_bytes_(0),
+      session_budget_(0),
+      delegate_(nullptr) {
+  DCHECK_LT(0u, chunk_size_);
+}
+
+QuicSendBufferPool::~QuicSendBufferPool() {
+  QUIC_DLOG_IF(WARNING, buffered_bytes_ != 0)
+      << "Send buffer pool destroyed with " << buffered_bytes_
+      << " bytes buffered";
+  g_process_buffered_bytes -= buffered_bytes_;
+  MarkAllocatorIdle();
+}
+
+char* QuicSendBufferPool::New(size_t size) {
+  if (size > chunk_size_) {
+    return Allocate(size);
+  }
+  if (free_chunks_.empty()) {
+    return Allocate(chunk_size_);
+  }
+  char* buffer = free_chunks_.back();
+  free_chunks_.pop_back();
+  return buffer;
+}
+
+char* QuicSendBufferPool::New(size_t size, bool /*flag_enable*/) {
+  return New(size);
+}
+
+void QuicSendBufferPool::Delete(char* buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  if (GetCapacity(buffer) == chunk_size_ &&
+      free_chunks_.size() < max_free_chunks_) {
+    free_chunks_.push_back(buffer);
+    return;
+  }
+  delete[](buffer - kHeaderSize);
+}
+
+void QuicSendBufferPool::MarkAllocatorIdle() {
+  for (char* buffer : free_chunks_) {
+    delete[](buffer - kHeaderSize);
+  }
+  free_chunks_.clear();
+}
+
+void QuicSendBufferPool::OnBytesBuffered(QuicByteCount bytes) {
+  buffered_bytes_ += bytes;
+  g_process_buffered_bytes += bytes;
+}
+
+void QuicSendBufferPool::OnBytesReleased(QuicByteCount bytes) {
+  if (bytes > buffered_bytes_) {
+    QUIC_BUG << "Releasing " << bytes << " bytes while only "
+             << buffered_bytes_ << " are buffered";
+    bytes = buffered_bytes_;
+  }
+  buffered_bytes_ -= bytes;
+  g_process_buffered_bytes -= bytes;
+  if (buffered_bytes_ == 0) {
+    // Idle sessions keep no chunks.
+    MarkAllocatorIdle();
+  }
+  if (delegate_ != nullptr) {
+    delegate_->OnSendBufferMemoryReleased();
+  }
+}
+
+bool QuicSendBufferPool::IsOverBudget() const {
+  if (session_budget_ > 0 && buffered_bytes_ >= session_budget_) {
+    return true;
+  }
+  const QuicByteCount process_budget = g_process_budget;
+  return process_budget > 0 && buffered_bytes_ > 0 &&
+         g_process_buffered_bytes >= process_budget;
+}
+
+// static
+void QuicSendBufferPool::SetProcessBudget(QuicByteCount budget) {
+  g_process_budget = budget;
+}
+
+// static
+QuicByteCount QuicSendBufferPool::ProcessBufferedBytes() {
+  return g_process_buffered_bytes;
+}
+
+char* QuicSendBufferPool::Allocate(size_t capacity) {
+  char* allocation = new char[kHeaderSize + capacity];
+  memcpy(allocation, &capacity, sizeof(capacity));
+  return allocation + kHeaderSize;
+}
+
+}  // namespace quic
@@ -0,0 +1,100 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_SEND_BUFFER_POOL_H_
+#define QUICHE_QUIC_CORE_QUIC_SEND_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/quic_buffer_allocator.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+
+namespace quic {
+
+// Default size of the chunks stream data is copied into.
+const size_t kDefaultSendBufferChunkSize = 4096;
+
+// Default number of released chunks a pool keeps for reuse.
+const size_t kDefaultMaxFreeSendBufferChunks = 64;
+
+// Session-wide allocator and memory accountant for stream send buffers.
+//
+// As an allocator, it hands out fixed-size chunks from a free list, so that
+// streams copying application data do not hit the system allocator for every
+// chunk.  Requests for other sizes are passed through.  The free list is
+// emptied whenever the send buffers of the session hold no more data.
+//
+// As an accountant, it tracks the bytes held by the send buffers of a session,
+// and across all the sessions of the process.  Once the session budget, or the
+// process budget, is exceeded, streams stop accepting new data until the peer
+// acknowledges enough of it.  The process budget only blocks sessions which
+// hold buffered data themselves, so that each blocked session is eventually
+// unblocked by its own acks.
+class QUIC_EXPORT_PRIVATE QuicSendBufferPool : public QuicBufferAllocator {
+ public:
+  class QUIC_EXPORT_PRIVATE Delegate {
+   public:
+    virtual ~Delegate() {}
+
+    // Called whenever send buffers release bytes, which may bring the pool
+    // back under budget.
+    virtual void OnSendBufferMemoryReleased() = 0;
+  };
+
+  QuicSendBufferPool();
+  QuicSendBufferPool(size_t chunk_size, size_t max_free_chunks);
+  QuicSendBufferPool(const QuicSendBufferPool&) = delete;
+  QuicSendBufferPool& operator=(const QuicSendBufferPool&) = delete;
+  ~QuicSendBufferPool() override;
+
+  // QuicBufferAllocator
+  char* New(size_t size) override;
+  char* New(size_t size, bool flag_enable) override;
+  void Delete(char* buffer) override;
+  void MarkAllocatorIdle() override;
+
+  // Called by send buffers when they start or stop holding |bytes| of stream
+  // data.
+  void OnBytesBuffered(QuicByteCount bytes);
+  void OnBytesReleased(QuicByteCount bytes);
+
+  // Returns true if streams of this session should not accept new data.
+  bool IsOverBudget() const;
+
+  // |delegate| is not owned, and may be null.
+  void set_delegate(Delegate* delegate) { delegate_ = delegate; }
+
+  // Maximum bytes buffered by this session.  0 means unlimited, the default.
+  void set_session_budget(QuicByteCount budget) { session_budget_ = budget; }
+  QuicByteCount session_budget() const { return session_budget_; }
+
+  // Maximum bytes buffered by all sessions of the process.  0 means unlimited,
+  // the default.  Thread-safe.
+  static void SetProcessBudget(QuicByteCount budget);
+  static QuicByteCount ProcessBufferedBytes();
+
+  size_t chunk_size() const { return chunk_size_; }
+  QuicByteCount buffered_bytes() const { return buffered_bytes_; }
+  size_t num_free_chunks() const { return free_chunks_.size(); }
+
+ private:
+  // Allocates a buffer able to hold |capacity| bytes.
+  char* Allocate(size_t capacity);
+
+  const size_t chunk_size_;
+  const size_t max_free_chunks_;
+  // Released chunks, ready for reuse.
+  std::vector<char*> free_chunks_;
+
+  QuicByteCount buffered_bytes_;
+  QuicByteCount session_budget_;
+
+  Delegate* delegate_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_SEND_BUFFER_POOL_H_
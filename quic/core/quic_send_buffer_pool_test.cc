@@ -0,0 +1,127 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_send_buffer_pool.h"
+
+#include <cstring>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+
+namespace quic {
+namespace test {
+namespace {
+
+class QuicSendBufferPoolTest : public QuicTest {
+ public:
+  QuicSendBufferPoolTest() : pool_(1024, 2) {}
+
+  ~QuicSendBufferPoolTest() override {
+    QuicSendBufferPool::SetProcessBudget(0);
+  }
+
+ protected:
+  QuicSendBufferPool pool_;
+};
+
+TEST_F(QuicSendBufferPoolTest, ReusesChunks) {
+  char* chunk1 = pool_.New(1024);
+  char* chunk2 = pool_.New(100);
+  char* chunk3 = pool_.New(1024);
+  memset(chunk1, 'a', 1024);
+  memset(chunk2, 'b', 1024);
+  pool_.Delete(chunk1);
+  pool_.Delete(chunk2);
+  // The pool keeps at most 2 free chunks.
+  pool_.Delete(chunk3);
+  EXPECT_EQ(2u, pool_.num_free_chunks());
+
+  // Freed chunks are handed out again, whatever the requested size up to the
+  // chunk size.
+  EXPECT_EQ(chunk2, pool_.New(10));
+  EXPECT_EQ(chunk1, pool_.New(1024));
+  EXPECT_EQ(0u, pool_.num_free_chunks());
+  pool_.Delete(chunk1);
+  pool_.Delete(chunk2);
+
+  pool_.MarkAllocatorIdle();
+  EXPECT_EQ(0u, pool_.num_free_chunks());
+}
+
+TEST_F(QuicSendBufferPoolTest, FreesChunksOnceNothingIsBuffered) {
+  char* chunk1 = pool_.New(1024);
+  char* chunk2 = pool_.New(1024);
+  pool_.OnBytesBuffered(2048);
+  pool_.Delete(chunk1);
+  pool_.OnBytesReleased(1024);
+  EXPECT_EQ(1u, pool_.num_free_chunks());
+
+  pool_.Delete(chunk2);
+  pool_.OnBytesReleased(1024);
+  EXPECT_EQ(0u, pool_.num_free_chunks());
+}
+
+TEST_F(QuicSendBufferPoolTest, LargeBuffersAreNotPooled) {
+  char* buffer = pool_.New(4096, true);
+  memset(buffer, 'a', 4096);
+  pool_.Delete(buffer);
+  EXPECT_EQ(0u, pool_.num_free_chunks());
+  pool_.Delete(nullptr);
+}
+
+TEST_F(QuicSendBufferPoolTest, SessionBudget) {
+  EXPECT_FALSE(pool_.IsOverBudget());
+  pool_.OnBytesBuffered(5000);
+  // Unlimited by default.
+  EXPECT_FALSE(pool_.IsOverBudget());
+
+  pool_.set_session_budget(4000);
+  EXPECT_TRUE(pool_.IsOverBudget());
+  pool_.OnBytesReleased(1001);
+  EXPECT_FALSE(pool_.IsOverBudget());
+  EXPECT_EQ(3999u, pool_.buffered_bytes());
+  pool_.OnBytesReleased(3999);
+}
+
+class MockDelegate : public QuicSendBufferPool::Delegate {
+ public:
+  MOCK_METHOD0(OnSendBufferMemoryReleased, void());
+};
+
+TEST_F(QuicSendBufferPoolTest, NotifiesDelegateOfReleasedBytes) {
+  MockDelegate delegate;
+  pool_.set_delegate(&delegate);
+  pool_.OnBytesBuffered(100);
+  EXPECT_CALL(delegate, OnSendBufferMemoryReleased()).Times(2);
+  pool_.OnBytesReleased(60);
+  pool_.OnBytesReleased(40);
+
+  pool_.set_delegate(nullptr);
+  pool_.OnBytesBuffered(100);
+  pool_.OnBytesReleased(100);
+}
+
+TEST_F(QuicSendBufferPoolTest, ProcessBudget) {
+  QuicSendBufferPool other_pool;
+  const QuicByteCount initial_bytes =
+      QuicSendBufferPool::ProcessBufferedBytes();
+  QuicSendBufferPool::SetProcessBudget(initial_bytes + 3000);
+
+  other_pool.OnBytesBuffered(3000);
+  EXPECT_EQ(initial_bytes + 3000, QuicSendBufferPool::ProcessBufferedBytes());
+  EXPECT_TRUE(other_pool.IsOverBudget());
+  // Sessions without buffered data are never blocked, so that they are not
+  // left without acks to unblock them.
+  EXPECT_FALSE(pool_.IsOverBudget());
+  pool_.OnBytesBuffered(1);
+  EXPECT_TRUE(pool_.IsOverBudget());
+
+  other_pool.OnBytesReleased(3000);
+  EXPECT_FALSE(pool_.IsOverBudget());
+  pool_.OnBytesReleased(1);
+  EXPECT_EQ(initial_bytes, QuicSendBufferPool::ProcessBufferedBytes());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
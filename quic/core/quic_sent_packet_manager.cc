@@ -169,6 +169,9 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
   if (config.HasClientRequestedIndependentOption(kTBBR, perspective)) {
     SetSendAlgorithm(kBBR);
   }
+  if (config.HasClientRequestedIndependentOption(kB2ON, perspective)) {
+    SetSendAlgorithm(kBBRv2);
+  }
   if (config.HasClientRequestedIndependentOption(kRENO, perspective)) {
     SetSendAlgorithm(kRenoBytes);
   } else if (config.HasClientRequestedIndependentOption(kBYTE, perspective) ||
@@ -226,6 +229,9 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
   if (config.HasClientRequestedIndependentOption(kLFAK, perspective)) {
     uber_loss_algorithm_.SetLossDetectionType(kLazyFack);
   }
+  if (config.HasClientRequestedIndependentOption(kRACK, perspective)) {
+    uber_loss_algorithm_.SetLossDetectionType(kAdaptiveReordering);
+  }
   if (config.HasClientSentConnectionOption(kCONH, perspective)) {
     conservative_handshake_retransmits_ = true;
   }
@@ -1048,7 +1054,8 @@ const QuicTime::Delta QuicSentPacketManager::GetRetransmissionDelay(
 }
 
 QuicTime::Delta QuicSentPacketManager::GetSlowStartDuration() const {
-  if (send_algorithm_->GetCongestionControlType() != kBBR) {
+  if (send_algorithm_->GetCongestionControlType() != kBBR &&
+      send_algorithm_->GetCongestionControlType() != kBBRv2) {
     return QuicTime::Delta::Infinite();
   }
 
@@ -53,6 +53,8 @@ QuicSession::QuicSession(QuicConnection* connection,
     : connection_(connection),
       visitor_(owner),
       write_blocked_streams_(connection->transport_version()),
+      send_buffer_pool_enabled_(false),
+      compact_zombie_streams_(false),
       config_(config),
       stream_id_manager_(this,
                          kDefaultMaxStreamsPerConnection,
@@ -91,6 +93,7 @@ QuicSession::QuicSession(QuicConnection* connection,
   closed_streams_clean_up_alarm_ =
       QuicWrapUnique<QuicAlarm>(connection_->alarm_factory()->CreateAlarm(
           new ClosedStreamsCleanUpDelegate(this)));
+  send_buffer_pool_.set_delegate(this);
 }
 
 void QuicSession::Initialize() {
@@ -115,6 +118,9 @@ void QuicSession::Initialize() {
 
 QuicSession::~QuicSession() {
   QUIC_LOG_IF(WARNING, !zombie_streams_.empty()) << "Still have zombie streams";
+  // Data streams, and their send buffers, are destroyed with the members of
+  // this session, which must not be notified by then.
+  send_buffer_pool_.set_delegate(nullptr);
 }
 
 void QuicSession::RegisterStaticStream(std::unique_ptr<QuicStream> stream,
@@ -568,6 +574,10 @@ void QuicSession::OnCanWrite() {
   if (control_frame_manager_.WillingToWrite()) {
     control_frame_manager_.OnCanWrite();
   }
+  if (control_frame_manager_.defer_non_urgent_frames()) {
+    // Deferred control frames share the packets written below.
+    control_frame_manager_.WriteDeferredFrames();
+  }
   for (size_t i = 0; i < num_writes; ++i) {
     if (!(write_blocked_streams_.HasWriteBlockedSpecialStream() ||
           write_blocked_streams_.HasWriteBlockedDataStreams())) {
@@ -672,8 +682,16 @@ QuicConsumedData QuicSession::WritevData(QuicStream* stream,
     return QuicConsumedData(0, false);
   }
 
-  QuicConsumedData data =
-      connection_->SendStreamData(id, write_length, offset, state);
+  QuicConsumedData data(0, false);
+  if (control_frame_manager_.defer_non_urgent_frames() &&
+      control_frame_manager_.HasDeferredFrames()) {
+    // Bundle deferred control frames with the stream data.
+    QuicConnection::ScopedPacketFlusher flusher(connection_);
+    control_frame_manager_.WriteDeferredFrames();
+    data = connection_->SendStreamData(id, write_length, offset, state);
+  } else {
+    data = connection_->SendStreamData(id, write_length, offset, state);
+  }
   if (offset >= stream->stream_bytes_written()) {
     // This is new stream data.
     write_blocked_streams_.UpdateBytesForStream(id, data.bytes_consumed);
@@ -866,6 +884,11 @@ void QuicSession::CloseStreamInner(QuicStreamId stream_id, bool locally_reset) {
 
   stream->OnClose();
 
+  // OnClose() may have found the stream done waiting for acks.
+  if (compact_zombie_streams_ && QuicContainsKey(zombie_streams_, stream_id)) {
+    stream->ReleaseStateWhileWaitingForAcks();
+  }
+
   if (!stream_was_draining && !IsIncomingStream(stream_id) && had_fin_or_rst &&
       !VersionHasIetfQuicFrames(connection_->transport_version())) {
     // Streams that first became draining already called OnCanCreate...
@@ -995,6 +1018,19 @@ void QuicSession::OnConfigNegotiated() {
       if (ContainsQuicTag(config_.ReceivedConnectionOptions(), kIFWA)) {
         AdjustInitialFlowControlWindows(1024 * 1024);
       }
+      if (ContainsQuicTag(config_.ReceivedConnectionOptions(), kSBMB)) {
+        EnableSendBufferPool(1024 * 1024);
+      }
+      if (ContainsQuicTag(config_.ReceivedConnectionOptions(), kDNUF)) {
+        control_frame_manager_.set_defer_non_urgent_frames(true);
+      }
+      if (ContainsQuicTag(config_.ReceivedConnectionOptions(), kBDPW)) {
+        flow_controller_.EnableBdpReceiveWindowTuning(
+            flow_controller_.receive_window_size_limit());
+      }
+      if (ContainsQuicTag(config_.ReceivedConnectionOptions(), kCZMB)) {
+        set_compact_zombie_streams(true);
+      }
     }
 
     config_.SetStatelessResetTokenToSend(GetStatelessResetToken());
@@ -1172,6 +1208,14 @@ void QuicSession::UpdateStreamPriority(QuicStreamId id,
   write_blocked_streams()->UpdateStreamPriority(id, new_priority);
 }
 
+void QuicSession::UpdateStreamIncremental(QuicStreamId id, bool incremental) {
+  write_blocked_streams()->UpdateStreamIncremental(id, incremental);
+}
+
+void QuicSession::SetStreamSchedulingPolicy(QuicStreamSchedulingPolicy policy) {
+  write_blocked_streams()->SetSchedulingPolicy(policy);
+}
+
 QuicConfig* QuicSession::config() {
   return &config_;
 }
@@ -1384,6 +1428,36 @@ size_t QuicSession::GetNumDrainingStreams() const {
   return draining_streams_.size();
 }
 
+void QuicSession::EnableSendBufferPool(QuicByteCount session_budget) {
+  send_buffer_pool_enabled_ = true;
+  send_buffer_pool_.set_session_budget(session_budget);
+}
+
+void QuicSession::MarkStreamBlockedOnSendBuffer(QuicStreamId id) {
+  QUIC_DVLOG(1) << ENDPOINT << "Stream " << id
+                << " blocked on send buffer memory, "
+                << send_buffer_pool_.buffered_bytes() << " bytes buffered";
+  streams_blocked_on_send_buffer_.insert(id);
+}
+
+void QuicSession::OnSendBufferMemoryReleased() {
+  MaybeResumeStreamsBlockedOnSendBuffer();
+}
+
+void QuicSession::MaybeResumeStreamsBlockedOnSendBuffer() {
+  if (streams_blocked_on_send_buffer_.empty() ||
+      send_buffer_pool_.IsOverBudget()) {
+    return;
+  }
+  for (QuicStreamId id : streams_blocked_on_send_buffer_) {
+    // Streams may have been closed in the meantime.
+    if (stream_map_.find(id) != stream_map_.end()) {
+      write_blocked_streams_.AddStream(id);
+    }
+  }
+  streams_blocked_on_send_buffer_.clear();
+}
+
 void QuicSession::MarkConnectionLevelWriteBlocked(QuicStreamId id) {
   if (GetOrCreateStream(id) == nullptr) {
     QUIC_BUG << "Marking unknown stream " << id << " blocked.";
@@ -1402,6 +1476,12 @@ bool QuicSession::HasDataToWrite() const {
 }
 
 void QuicSession::OnAckNeedsRetransmittableFrame() {
+  if (control_frame_manager_.defer_non_urgent_frames() &&
+      control_frame_manager_.HasDeferredFrames()) {
+    // Deferred control frames make the ack retransmittable.
+    control_frame_manager_.WriteDeferredFrames();
+    return;
+  }
   flow_controller_.SendWindowUpdate();
 }
 
@@ -1806,6 +1886,22 @@ void QuicSession::OnMessageLost(QuicMessageId message_id) {
 
 void QuicSession::CleanUpClosedStreams() {
   closed_streams_.clear();
+  if (sequencer_block_pool_.num_blocks_in_use() == 0) {
+    // No stream holds received data, so keep no blocks around for it.
+    sequencer_block_pool_.ReleaseFreeBlocks();
+  }
+  if (!compact_zombie_streams_) {
+    return;
+  }
+  // Bursts of closed streams would otherwise pin the peak capacity for the
+  // lifetime of the connection.
+  ClosedStreams().swap(closed_streams_);
+  if (draining_streams_.empty()) {
+    QuicUnorderedSet<QuicStreamId>().swap(draining_streams_);
+  }
+  if (streams_waiting_for_acks_.empty()) {
+    QuicUnorderedSet<QuicStreamId>().swap(streams_waiting_for_acks_);
+  }
 }
 
 bool QuicSession::session_decides_what_to_write() const {
@@ -20,8 +20,10 @@
 #include "net/third_party/quiche/src/quic/core/quic_error_codes.h"
 #include "net/third_party/quiche/src/quic/core/quic_packet_creator.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
+#include "net/third_party/quiche/src/quic/core/quic_send_buffer_pool.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream_frame_data_producer.h"
+#include "net/third_party/quiche/src/quic/core/quic_stream_sequencer_buffer.h"
 #include "net/third_party/quiche/src/quic/core/quic_write_blocked_list.h"
 #include "net/third_party/quiche/src/quic/core/session_notifier_interface.h"
 #include "net/third_party/quiche/src/quic/core/uber_quic_stream_id_manager.h"
@@ -40,9 +42,11 @@ namespace test {
 class QuicSessionPeer;
 }  // namespace test
 
-class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
-                                        public SessionNotifierInterface,
-                                        public QuicStreamFrameDataProducer {
+class QUIC_EXPORT_PRIVATE QuicSession
+    : public QuicConnectionVisitorInterface,
+      public SessionNotifierInterface,
+      public QuicStreamFrameDataProducer,
+      public QuicSendBufferPool::Delegate {
  public:
   // An interface from the session to the entity owning the session.
   // This lets the session notify its owner (the Dispatcher) when the connection
@@ -151,6 +155,9 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   bool HasUnackedCryptoData() const override;
   bool HasUnackedStreamData() const override;
 
+  // QuicSendBufferPool::Delegate methods:
+  void OnSendBufferMemoryReleased() override;
+
   // Called on every incoming packet. Passes |packet| through to |connection_|.
   virtual void ProcessUdpPacket(const QuicSocketAddress& self_address,
                                 const QuicSocketAddress& peer_address,
@@ -266,11 +273,43 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // list.
   virtual void UpdateStreamPriority(QuicStreamId id,
                                     spdy::SpdyPriority new_priority);
+  // Marks a data stream as incremental or not in the write blocked list.  Only
+  // has an effect under QuicStreamSchedulingPolicy::kIncrementalRoundRobin.
+  void UpdateStreamIncremental(QuicStreamId id, bool incremental);
+
+  // Selects how the write blocked list orders data streams of the same
+  // priority.  Must be called before any data stream is created.
+  void SetStreamSchedulingPolicy(QuicStreamSchedulingPolicy policy);
 
   // Returns mutable config for this session. Returned config is owned
   // by QuicSession.
   QuicConfig* config();
 
+  // Makes the send buffers of data streams created from now on allocate from
+  // send_buffer_pool() and account their memory to it, limited to
+  // |session_budget| bytes.  0 means unlimited.
+  void EnableSendBufferPool(QuicByteCount session_budget);
+  bool send_buffer_pool_enabled() const { return send_buffer_pool_enabled_; }
+
+  // Returns the pool the send buffers of data streams allocate from and
+  // account their memory to, if send_buffer_pool_enabled().
+  QuicSendBufferPool* send_buffer_pool() { return &send_buffer_pool_; }
+
+  // Returns the pool the sequencer buffers of streams allocate their blocks
+  // from.
+  QuicStreamSequencerBuffer::BlockPool* sequencer_block_pool() {
+    return &sequencer_block_pool_;
+  }
+
+  // If true, closed streams kept as zombies while their data is waiting for
+  // acks release all other state, and the containers of closed streams give
+  // their memory back once empty. False by default, enabled on servers by
+  // the CZMB connection option.
+  void set_compact_zombie_streams(bool compact_zombie_streams) {
+    compact_zombie_streams_ = compact_zombie_streams;
+  }
+  bool compact_zombie_streams() const { return compact_zombie_streams_; }
+
   // Returns true if the stream existed previously and has been closed.
   // Returns false if the stream is still active or if the stream has
   // not yet been created.
@@ -319,6 +358,11 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // WINDOW_UPDATE arrives.
   void MarkConnectionLevelWriteBlocked(QuicStreamId id);
 
+  // Called by stream |id| when it refused new data because the send buffer
+  // pool is over budget.  The stream will be given a chance to write once acks,
+  // or closed streams, release enough memory.
+  void MarkStreamBlockedOnSendBuffer(QuicStreamId id);
+
   // Called when stream |id| is done waiting for acks either because all data
   // gets acked or is not interested in data being acked (which happens when
   // a stream is reset because of an error).
@@ -602,6 +646,10 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // Closes the pending stream |stream_id| before it has been created.
   void ClosePendingStream(QuicStreamId stream_id);
 
+  // Marks the streams waiting for send buffer memory write blocked if the pool
+  // is back under budget.
+  void MaybeResumeStreamsBlockedOnSendBuffer();
+
   // Creates or gets pending stream, feeds it with |frame|, and processes the
   // pending stream.
   void PendingStreamOnStreamFrame(const QuicStreamFrame& frame);
@@ -630,11 +678,29 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // destructors, so the write blocked list must outlive all streams.
   QuicWriteBlockedList write_blocked_streams_;
 
+  // Send buffers of data streams hold memory allocated by the pool, so it must
+  // outlive all streams.
+  QuicSendBufferPool send_buffer_pool_;
+
+  // Whether new data streams use |send_buffer_pool_|.
+  bool send_buffer_pool_enabled_;
+
+  // Sequencer buffers of streams hold blocks allocated by the pool, so it must
+  // outlive all streams.
+  QuicStreamSequencerBuffer::BlockPool sequencer_block_pool_;
+
+  // Streams which refused new data because |send_buffer_pool_| was over
+  // budget.
+  QuicUnorderedSet<QuicStreamId> streams_blocked_on_send_buffer_;
+
   ClosedStreams closed_streams_;
   // Streams which are closed, but need to be kept alive. Currently, the only
   // reason is the stream's sent data (including FIN) does not get fully acked.
   ZombieStreamMap zombie_streams_;
 
+  // Whether zombie streams are compacted, see set_compact_zombie_streams().
+  bool compact_zombie_streams_;
+
   QuicConfig config_;
 
   // Map from StreamId to pointers to streams. Owns the streams.
@@ -133,6 +133,7 @@ class TestStream : public QuicStream {
 
   MOCK_CONST_METHOD0(HasPendingRetransmission, bool());
   MOCK_METHOD1(OnStopSending, void(uint16_t code));
+  MOCK_METHOD0(ReleaseStateWhileWaitingForAcks, void());
 };
 
 class TestSession : public QuicSession {
@@ -305,6 +306,7 @@ class TestSession : public QuicSession {
 
   using QuicSession::ActivateStream;
   using QuicSession::closed_streams;
+  using QuicSession::control_frame_manager;
   using QuicSession::zombie_streams;
 
  private:
@@ -1612,6 +1614,63 @@ TEST_P(QuicSessionTestServer, CustomFlowControlWindow) {
                              session_.flow_controller()));
 }
 
+TEST_P(QuicSessionTestServer, SendBufferBudgetConnectionOption) {
+  EXPECT_FALSE(session_.send_buffer_pool_enabled());
+  QuicTagVector copt;
+  copt.push_back(kSBMB);
+  QuicConfigPeer::SetReceivedConnectionOptions(session_.config(), copt);
+
+  session_.OnConfigNegotiated();
+  EXPECT_TRUE(session_.send_buffer_pool_enabled());
+  EXPECT_EQ(1024 * 1024u, session_.send_buffer_pool()->session_budget());
+
+  // Data streams created from now on account their memory to the pool.
+  session_.set_writev_consumes_all_data(true);
+  TestStream* stream = session_.CreateOutgoingBidirectionalStream();
+  stream->WriteOrBufferData(std::string(100, '.'), false, nullptr);
+  EXPECT_EQ(100u, session_.send_buffer_pool()->buffered_bytes());
+}
+
+TEST_P(QuicSessionTestServer, DeferNonUrgentFramesConnectionOption) {
+  EXPECT_FALSE(session_.control_frame_manager().defer_non_urgent_frames());
+  QuicTagVector copt;
+  copt.push_back(kDNUF);
+  QuicConfigPeer::SetReceivedConnectionOptions(session_.config(), copt);
+
+  session_.OnConfigNegotiated();
+  EXPECT_TRUE(session_.control_frame_manager().defer_non_urgent_frames());
+}
+
+TEST_P(QuicSessionTestServer, CompactZombieStreamsConnectionOption) {
+  EXPECT_FALSE(session_.compact_zombie_streams());
+  QuicTagVector copt;
+  copt.push_back(kCZMB);
+  QuicConfigPeer::SetReceivedConnectionOptions(session_.config(), copt);
+
+  session_.OnConfigNegotiated();
+  EXPECT_TRUE(session_.compact_zombie_streams());
+}
+
+TEST_P(QuicSessionTestServer, BdpReceiveWindowTuningConnectionOption) {
+  TestStream* stream2 = session_.CreateOutgoingBidirectionalStream();
+  EXPECT_FALSE(session_.flow_controller()->bdp_receive_window_tuning());
+  EXPECT_FALSE(stream2->flow_controller()->bdp_receive_window_tuning());
+  QuicTagVector copt;
+  copt.push_back(kBDPW);
+  QuicConfigPeer::SetReceivedConnectionOptions(session_.config(), copt);
+
+  session_.OnConfigNegotiated();
+  EXPECT_TRUE(session_.flow_controller()->bdp_receive_window_tuning());
+  EXPECT_TRUE(session_.flow_controller()->auto_tune_receive_window());
+  EXPECT_EQ(kSessionReceiveWindowLimit,
+            session_.flow_controller()->receive_window_size_limit());
+  // Only streams created afterwards size their windows from the
+  // bandwidth-delay product.
+  EXPECT_FALSE(stream2->flow_controller()->bdp_receive_window_tuning());
+  TestStream* stream4 = session_.CreateOutgoingBidirectionalStream();
+  EXPECT_TRUE(stream4->flow_controller()->bdp_receive_window_tuning());
+}
+
 TEST_P(QuicSessionTestServer, FlowControlWithInvalidFinalOffset) {
   // Test that if we receive a stream RST with a highest byte offset that
   // violates flow control, that we close the connection.
@@ -1985,6 +2044,43 @@ TEST_P(QuicSessionTestServer, TestZombieStreams) {
   EXPECT_EQ(2u, session_.closed_streams()->size());
 }
 
+TEST_P(QuicSessionTestServer, ResetStreamResumesStreamsBlockedOnSendBuffer) {
+  if (GetParam().handshake_protocol == PROTOCOL_TLS1_3) {
+    // Like OnCanWrite above, this does not work with TLS yet.
+    return;
+  }
+  session_.set_writev_consumes_all_data(true);
+  session_.EnableSendBufferPool(100);
+
+  TestStream* stream2 = session_.CreateOutgoingBidirectionalStream();
+  TestStream* stream4 = session_.CreateOutgoingBidirectionalStream();
+  std::string body(100, '.');
+  stream2->WriteOrBufferData(body, false, nullptr);
+  EXPECT_TRUE(session_.send_buffer_pool()->IsOverBudget());
+
+  // stream2 holds the whole budget, so stream4 is refused new data.
+  struct iovec iov = {const_cast<char*>(body.data()), body.length()};
+  EXPECT_EQ(0u, stream4->WritevData(&iov, 1, false).bytes_consumed);
+  QuicWriteBlockedList* write_blocked_streams =
+      QuicSessionPeer::GetWriteBlockedStreams(&session_);
+  EXPECT_FALSE(write_blocked_streams->IsStreamBlocked(stream4->id()));
+
+  // Resetting stream2 releases its send buffer once the stream is destroyed,
+  // without any data being acked.
+  EXPECT_CALL(*connection_, SendControlFrame(_))
+      .WillRepeatedly(Invoke(&ClearControlFrame));
+  EXPECT_CALL(*connection_,
+              OnStreamReset(stream2->id(), QUIC_STREAM_CANCELLED));
+  stream2->Reset(QUIC_STREAM_CANCELLED);
+  session_.CleanUpClosedStreams();
+  EXPECT_EQ(0u, session_.send_buffer_pool()->buffered_bytes());
+  EXPECT_TRUE(write_blocked_streams->IsStreamBlocked(stream4->id()));
+
+  EXPECT_CALL(*stream4, OnCanWrite());
+  session_.OnCanWrite();
+  EXPECT_EQ(100u, stream4->WritevData(&iov, 1, false).bytes_consumed);
+}
+
 TEST_P(QuicSessionTestServer, OnStreamFrameLost) {
   if (GetParam().handshake_protocol == PROTOCOL_TLS1_3) {
     // TODO(nharper, b/112643533): Figure out why this test fails when TLS is
@@ -2262,6 +2358,31 @@ TEST_P(QuicSessionTestServer, LocallyResetZombieStreams) {
   session_.OnCanWrite();
 }
 
+TEST_P(QuicSessionTestServer, CompactZombieStreams) {
+  if (GetParam().handshake_protocol == PROTOCOL_TLS1_3) {
+    // Like the other zombie stream tests, this does not work with TLS yet.
+    return;
+  }
+  session_.set_compact_zombie_streams(true);
+  session_.set_writev_consumes_all_data(true);
+  TestStream* stream2 = session_.CreateOutgoingBidirectionalStream();
+  std::string body(100, '.');
+  stream2->CloseReadSide();
+  EXPECT_CALL(*stream2, ReleaseStateWhileWaitingForAcks());
+  stream2->WriteOrBufferData(body, true, nullptr);
+  EXPECT_TRUE(QuicContainsKey(session_.zombie_streams(), stream2->id()));
+
+  // The zombie stream still processes acks of its data.
+  QuicStreamFrame frame(stream2->id(), true, 0, 100);
+  session_.OnFrameAcked(QuicFrame(frame), QuicTime::Delta::Zero(),
+                        QuicTime::Zero());
+  EXPECT_FALSE(QuicContainsKey(session_.zombie_streams(), stream2->id()));
+  ASSERT_EQ(1u, session_.closed_streams()->size());
+
+  session_.CleanUpClosedStreams();
+  EXPECT_EQ(0u, session_.closed_streams()->capacity());
+}
+
 TEST_P(QuicSessionTestServer, CleanUpClosedStreamsAlarm) {
   EXPECT_FALSE(
       QuicSessionPeer::GetCleanUpClosedStreamsAlarm(&session_)->IsSet());
@@ -55,7 +55,9 @@ PendingStream::PendingStream(QuicStreamId id, QuicSession* session)
                        kStreamReceiveWindowLimit,
                        session_->flow_controller()->auto_tune_receive_window(),
                        session_->flow_controller()),
-      sequencer_(this) {}
+      sequencer_(this) {
+  sequencer_.SetBlockPool(session_->sequencer_block_pool());
+}
 
 void PendingStream::OnDataAvailable() {
   // It will be called when pending stream receives its first byte. But this
@@ -222,7 +224,11 @@ QuicStream::QuicStream(QuicStreamId id,
                  0,
                  false,
                  FlowController(id, session, type),
-                 session->flow_controller()) {}
+                 session->flow_controller()) {
+  // Streams created from pending streams keep the pending stream's sequencer,
+  // which already uses the pool.
+  sequencer_.SetBlockPool(session_->sequencer_block_pool());
+}
 
 QuicStream::QuicStream(QuicStreamId id,
                        QuicSession* session,
@@ -278,6 +284,9 @@ QuicStream::QuicStream(QuicStreamId id,
   if (type_ != CRYPTO) {
     session_->RegisterStreamPriority(id, is_static_, priority_);
   }
+  if (!is_static_ && type_ != CRYPTO && session_->send_buffer_pool_enabled()) {
+    send_buffer_.SetPool(session_->send_buffer_pool());
+  }
 }
 
 QuicStream::~QuicStream() {
@@ -487,6 +496,13 @@ void QuicStream::WriteOrBufferData(
     // Write data if there is no buffered data before.
     WriteBufferedData();
   }
+  // The data is accounted to the send buffer pool even if it exceeds the
+  // budget.  In that case, the stream is only resumed through
+  // OnCanWriteNewData() once memory gets released.
+  if (!data.empty() && !fin_buffered_ && !HasSendBufferMemory()) {
+    QUIC_DVLOG(1) << ENDPOINT << "Stream " << id_
+                  << " exceeded the send buffer budget";
+  }
 }
 
 void QuicStream::OnCanWrite() {
@@ -510,7 +526,8 @@ void QuicStream::OnCanWrite() {
   if (HasBufferedData() || (fin_buffered_ && !fin_sent_)) {
     WriteBufferedData();
   }
-  if (!fin_buffered_ && !fin_sent_ && CanWriteNewData()) {
+  if (!fin_buffered_ && !fin_sent_ && CanWriteNewData() &&
+      HasSendBufferMemory()) {
     // Notify upper layer to write new data when buffered data size is below
     // low water mark.
     OnCanWriteNewData();
@@ -574,7 +591,7 @@ QuicConsumedData QuicStream::WritevData(const struct iovec* iov,
   }
 
   bool had_buffered_data = HasBufferedData();
-  if (CanWriteNewData()) {
+  if (CanWriteNewData() && HasSendBufferMemory()) {
     // Save all data if buffered data size is below low water mark.
     consumed_data.bytes_consumed = write_length;
     if (consumed_data.bytes_consumed > 0) {
@@ -619,7 +636,7 @@ QuicConsumedData QuicStream::WriteMemSlices(QuicMemSliceSpan span, bool fin) {
   }
 
   bool had_buffered_data = HasBufferedData();
-  if (CanWriteNewData() || span.empty()) {
+  if (span.empty() || CanBufferNewData()) {
     consumed_data.fin_consumed = fin;
     if (!span.empty()) {
       // Buffer all data if buffered data size is below limit.
@@ -736,6 +753,12 @@ void QuicStream::OnClose() {
   AddBytesConsumed(bytes_to_consume);
 }
 
+void QuicStream::ReleaseStateWhileWaitingForAcks() {
+  // The stream is closed, so data left in the sequencer, e.g. received out of
+  // order before a reset, is never read.  The send buffer is still needed.
+  sequencer_.ReleaseBuffer();
+}
+
 void QuicStream::OnWindowUpdateFrame(const QuicWindowUpdateFrame& frame) {
   if (GetQuicReloadableFlag(quic_no_window_update_on_read_only_stream) &&
       type_ == READ_UNIDIRECTIONAL) {
@@ -1031,6 +1054,20 @@ bool QuicStream::CanWriteNewData() const {
   return BufferedDataBytes() < buffered_data_threshold_;
 }
 
+bool QuicStream::HasSendBufferMemory() {
+  if (send_buffer_.pool() == nullptr || !send_buffer_.pool()->IsOverBudget()) {
+    return true;
+  }
+  session_->MarkStreamBlockedOnSendBuffer(id_);
+  return false;
+}
+
+bool QuicStream::CanBufferNewData() {
+  // Only check the send buffer memory once the stream itself can take more
+  // data, since HasSendBufferMemory() registers the stream to be resumed.
+  return CanWriteNewData() && HasSendBufferMemory();
+}
+
 bool QuicStream::CanWriteNewDataAfterData(QuicByteCount length) const {
   return (BufferedDataBytes() + length) < buffered_data_threshold_;
 }
@@ -167,6 +167,11 @@ class QUIC_EXPORT_PRIVATE QuicStream
   // a RST_STREAM has been sent.
   virtual void OnClose();
 
+  // Called by the session after OnClose if the stream is kept as a zombie
+  // because its data is waiting for acks. Releases state which is not needed
+  // to process acks, losses and retransmissions of that data.
+  virtual void ReleaseStateWhileWaitingForAcks();
+
   // Called by the session when the endpoint receives a RST_STREAM from the
   // peer.
   virtual void OnStreamReset(const QuicRstStreamFrame& frame);
@@ -269,6 +274,8 @@ class QUIC_EXPORT_PRIVATE QuicStream
   // and then buffers any remaining data in queued_data_.
   // If fin is true: if it is immediately passed on to the session,
   // write_side_closed() becomes true, otherwise fin_buffered_ becomes true.
+  // The data counts against the send buffer budget of the session, but is
+  // accepted even beyond it.
   void WriteOrBufferData(
       QuicStringPiece data,
       bool fin,
@@ -317,6 +324,10 @@ class QUIC_EXPORT_PRIVATE QuicStream
   // that data copy is avoided.
   QuicConsumedData WriteMemSlices(QuicMemSliceSpan span, bool fin);
 
+  // Returns true if WriteMemSlices() would buffer new data now.  Otherwise,
+  // returns false, and OnCanWriteNewData() is called once it would.
+  bool CanBufferNewData();
+
   // Returns true if any stream data is lost (including fin) and needs to be
   // retransmitted.
   virtual bool HasPendingRetransmission() const;
@@ -386,6 +397,11 @@ class QUIC_EXPORT_PRIVATE QuicStream
   // Called when upper layer can write new data.
   virtual void OnCanWriteNewData() {}
 
+  // Returns true if the session's send buffer pool is under budget.
+  // Otherwise, returns false and asks the session to resume this stream once
+  // memory gets released.
+  bool HasSendBufferMemory();
+
   // Called when |bytes_consumed| bytes has been consumed.
   virtual void OnStreamDataConsumed(size_t bytes_consumed);
 
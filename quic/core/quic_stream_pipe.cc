@@ -0,0 +1,87 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_stream_pipe.h"
+
+#include "net/third_party/quiche/src/quic/core/quic_stream.h"
+#include "net/third_party/quiche/src/quic/core/quic_stream_sequencer_buffer.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_arraysize.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice_storage.h"
+
+namespace quic {
+
+namespace {
+
+// Maximum number of readable regions forwarded by one write to the sink.
+const size_t kMaxRegionsPerWrite = 16;
+
+}  // namespace
+
+QuicStreamPipe::QuicStreamPipe(QuicStream* source,
+                               QuicStreamSequencer* source_sequencer,
+                               QuicStream* sink,
+                               QuicBufferAllocator* allocator)
+    : source_(source),
+      source_sequencer_(source_sequencer),
+      sink_(sink),
+      allocator_(allocator),
+      fin_forwarded_(false),
+      bytes_forwarded_(0) {
+  DCHECK(source_ != nullptr);
+  DCHECK(source_sequencer_ != nullptr);
+  DCHECK(sink_ != nullptr);
+  DCHECK_NE(source_, sink_);
+}
+
+QuicStreamPipe::~QuicStreamPipe() {}
+
+QuicByteCount QuicStreamPipe::Pump() {
+  QuicStreamSequencer* sequencer = source_sequencer_;
+  QuicByteCount bytes_forwarded = 0;
+  while (!fin_forwarded_ && !source_->reading_stopped() &&
+         !sink_->write_side_closed()) {
+    iovec iov[kMaxRegionsPerWrite];
+    const int num_regions =
+        sequencer->GetReadableRegions(iov, QUIC_ARRAYSIZE(iov));
+    QuicByteCount length = 0;
+    for (int i = 0; i < num_regions; ++i) {
+      length += iov[i].iov_len;
+    }
+    const bool fin =
+        sequencer->NumBytesConsumed() + length == sequencer->close_offset();
+    if (length == 0 && !fin) {
+      break;
+    }
+    if (length > 0 && !sink_->CanBufferNewData()) {
+      break;
+    }
+
+    // A readable region never spans more than one sequencer buffer block, so
+    // each region is copied into a single slice.
+    QuicMemSliceStorage storage(iov, num_regions, allocator_,
+                                QuicStreamSequencerBuffer::kBlockSizeBytes);
+    const QuicConsumedData consumed =
+        sink_->WriteMemSlices(storage.ToSpan(), fin);
+    if (consumed.bytes_consumed == 0 && !consumed.fin_consumed) {
+      break;
+    }
+    if (consumed.bytes_consumed > 0) {
+      sequencer->MarkConsumed(consumed.bytes_consumed);
+      bytes_forwarded += consumed.bytes_consumed;
+    }
+    if (consumed.fin_consumed) {
+      QUIC_DVLOG(1) << "Forwarded fin of stream " << source_->id()
+                    << " to stream " << sink_->id();
+      fin_forwarded_ = true;
+      if (sequencer->IsClosed()) {
+        source_->OnFinRead();
+      }
+    }
+  }
+  bytes_forwarded_ += bytes_forwarded;
+  return bytes_forwarded;
+}
+
+}  // namespace quic
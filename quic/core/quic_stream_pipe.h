@@ -0,0 +1,62 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_CORE_QUIC_STREAM_PIPE_H_
+#define QUICHE_QUIC_CORE_QUIC_STREAM_PIPE_H_
+
+#include "net/third_party/quiche/src/quic/core/quic_buffer_allocator.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
+
+namespace quic {
+
+class QuicStream;
+class QuicStreamSequencer;
+
+// Forwards the data received on |source| to |sink|, possibly a stream of
+// another session, along with the fin.  Received data is copied straight from
+// the sequencer of |source| into QuicMemSlices which the send buffer of |sink|
+// takes over, without an intermediate application buffer.
+//
+// Data is only read from |source| while |sink| can buffer more of it.  Data
+// left unread in |source| is not consumed, so |source| does not extend its
+// flow control window and the peer of |source| is eventually blocked until
+// |sink| catches up.
+//
+// The pipe does not own the streams.  Their owner drives it by calling Pump()
+// from OnDataAvailable() of |source| and from OnCanWriteNewData() of |sink|,
+// and handles resets and closing of either stream.  |source_sequencer| is the
+// sequencer of |source|, which its owner has access to.
+class QUIC_EXPORT_PRIVATE QuicStreamPipe {
+ public:
+  QuicStreamPipe(QuicStream* source,
+                 QuicStreamSequencer* source_sequencer,
+                 QuicStream* sink,
+                 QuicBufferAllocator* allocator);
+  QuicStreamPipe(const QuicStreamPipe&) = delete;
+  QuicStreamPipe& operator=(const QuicStreamPipe&) = delete;
+  ~QuicStreamPipe();
+
+  // Forwards as much readable data of |source| as |sink| accepts, and the fin
+  // once all data has been forwarded.  Returns the number of bytes forwarded.
+  QuicByteCount Pump();
+
+  // Returns true if the fin of |source| has been forwarded to |sink|.
+  bool fin_forwarded() const { return fin_forwarded_; }
+
+  // Total number of bytes forwarded.
+  QuicByteCount bytes_forwarded() const { return bytes_forwarded_; }
+
+ private:
+  QuicStream* source_;
+  QuicStreamSequencer* source_sequencer_;
+  QuicStream* sink_;
+  QuicBufferAllocator* allocator_;
+  bool fin_forwarded_;
+  QuicByteCount bytes_forwarded_;
+};
+
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_CORE_QUIC_STREAM_PIPE_H_
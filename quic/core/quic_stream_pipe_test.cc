@@ -0,0 +1,138 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/core/quic_stream_pipe.h"
+
+#include <memory>
+#include <string>
+
+#include "net/third_party/quiche/src/quic/core/quic_simple_buffer_allocator.h"
+#include "net/third_party/quiche/src/quic/core/quic_stream.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_config_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_stream_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+using testing::Return;
+using testing::StrictMock;
+
+namespace quic {
+namespace test {
+namespace {
+
+// Stream driving the pipe it is an end of.
+class PipeTestStream : public QuicStream {
+ public:
+  PipeTestStream(QuicStreamId id, QuicSession* session)
+      : QuicStream(id, session, /*is_static=*/false, BIDIRECTIONAL),
+        pipe_(nullptr) {}
+
+  void OnDataAvailable() override {
+    if (pipe_ != nullptr) {
+      pipe_->Pump();
+    }
+  }
+
+  void OnCanWriteNewData() override {
+    if (pipe_ != nullptr) {
+      pipe_->Pump();
+    }
+  }
+
+  void set_pipe(QuicStreamPipe* pipe) { pipe_ = pipe; }
+
+ private:
+  QuicStreamPipe* pipe_;
+};
+
+class QuicStreamPipeTest : public QuicTest {
+ public:
+  QuicStreamPipeTest() {
+    SetQuicFlag(FLAGS_quic_buffered_data_threshold, 100);
+    connection_ = new StrictMock<MockQuicConnection>(
+        &helper_, &alarm_factory_, Perspective::IS_SERVER);
+    session_ = QuicMakeUnique<StrictMock<MockQuicSession>>(connection_);
+    QuicConfigPeer::SetReceivedInitialStreamFlowControlWindow(
+        session_->config(), kMinimumFlowControlSendWindow);
+    EXPECT_CALL(*session_, SendRstStream(_, _, _)).Times(AnyNumber());
+
+    const QuicTransportVersion version = connection_->transport_version();
+    source_ = new PipeTestStream(
+        GetNthClientInitiatedBidirectionalStreamId(version, 0), session_.get());
+    sink_ = new PipeTestStream(
+        GetNthClientInitiatedBidirectionalStreamId(version, 1), session_.get());
+    session_->ActivateStream(QuicWrapUnique(source_));
+    session_->ActivateStream(QuicWrapUnique(sink_));
+
+    pipe_ = QuicMakeUnique<QuicStreamPipe>(
+        source_, QuicStreamPeer::sequencer(source_), sink_, &allocator_);
+    source_->set_pipe(pipe_.get());
+    sink_->set_pipe(pipe_.get());
+  }
+
+  QuicStreamOffset SourceBytesConsumed() {
+    return QuicStreamPeer::sequencer(source_)->NumBytesConsumed();
+  }
+
+ protected:
+  MockQuicConnectionHelper helper_;
+  MockAlarmFactory alarm_factory_;
+  MockQuicConnection* connection_;
+  std::unique_ptr<MockQuicSession> session_;
+  PipeTestStream* source_;
+  PipeTestStream* sink_;
+  SimpleBufferAllocator allocator_;
+  std::unique_ptr<QuicStreamPipe> pipe_;
+};
+
+TEST_F(QuicStreamPipeTest, ForwardsDataAndFin) {
+  // The connection is write blocked, so forwarded data stays buffered in the
+  // sink.
+  EXPECT_CALL(*session_, WritevData(sink_, _, _, _, _))
+      .WillOnce(Return(QuicConsumedData(0, false)));
+  source_->OnStreamFrame(
+      QuicStreamFrame(source_->id(), false, 0, std::string(200, 'a')));
+  EXPECT_EQ(200u, pipe_->bytes_forwarded());
+  EXPECT_EQ(200u, SourceBytesConsumed());
+  EXPECT_EQ(200u, sink_->BufferedDataBytes());
+
+  // The sink is above its buffered data threshold, so new data is left in the
+  // source.
+  source_->OnStreamFrame(
+      QuicStreamFrame(source_->id(), true, 200, std::string(50, 'b')));
+  EXPECT_EQ(0u, pipe_->Pump());
+  EXPECT_EQ(200u, SourceBytesConsumed());
+  EXPECT_FALSE(pipe_->fin_forwarded());
+
+  // Once the sink drains, the rest of the data is forwarded along with the
+  // fin.
+  EXPECT_CALL(*session_, WritevData(sink_, _, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke(MockQuicSession::ConsumeData));
+  sink_->OnCanWrite();
+  EXPECT_EQ(250u, pipe_->bytes_forwarded());
+  EXPECT_EQ(250u, SourceBytesConsumed());
+  EXPECT_TRUE(pipe_->fin_forwarded());
+  EXPECT_TRUE(sink_->fin_sent());
+  EXPECT_TRUE(QuicStreamPeer::read_side_closed(source_));
+  EXPECT_EQ(0u, sink_->BufferedDataBytes());
+}
+
+TEST_F(QuicStreamPipeTest, StopsWhenSinkIsClosed) {
+  EXPECT_CALL(*session_, WritevData(sink_, _, _, _, _)).Times(0);
+  sink_->CloseWriteSide();
+  source_->OnStreamFrame(
+      QuicStreamFrame(source_->id(), false, 0, std::string(200, 'a')));
+  EXPECT_EQ(0u, pipe_->bytes_forwarded());
+  EXPECT_EQ(0u, SourceBytesConsumed());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace quic
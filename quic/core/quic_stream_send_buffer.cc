@@ -6,6 +6,7 @@
 
 #include "net/third_party/quiche/src/quic/core/quic_data_writer.h"
 #include "net/third_party/quiche/src/quic/core/quic_interval.h"
+#include "net/third_party/quiche/src/quic/core/quic_send_buffer_pool.h"
 #include "net/third_party/quiche/src/quic/core/quic_stream_send_buffer.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
@@ -42,11 +43,25 @@ bool StreamPendingRetransmission::operator==(
 QuicStreamSendBuffer::QuicStreamSendBuffer(QuicBufferAllocator* allocator)
     : stream_offset_(0),
       allocator_(allocator),
+      pool_(nullptr),
       stream_bytes_written_(0),
       stream_bytes_outstanding_(0),
       write_index_(-1) {}
 
-QuicStreamSendBuffer::~QuicStreamSendBuffer() {}
+QuicStreamSendBuffer::~QuicStreamSendBuffer() {
+  if (pool_ == nullptr) {
+    return;
+  }
+  for (BufferedSlice& slice : buffered_slices_) {
+    ReleaseMemSlice(&slice.slice);
+  }
+}
+
+void QuicStreamSendBuffer::SetPool(QuicSendBufferPool* pool) {
+  DCHECK_EQ(0u, stream_offset_);
+  allocator_ = pool;
+  pool_ = pool;
+}
 
 void QuicStreamSendBuffer::SaveStreamData(const struct iovec* iov,
                                           int iov_count,
@@ -54,8 +69,13 @@ void QuicStreamSendBuffer::SaveStreamData(const struct iovec* iov,
                                           QuicByteCount data_length) {
   DCHECK_LT(0u, data_length);
   // Latch the maximum data slice size.
-  const QuicByteCount max_data_slice_size =
+  QuicByteCount max_data_slice_size =
       GetQuicFlag(FLAGS_quic_send_buffer_max_data_slice_size);
+  if (pool_ != nullptr) {
+    // Slices are the unit of reuse of the pool, and of release on ack.
+    max_data_slice_size = std::min<QuicByteCount>(max_data_slice_size,
+                                                  pool_->chunk_size());
+  }
   while (data_length > 0) {
     size_t slice_len = std::min(data_length, max_data_slice_size);
     QuicMemSlice slice(allocator_, slice_len);
@@ -75,6 +95,9 @@ void QuicStreamSendBuffer::SaveMemSlice(QuicMemSlice slice) {
     return;
   }
   size_t length = slice.length();
+  if (pool_ != nullptr) {
+    pool_->OnBytesBuffered(length);
+  }
   buffered_slices_.emplace_back(std::move(slice), stream_offset_);
   if (write_index_ == -1) {
     write_index_ = buffered_slices_.size() - 1;
@@ -269,7 +292,7 @@ bool QuicStreamSendBuffer::FreeMemSlices(QuicStreamOffset start,
     }
     if (!it->slice.empty() &&
         bytes_acked_.Contains(it->offset, it->offset + it->slice.length())) {
-      it->slice.Reset();
+      ReleaseMemSlice(&it->slice);
     }
   }
   return true;
@@ -294,6 +317,16 @@ void QuicStreamSendBuffer::CleanUpBufferedSlices() {
   }
 }
 
+void QuicStreamSendBuffer::ReleaseMemSlice(QuicMemSlice* slice) {
+  const QuicByteCount length = slice->length();
+  // Return the memory to the pool before accounting it, so that the pool can
+  // free all of its memory once nothing is buffered.
+  slice->Reset();
+  if (pool_ != nullptr && length > 0) {
+    pool_->OnBytesReleased(length);
+  }
+}
+
 bool QuicStreamSendBuffer::IsStreamDataOutstanding(
     QuicStreamOffset offset,
     QuicByteCount data_length) const {
@@ -21,6 +21,7 @@ class QuicStreamPeer;
 }  // namespace test
 
 class QuicDataWriter;
+class QuicSendBufferPool;
 
 // BufferedSlice comprises information of a piece of stream data stored in
 // contiguous memory space. Please note, BufferedSlice is constructed when
@@ -65,6 +66,12 @@ class QUIC_EXPORT_PRIVATE QuicStreamSendBuffer {
   QuicStreamSendBuffer(QuicStreamSendBuffer&& other) = default;
   ~QuicStreamSendBuffer();
 
+  // Makes this send buffer allocate its slices from |pool| and account the
+  // bytes it holds to |pool|, which must outlive it.  Must be called before any
+  // data is saved.
+  void SetPool(QuicSendBufferPool* pool);
+  QuicSendBufferPool* pool() const { return pool_; }
+
   // Save |data_length| of data starts at |iov_offset| in |iov| to send buffer.
   void SaveStreamData(const struct iovec* iov,
                       int iov_count,
@@ -141,6 +148,9 @@ class QUIC_EXPORT_PRIVATE QuicStreamSendBuffer {
   // Cleanup empty slices in order from buffered_slices_.
   void CleanUpBufferedSlices();
 
+  // Resets |slice| and stops accounting its bytes to |pool_|.
+  void ReleaseMemSlice(QuicMemSlice* slice);
+
   QuicDeque<BufferedSlice> buffered_slices_;
 
   // Offset of next inserted byte.
@@ -148,6 +158,9 @@ class QUIC_EXPORT_PRIVATE QuicStreamSendBuffer {
 
   QuicBufferAllocator* allocator_;
 
+  // Not owned.  May be null.
+  QuicSendBufferPool* pool_;
+
   // Bytes that have been consumed by the stream.
   uint64_t stream_bytes_written_;
 
@@ -7,6 +7,7 @@
 #include <string>
 
 #include "net/third_party/quiche/src/quic/core/quic_data_writer.h"
+#include "net/third_party/quiche/src/quic/core/quic_send_buffer_pool.h"
 #include "net/third_party/quiche/src/quic/core/quic_simple_buffer_allocator.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_expect_bug.h"
@@ -320,6 +321,37 @@ TEST_F(QuicStreamSendBufferTest, SaveEmptyMemSliceSpan) {
   EXPECT_EQ(10u, send_buffer.size());
 }
 
+TEST_F(QuicStreamSendBufferTest, AccountsMemoryToPool) {
+  QuicSendBufferPool pool(1024, 8);
+  {
+    QuicStreamSendBuffer send_buffer(&allocator_);
+    send_buffer.SetPool(&pool);
+
+    // Data is copied in chunks of the pool.
+    std::string data(3000, 'a');
+    struct iovec iov = MakeIovec(data);
+    send_buffer.SaveStreamData(&iov, 1, 0, data.length());
+    EXPECT_EQ(3u, send_buffer.size());
+    EXPECT_EQ(3000u, pool.buffered_bytes());
+
+    char buf[4000];
+    QuicDataWriter writer(4000, buf, HOST_BYTE_ORDER);
+    ASSERT_TRUE(send_buffer.WriteStreamData(0, 3000, &writer));
+    send_buffer.OnStreamDataConsumed(3000);
+
+    // A fully acked chunk is released even if earlier data is outstanding.
+    QuicByteCount newly_acked_length;
+    EXPECT_TRUE(send_buffer.OnStreamDataAcked(1024, 1024, &newly_acked_length));
+    EXPECT_EQ(3000u - 1024, pool.buffered_bytes());
+    EXPECT_TRUE(send_buffer.OnStreamDataAcked(0, 1000, &newly_acked_length));
+    EXPECT_EQ(3000u - 1024, pool.buffered_bytes());
+    EXPECT_TRUE(send_buffer.OnStreamDataAcked(1000, 24, &newly_acked_length));
+    EXPECT_EQ(3000u - 2048, pool.buffered_bytes());
+  }
+  // Destroying the send buffer releases the rest.
+  EXPECT_EQ(0u, pool.buffered_bytes());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -132,6 +132,12 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencer {
   // Free the memory of underlying buffer when no bytes remain in it.
   void ReleaseBufferIfEmpty();
 
+  // Makes the underlying buffer allocate its blocks from |pool|, which must
+  // outlive this sequencer.  Must be called before any data is buffered.
+  void SetBlockPool(QuicStreamSequencerBuffer::BlockPool* pool) {
+    buffered_frames_.SetBlockPool(pool);
+  }
+
   // Number of bytes in the buffer right now.
   size_t NumBytesBuffered() const;
 
@@ -5,6 +5,7 @@
 #include "net/third_party/quiche/src/quic/core/quic_stream_sequencer_buffer.h"
 
 #include <string>
+#include <vector>
 
 #include "net/third_party/quiche/src/quic/core/quic_constants.h"
 #include "net/third_party/quiche/src/quic/core/quic_interval.h"
@@ -29,15 +30,77 @@ const size_t kMaxNumDataIntervalsAllowed = 2 * kMaxPacketGap;
 
 }  // namespace
 
+const size_t QuicStreamSequencerBuffer::kDefaultMaxPooledBlocks;
+
+QuicStreamSequencerBuffer::BlockPool::BlockPool()
+    : BlockPool(kDefaultMaxPooledBlocks) {}
+
+QuicStreamSequencerBuffer::BlockPool::BlockPool(size_t max_free_blocks)
+    : max_free_blocks_(max_free_blocks), num_blocks_in_use_(0) {}
+
+QuicStreamSequencerBuffer::BlockPool::~BlockPool() {
+  QUIC_DLOG_IF(WARNING, num_blocks_in_use_ != 0)
+      << "Block pool destroyed with " << num_blocks_in_use_
+      << " blocks in use";
+  ReleaseFreeBlocks();
+}
+
+QuicStreamSequencerBuffer::BufferBlock*
+QuicStreamSequencerBuffer::BlockPool::New() {
+  ++num_blocks_in_use_;
+  if (free_blocks_.empty()) {
+    return new BufferBlock();
+  }
+  BufferBlock* block = free_blocks_.back();
+  free_blocks_.pop_back();
+  return block;
+}
+
+void QuicStreamSequencerBuffer::BlockPool::Delete(BufferBlock* block) {
+  DCHECK_LT(0u, num_blocks_in_use_);
+  --num_blocks_in_use_;
+  if (free_blocks_.size() < max_free_blocks_) {
+    free_blocks_.push_back(block);
+    return;
+  }
+  delete block;
+}
+
+void QuicStreamSequencerBuffer::BlockPool::ReleaseFreeBlocks() {
+  for (BufferBlock* block : free_blocks_) {
+    delete block;
+  }
+  // Also give back the memory of the vector itself.
+  std::vector<BufferBlock*>().swap(free_blocks_);
+}
+
 QuicStreamSequencerBuffer::QuicStreamSequencerBuffer(size_t max_capacity_bytes)
     : max_buffer_capacity_bytes_(max_capacity_bytes),
       blocks_count_(CalculateBlockCount(max_capacity_bytes)),
       total_bytes_read_(0),
       blocks_(nullptr),
+      single_block_(nullptr),
+      single_block_index_(0),
+      block_pool_(nullptr),
       total_bytes_prefetched_(0) {
   Clear();
 }
 
+QuicStreamSequencerBuffer::QuicStreamSequencerBuffer(
+    QuicStreamSequencerBuffer&& other)
+    : max_buffer_capacity_bytes_(other.max_buffer_capacity_bytes_),
+      blocks_count_(other.blocks_count_),
+      total_bytes_read_(other.total_bytes_read_),
+      blocks_(std::move(other.blocks_)),
+      single_block_(other.single_block_),
+      single_block_index_(other.single_block_index_),
+      block_pool_(other.block_pool_),
+      num_bytes_buffered_(other.num_bytes_buffered_),
+      bytes_received_(std::move(other.bytes_received_)),
+      total_bytes_prefetched_(other.total_bytes_prefetched_) {
+  other.single_block_ = nullptr;
+}
+
 QuicStreamSequencerBuffer::~QuicStreamSequencerBuffer() {
   Clear();
 }
@@ -49,6 +112,8 @@ void QuicStreamSequencerBuffer::Clear() {
         RetireBlock(i);
       }
     }
+  } else if (single_block_ != nullptr) {
+    RetireBlock(single_block_index_);
   }
   num_bytes_buffered_ = 0;
   bytes_received_.Clear();
@@ -56,13 +121,50 @@ void QuicStreamSequencerBuffer::Clear() {
   total_bytes_prefetched_ = total_bytes_read_;
 }
 
+QuicStreamSequencerBuffer::BufferBlock* QuicStreamSequencerBuffer::GetBlock(
+    size_t index) const {
+  if (blocks_ != nullptr) {
+    return blocks_[index];
+  }
+  return index == single_block_index_ ? single_block_ : nullptr;
+}
+
+QuicStreamSequencerBuffer::BufferBlock*
+QuicStreamSequencerBuffer::AllocateBlock(size_t index) {
+  DCHECK(GetBlock(index) == nullptr);
+  BufferBlock* block =
+      block_pool_ != nullptr ? block_pool_->New() : new BufferBlock();
+  if (blocks_ == nullptr) {
+    if (single_block_ == nullptr) {
+      single_block_ = block;
+      single_block_index_ = index;
+      return block;
+    }
+    // A second block is needed, switch to the block array.
+    blocks_.reset(new BufferBlock*[blocks_count_]());
+    blocks_[single_block_index_] = single_block_;
+    single_block_ = nullptr;
+  }
+  blocks_[index] = block;
+  return block;
+}
+
 bool QuicStreamSequencerBuffer::RetireBlock(size_t idx) {
-  if (blocks_[idx] == nullptr) {
+  BufferBlock* block = GetBlock(idx);
+  if (block == nullptr) {
     QUIC_BUG << "Try to retire block twice";
     return false;
   }
-  delete blocks_[idx];
-  blocks_[idx] = nullptr;
+  if (blocks_ != nullptr) {
+    blocks_[idx] = nullptr;
+  } else {
+    single_block_ = nullptr;
+  }
+  if (block_pool_ != nullptr) {
+    block_pool_->Delete(block);
+  } else {
+    delete block;
+  }
   QUIC_DVLOG(1) << "Retired block with index: " << idx;
   return true;
 }
@@ -162,13 +264,6 @@ bool QuicStreamSequencerBuffer::CopyStreamData(QuicStreamOffset offset,
       bytes_avail = total_bytes_read_ + max_buffer_capacity_bytes_ - offset;
     }
 
-    if (blocks_ == nullptr) {
-      blocks_.reset(new BufferBlock*[blocks_count_]());
-      for (size_t i = 0; i < blocks_count_; ++i) {
-        blocks_[i] = nullptr;
-      }
-    }
-
     if (write_block_num >= blocks_count_) {
       *error_details = QuicStrCat(
           "QuicStreamSequencerBuffer error: OnStreamData() exceed array bounds."
@@ -177,20 +272,14 @@ bool QuicStreamSequencerBuffer::CopyStreamData(QuicStreamOffset offset,
           " blocks_count_ = ", blocks_count_);
       return false;
     }
-    if (blocks_ == nullptr) {
-      *error_details =
-          "QuicStreamSequencerBuffer error: OnStreamData() blocks_ is null";
-      return false;
-    }
-    if (blocks_[write_block_num] == nullptr) {
-      // TODO(danzh): Investigate if using a freelist would improve performance.
-      // Same as RetireBlock().
-      blocks_[write_block_num] = new BufferBlock();
+    BufferBlock* block = GetBlock(write_block_num);
+    if (block == nullptr) {
+      block = AllocateBlock(write_block_num);
     }
 
     const size_t bytes_to_copy =
         std::min<size_t>(bytes_avail, source_remaining);
-    char* dest = blocks_[write_block_num]->buffer + write_block_offset;
+    char* dest = block->buffer + write_block_offset;
     QUIC_DVLOG(1) << "Write at offset: " << offset
                   << " length: " << bytes_to_copy;
 
@@ -231,18 +320,19 @@ QuicErrorCode QuicStreamSequencerBuffer::Readv(const iovec* dest_iov,
       size_t bytes_to_copy =
           std::min<size_t>(bytes_available_in_block, dest_remaining);
       DCHECK_GT(bytes_to_copy, 0u);
-      if (blocks_[block_idx] == nullptr || dest == nullptr) {
+      const BufferBlock* block = GetBlock(block_idx);
+      if (block == nullptr || dest == nullptr) {
         *error_details = QuicStrCat(
             "QuicStreamSequencerBuffer error:"
             " Readv() dest == nullptr: ",
             (dest == nullptr), " blocks_[", block_idx,
-            "] == nullptr: ", (blocks_[block_idx] == nullptr),
+            "] == nullptr: ", (block == nullptr),
             " Gaps: ", GapsDebugString(),
             " Remaining frames: ", ReceivedFramesDebugString(),
             " total_bytes_read_ = ", total_bytes_read_);
         return QUIC_STREAM_SEQUENCER_INVALID_STATE;
       }
-      memcpy(dest, blocks_[block_idx]->buffer + start_offset_in_block,
+      memcpy(dest, block->buffer + start_offset_in_block,
              bytes_to_copy);
       dest += bytes_to_copy;
       dest_remaining -= bytes_to_copy;
@@ -292,14 +382,14 @@ int QuicStreamSequencerBuffer::GetReadableRegions(struct iovec* iov,
 
   // If readable region is within one block, deal with it seperately.
   if (start_block_idx == end_block_idx && ReadOffset() <= end_block_offset) {
-    iov[0].iov_base = blocks_[start_block_idx]->buffer + ReadOffset();
+    iov[0].iov_base = GetBlock(start_block_idx)->buffer + ReadOffset();
     iov[0].iov_len = ReadableBytes();
     QUIC_DVLOG(1) << "Got only a single block with index: " << start_block_idx;
     return 1;
   }
 
   // Get first block
-  iov[0].iov_base = blocks_[start_block_idx]->buffer + ReadOffset();
+  iov[0].iov_base = GetBlock(start_block_idx)->buffer + ReadOffset();
   iov[0].iov_len = GetBlockCapacity(start_block_idx) - ReadOffset();
   QUIC_DVLOG(1) << "Got first block " << start_block_idx << " with len "
                 << iov[0].iov_len;
@@ -312,8 +402,8 @@ int QuicStreamSequencerBuffer::GetReadableRegions(struct iovec* iov,
   int iov_used = 1;
   size_t block_idx = (start_block_idx + iov_used) % blocks_count_;
   while (block_idx != end_block_idx && iov_used < iov_count) {
-    DCHECK(nullptr != blocks_[block_idx]);
-    iov[iov_used].iov_base = blocks_[block_idx]->buffer;
+    DCHECK(nullptr != GetBlock(block_idx));
+    iov[iov_used].iov_base = GetBlock(block_idx)->buffer;
     iov[iov_used].iov_len = GetBlockCapacity(block_idx);
     QUIC_DVLOG(1) << "Got block with index: " << block_idx;
     ++iov_used;
@@ -322,8 +412,8 @@ int QuicStreamSequencerBuffer::GetReadableRegions(struct iovec* iov,
 
   // Deal with last block if |iov| can hold more.
   if (iov_used < iov_count) {
-    DCHECK(nullptr != blocks_[block_idx]);
-    iov[iov_used].iov_base = blocks_[end_block_idx]->buffer;
+    DCHECK(nullptr != GetBlock(block_idx));
+    iov[iov_used].iov_base = GetBlock(end_block_idx)->buffer;
     iov[iov_used].iov_len = end_block_offset + 1;
     QUIC_DVLOG(1) << "Got last block with index: " << end_block_idx;
     ++iov_used;
@@ -352,7 +442,7 @@ bool QuicStreamSequencerBuffer::PeekRegion(QuicStreamOffset offset,
   // Beginning of region.
   size_t block_idx = GetBlockIndex(offset);
   size_t block_offset = GetInBlockOffset(offset);
-  iov->iov_base = blocks_[block_idx]->buffer + block_offset;
+  iov->iov_base = GetBlock(block_idx)->buffer + block_offset;
 
   // Determine if entire block has been received.
   size_t end_block_idx = GetBlockIndex(FirstMissingByte());
@@ -433,6 +523,11 @@ size_t QuicStreamSequencerBuffer::BytesBuffered() const {
   return num_bytes_buffered_;
 }
 
+void QuicStreamSequencerBuffer::SetBlockPool(BlockPool* pool) {
+  DCHECK(blocks_ == nullptr && single_block_ == nullptr);
+  block_pool_ = pool;
+}
+
 size_t QuicStreamSequencerBuffer::GetBlockIndex(QuicStreamOffset offset) const {
   return (offset % max_buffer_capacity_bytes_) / kBlockSizeBytes;
 }
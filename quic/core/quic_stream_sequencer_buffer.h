@@ -63,6 +63,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "net/third_party/quiche/src/quic/core/quic_interval_set.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
@@ -89,9 +90,39 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
     char buffer[kBlockSizeBytes];
   };
 
+  // Default number of retired blocks a BlockPool keeps for reuse.
+  static const size_t kDefaultMaxPooledBlocks = 8;
+
+  // Free list of retired blocks, shared by the buffers of one session so that
+  // they reuse each other's blocks.  Like the buffers, it is not thread-safe.
+  // Blocks retired beyond |max_free_blocks| are freed.
+  class QUIC_EXPORT_PRIVATE BlockPool {
+   public:
+    BlockPool();
+    explicit BlockPool(size_t max_free_blocks);
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+    ~BlockPool();
+
+    BufferBlock* New();
+    void Delete(BufferBlock* block);
+
+    // Frees the retired blocks kept for reuse.
+    void ReleaseFreeBlocks();
+
+    size_t num_free_blocks() const { return free_blocks_.size(); }
+    size_t num_blocks_in_use() const { return num_blocks_in_use_; }
+
+   private:
+    const size_t max_free_blocks_;
+    std::vector<BufferBlock*> free_blocks_;
+    // Blocks handed out by New() and not yet passed to Delete().
+    size_t num_blocks_in_use_;
+  };
+
   explicit QuicStreamSequencerBuffer(size_t max_capacity_bytes);
   QuicStreamSequencerBuffer(const QuicStreamSequencerBuffer&) = delete;
-  QuicStreamSequencerBuffer(QuicStreamSequencerBuffer&&) = default;
+  QuicStreamSequencerBuffer(QuicStreamSequencerBuffer&& other);
   QuicStreamSequencerBuffer& operator=(const QuicStreamSequencerBuffer&) =
       delete;
   ~QuicStreamSequencerBuffer();
@@ -171,6 +202,11 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
   // Returns number of bytes available to be read out.
   size_t ReadableBytes() const;
 
+  // Makes this buffer allocate its blocks from |pool|, and retire them to it.
+  // |pool| must outlive this buffer.  Must be called while no block is
+  // allocated.  Without a pool, blocks are allocated and freed one by one.
+  void SetBlockPool(BlockPool* pool);
+
  private:
   friend class test::QuicStreamSequencerBufferPeer;
 
@@ -181,8 +217,15 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
                       size_t* bytes_copy,
                       std::string* error_details);
 
+  // Returns the block at |index|, or nullptr if it is not allocated.
+  BufferBlock* GetBlock(size_t index) const;
+
+  // Allocates the block at |index|, which must not be allocated yet, and
+  // returns it.  |blocks_| is only allocated once a second block is needed.
+  BufferBlock* AllocateBlock(size_t index);
+
   // Dispose the given buffer block.
-  // After calling this method, blocks_[index] is set to nullptr
+  // After calling this method, GetBlock(index) returns nullptr
   // in order to indicate that no memory set is allocated for that block.
   // Returns true on success, false otherwise.
   bool RetireBlock(size_t index);
@@ -236,8 +279,19 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
   // An ordered, variable-length list of blocks, with the length limited
   // such that the number of blocks never exceeds blocks_count_.
   // Each list entry can hold up to kBlockSizeBytes bytes.
+  // Not allocated while at most one block has been in use at a time, in which
+  // case that block is |single_block_|.
   std::unique_ptr<BufferBlock*[]> blocks_;
 
+  // The only allocated block, at index |single_block_index_|, while |blocks_|
+  // is not allocated.  Most streams never hold more than one block at a time,
+  // and are spared the blocks_count_ pointers of |blocks_|.
+  BufferBlock* single_block_;
+  size_t single_block_index_;
+
+  // Not owned.  May be null.
+  BlockPool* block_pool_;
+
   // Number of bytes in buffer.
   size_t num_bytes_buffered_;
 
@@ -444,23 +444,100 @@ TEST_F(QuicStreamSequencerBufferTest, GetReadableRegionsEmpty) {
 }
 
 TEST_F(QuicStreamSequencerBufferTest, ReleaseWholeBuffer) {
-  // Tests that buffer is not deallocated unless ReleaseWholeBuffer() is called.
-  std::string source(100, 'b');
-  // Write something into [0, 100).
+  // Tests that the block array is not deallocated unless ReleaseWholeBuffer()
+  // is called.
+  std::string source(kBlockSizeBytes + 100, 'b');
+  // Write something into [0, kBlockSizeBytes + 100).
   buffer_->OnStreamData(0, source, &written_, &error_details_);
   EXPECT_TRUE(buffer_->HasBytesToRead());
-  char dest[120];
-  iovec iovecs[3]{iovec{dest, 40}, iovec{dest + 40, 40}, iovec{dest + 80, 40}};
+  char dest[kBlockSizeBytes + 120];
+  iovec iovecs[3]{iovec{dest, kBlockSizeBytes},
+                  iovec{dest + kBlockSizeBytes, 60},
+                  iovec{dest + kBlockSizeBytes + 60, 60}};
   size_t read;
   EXPECT_EQ(QUIC_NO_ERROR, buffer_->Readv(iovecs, 3, &read, &error_details_));
-  EXPECT_EQ(100u, read);
-  EXPECT_EQ(100u, buffer_->BytesConsumed());
+  EXPECT_EQ(kBlockSizeBytes + 100, read);
+  EXPECT_EQ(kBlockSizeBytes + 100, buffer_->BytesConsumed());
   EXPECT_TRUE(helper_->CheckBufferInvariants());
   EXPECT_TRUE(helper_->IsBufferAllocated());
   buffer_->ReleaseWholeBuffer();
   EXPECT_FALSE(helper_->IsBufferAllocated());
 }
 
+TEST_F(QuicStreamSequencerBufferTest, SingleBlockWithoutBlockArray) {
+  std::string source(1000, 'a');
+  // Data within one block does not need the block array.
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(0, source, &written_, &error_details_));
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(2000, source, &written_, &error_details_));
+  EXPECT_TRUE(helper_->IsBufferAllocated());
+  EXPECT_FALSE(helper_->IsBlockArrayAllocated());
+  EXPECT_NE(nullptr, helper_->GetBlock(0));
+  EXPECT_EQ(nullptr, helper_->GetBlock(1));
+
+  // Once the data is read, the block is retired and nothing is left allocated.
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(1000, source, &written_, &error_details_));
+  char dest[3000];
+  EXPECT_EQ(3000u, helper_->Read(dest, 3000));
+  EXPECT_FALSE(helper_->IsBufferAllocated());
+  EXPECT_TRUE(helper_->CheckBufferInvariants());
+
+  // Data of a second block is buffered while the first one is in use.
+  EXPECT_EQ(QUIC_NO_ERROR, buffer_->OnStreamData(kBlockSizeBytes + 10, source,
+                                                 &written_, &error_details_));
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(3000, source, &written_, &error_details_));
+  EXPECT_TRUE(helper_->IsBlockArrayAllocated());
+  EXPECT_NE(nullptr, helper_->GetBlock(0));
+  EXPECT_NE(nullptr, helper_->GetBlock(1));
+  EXPECT_TRUE(helper_->CheckBufferInvariants());
+}
+
+TEST_F(QuicStreamSequencerBufferTest, RetiredBlocksAreReused) {
+  QuicStreamSequencerBuffer::BlockPool pool;
+  buffer_->SetBlockPool(&pool);
+  std::string source(100, 'a');
+  buffer_->OnStreamData(0, source, &written_, &error_details_);
+  BufferBlock* block = helper_->GetBlock(0);
+  EXPECT_EQ(1u, pool.num_blocks_in_use());
+  char dest[100];
+  EXPECT_EQ(100u, helper_->Read(dest, 100));
+  EXPECT_EQ(0u, pool.num_blocks_in_use());
+  EXPECT_EQ(1u, pool.num_free_blocks());
+
+  // The next block allocation, by any buffer of the pool, takes the retired
+  // block.
+  QuicStreamSequencerBuffer buffer2(max_capacity_bytes_);
+  buffer2.SetBlockPool(&pool);
+  QuicStreamSequencerBufferPeer helper2(&buffer2);
+  buffer2.OnStreamData(0, source, &written_, &error_details_);
+  EXPECT_EQ(block, helper2.GetBlock(0));
+  EXPECT_EQ(0u, pool.num_free_blocks());
+}
+
+TEST_F(QuicStreamSequencerBufferTest, BlockPoolKeepsAtMostMaxFreeBlocks) {
+  QuicStreamSequencerBuffer::BlockPool pool(2);
+  buffer_->SetBlockPool(&pool);
+  // Out of order data of three blocks is held at the same time.
+  std::string source(100, 'a');
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(QUIC_NO_ERROR,
+              buffer_->OnStreamData(i * kBlockSizeBytes + 1, source, &written_,
+                                    &error_details_));
+  }
+  EXPECT_EQ(3u, pool.num_blocks_in_use());
+
+  // Blocks retired beyond the cap are freed.
+  buffer_->Clear();
+  EXPECT_EQ(0u, pool.num_blocks_in_use());
+  EXPECT_EQ(2u, pool.num_free_blocks());
+
+  pool.ReleaseFreeBlocks();
+  EXPECT_EQ(0u, pool.num_free_blocks());
+}
+
 TEST_F(QuicStreamSequencerBufferTest, GetReadableRegionsBlockedByGap) {
   // Write into [1, 1024).
   std::string source(1023, 'a');
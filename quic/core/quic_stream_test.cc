@@ -8,6 +8,7 @@
 #include <string>
 
 #include "net/third_party/quiche/src/quic/core/quic_connection.h"
+#include "net/third_party/quiche/src/quic/core/quic_send_buffer_pool.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/core/quic_versions.h"
 #include "net/third_party/quiche/src/quic/core/quic_write_blocked_list.h"
@@ -73,6 +74,7 @@ class QuicStreamTestBase : public QuicTestWithParam<ParsedQuicVersion> {
  public:
   QuicStreamTestBase()
       : initial_flow_control_window_bytes_(kMaxOutgoingPacketSize),
+        send_buffer_budget_(0),
         zero_(QuicTime::Delta::Zero()),
         supported_versions_(AllSupportedVersions()) {}
 
@@ -88,6 +90,9 @@ class QuicStreamTestBase : public QuicTestWithParam<ParsedQuicVersion> {
     // negotiated in the config.
     QuicConfigPeer::SetReceivedInitialStreamFlowControlWindow(
         session_->config(), initial_flow_control_window_bytes_);
+    if (send_buffer_budget_ > 0) {
+      session_->EnableSendBufferPool(send_buffer_budget_);
+    }
 
     stream_ = new TestStream(kTestStreamId, session_.get(), BIDIRECTIONAL);
     EXPECT_NE(nullptr, stream_);
@@ -107,6 +112,10 @@ class QuicStreamTestBase : public QuicTestWithParam<ParsedQuicVersion> {
     initial_flow_control_window_bytes_ = val;
   }
 
+  void set_send_buffer_budget(QuicByteCount budget) {
+    send_buffer_budget_ = budget;
+  }
+
   bool HasWriteBlockedStreams() {
     return write_blocked_list_->HasWriteBlockedSpecialStream() ||
            write_blocked_list_->HasWriteBlockedDataStreams();
@@ -141,6 +150,7 @@ class QuicStreamTestBase : public QuicTestWithParam<ParsedQuicVersion> {
   TestStream* stream_;
   QuicWriteBlockedList* write_blocked_list_;
   uint32_t initial_flow_control_window_bytes_;
+  QuicByteCount send_buffer_budget_;
   QuicTime::Delta zero_;
   ParsedQuicVersionVector supported_versions_;
   const QuicStreamId kTestStreamId =
@@ -947,6 +957,28 @@ TEST_P(QuicStreamTest, StreamDataGetAckedOutOfOrder) {
   }
 }
 
+TEST_P(QuicStreamTest, ReleaseStateWhileWaitingForAcks) {
+  Initialize();
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Invoke(MockQuicSession::ConsumeData));
+  // Data received out of order stays in the sequencer buffer.
+  QuicStreamFrame frame(stream_->id(), false, 1, QuicStringPiece("."));
+  stream_->OnStreamFrame(frame);
+  QuicStreamSequencer* sequencer = QuicStreamPeer::sequencer(stream_);
+  EXPECT_TRUE(QuicStreamSequencerPeer::IsUnderlyingBufferAllocated(sequencer));
+  stream_->WriteOrBufferData(kData1, true, nullptr);
+
+  stream_->ReleaseStateWhileWaitingForAcks();
+  EXPECT_FALSE(QuicStreamSequencerPeer::IsUnderlyingBufferAllocated(sequencer));
+  // Acks of the sent data are still processed.
+  EXPECT_TRUE(stream_->IsWaitingForAcks());
+  QuicByteCount newly_acked_length = 0;
+  EXPECT_TRUE(stream_->OnStreamFrameAcked(0, 9, true, QuicTime::Delta::Zero(),
+                                          &newly_acked_length));
+  EXPECT_EQ(9u, newly_acked_length);
+  EXPECT_FALSE(stream_->IsWaitingForAcks());
+}
+
 TEST_P(QuicStreamTest, CancelStream) {
   Initialize();
   EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
@@ -1086,6 +1118,73 @@ TEST_P(QuicStreamTest, CanWriteNewDataAfterData) {
   EXPECT_FALSE(stream_->CanWriteNewDataAfterData(100));
 }
 
+TEST_P(QuicStreamTest, SendBufferPoolDisabledByDefault) {
+  Initialize();
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Invoke(MockQuicSession::ConsumeData));
+  stream_->WriteOrBufferData(std::string(100, 'a'), false, nullptr);
+  EXPECT_EQ(0u, session_->send_buffer_pool()->buffered_bytes());
+}
+
+TEST_P(QuicStreamTest, SendBufferBudget) {
+  set_send_buffer_budget(100);
+  Initialize();
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Invoke(MockQuicSession::ConsumeData));
+  QuicSendBufferPool* pool = session_->send_buffer_pool();
+
+  // Sent data is held until acked.
+  std::string data(100, 'a');
+  stream_->WriteOrBufferData(data, false, nullptr);
+  EXPECT_EQ(0u, stream_->BufferedDataBytes());
+  EXPECT_EQ(100u, pool->buffered_bytes());
+  EXPECT_TRUE(pool->IsOverBudget());
+
+  // New data is refused while the pool is over budget.
+  struct iovec iov = {const_cast<char*>(data.data()), data.length()};
+  EXPECT_EQ(0u, stream_->WritevData(&iov, 1, false).bytes_consumed);
+  EXPECT_FALSE(write_blocked_list_->IsStreamBlocked(stream_->id()));
+
+  // Acks release the memory and resume the stream.
+  QuicStreamFrame frame(stream_->id(), false, 0,
+                        static_cast<QuicPacketLength>(data.length()));
+  EXPECT_TRUE(session_->OnFrameAcked(QuicFrame(frame), QuicTime::Delta::Zero(),
+                                     QuicTime::Zero()));
+  EXPECT_EQ(0u, pool->buffered_bytes());
+  EXPECT_TRUE(write_blocked_list_->IsStreamBlocked(stream_->id()));
+  EXPECT_CALL(*stream_, OnCanWriteNewData());
+  stream_->OnCanWrite();
+  EXPECT_EQ(100u, stream_->WritevData(&iov, 1, false).bytes_consumed);
+}
+
+TEST_P(QuicStreamTest, WriteOrBufferDataCountsAgainstSendBufferBudget) {
+  set_send_buffer_budget(100);
+  Initialize();
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Invoke(MockQuicSession::ConsumeData));
+  QuicSendBufferPool* pool = session_->send_buffer_pool();
+  const QuicByteCount process_bytes =
+      QuicSendBufferPool::ProcessBufferedBytes();
+
+  // All data is accepted, even beyond the budget.
+  std::string data(150, 'a');
+  stream_->WriteOrBufferData(data, false, nullptr);
+  EXPECT_EQ(150u, pool->buffered_bytes());
+  EXPECT_EQ(process_bytes + 150, QuicSendBufferPool::ProcessBufferedBytes());
+  EXPECT_TRUE(pool->IsOverBudget());
+  EXPECT_FALSE(write_blocked_list_->IsStreamBlocked(stream_->id()));
+
+  // Acks resume the stream, which had no other reason to be write blocked.
+  QuicStreamFrame frame(stream_->id(), false, 0,
+                        static_cast<QuicPacketLength>(data.length()));
+  EXPECT_TRUE(session_->OnFrameAcked(QuicFrame(frame), QuicTime::Delta::Zero(),
+                                     QuicTime::Zero()));
+  EXPECT_EQ(process_bytes, QuicSendBufferPool::ProcessBufferedBytes());
+  EXPECT_TRUE(write_blocked_list_->IsStreamBlocked(stream_->id()));
+  EXPECT_CALL(*stream_, OnCanWriteNewData());
+  stream_->OnCanWrite();
+}
+
 TEST_P(QuicStreamTest, WriteBufferedData) {
   // Set buffered data low water mark to be 100.
   SetQuicFlag(FLAGS_quic_buffered_data_threshold, 100);
@@ -383,6 +383,19 @@ enum LossDetectionType : uint8_t {
   kTime,          // Time based loss detection.
   kAdaptiveTime,  // Adaptive time based loss detection.
   kLazyFack,      // Nack based but with FACK disabled for the first ack.
+  kAdaptiveReordering,  // RACK-style packet and time thresholds, both learned
+                        // from the reordering observed by the sender.
+};
+
+// Order in which QuicWriteBlockedList serves data streams of the same
+// priority.
+enum class QuicStreamSchedulingPolicy : uint8_t {
+  // Streams are served in the order they became blocked, and the most recently
+  // served stream may write up to 16000 bytes before yielding.
+  kStrictFifo,
+  // Non-incremental streams are served one after the other, then incremental
+  // streams share the bandwidth round-robin with a per-turn byte quantum.
+  kIncrementalRoundRobin,
 };
 
 // EncryptionLevel enumerates the stages of encryption that a QUIC connection
@@ -9,10 +9,21 @@
 
 namespace quic {
 
+namespace {
+
+// Bytes a data stream may write before yielding to another stream of the same
+// priority.
+const int32_t kBatchWriteSize = 16000;
+
+}  // namespace
+
 QuicWriteBlockedList::QuicWriteBlockedList(QuicTransportVersion version)
-    : priority_write_scheduler_(QuicVersionUsesCryptoFrames(version)
+    : scheduling_policy_(QuicStreamSchedulingPolicy::kStrictFifo),
+      num_registered_data_streams_(0),
+      priority_write_scheduler_(QuicVersionUsesCryptoFrames(version)
                                     ? std::numeric_limits<QuicStreamId>::max()
                                     : 0),
+      incremental_write_scheduler_(kBatchWriteSize),
       last_priority_popped_(0) {
   memset(batch_write_stream_id_, 0, sizeof(batch_write_stream_id_));
   memset(bytes_left_for_batch_write_, 0, sizeof(bytes_left_for_batch_write_));
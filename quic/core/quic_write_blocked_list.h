@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "net/third_party/quiche/src/quic/core/quic_incremental_write_scheduler.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_export.h"
@@ -19,6 +20,8 @@ namespace quic {
 // Keeps tracks of the QUIC streams that have data to write, sorted by
 // priority.  QUIC stream priority order is:
 // Crypto stream > Headers stream > Data streams by requested priority.
+// Data streams of the same priority are ordered according to the
+// QuicStreamSchedulingPolicy.
 class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
  private:
   typedef spdy::PriorityWriteScheduler<QuicStreamId> QuicPriorityWriteScheduler;
@@ -29,7 +32,22 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
   QuicWriteBlockedList& operator=(const QuicWriteBlockedList&) = delete;
   ~QuicWriteBlockedList();
 
+  // Selects how data streams are scheduled.  Must be called before any data
+  // stream is registered.  Under kIncrementalRoundRobin, data streams are
+  // registered as incremental.
+  void SetSchedulingPolicy(QuicStreamSchedulingPolicy policy) {
+    DCHECK_EQ(0u, num_registered_data_streams_);
+    scheduling_policy_ = policy;
+  }
+
+  QuicStreamSchedulingPolicy scheduling_policy() const {
+    return scheduling_policy_;
+  }
+
   bool HasWriteBlockedDataStreams() const {
+    if (UsesIncrementalScheduler()) {
+      return incremental_write_scheduler_.HasReadyStreams();
+    }
     return priority_write_scheduler_.HasReadyStreams();
   }
 
@@ -43,7 +61,9 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
 
   size_t NumBlockedStreams() const {
     return NumBlockedSpecialStreams() +
-           priority_write_scheduler_.NumReadyStreams();
+           (UsesIncrementalScheduler()
+                ? incremental_write_scheduler_.NumReadyStreams()
+                : priority_write_scheduler_.NumReadyStreams());
   }
 
   bool ShouldYield(QuicStreamId id) const {
@@ -58,6 +78,9 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
       }
     }
 
+    if (UsesIncrementalScheduler()) {
+      return incremental_write_scheduler_.ShouldYield(id);
+    }
     return priority_write_scheduler_.ShouldYield(id);
   }
 
@@ -69,6 +92,10 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
       return static_stream_id;
     }
 
+    if (UsesIncrementalScheduler()) {
+      return incremental_write_scheduler_.PopNextReadyStream();
+    }
+
     const auto id_and_precedence =
         priority_write_scheduler_.PopNextReadyStreamAndPrecedence();
     const QuicStreamId id = std::get<0>(id_and_precedence);
@@ -94,11 +121,18 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
                       bool is_static_stream,
                       spdy::SpdyPriority priority) {
     DCHECK(!priority_write_scheduler_.StreamRegistered(stream_id));
+    DCHECK(!incremental_write_scheduler_.StreamRegistered(stream_id));
     if (is_static_stream) {
       static_stream_collection_.Register(stream_id);
       return;
     }
 
+    ++num_registered_data_streams_;
+    if (UsesIncrementalScheduler()) {
+      incremental_write_scheduler_.RegisterStream(stream_id, priority,
+                                                  /*incremental=*/true);
+      return;
+    }
     priority_write_scheduler_.RegisterStream(
         stream_id, spdy::SpdyStreamPrecedence(priority));
   }
@@ -108,17 +142,42 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
       static_stream_collection_.Unregister(stream_id);
       return;
     }
+    --num_registered_data_streams_;
+    if (UsesIncrementalScheduler()) {
+      incremental_write_scheduler_.UnregisterStream(stream_id);
+      return;
+    }
     priority_write_scheduler_.UnregisterStream(stream_id);
   }
 
   void UpdateStreamPriority(QuicStreamId stream_id,
                             spdy::SpdyPriority new_priority) {
     DCHECK(!static_stream_collection_.IsRegistered(stream_id));
+    if (UsesIncrementalScheduler()) {
+      incremental_write_scheduler_.UpdateStreamUrgency(stream_id,
+                                                       new_priority);
+      return;
+    }
     priority_write_scheduler_.UpdateStreamPrecedence(
         stream_id, spdy::SpdyStreamPrecedence(new_priority));
   }
 
+  // Incremental streams of the same priority share the bandwidth, while
+  // non-incremental ones are written one after the other.  Ignored unless the
+  // policy is kIncrementalRoundRobin.
+  void UpdateStreamIncremental(QuicStreamId stream_id, bool incremental) {
+    DCHECK(!static_stream_collection_.IsRegistered(stream_id));
+    if (UsesIncrementalScheduler()) {
+      incremental_write_scheduler_.UpdateStreamIncremental(stream_id,
+                                                           incremental);
+    }
+  }
+
   void UpdateBytesForStream(QuicStreamId stream_id, size_t bytes) {
+    if (UsesIncrementalScheduler()) {
+      incremental_write_scheduler_.UpdateBytesForStream(stream_id, bytes);
+      return;
+    }
     if (batch_write_stream_id_[last_priority_popped_] == stream_id) {
       // If this was the last data stream popped by PopFront, update the
       // bytes remaining in its batch write.
@@ -136,6 +195,11 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
       return;
     }
 
+    if (UsesIncrementalScheduler()) {
+      incremental_write_scheduler_.MarkStreamReady(stream_id);
+      return;
+    }
+
     bool push_front =
         stream_id == batch_write_stream_id_[last_priority_popped_] &&
         bytes_left_for_batch_write_[last_priority_popped_] > 0;
@@ -150,11 +214,25 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
       }
     }
 
+    if (UsesIncrementalScheduler()) {
+      return incremental_write_scheduler_.IsStreamReady(stream_id);
+    }
     return priority_write_scheduler_.IsStreamReady(stream_id);
   }
 
  private:
+  bool UsesIncrementalScheduler() const {
+    return scheduling_policy_ ==
+           QuicStreamSchedulingPolicy::kIncrementalRoundRobin;
+  }
+
+  QuicStreamSchedulingPolicy scheduling_policy_;
+  size_t num_registered_data_streams_;
+
+  // Used under kStrictFifo.
   QuicPriorityWriteScheduler priority_write_scheduler_;
+  // Used under kIncrementalRoundRobin.
+  QuicIncrementalWriteScheduler incremental_write_scheduler_;
 
   // If performing batch writes, this will be the stream ID of the stream doing
   // batch writes for this priority level.  We will allow this stream to write
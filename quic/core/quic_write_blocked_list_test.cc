@@ -224,6 +224,68 @@ TEST_F(QuicWriteBlockedListTest, Ceding) {
   EXPECT_FALSE(write_blocked_list_.ShouldYield(1));
 }
 
+TEST_F(QuicWriteBlockedListTest, IncrementalRoundRobin) {
+  write_blocked_list_.SetSchedulingPolicy(
+      QuicStreamSchedulingPolicy::kIncrementalRoundRobin);
+  write_blocked_list_.RegisterStream(1, true, kV3HighestPriority);
+  write_blocked_list_.RegisterStream(15, false, 3);
+  write_blocked_list_.RegisterStream(16, false, 3);
+  write_blocked_list_.RegisterStream(17, false, 3);
+  write_blocked_list_.RegisterStream(18, false, kV3LowestPriority);
+
+  write_blocked_list_.AddStream(18);
+  write_blocked_list_.AddStream(15);
+  write_blocked_list_.AddStream(16);
+  write_blocked_list_.AddStream(17);
+  write_blocked_list_.AddStream(1);
+  EXPECT_EQ(5u, write_blocked_list_.NumBlockedStreams());
+  EXPECT_TRUE(write_blocked_list_.IsStreamBlocked(16));
+  EXPECT_TRUE(write_blocked_list_.ShouldYield(15));
+
+  // Static streams still go first.
+  EXPECT_EQ(1u, write_blocked_list_.PopFront());
+  EXPECT_FALSE(write_blocked_list_.ShouldYield(15));
+  EXPECT_TRUE(write_blocked_list_.ShouldYield(16));
+  EXPECT_TRUE(write_blocked_list_.ShouldYield(18));
+
+  // Streams of the same priority take 16k turns.
+  EXPECT_EQ(15u, write_blocked_list_.PopFront());
+  write_blocked_list_.UpdateBytesForStream(15, 15999);
+  write_blocked_list_.AddStream(15);
+  EXPECT_EQ(15u, write_blocked_list_.PopFront());
+  write_blocked_list_.UpdateBytesForStream(15, 1);
+  write_blocked_list_.AddStream(15);
+  EXPECT_EQ(16u, write_blocked_list_.PopFront());
+  write_blocked_list_.UpdateBytesForStream(16, 16000);
+  write_blocked_list_.AddStream(16);
+
+  // A non-incremental stream is written to completion before the others.
+  write_blocked_list_.UpdateStreamIncremental(15, false);
+  EXPECT_EQ(15u, write_blocked_list_.PopFront());
+  write_blocked_list_.UpdateBytesForStream(15, 100000);
+  write_blocked_list_.AddStream(15);
+  EXPECT_EQ(15u, write_blocked_list_.PopFront());
+  EXPECT_EQ(17u, write_blocked_list_.PopFront());
+  EXPECT_EQ(16u, write_blocked_list_.PopFront());
+  EXPECT_EQ(18u, write_blocked_list_.PopFront());
+  EXPECT_FALSE(write_blocked_list_.HasWriteBlockedDataStreams());
+}
+
+TEST_F(QuicWriteBlockedListTest, IncrementalUnregisterBlockedStream) {
+  write_blocked_list_.SetSchedulingPolicy(
+      QuicStreamSchedulingPolicy::kIncrementalRoundRobin);
+  write_blocked_list_.RegisterStream(15, false, 3);
+  write_blocked_list_.RegisterStream(16, false, 5);
+  write_blocked_list_.AddStream(15);
+  write_blocked_list_.AddStream(16);
+
+  write_blocked_list_.UnregisterStream(15, false);
+  EXPECT_EQ(1u, write_blocked_list_.NumBlockedStreams());
+  write_blocked_list_.UpdateStreamPriority(16, kV3HighestPriority);
+  EXPECT_EQ(16u, write_blocked_list_.PopFront());
+  EXPECT_EQ(0u, write_blocked_list_.NumBlockedStreams());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace quic
@@ -1,16 +0,0 @@
-// Copyright (c) 2019 The Chromium Authors. All rights reserved.
-// Use of this source code is governed by a BSD-style license that can be
-// found in the LICENSE file.
-
-#ifndef QUICHE_QUIC_PLATFORM_API_QUIC_BBR2_SENDER_H_
-#define QUICHE_QUIC_PLATFORM_API_QUIC_BBR2_SENDER_H_
-
-#include "net/quic/platform/impl/quic_bbr2_sender_impl.h"
-
-namespace quic {
-
-using QuicBbr2Sender = QuicBbr2SenderImpl;
-
-}  // namespace quic
-
-#endif  // QUICHE_QUIC_PLATFORM_API_QUIC_BBR2_SENDER_H_
@@ -41,7 +41,7 @@ bool QuicStreamSequencerBufferPeer::CheckEmptyInvariants() {
 
 bool QuicStreamSequencerBufferPeer::IsBlockArrayEmpty() {
   if (buffer_->blocks_ == nullptr) {
-    return true;
+    return buffer_->single_block_ == nullptr;
   }
 
   size_t count = buffer_->blocks_count_;
@@ -99,7 +99,7 @@ size_t QuicStreamSequencerBufferPeer::GetInBlockOffset(
 }
 
 BufferBlock* QuicStreamSequencerBufferPeer::GetBlock(size_t index) {
-  return buffer_->blocks_[index];
+  return buffer_->GetBlock(index);
 }
 
 int QuicStreamSequencerBufferPeer::IntervalSize() {
@@ -139,6 +139,10 @@ void QuicStreamSequencerBufferPeer::AddBytesReceived(QuicStreamOffset offset,
 }
 
 bool QuicStreamSequencerBufferPeer::IsBufferAllocated() {
+  return buffer_->blocks_ != nullptr || buffer_->single_block_ != nullptr;
+}
+
+bool QuicStreamSequencerBufferPeer::IsBlockArrayAllocated() {
   return buffer_->blocks_ != nullptr;
 }
 
@@ -47,8 +47,11 @@ class QuicStreamSequencerBufferPeer {
 
   void AddBytesReceived(QuicStreamOffset offset, QuicByteCount length);
 
+  // Returns true if any block, or the block array, is allocated.
   bool IsBufferAllocated();
 
+  bool IsBlockArrayAllocated();
+
   size_t block_count();
 
   const QuicIntervalSet<QuicStreamOffset>& bytes_received();
@@ -0,0 +1,418 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/test_tools/simulator/congestion_control_benchmark.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <memory>
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/send_algorithm_interface.h"
+#include "net/third_party/quiche/src/quic/core/quic_connection_stats.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_str_cat.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_connection_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_sent_packet_manager_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/link.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/packet_filter.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/parallel_runner.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/quic_endpoint.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/simulator.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/switch.h"
+
+namespace quic {
+namespace simulator {
+
+namespace {
+
+// Same as the initial window used by the congestion control simulator tests.
+const QuicPacketCount kInitialCongestionWindowPackets = 10;
+
+// The access links are fast and short compared to the bottleneck, so that the
+// bottleneck queue is the only place where packets build up.
+const float kAccessLinkBandwidthMultiplier = 10;
+const QuicTime::Delta kAccessLinkPropagationDelay =
+    QuicTime::Delta::FromMilliseconds(1);
+
+// How often the occupancy of the bottleneck queue is sampled.
+const QuicTime::Delta kQueueSamplingInterval =
+    QuicTime::Delta::FromMilliseconds(10);
+
+// The transfer is never meant to finish within the scenario duration.
+const QuicByteCount kBulkTransferSize = 1024 * 1024 * 1024;
+
+// Drops each packet going through it with a fixed probability.
+class RandomLossFilter : public PacketFilter {
+ public:
+  RandomLossFilter(Simulator* simulator,
+                   std::string name,
+                   float loss_rate,
+                   Endpoint* input)
+      : PacketFilter(simulator, name, input), loss_rate_(loss_rate) {}
+  RandomLossFilter(const RandomLossFilter&) = delete;
+  RandomLossFilter& operator=(const RandomLossFilter&) = delete;
+  ~RandomLossFilter() override {}
+
+ protected:
+  bool FilterPacket(const Packet& /*packet*/) override {
+    if (loss_rate_ <= 0) {
+      return true;
+    }
+    // Use the top 53 bits of the random value to get a uniform double.
+    const double sample =
+        (simulator_->GetRandomGenerator()->RandUint64() >> 11) *
+        (1.0 / (uint64_t{1} << 53));
+    return sample >= loss_rate_;
+  }
+
+ private:
+  const float loss_rate_;
+};
+
+// Periodically records the queueing delay of a switch port queue.
+class QueueDelaySampler : public Actor {
+ public:
+  QueueDelaySampler(Simulator* simulator,
+                    std::string name,
+                    Queue* queue,
+                    QuicBandwidth drain_rate)
+      : Actor(simulator, name),
+        queue_(queue),
+        drain_rate_(drain_rate),
+        total_delay_(QuicTime::Delta::Zero()),
+        max_delay_(QuicTime::Delta::Zero()),
+        samples_(0) {
+    Schedule(clock_->Now());
+  }
+  QueueDelaySampler(const QueueDelaySampler&) = delete;
+  QueueDelaySampler& operator=(const QueueDelaySampler&) = delete;
+  ~QueueDelaySampler() override {}
+
+  void Act() override {
+    const QuicTime::Delta delay =
+        drain_rate_.TransferTime(queue_->bytes_queued());
+    total_delay_ = total_delay_ + delay;
+    max_delay_ = std::max(max_delay_, delay);
+    ++samples_;
+    Schedule(clock_->Now() + kQueueSamplingInterval);
+  }
+
+  QuicTime::Delta mean_delay() const {
+    if (samples_ == 0) {
+      return QuicTime::Delta::Zero();
+    }
+    return QuicTime::Delta::FromMicroseconds(total_delay_.ToMicroseconds() /
+                                             samples_);
+  }
+  QuicTime::Delta max_delay() const { return max_delay_; }
+
+ private:
+  Queue* queue_;
+  const QuicBandwidth drain_rate_;
+  QuicTime::Delta total_delay_;
+  QuicTime::Delta max_delay_;
+  uint64_t samples_;
+};
+
+// Owns all the objects of a single scenario.  The simulator is declared before
+// the actors, so that it outlives all the actors registered with it.
+class ScenarioRunner {
+ public:
+  explicit ScenarioRunner(const CongestionControlScenario& scenario)
+      : scenario_(scenario) {
+    random_.set_seed(scenario.seed);
+    simulator_.set_random_generator(&random_);
+  }
+  ScenarioRunner(const ScenarioRunner&) = delete;
+  ScenarioRunner& operator=(const ScenarioRunner&) = delete;
+
+  CongestionControlScenarioResult Run() {
+    CreateTopology();
+
+    for (auto& sender : senders_) {
+      sender->AddBytesToTransfer(kBulkTransferSize);
+    }
+    simulator_.RunFor(scenario_.duration);
+
+    return CollectResults();
+  }
+
+ private:
+  size_t flow_count() const { return scenario_.competing_flows + 1; }
+
+  void CreateTopology() {
+    const QuicTime::Delta bottleneck_propagation_delay =
+        std::max(QuicTime::Delta::FromMicroseconds(
+                     scenario_.rtt.ToMicroseconds() / 2) -
+                     kAccessLinkPropagationDelay,
+                 QuicTime::Delta::Zero());
+    const QuicByteCount bdp = scenario_.bottleneck_bandwidth * scenario_.rtt;
+    const QuicByteCount buffer_size = std::max<QuicByteCount>(
+        static_cast<QuicByteCount>(scenario_.buffer_bdp_fraction * bdp),
+        kMaxOutgoingPacketSize);
+
+    // Ports 1 to N are used by the senders, port N + 1 by the receivers.
+    const SwitchPortNumber receiver_port = flow_count() + 1;
+    switch_ = QuicMakeUnique<Switch>(&simulator_, "Switch", receiver_port,
+                                     buffer_size);
+
+    std::vector<QuicEndpoint*> receivers;
+    for (size_t i = 0; i < flow_count(); ++i) {
+      const std::string sender_name = QuicStrCat("Sender ", i);
+      const std::string receiver_name = QuicStrCat("Receiver ", i);
+      const QuicConnectionId connection_id = test::TestConnectionId(42 + i);
+      senders_.push_back(QuicMakeUnique<QuicEndpoint>(
+          &simulator_, sender_name, receiver_name, Perspective::IS_CLIENT,
+          connection_id));
+      receivers_.push_back(QuicMakeUnique<QuicEndpoint>(
+          &simulator_, receiver_name, sender_name, Perspective::IS_SERVER,
+          connection_id));
+      receivers.push_back(receivers_.back().get());
+
+      SetCongestionControl(
+          senders_.back().get(),
+          i == 0 ? scenario_.congestion_control_type
+                 : scenario_.competing_congestion_control_type);
+
+      sender_links_.push_back(QuicMakeUnique<SymmetricLink>(
+          senders_.back().get(), switch_->port(i + 1),
+          kAccessLinkBandwidthMultiplier * scenario_.bottleneck_bandwidth,
+          kAccessLinkPropagationDelay));
+    }
+
+    receiver_multiplexer_ =
+        QuicMakeUnique<QuicEndpointMultiplexer>("Receiver multiplexer",
+                                                receivers);
+    loss_filter_ = QuicMakeUnique<RandomLossFilter>(
+        &simulator_, "Bottleneck loss", scenario_.loss_rate,
+        switch_->port(receiver_port));
+    bottleneck_link_ = QuicMakeUnique<SymmetricLink>(
+        loss_filter_.get(), receiver_multiplexer_.get(),
+        scenario_.bottleneck_bandwidth, bottleneck_propagation_delay);
+    queue_sampler_ = QuicMakeUnique<QueueDelaySampler>(
+        &simulator_, "Bottleneck queue sampler",
+        switch_->port_queue(receiver_port), scenario_.bottleneck_bandwidth);
+  }
+
+  void SetCongestionControl(QuicEndpoint* endpoint,
+                            CongestionControlType type) {
+    QuicConnection* connection = endpoint->connection();
+    // Ownership of the sender is taken over by the connection.
+    SendAlgorithmInterface* send_algorithm = SendAlgorithmInterface::Create(
+        connection->clock(), connection->sent_packet_manager().GetRttStats(),
+        test::QuicSentPacketManagerPeer::GetUnackedPacketMap(
+            test::QuicConnectionPeer::GetSentPacketManager(connection)),
+        type, simulator_.GetRandomGenerator(),
+        test::QuicConnectionPeer::GetStats(connection),
+        kInitialCongestionWindowPackets);
+    test::QuicConnectionPeer::SetSendAlgorithm(connection, send_algorithm);
+  }
+
+  CongestionControlScenarioResult CollectResults() {
+    CongestionControlScenarioResult result;
+    result.scenario = scenario_;
+    result.mean_queueing_delay = queue_sampler_->mean_delay();
+    result.max_queueing_delay = queue_sampler_->max_delay();
+
+    QuicByteCount total_bytes_received = 0;
+    double sum_throughput = 0;
+    double sum_throughput_squared = 0;
+    for (size_t i = 0; i < flow_count(); ++i) {
+      QuicConnection* connection = senders_[i]->connection();
+      const QuicConnectionStats& stats = connection->GetStats();
+
+      CongestionControlFlowResult flow;
+      flow.congestion_control_type =
+          connection->sent_packet_manager()
+              .GetSendAlgorithm()
+              ->GetCongestionControlType();
+      flow.bytes_received = receivers_[i]->bytes_received();
+      flow.throughput = QuicBandwidth::FromBytesAndTimeDelta(
+          flow.bytes_received, scenario_.duration);
+      flow.packets_sent = stats.packets_sent;
+      flow.packets_lost = stats.packets_lost;
+      flow.smoothed_rtt =
+          connection->sent_packet_manager().GetRttStats()->smoothed_rtt();
+      result.flows.push_back(flow);
+
+      total_bytes_received += flow.bytes_received;
+      const double throughput = flow.throughput.ToBitsPerSecond();
+      sum_throughput += throughput;
+      sum_throughput_squared += throughput * throughput;
+    }
+
+    const QuicByteCount capacity =
+        scenario_.bottleneck_bandwidth * scenario_.duration;
+    if (capacity > 0) {
+      result.link_utilization =
+          static_cast<float>(total_bytes_received) / capacity;
+    }
+    if (sum_throughput_squared > 0) {
+      result.fairness_index = sum_throughput * sum_throughput /
+                              (flow_count() * sum_throughput_squared);
+    }
+    return result;
+  }
+
+  const CongestionControlScenario scenario_;
+
+  Simulator simulator_;
+  test::SimpleRandom random_;
+
+  std::unique_ptr<Switch> switch_;
+  std::vector<std::unique_ptr<QuicEndpoint>> senders_;
+  std::vector<std::unique_ptr<QuicEndpoint>> receivers_;
+  std::vector<std::unique_ptr<SymmetricLink>> sender_links_;
+  std::unique_ptr<QuicEndpointMultiplexer> receiver_multiplexer_;
+  std::unique_ptr<RandomLossFilter> loss_filter_;
+  std::unique_ptr<SymmetricLink> bottleneck_link_;
+  std::unique_ptr<QueueDelaySampler> queue_sampler_;
+};
+
+std::string MillisecondsToString(QuicTime::Delta delta) {
+  return QuicStringPrintf("%.3f", delta.ToMicroseconds() / 1000.0);
+}
+
+}  // namespace
+
+std::string CongestionControlScenario::Name() const {
+  std::string name = QuicStringPrintf(
+      "%s_%" PRId64 "kbps_%" PRId64 "ms_%.2fbdp_%.4floss",
+      CongestionControlTypeToBenchmarkName(congestion_control_type).c_str(),
+      bottleneck_bandwidth.ToKBitsPerSecond(), rtt.ToMilliseconds(),
+      buffer_bdp_fraction, loss_rate);
+  if (competing_flows > 0) {
+    name = QuicStrCat(name, "_vs_", competing_flows, "x",
+                      CongestionControlTypeToBenchmarkName(
+                          competing_congestion_control_type));
+  }
+  return name;
+}
+
+float CongestionControlFlowResult::LossRate() const {
+  if (packets_sent == 0) {
+    return 0;
+  }
+  return static_cast<float>(packets_lost) / packets_sent;
+}
+
+std::string CongestionControlTypeToBenchmarkName(CongestionControlType type) {
+  switch (type) {
+    case kCubicBytes:
+      return "cubic";
+    case kRenoBytes:
+      return "reno";
+    case kBBR:
+      return "bbr";
+    case kPCC:
+      return "pcc";
+    case kGoogCC:
+      return "goog_cc";
+    case kBBRv2:
+      return "bbr2";
+  }
+  return QuicStrCat("unknown(", static_cast<int>(type), ")");
+}
+
+bool ParseCongestionControlType(QuicStringPiece name,
+                                CongestionControlType* type) {
+  for (CongestionControlType candidate :
+       {kCubicBytes, kRenoBytes, kBBR, kPCC, kGoogCC, kBBRv2}) {
+    if (name == CongestionControlTypeToBenchmarkName(candidate)) {
+      *type = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+CongestionControlScenarioResult RunCongestionControlScenario(
+    const CongestionControlScenario& scenario) {
+  QUIC_LOG(INFO) << "Running congestion control scenario " << scenario.Name()
+                 << " for " << scenario.duration;
+  ScenarioRunner runner(scenario);
+  return runner.Run();
+}
+
+std::vector<CongestionControlScenarioResult> RunCongestionControlScenarios(
+    const std::vector<CongestionControlScenario>& scenarios,
+    size_t thread_count) {
+  // Every scenario carries its own seed, so that all the congestion controllers
+  // are compared under the same random loss pattern.
+  ParallelRunner runner(thread_count, /*base_seed=*/0);
+  return runner.RunAndCollect<CongestionControlScenarioResult>(
+      scenarios.size(), [&scenarios](size_t run_index, uint64_t /*seed*/) {
+        return RunCongestionControlScenario(scenarios[run_index]);
+      });
+}
+
+std::string CongestionControlResultsToCsv(
+    const std::vector<CongestionControlScenarioResult>& results) {
+  std::string csv =
+      "scenario,bottleneck_kbps,rtt_ms,buffer_bdp,loss_rate,competing_flows,"
+      "flow,congestion_control,throughput_kbps,flow_loss_rate,smoothed_rtt_ms,"
+      "mean_queueing_delay_ms,max_queueing_delay_ms,link_utilization,"
+      "fairness_index\n";
+  for (const CongestionControlScenarioResult& result : results) {
+    const CongestionControlScenario& scenario = result.scenario;
+    for (size_t i = 0; i < result.flows.size(); ++i) {
+      const CongestionControlFlowResult& flow = result.flows[i];
+      csv = QuicStrCat(
+          csv, scenario.Name(), ",",
+          scenario.bottleneck_bandwidth.ToKBitsPerSecond(), ",",
+          scenario.rtt.ToMilliseconds(), ",", scenario.buffer_bdp_fraction,
+          ",", scenario.loss_rate, ",", scenario.competing_flows, ",", i, ",",
+          CongestionControlTypeToBenchmarkName(flow.congestion_control_type),
+          ",", flow.throughput.ToKBitsPerSecond(), ",", flow.LossRate(), ",",
+          MillisecondsToString(flow.smoothed_rtt), ",",
+          MillisecondsToString(result.mean_queueing_delay), ",",
+          MillisecondsToString(result.max_queueing_delay), ",",
+          result.link_utilization, ",", result.fairness_index, "\n");
+    }
+  }
+  return csv;
+}
+
+std::string CongestionControlResultsToJson(
+    const std::vector<CongestionControlScenarioResult>& results) {
+  std::string json = "[";
+  for (size_t r = 0; r < results.size(); ++r) {
+    const CongestionControlScenarioResult& result = results[r];
+    const CongestionControlScenario& scenario = result.scenario;
+    json = QuicStrCat(
+        json, r == 0 ? "\n" : ",\n", "  {\"scenario\": \"", scenario.Name(),
+        "\", \"bottleneck_kbps\": ",
+        scenario.bottleneck_bandwidth.ToKBitsPerSecond(),
+        ", \"rtt_ms\": ", scenario.rtt.ToMilliseconds(),
+        ", \"buffer_bdp\": ", scenario.buffer_bdp_fraction,
+        ", \"loss_rate\": ", scenario.loss_rate,
+        ", \"duration_ms\": ", scenario.duration.ToMilliseconds(),
+        ", \"seed\": ", scenario.seed,
+        ", \"mean_queueing_delay_ms\": ",
+        MillisecondsToString(result.mean_queueing_delay),
+        ", \"max_queueing_delay_ms\": ",
+        MillisecondsToString(result.max_queueing_delay),
+        ", \"link_utilization\": ", result.link_utilization,
+        ", \"fairness_index\": ", result.fairness_index, ", \"flows\": [");
+    for (size_t i = 0; i < result.flows.size(); ++i) {
+      const CongestionControlFlowResult& flow = result.flows[i];
+      json = QuicStrCat(
+          json, i == 0 ? "" : ", ", "{\"congestion_control\": \"",
+          CongestionControlTypeToBenchmarkName(flow.congestion_control_type),
+          "\", \"throughput_kbps\": ", flow.throughput.ToKBitsPerSecond(),
+          ", \"bytes_received\": ", flow.bytes_received,
+          ", \"packets_sent\": ", flow.packets_sent,
+          ", \"packets_lost\": ", flow.packets_lost,
+          ", \"smoothed_rtt_ms\": ", MillisecondsToString(flow.smoothed_rtt),
+          "}");
+    }
+    json = QuicStrCat(json, "]}");
+  }
+  return QuicStrCat(json, "\n]\n");
+}
+
+}  // namespace simulator
+}  // namespace quic
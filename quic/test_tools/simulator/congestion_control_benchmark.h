@@ -0,0 +1,113 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_CONGESTION_CONTROL_BENCHMARK_H_
+#define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_CONGESTION_CONTROL_BENCHMARK_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/quic_bandwidth.h"
+#include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+
+namespace quic {
+namespace simulator {
+
+// A single point of the congestion control benchmark matrix.  All flows share
+// the following topology:
+//
+//   Flow 0 sender   Flow 1 sender  ...  Flow N sender
+//         |               |                   |
+//         +-------- Network switch -----------+   <-- access links
+//                         *   <-- bottleneck queue of |buffer_bdp_fraction|
+//                         |       times the bottleneck BDP
+//                         |   <-- random loss of |loss_rate|
+//                         |   <-- bottleneck link
+//              Receiver multiplexer
+//
+// Flow 0 runs |congestion_control_type|; the |competing_flows| other flows run
+// |competing_congestion_control_type|.  All flows transfer bulk data for the
+// whole |duration| of the scenario.
+struct CongestionControlScenario {
+  CongestionControlType congestion_control_type = kBBR;
+  CongestionControlType competing_congestion_control_type = kCubicBytes;
+  QuicBandwidth bottleneck_bandwidth = QuicBandwidth::FromKBitsPerSecond(4000);
+  // Round-trip propagation delay of the path, excluding queueing.
+  QuicTime::Delta rtt = QuicTime::Delta::FromMilliseconds(64);
+  // Size of the bottleneck queue, in multiples of the bottleneck BDP.
+  float buffer_bdp_fraction = 1.0f;
+  // Probability that a packet leaving the bottleneck queue is dropped.
+  float loss_rate = 0.0f;
+  size_t competing_flows = 0;
+  QuicTime::Delta duration = QuicTime::Delta::FromSeconds(30);
+  uint64_t seed = 0;
+
+  // Human-readable name of the scenario, used as the row label in reports.
+  std::string Name() const;
+};
+
+// Results measured for an individual flow of a scenario.
+struct CongestionControlFlowResult {
+  CongestionControlType congestion_control_type = kBBR;
+  // Application bytes received by the peer over the scenario duration.
+  QuicByteCount bytes_received = 0;
+  QuicBandwidth throughput = QuicBandwidth::Zero();
+  QuicPacketCount packets_sent = 0;
+  QuicPacketCount packets_lost = 0;
+  // Smoothed RTT of the connection at the end of the scenario.
+  QuicTime::Delta smoothed_rtt = QuicTime::Delta::Zero();
+
+  float LossRate() const;
+};
+
+struct CongestionControlScenarioResult {
+  CongestionControlScenario scenario;
+  // Flow 0 is the flow under test, followed by the competing flows.
+  std::vector<CongestionControlFlowResult> flows;
+  // Queueing delay at the bottleneck, sampled periodically over the scenario.
+  QuicTime::Delta mean_queueing_delay = QuicTime::Delta::Zero();
+  QuicTime::Delta max_queueing_delay = QuicTime::Delta::Zero();
+  // Fraction of the bottleneck capacity used by all flows together.
+  float link_utilization = 0.0f;
+  // Jain's fairness index over the throughput of all flows.  1.0 means the
+  // bottleneck is shared perfectly evenly.
+  float fairness_index = 1.0f;
+};
+
+// Returns the lowercase name used for |type| on the command line and in the
+// reports, e.g. "bbr2" for kBBRv2.
+std::string CongestionControlTypeToBenchmarkName(CongestionControlType type);
+
+// Parses a name returned by CongestionControlTypeToBenchmarkName.  Returns
+// false if |name| is not recognized.
+bool ParseCongestionControlType(QuicStringPiece name,
+                                CongestionControlType* type);
+
+// Builds the topology described by |scenario| in a fresh Simulator, runs it
+// and returns the measured results.  Deterministic for a given scenario.
+CongestionControlScenarioResult RunCongestionControlScenario(
+    const CongestionControlScenario& scenario);
+
+// Runs all |scenarios| using up to |thread_count| threads, see
+// ParallelRunner.  The results are in the same order as |scenarios|, and do
+// not depend on |thread_count|.
+std::vector<CongestionControlScenarioResult> RunCongestionControlScenarios(
+    const std::vector<CongestionControlScenario>& scenarios,
+    size_t thread_count);
+
+// Formats |results| as CSV, one row per flow, preceded by a header row.
+std::string CongestionControlResultsToCsv(
+    const std::vector<CongestionControlScenarioResult>& results);
+
+// Formats |results| as a JSON array, one object per scenario.
+std::string CongestionControlResultsToJson(
+    const std::vector<CongestionControlScenarioResult>& results);
+
+}  // namespace simulator
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TEST_TOOLS_SIMULATOR_CONGESTION_CONTROL_BENCHMARK_H_
@@ -0,0 +1,247 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Runs a matrix of congestion control scenarios on the network simulator and
+// prints throughput, queueing delay, loss and fairness for every flow.
+//
+// Usage: congestion_control_benchmark [--congestion_control=bbr,bbr2,cubic]
+//            [--bottleneck_kbps=1000,10000] [--rtt_ms=20,100]
+//            [--buffer_bdp=0.5,2] [--loss_rate=0,0.01]
+//            [--competing_flows=0,1] [--competing_congestion_control=cubic]
+//            [--threads=N] [--output_format=csv|json]
+//
+// Every combination of the comma-separated values is run once.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/congestion_control_benchmark.h"
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    congestion_control,
+    "bbr,bbr2,cubic",
+    "Comma-separated congestion control algorithms of the flow under test. "
+    "One of: bbr, bbr2, cubic, reno, pcc.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    competing_congestion_control,
+    "cubic",
+    "Comma-separated congestion control algorithms of the competing flows.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(
+    std::string,
+    bottleneck_kbps,
+    "1000,4000,16000",
+    "Comma-separated bottleneck bandwidths, in kbps.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(std::string,
+                              rtt_ms,
+                              "20,64,200",
+                              "Comma-separated round-trip propagation delays, "
+                              "in milliseconds.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(std::string,
+                              buffer_bdp,
+                              "0.5,1,4",
+                              "Comma-separated bottleneck buffer sizes, in "
+                              "multiples of the bottleneck BDP.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(std::string,
+                              loss_rate,
+                              "0,0.01",
+                              "Comma-separated random loss probabilities at "
+                              "the bottleneck.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(std::string,
+                              competing_flows,
+                              "0,1",
+                              "Comma-separated numbers of competing flows.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              duration_s,
+                              30,
+                              "Simulated duration of each scenario, in "
+                              "seconds.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              seed,
+                              1,
+                              "Seed of the random generator of every "
+                              "scenario.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(int32_t,
+                              threads,
+                              0,
+                              "Number of scenarios simulated concurrently.  "
+                              "Zero uses one thread per core.");
+
+DEFINE_QUIC_COMMAND_LINE_FLAG(std::string,
+                              output_format,
+                              "csv",
+                              "Output format, either csv or json.");
+
+namespace quic {
+namespace simulator {
+namespace {
+
+bool ParseUint64List(QuicStringPiece flag_name,
+                     QuicStringPiece value,
+                     std::vector<uint64_t>* out) {
+  for (QuicStringPiece item : QuicTextUtils::Split(value, ',')) {
+    QuicTextUtils::RemoveLeadingAndTrailingWhitespace(&item);
+    uint64_t number;
+    if (!QuicTextUtils::StringToUint64(item, &number)) {
+      std::cerr << "Invalid value \"" << item << "\" in --" << flag_name
+                << "\n";
+      return false;
+    }
+    out->push_back(number);
+  }
+  return !out->empty();
+}
+
+bool ParseFloatList(QuicStringPiece flag_name,
+                    QuicStringPiece value,
+                    std::vector<float>* out) {
+  for (QuicStringPiece item : QuicTextUtils::Split(value, ',')) {
+    QuicTextUtils::RemoveLeadingAndTrailingWhitespace(&item);
+    const std::string item_string(item);
+    char* end = nullptr;
+    const float number = std::strtof(item_string.c_str(), &end);
+    if (item_string.empty() || *end != '\0' || number < 0) {
+      std::cerr << "Invalid value \"" << item << "\" in --" << flag_name
+                << "\n";
+      return false;
+    }
+    out->push_back(number);
+  }
+  return !out->empty();
+}
+
+bool ParseCongestionControlList(QuicStringPiece flag_name,
+                                QuicStringPiece value,
+                                std::vector<CongestionControlType>* out) {
+  for (QuicStringPiece item : QuicTextUtils::Split(value, ',')) {
+    QuicTextUtils::RemoveLeadingAndTrailingWhitespace(&item);
+    CongestionControlType type;
+    if (!ParseCongestionControlType(item, &type)) {
+      std::cerr << "Unknown congestion control \"" << item << "\" in --"
+                << flag_name << "\n";
+      return false;
+    }
+    if (type == kPCC) {
+      // Without the flag, SendAlgorithmInterface::Create falls back to CUBIC.
+      SetQuicReloadableFlag(quic_enable_pcc3, true);
+    }
+    out->push_back(type);
+  }
+  return !out->empty();
+}
+
+int RunBenchmark() {
+  std::vector<CongestionControlType> congestion_controls;
+  std::vector<CongestionControlType> competing_congestion_controls;
+  std::vector<uint64_t> bottleneck_kbps;
+  std::vector<uint64_t> rtt_ms;
+  std::vector<float> buffer_bdp;
+  std::vector<float> loss_rates;
+  std::vector<uint64_t> competing_flows;
+  if (!ParseCongestionControlList("congestion_control",
+                                  GetQuicFlag(FLAGS_congestion_control),
+                                  &congestion_controls) ||
+      !ParseCongestionControlList(
+          "competing_congestion_control",
+          GetQuicFlag(FLAGS_competing_congestion_control),
+          &competing_congestion_controls) ||
+      !ParseUint64List("bottleneck_kbps", GetQuicFlag(FLAGS_bottleneck_kbps),
+                       &bottleneck_kbps) ||
+      !ParseUint64List("rtt_ms", GetQuicFlag(FLAGS_rtt_ms), &rtt_ms) ||
+      !ParseFloatList("buffer_bdp", GetQuicFlag(FLAGS_buffer_bdp),
+                      &buffer_bdp) ||
+      !ParseFloatList("loss_rate", GetQuicFlag(FLAGS_loss_rate),
+                      &loss_rates) ||
+      !ParseUint64List("competing_flows", GetQuicFlag(FLAGS_competing_flows),
+                       &competing_flows)) {
+    return 1;
+  }
+
+  const std::string output_format = GetQuicFlag(FLAGS_output_format);
+  if (output_format != "csv" && output_format != "json") {
+    std::cerr << "Unknown --output_format " << output_format << "\n";
+    return 1;
+  }
+
+  std::vector<CongestionControlScenario> scenarios;
+  for (CongestionControlType congestion_control : congestion_controls) {
+    for (uint64_t kbps : bottleneck_kbps) {
+      for (uint64_t rtt : rtt_ms) {
+        for (float buffer : buffer_bdp) {
+          for (float loss_rate : loss_rates) {
+            for (uint64_t flows : competing_flows) {
+              for (CongestionControlType competing_congestion_control :
+                   competing_congestion_controls) {
+                CongestionControlScenario scenario;
+                scenario.congestion_control_type = congestion_control;
+                scenario.competing_congestion_control_type =
+                    competing_congestion_control;
+                scenario.bottleneck_bandwidth =
+                    QuicBandwidth::FromKBitsPerSecond(kbps);
+                scenario.rtt = QuicTime::Delta::FromMilliseconds(rtt);
+                scenario.buffer_bdp_fraction = buffer;
+                scenario.loss_rate = loss_rate;
+                scenario.competing_flows = flows;
+                scenario.duration =
+                    QuicTime::Delta::FromSeconds(GetQuicFlag(FLAGS_duration_s));
+                scenario.seed = GetQuicFlag(FLAGS_seed);
+                scenarios.push_back(scenario);
+                if (flows == 0) {
+                  // The competing algorithm is irrelevant without competitors.
+                  break;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const int32_t threads = GetQuicFlag(FLAGS_threads);
+  if (threads < 0) {
+    std::cerr << "Invalid --threads " << threads << "\n";
+    return 1;
+  }
+  std::vector<CongestionControlScenarioResult> results =
+      RunCongestionControlScenarios(scenarios, threads);
+
+  if (output_format == "json") {
+    std::cout << CongestionControlResultsToJson(results);
+  } else {
+    std::cout << CongestionControlResultsToCsv(results);
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace simulator
+}  // namespace quic
+
+int main(int argc, char* argv[]) {
+  const char* usage = "Usage: congestion_control_benchmark [options]";
+  std::vector<std::string> args =
+      quic::QuicParseCommandLineFlags(usage, argc, argv);
+  if (!args.empty()) {
+    quic::QuicPrintCommandLineFlagHelp(usage);
+    return 1;
+  }
+
+  return quic::simulator::RunBenchmark();
+}
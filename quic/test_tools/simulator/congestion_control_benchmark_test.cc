@@ -0,0 +1,137 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/test_tools/simulator/congestion_control_benchmark.h"
+
+#include <string>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
+
+namespace quic {
+namespace simulator {
+namespace {
+
+class CongestionControlBenchmarkTest : public QuicTest {
+ protected:
+  CongestionControlBenchmarkTest() {
+    scenario_.bottleneck_bandwidth = QuicBandwidth::FromKBitsPerSecond(2000);
+    scenario_.rtt = QuicTime::Delta::FromMilliseconds(40);
+    scenario_.buffer_bdp_fraction = 2.0f;
+    scenario_.duration = QuicTime::Delta::FromSeconds(10);
+    scenario_.seed = 1;
+  }
+
+  CongestionControlScenario scenario_;
+};
+
+TEST_F(CongestionControlBenchmarkTest, ParseCongestionControlType) {
+  for (CongestionControlType type :
+       {kCubicBytes, kRenoBytes, kBBR, kPCC, kBBRv2}) {
+    CongestionControlType parsed;
+    ASSERT_TRUE(ParseCongestionControlType(
+        CongestionControlTypeToBenchmarkName(type), &parsed));
+    EXPECT_EQ(type, parsed);
+  }
+  CongestionControlType parsed;
+  EXPECT_FALSE(ParseCongestionControlType("vegas", &parsed));
+}
+
+TEST_F(CongestionControlBenchmarkTest, SingleFlow) {
+  scenario_.congestion_control_type = kBBR;
+  CongestionControlScenarioResult result =
+      RunCongestionControlScenario(scenario_);
+
+  ASSERT_EQ(1u, result.flows.size());
+  EXPECT_EQ(kBBR, result.flows[0].congestion_control_type);
+  EXPECT_EQ(0u, result.flows[0].packets_lost);
+  // Startup takes a few round trips, the rest of the time the link is full.
+  EXPECT_GT(result.link_utilization, 0.8f);
+  EXPECT_LE(result.link_utilization, 1.0f);
+  EXPECT_FLOAT_EQ(1.0f, result.fairness_index);
+  EXPECT_LE(result.mean_queueing_delay, result.max_queueing_delay);
+  EXPECT_GE(result.flows[0].smoothed_rtt, scenario_.rtt);
+}
+
+TEST_F(CongestionControlBenchmarkTest, RandomLoss) {
+  scenario_.congestion_control_type = kCubicBytes;
+  scenario_.loss_rate = 0.02f;
+  CongestionControlScenarioResult result =
+      RunCongestionControlScenario(scenario_);
+
+  ASSERT_EQ(1u, result.flows.size());
+  EXPECT_GT(result.flows[0].packets_lost, 0u);
+  EXPECT_GT(result.flows[0].LossRate(), 0.005f);
+}
+
+TEST_F(CongestionControlBenchmarkTest, Competition) {
+  scenario_.congestion_control_type = kBBR;
+  scenario_.competing_congestion_control_type = kCubicBytes;
+  scenario_.competing_flows = 2;
+  CongestionControlScenarioResult result =
+      RunCongestionControlScenario(scenario_);
+
+  ASSERT_EQ(3u, result.flows.size());
+  EXPECT_EQ(kBBR, result.flows[0].congestion_control_type);
+  EXPECT_EQ(kCubicBytes, result.flows[1].congestion_control_type);
+  EXPECT_EQ(kCubicBytes, result.flows[2].congestion_control_type);
+  for (const CongestionControlFlowResult& flow : result.flows) {
+    EXPECT_GT(flow.bytes_received, 0u);
+  }
+  EXPECT_GT(result.fairness_index, 1.0f / 3);
+  EXPECT_LE(result.fairness_index, 1.0f);
+}
+
+TEST_F(CongestionControlBenchmarkTest, Deterministic) {
+  scenario_.loss_rate = 0.01f;
+  scenario_.competing_flows = 1;
+  CongestionControlScenarioResult first =
+      RunCongestionControlScenario(scenario_);
+  CongestionControlScenarioResult second =
+      RunCongestionControlScenario(scenario_);
+
+  EXPECT_EQ(CongestionControlResultsToCsv({first}),
+            CongestionControlResultsToCsv({second}));
+}
+
+TEST_F(CongestionControlBenchmarkTest, ParallelMatchesSequential) {
+  std::vector<CongestionControlScenario> scenarios;
+  for (CongestionControlType type : {kBBR, kBBRv2, kCubicBytes}) {
+    scenario_.congestion_control_type = type;
+    scenario_.loss_rate = 0.01f;
+    scenarios.push_back(scenario_);
+  }
+
+  std::vector<CongestionControlScenarioResult> sequential =
+      RunCongestionControlScenarios(scenarios, 1);
+  std::vector<CongestionControlScenarioResult> parallel =
+      RunCongestionControlScenarios(scenarios, 3);
+  ASSERT_EQ(3u, parallel.size());
+  EXPECT_EQ(CongestionControlResultsToCsv(sequential),
+            CongestionControlResultsToCsv(parallel));
+}
+
+TEST_F(CongestionControlBenchmarkTest, Output) {
+  scenario_.competing_flows = 1;
+  std::vector<CongestionControlScenarioResult> results = {
+      RunCongestionControlScenario(scenario_)};
+
+  // Header plus one row per flow.
+  const std::string csv = CongestionControlResultsToCsv(results);
+  std::vector<QuicStringPiece> lines = QuicTextUtils::Split(csv, '\n');
+  ASSERT_GE(lines.size(), 3u);
+  EXPECT_TRUE(QuicTextUtils::StartsWith(lines[0], "scenario,"));
+  EXPECT_TRUE(QuicTextUtils::StartsWith(lines[1], scenario_.Name()));
+  EXPECT_TRUE(QuicTextUtils::StartsWith(lines[2], scenario_.Name()));
+
+  const std::string json = CongestionControlResultsToJson(results);
+  EXPECT_TRUE(QuicTextUtils::StartsWith(json, "[\n  {\"scenario\": \""));
+  EXPECT_NE(std::string::npos, json.find("\"flows\": [{"));
+  EXPECT_TRUE(QuicTextUtils::EndsWithIgnoreCase(json, "]}\n]\n"));
+}
+
+}  // namespace
+}  // namespace simulator
+}  // namespace quic
@@ -0,0 +1,588 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/test_tools/simulator/connection_profiler.h"
+
+#include <chrono>
+#include <utility>
+
+#include "net/third_party/quiche/src/quic/core/congestion_control/send_algorithm_interface.h"
+#include "net/third_party/quiche/src/quic/core/crypto/null_decrypter.h"
+#include "net/third_party/quiche/src/quic/core/crypto/null_encrypter.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_decrypter.h"
+#include "net/third_party/quiche/src/quic/core/crypto/quic_encrypter.h"
+#include "net/third_party/quiche/src/quic/core/quic_connection.h"
+#include "net/third_party/quiche/src/quic/core/quic_framer.h"
+#include "net/third_party/quiche/src/quic/core/quic_sent_packet_manager.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_str_cat.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_string_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_connection_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_sent_packet_manager_peer.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/quic_endpoint.h"
+
+namespace quic {
+namespace simulator {
+
+namespace {
+
+using ScopedTimer = ConnectionProfiler::ScopedTimer;
+
+// Forwards to |encrypter_|, timing the per-packet operations.
+class TimingEncrypter : public QuicEncrypter {
+ public:
+  TimingEncrypter(ConnectionProfiler* profiler,
+                  std::unique_ptr<QuicEncrypter> encrypter)
+      : profiler_(profiler), encrypter_(std::move(encrypter)) {}
+  TimingEncrypter(const TimingEncrypter&) = delete;
+  TimingEncrypter& operator=(const TimingEncrypter&) = delete;
+  ~TimingEncrypter() override {}
+
+  bool SetKey(QuicStringPiece key) override {
+    return encrypter_->SetKey(key);
+  }
+  bool SetNoncePrefix(QuicStringPiece nonce_prefix) override {
+    return encrypter_->SetNoncePrefix(nonce_prefix);
+  }
+  bool SetIV(QuicStringPiece iv) override { return encrypter_->SetIV(iv); }
+  bool SetHeaderProtectionKey(QuicStringPiece key) override {
+    return encrypter_->SetHeaderProtectionKey(key);
+  }
+  bool EncryptPacket(uint64_t packet_number,
+                     QuicStringPiece associated_data,
+                     QuicStringPiece plaintext,
+                     char* output,
+                     size_t* output_length,
+                     size_t max_output_length) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kEncryption);
+    return encrypter_->EncryptPacket(packet_number, associated_data, plaintext,
+                                     output, output_length, max_output_length);
+  }
+  std::string GenerateHeaderProtectionMask(QuicStringPiece sample) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kEncryption);
+    return encrypter_->GenerateHeaderProtectionMask(sample);
+  }
+  size_t GetKeySize() const override { return encrypter_->GetKeySize(); }
+  size_t GetNoncePrefixSize() const override {
+    return encrypter_->GetNoncePrefixSize();
+  }
+  size_t GetIVSize() const override { return encrypter_->GetIVSize(); }
+  size_t GetMaxPlaintextSize(size_t ciphertext_size) const override {
+    return encrypter_->GetMaxPlaintextSize(ciphertext_size);
+  }
+  size_t GetCiphertextSize(size_t plaintext_size) const override {
+    return encrypter_->GetCiphertextSize(plaintext_size);
+  }
+  QuicStringPiece GetKey() const override { return encrypter_->GetKey(); }
+  QuicStringPiece GetNoncePrefix() const override {
+    return encrypter_->GetNoncePrefix();
+  }
+
+ private:
+  ConnectionProfiler* profiler_;
+  std::unique_ptr<QuicEncrypter> encrypter_;
+};
+
+// Forwards to |decrypter_|, timing the per-packet operations.
+class TimingDecrypter : public QuicDecrypter {
+ public:
+  TimingDecrypter(ConnectionProfiler* profiler,
+                  std::unique_ptr<QuicDecrypter> decrypter)
+      : profiler_(profiler), decrypter_(std::move(decrypter)) {}
+  TimingDecrypter(const TimingDecrypter&) = delete;
+  TimingDecrypter& operator=(const TimingDecrypter&) = delete;
+  ~TimingDecrypter() override {}
+
+  bool SetKey(QuicStringPiece key) override {
+    return decrypter_->SetKey(key);
+  }
+  bool SetNoncePrefix(QuicStringPiece nonce_prefix) override {
+    return decrypter_->SetNoncePrefix(nonce_prefix);
+  }
+  bool SetIV(QuicStringPiece iv) override { return decrypter_->SetIV(iv); }
+  bool SetHeaderProtectionKey(QuicStringPiece key) override {
+    return decrypter_->SetHeaderProtectionKey(key);
+  }
+  bool SetPreliminaryKey(QuicStringPiece key) override {
+    return decrypter_->SetPreliminaryKey(key);
+  }
+  bool SetDiversificationNonce(const DiversificationNonce& nonce) override {
+    return decrypter_->SetDiversificationNonce(nonce);
+  }
+  bool DecryptPacket(uint64_t packet_number,
+                     QuicStringPiece associated_data,
+                     QuicStringPiece ciphertext,
+                     char* output,
+                     size_t* output_length,
+                     size_t max_output_length) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kDecryption);
+    return decrypter_->DecryptPacket(packet_number, associated_data,
+                                     ciphertext, output, output_length,
+                                     max_output_length);
+  }
+  std::string GenerateHeaderProtectionMask(
+      QuicDataReader* sample_reader) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kDecryption);
+    return decrypter_->GenerateHeaderProtectionMask(sample_reader);
+  }
+  size_t GetKeySize() const override { return decrypter_->GetKeySize(); }
+  size_t GetIVSize() const override { return decrypter_->GetIVSize(); }
+  QuicStringPiece GetKey() const override { return decrypter_->GetKey(); }
+  QuicStringPiece GetNoncePrefix() const override {
+    return decrypter_->GetNoncePrefix();
+  }
+  uint32_t cipher_id() const override { return decrypter_->cipher_id(); }
+
+ private:
+  ConnectionProfiler* profiler_;
+  std::unique_ptr<QuicDecrypter> decrypter_;
+};
+
+// Forwards to |sender_|, timing every call that does more than return a
+// member.
+class TimingSendAlgorithm : public SendAlgorithmInterface {
+ public:
+  TimingSendAlgorithm(ConnectionProfiler* profiler,
+                      std::unique_ptr<SendAlgorithmInterface> sender)
+      : profiler_(profiler), sender_(std::move(sender)) {}
+  TimingSendAlgorithm(const TimingSendAlgorithm&) = delete;
+  TimingSendAlgorithm& operator=(const TimingSendAlgorithm&) = delete;
+  ~TimingSendAlgorithm() override {}
+
+  void SetFromConfig(const QuicConfig& config,
+                     Perspective perspective) override {
+    sender_->SetFromConfig(config, perspective);
+  }
+  void SetInitialCongestionWindowInPackets(QuicPacketCount packets) override {
+    sender_->SetInitialCongestionWindowInPackets(packets);
+  }
+  void OnCongestionEvent(bool rtt_updated,
+                         QuicByteCount prior_in_flight,
+                         QuicTime event_time,
+                         const AckedPacketVector& acked_packets,
+                         const LostPacketVector& lost_packets) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kCongestionControl);
+    sender_->OnCongestionEvent(rtt_updated, prior_in_flight, event_time,
+                               acked_packets, lost_packets);
+  }
+  void OnPacketSent(QuicTime sent_time,
+                    QuicByteCount bytes_in_flight,
+                    QuicPacketNumber packet_number,
+                    QuicByteCount bytes,
+                    HasRetransmittableData is_retransmittable) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kCongestionControl);
+    sender_->OnPacketSent(sent_time, bytes_in_flight, packet_number, bytes,
+                          is_retransmittable);
+  }
+  void OnRetransmissionTimeout(bool packets_retransmitted) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kCongestionControl);
+    sender_->OnRetransmissionTimeout(packets_retransmitted);
+  }
+  void OnConnectionMigration() override { sender_->OnConnectionMigration(); }
+  bool CanSend(QuicByteCount bytes_in_flight) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kCongestionControl);
+    return sender_->CanSend(bytes_in_flight);
+  }
+  QuicBandwidth PacingRate(QuicByteCount bytes_in_flight) const override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kCongestionControl);
+    return sender_->PacingRate(bytes_in_flight);
+  }
+  QuicBandwidth BandwidthEstimate() const override {
+    return sender_->BandwidthEstimate();
+  }
+  QuicByteCount GetCongestionWindow() const override {
+    return sender_->GetCongestionWindow();
+  }
+  bool InSlowStart() const override { return sender_->InSlowStart(); }
+  bool InRecovery() const override { return sender_->InRecovery(); }
+  bool ShouldSendProbingPacket() const override {
+    return sender_->ShouldSendProbingPacket();
+  }
+  QuicByteCount GetSlowStartThreshold() const override {
+    return sender_->GetSlowStartThreshold();
+  }
+  CongestionControlType GetCongestionControlType() const override {
+    return sender_->GetCongestionControlType();
+  }
+  void AdjustNetworkParameters(QuicBandwidth bandwidth,
+                               QuicTime::Delta rtt,
+                               bool allow_cwnd_to_decrease) override {
+    sender_->AdjustNetworkParameters(bandwidth, rtt, allow_cwnd_to_decrease);
+  }
+  std::string GetDebugState() const override {
+    return sender_->GetDebugState();
+  }
+  void OnApplicationLimited(QuicByteCount bytes_in_flight) override {
+    ScopedTimer timer(profiler_, ProfiledComponent::kCongestionControl);
+    sender_->OnApplicationLimited(bytes_in_flight);
+  }
+
+ private:
+  ConnectionProfiler* profiler_;
+  std::unique_ptr<SendAlgorithmInterface> sender_;
+};
+
+}  // namespace
+
+// Sits between the framer of a connection and the connection itself, and
+// charges everything from the start to the end of an ACK frame to
+// kAckProcessing.
+class ConnectionProfiler::TimingFramerVisitor
+    : public QuicFramerVisitorInterface {
+ public:
+  TimingFramerVisitor(ConnectionProfiler* profiler, QuicConnection* connection)
+      : profiler_(profiler), connection_(connection), in_ack_frame_(false) {}
+  TimingFramerVisitor(const TimingFramerVisitor&) = delete;
+  TimingFramerVisitor& operator=(const TimingFramerVisitor&) = delete;
+  ~TimingFramerVisitor() override {}
+
+  void OnError(QuicFramer* framer) override {
+    MaybeEndAckFrame();
+    connection_->OnError(framer);
+  }
+  bool OnProtocolVersionMismatch(ParsedQuicVersion received_version) override {
+    return connection_->OnProtocolVersionMismatch(received_version);
+  }
+  void OnPacket() override { connection_->OnPacket(); }
+  void OnPublicResetPacket(const QuicPublicResetPacket& packet) override {
+    connection_->OnPublicResetPacket(packet);
+  }
+  void OnVersionNegotiationPacket(
+      const QuicVersionNegotiationPacket& packet) override {
+    connection_->OnVersionNegotiationPacket(packet);
+  }
+  void OnRetryPacket(QuicConnectionId original_connection_id,
+                     QuicConnectionId new_connection_id,
+                     QuicStringPiece retry_token) override {
+    connection_->OnRetryPacket(original_connection_id, new_connection_id,
+                                retry_token);
+  }
+  bool OnUnauthenticatedPublicHeader(const QuicPacketHeader& header) override {
+    return connection_->OnUnauthenticatedPublicHeader(header);
+  }
+  bool OnUnauthenticatedHeader(const QuicPacketHeader& header) override {
+    return connection_->OnUnauthenticatedHeader(header);
+  }
+  void OnDecryptedPacket(EncryptionLevel level) override {
+    connection_->OnDecryptedPacket(level);
+  }
+  bool OnPacketHeader(const QuicPacketHeader& header) override {
+    return connection_->OnPacketHeader(header);
+  }
+  void OnCoalescedPacket(const QuicEncryptedPacket& packet) override {
+    connection_->OnCoalescedPacket(packet);
+  }
+  bool OnStreamFrame(const QuicStreamFrame& frame) override {
+    return connection_->OnStreamFrame(frame);
+  }
+  bool OnCryptoFrame(const QuicCryptoFrame& frame) override {
+    return connection_->OnCryptoFrame(frame);
+  }
+  bool OnAckFrameStart(QuicPacketNumber largest_acked,
+                       QuicTime::Delta ack_delay_time) override {
+    MaybeEndAckFrame();
+    profiler_->BeginComponent(ProfiledComponent::kAckProcessing);
+    in_ack_frame_ = true;
+    return MaybeEndAckFrameOnError(
+        connection_->OnAckFrameStart(largest_acked, ack_delay_time));
+  }
+  bool OnAckRange(QuicPacketNumber start, QuicPacketNumber end) override {
+    return MaybeEndAckFrameOnError(connection_->OnAckRange(start, end));
+  }
+  bool OnAckTimestamp(QuicPacketNumber packet_number,
+                      QuicTime timestamp) override {
+    return MaybeEndAckFrameOnError(
+        connection_->OnAckTimestamp(packet_number, timestamp));
+  }
+  bool OnAckFrameEnd(QuicPacketNumber start) override {
+    const bool result = connection_->OnAckFrameEnd(start);
+    MaybeEndAckFrame();
+    return result;
+  }
+  bool OnStopWaitingFrame(const QuicStopWaitingFrame& frame) override {
+    return connection_->OnStopWaitingFrame(frame);
+  }
+  bool OnPaddingFrame(const QuicPaddingFrame& frame) override {
+    return connection_->OnPaddingFrame(frame);
+  }
+  bool OnPingFrame(const QuicPingFrame& frame) override {
+    return connection_->OnPingFrame(frame);
+  }
+  bool OnRstStreamFrame(const QuicRstStreamFrame& frame) override {
+    return connection_->OnRstStreamFrame(frame);
+  }
+  bool OnConnectionCloseFrame(const QuicConnectionCloseFrame& frame) override {
+    return connection_->OnConnectionCloseFrame(frame);
+  }
+  bool OnStopSendingFrame(const QuicStopSendingFrame& frame) override {
+    return connection_->OnStopSendingFrame(frame);
+  }
+  bool OnPathChallengeFrame(const QuicPathChallengeFrame& frame) override {
+    return connection_->OnPathChallengeFrame(frame);
+  }
+  bool OnPathResponseFrame(const QuicPathResponseFrame& frame) override {
+    return connection_->OnPathResponseFrame(frame);
+  }
+  bool OnGoAwayFrame(const QuicGoAwayFrame& frame) override {
+    return connection_->OnGoAwayFrame(frame);
+  }
+  bool OnWindowUpdateFrame(const QuicWindowUpdateFrame& frame) override {
+    return connection_->OnWindowUpdateFrame(frame);
+  }
+  bool OnBlockedFrame(const QuicBlockedFrame& frame) override {
+    return connection_->OnBlockedFrame(frame);
+  }
+  bool OnNewConnectionIdFrame(const QuicNewConnectionIdFrame& frame) override {
+    return connection_->OnNewConnectionIdFrame(frame);
+  }
+  bool OnRetireConnectionIdFrame(
+      const QuicRetireConnectionIdFrame& frame) override {
+    return connection_->OnRetireConnectionIdFrame(frame);
+  }
+  bool OnNewTokenFrame(const QuicNewTokenFrame& frame) override {
+    return connection_->OnNewTokenFrame(frame);
+  }
+  bool OnMessageFrame(const QuicMessageFrame& frame) override {
+    return connection_->OnMessageFrame(frame);
+  }
+  void OnPacketComplete() override {
+    MaybeEndAckFrame();
+    connection_->OnPacketComplete();
+  }
+  bool IsValidStatelessResetToken(QuicUint128 token) const override {
+    return connection_->IsValidStatelessResetToken(token);
+  }
+  void OnAuthenticatedIetfStatelessResetPacket(
+      const QuicIetfStatelessResetPacket& packet) override {
+    connection_->OnAuthenticatedIetfStatelessResetPacket(packet);
+  }
+  bool OnMaxStreamsFrame(const QuicMaxStreamsFrame& frame) override {
+    return connection_->OnMaxStreamsFrame(frame);
+  }
+  bool OnStreamsBlockedFrame(const QuicStreamsBlockedFrame& frame) override {
+    return connection_->OnStreamsBlockedFrame(frame);
+  }
+
+ private:
+  // Stops timing the ACK frame if the framer is not going to deliver the rest
+  // of it.
+  bool MaybeEndAckFrameOnError(bool result) {
+    if (!result) {
+      MaybeEndAckFrame();
+    }
+    return result;
+  }
+
+  void MaybeEndAckFrame() {
+    if (in_ack_frame_) {
+      in_ack_frame_ = false;
+      profiler_->EndComponent();
+    }
+  }
+
+  ConnectionProfiler* profiler_;
+  QuicConnection* connection_;
+  // True between OnAckFrameStart() and the end of the ACK frame.
+  bool in_ack_frame_;
+};
+
+std::string ProfiledComponentToString(ProfiledComponent component) {
+  switch (component) {
+    case ProfiledComponent::kPacketProcessing:
+      return "packet_processing";
+    case ProfiledComponent::kPacketSending:
+      return "packet_sending";
+    case ProfiledComponent::kEncryption:
+      return "encryption";
+    case ProfiledComponent::kDecryption:
+      return "decryption";
+    case ProfiledComponent::kAckProcessing:
+      return "ack_processing";
+    case ProfiledComponent::kCongestionControl:
+      return "congestion_control";
+  }
+  return QuicStrCat("unknown(", static_cast<int>(component), ")");
+}
+
+uint64_t ConnectionProfile::ProfiledTimeNs() const {
+  uint64_t total = 0;
+  for (uint64_t time : component_time_ns) {
+    total += time;
+  }
+  return total;
+}
+
+double ConnectionProfile::BytesPerCpuSecond() const {
+  const uint64_t profiled_time_ns = ProfiledTimeNs();
+  if (profiled_time_ns == 0) {
+    return 0;
+  }
+  return bytes_received * 1e9 / profiled_time_ns;
+}
+
+std::string ConnectionProfile::ToString() const {
+  const uint64_t profiled_time_ns = ProfiledTimeNs();
+  std::string output = QuicStringPrintf(
+      "Simulated %s, %llu bytes received, %.3f ms wall time, %.3f ms in the "
+      "transport core, %.0f bytes per CPU second\n",
+      simulated_time.ToDebuggingValue().c_str(),
+      static_cast<unsigned long long>(bytes_received), wall_time_ns / 1e6,
+      profiled_time_ns / 1e6, BytesPerCpuSecond());
+  for (size_t i = 0; i < kNumProfiledComponents; ++i) {
+    const double share =
+        profiled_time_ns == 0 ? 0 : 100.0 * component_time_ns[i] /
+                                        profiled_time_ns;
+    QuicStrAppend(
+        &output,
+        QuicStringPrintf(
+            "  %-20s %10.3f ms %5.1f%%\n",
+            ProfiledComponentToString(static_cast<ProfiledComponent>(i))
+                .c_str(),
+            component_time_ns[i] / 1e6, share));
+  }
+  return output;
+}
+
+ConnectionProfiler::ScopedTimer::ScopedTimer(ConnectionProfiler* profiler,
+                                             ProfiledComponent component)
+    : profiler_(profiler) {
+  if (profiler_ != nullptr) {
+    profiler_->BeginComponent(component);
+  }
+}
+
+ConnectionProfiler::ScopedTimer::~ScopedTimer() {
+  if (profiler_ != nullptr) {
+    profiler_->EndComponent();
+  }
+}
+
+ConnectionProfiler::ConnectionProfiler(Simulator* simulator)
+    : simulator_(simulator),
+      segment_start_ns_(0),
+      start_time_(simulator->GetClock()->Now()),
+      wall_time_ns_(0),
+      component_time_ns_({}) {}
+
+ConnectionProfiler::~ConnectionProfiler() {
+  DCHECK(active_components_.empty());
+}
+
+void ConnectionProfiler::Attach(QuicEndpoint* endpoint) {
+  QuicConnection* connection = endpoint->connection();
+  const Perspective perspective = connection->perspective();
+
+  // The simulator always uses the null crypters, see QuicEndpoint.
+  connection->SetEncrypter(
+      ENCRYPTION_FORWARD_SECURE,
+      QuicMakeUnique<TimingEncrypter>(
+          this, QuicMakeUnique<NullEncrypter>(perspective)));
+  auto decrypter = QuicMakeUnique<TimingDecrypter>(
+      this, QuicMakeUnique<NullDecrypter>(perspective));
+  if (connection->version().KnowsWhichDecrypterToUse()) {
+    connection->InstallDecrypter(ENCRYPTION_FORWARD_SECURE,
+                                 std::move(decrypter));
+  } else {
+    connection->SetDecrypter(ENCRYPTION_FORWARD_SECURE, std::move(decrypter));
+  }
+
+  // QuicSentPacketManager owns its send algorithm, so the wrapped one is a
+  // fresh instance of the same type.
+  QuicSentPacketManager* sent_packet_manager =
+      test::QuicConnectionPeer::GetSentPacketManager(connection);
+  std::unique_ptr<SendAlgorithmInterface> sender(SendAlgorithmInterface::Create(
+      connection->clock(), sent_packet_manager->GetRttStats(),
+      test::QuicSentPacketManagerPeer::GetUnackedPacketMap(sent_packet_manager),
+      sent_packet_manager->GetSendAlgorithm()->GetCongestionControlType(),
+      simulator_->GetRandomGenerator(),
+      test::QuicConnectionPeer::GetStats(connection),
+      sent_packet_manager->initial_congestion_window()));
+  test::QuicConnectionPeer::SetSendAlgorithm(
+      connection, new TimingSendAlgorithm(this, std::move(sender)));
+
+  framer_visitors_.push_back(
+      QuicMakeUnique<TimingFramerVisitor>(this, connection));
+  test::QuicConnectionPeer::GetFramer(connection)->set_visitor(
+      framer_visitors_.back().get());
+
+  endpoint->set_profiler(this);
+  endpoints_.push_back(endpoint);
+  initial_bytes_received_.push_back(endpoint->bytes_received());
+}
+
+void ConnectionProfiler::RunFor(QuicTime::Delta time_span) {
+  const uint64_t start = WallNowNs();
+  simulator_->RunFor(time_span);
+  wall_time_ns_ += WallNowNs() - start;
+}
+
+ConnectionProfile ConnectionProfiler::GetProfile() const {
+  ConnectionProfile profile;
+  profile.simulated_time = simulator_->GetClock()->Now() - start_time_;
+  profile.wall_time_ns = wall_time_ns_;
+  profile.component_time_ns = component_time_ns_;
+  profile.per_simulated_second_ns = per_simulated_second_ns_;
+  for (size_t i = 0; i < endpoints_.size(); ++i) {
+    profile.bytes_received +=
+        endpoints_[i]->bytes_received() - initial_bytes_received_[i];
+  }
+  return profile;
+}
+
+void ConnectionProfiler::Reset() {
+  DCHECK(active_components_.empty());
+  start_time_ = simulator_->GetClock()->Now();
+  wall_time_ns_ = 0;
+  component_time_ns_.fill(0);
+  per_simulated_second_ns_.clear();
+  for (size_t i = 0; i < endpoints_.size(); ++i) {
+    initial_bytes_received_[i] = endpoints_[i]->bytes_received();
+  }
+}
+
+void ConnectionProfiler::BeginComponent(ProfiledComponent component) {
+  const uint64_t now = WallNowNs();
+  if (!active_components_.empty()) {
+    ChargeCurrentSegment(now);
+  }
+  active_components_.push_back(component);
+  segment_start_ns_ = now;
+}
+
+void ConnectionProfiler::EndComponent() {
+  if (active_components_.empty()) {
+    QUIC_BUG << "EndComponent called without a matching BeginComponent";
+    return;
+  }
+  const uint64_t now = WallNowNs();
+  ChargeCurrentSegment(now);
+  active_components_.pop_back();
+  segment_start_ns_ = now;
+}
+
+void ConnectionProfiler::ChargeCurrentSegment(uint64_t now_ns) {
+  const size_t component = static_cast<size_t>(active_components_.back());
+  const uint64_t elapsed = now_ns - segment_start_ns_;
+  component_time_ns_[component] += elapsed;
+
+  const QuicTime::Delta simulated_time =
+      simulator_->GetClock()->Now() - start_time_;
+  const size_t second = simulated_time.ToMicroseconds() / kNumMicrosPerSecond;
+  if (second >= per_simulated_second_ns_.size()) {
+    per_simulated_second_ns_.resize(second + 1, ComponentTimes{});
+  }
+  per_simulated_second_ns_[second][component] += elapsed;
+}
+
+// static
+uint64_t ConnectionProfiler::WallNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace simulator
+}  // namespace quic
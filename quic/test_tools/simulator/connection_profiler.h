@@ -0,0 +1,176 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_CONNECTION_PROFILER_H_
+#define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_CONNECTION_PROFILER_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "net/third_party/quiche/src/quic/core/quic_time.h"
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/simulator.h"
+
+namespace quic {
+namespace simulator {
+
+class QuicEndpoint;
+
+// Parts of the transport core whose CPU cost is measured by
+// ConnectionProfiler.
+enum class ProfiledComponent : uint8_t {
+  // QuicFramer parsing of incoming packets, and the QuicConnection processing
+  // of every frame other than ACK frames.
+  kPacketProcessing = 0,
+  // Stream data framing and packet serialization on the send path.
+  kPacketSending,
+  // Packet protection and its removal.
+  kEncryption,
+  kDecryption,
+  // Parsing of ACK frames and their processing by QuicSentPacketManager,
+  // including loss detection.
+  kAckProcessing,
+  // Every call into the SendAlgorithmInterface.
+  kCongestionControl,
+};
+
+const size_t kNumProfiledComponents =
+    static_cast<size_t>(ProfiledComponent::kCongestionControl) + 1;
+
+// Returns a short name for |component|, e.g. "ack_processing".
+std::string ProfiledComponentToString(ProfiledComponent component);
+
+// Wall-clock time, in nanoseconds, spent in each of the profiled components.
+using ComponentTimes = std::array<uint64_t, kNumProfiledComponents>;
+
+// The output of a profiled simulation.
+struct ConnectionProfile {
+  // Simulated time covered by the profile.
+  QuicTime::Delta simulated_time = QuicTime::Delta::Zero();
+  // Wall-clock time spent running the simulator, including the time spent in
+  // the network simulation itself.
+  uint64_t wall_time_ns = 0;
+  // Exclusive wall-clock time of each component: time spent in a component
+  // called from another one is only charged to the innermost component.
+  ComponentTimes component_time_ns = {};
+  // |component_time_ns| broken down per simulated second.
+  std::vector<ComponentTimes> per_simulated_second_ns;
+  // Application bytes received by all the profiled endpoints.
+  QuicByteCount bytes_received = 0;
+
+  // Wall-clock time spent in all the profiled components together.
+  uint64_t ProfiledTimeNs() const;
+
+  // Application bytes received per second of wall-clock time spent in the
+  // profiled components.  This is the number to track for regressions, as it
+  // is independent of the simulator overhead.
+  double BytesPerCpuSecond() const;
+
+  // Human-readable report with the share of every component.
+  std::string ToString() const;
+};
+
+// Measures the wall-clock time spent in the real QuicConnection code while a
+// simulation runs, so that simulations can double as repeatable CPU benchmarks
+// of the transport core.  Typical use:
+//
+//   ConnectionProfiler profiler(&simulator);
+//   profiler.Attach(&sender);
+//   profiler.Attach(&receiver);
+//   sender.AddBytesToTransfer(bytes);
+//   profiler.RunFor(QuicTime::Delta::FromSeconds(10));
+//   QUIC_LOG(INFO) << profiler.GetProfile().ToString();
+//
+// The profiler replaces the encrypter, the decrypter and the send algorithm of
+// the attached endpoints by timing wrappers, and intercepts the framer visitor
+// of their connections.  It must outlive the endpoints it is attached to, and
+// only measures time spent on the thread that runs the simulation.
+class ConnectionProfiler {
+ public:
+  // Charges the wall-clock time of its scope to a component.  Does nothing if
+  // |profiler| is nullptr.
+  class ScopedTimer {
+   public:
+    ScopedTimer(ConnectionProfiler* profiler, ProfiledComponent component);
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ~ScopedTimer();
+
+   private:
+    ConnectionProfiler* profiler_;
+  };
+
+  explicit ConnectionProfiler(Simulator* simulator);
+  ConnectionProfiler(const ConnectionProfiler&) = delete;
+  ConnectionProfiler& operator=(const ConnectionProfiler&) = delete;
+  ~ConnectionProfiler();
+
+  // Instruments |endpoint|.  Must be called after the congestion control of
+  // the endpoint is configured and before it sends any data, since the send
+  // algorithm is recreated from its type.
+  void Attach(QuicEndpoint* endpoint);
+
+  // Same as the Simulator methods, but also measure the wall-clock time spent
+  // in the simulation.
+  void RunFor(QuicTime::Delta time_span);
+  template <class TerminationPredicate>
+  bool RunUntilOrTimeout(TerminationPredicate termination_predicate,
+                         QuicTime::Delta deadline);
+
+  // Returns the profile accumulated since the construction or the last
+  // Reset().
+  ConnectionProfile GetProfile() const;
+
+  // Discards everything measured so far, e.g. to exclude the slow start from
+  // the measurements.
+  void Reset();
+
+ private:
+  class TimingFramerVisitor;
+
+  // Starts charging time to |component|, pausing the component that is
+  // currently being charged, if any.
+  void BeginComponent(ProfiledComponent component);
+  // Stops charging the innermost component and resumes the enclosing one.
+  void EndComponent();
+  // Adds the time since |segment_start_ns_| to the innermost component.
+  void ChargeCurrentSegment(uint64_t now_ns);
+
+  // Monotonic wall-clock time, in nanoseconds.
+  static uint64_t WallNowNs();
+
+  Simulator* simulator_;
+  std::vector<QuicEndpoint*> endpoints_;
+  std::vector<std::unique_ptr<TimingFramerVisitor>> framer_visitors_;
+
+  // Components currently being timed, innermost last.
+  std::vector<ProfiledComponent> active_components_;
+  uint64_t segment_start_ns_;
+
+  QuicTime start_time_;
+  uint64_t wall_time_ns_;
+  ComponentTimes component_time_ns_;
+  std::vector<ComponentTimes> per_simulated_second_ns_;
+  // Bytes received by every endpoint at |start_time_|.
+  std::vector<QuicByteCount> initial_bytes_received_;
+};
+
+template <class TerminationPredicate>
+bool ConnectionProfiler::RunUntilOrTimeout(
+    TerminationPredicate termination_predicate,
+    QuicTime::Delta deadline) {
+  const uint64_t start = WallNowNs();
+  const bool result =
+      simulator_->RunUntilOrTimeout(termination_predicate, deadline);
+  wall_time_ns_ += WallNowNs() - start;
+  return result;
+}
+
+}  // namespace simulator
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TEST_TOOLS_SIMULATOR_CONNECTION_PROFILER_H_
@@ -0,0 +1,150 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/test_tools/simulator/connection_profiler.h"
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/quic_endpoint.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/simulator.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/switch.h"
+
+namespace quic {
+namespace simulator {
+namespace {
+
+const QuicBandwidth kLinkBandwidth =
+    QuicBandwidth::FromKBitsPerSecond(10 * 1000);
+const QuicTime::Delta kPropagationDelay = QuicTime::Delta::FromMilliseconds(20);
+const QuicByteCount kBdp = kLinkBandwidth * kPropagationDelay;
+
+size_t Index(ProfiledComponent component) {
+  return static_cast<size_t>(component);
+}
+
+class ConnectionProfilerTest : public QuicTest {
+ protected:
+  ConnectionProfilerTest()
+      : profiler_(&simulator_),
+        switch_(&simulator_, "Switch", 8, kBdp * 2),
+        sender_(&simulator_,
+                "Sender",
+                "Receiver",
+                Perspective::IS_CLIENT,
+                test::TestConnectionId(42)),
+        receiver_(&simulator_,
+                  "Receiver",
+                  "Sender",
+                  Perspective::IS_SERVER,
+                  test::TestConnectionId(42)),
+        sender_link_(&sender_,
+                     switch_.port(1),
+                     kLinkBandwidth,
+                     kPropagationDelay),
+        receiver_link_(&receiver_,
+                       switch_.port(2),
+                       kLinkBandwidth,
+                       kPropagationDelay) {}
+
+  Simulator simulator_;
+  // Outlives the endpoints it is attached to.
+  ConnectionProfiler profiler_;
+  Switch switch_;
+  QuicEndpoint sender_;
+  QuicEndpoint receiver_;
+  SymmetricLink sender_link_;
+  SymmetricLink receiver_link_;
+};
+
+TEST_F(ConnectionProfilerTest, ProfileTransfer) {
+  const CongestionControlType congestion_control_type =
+      sender_.connection()->sent_packet_manager().GetSendAlgorithm()
+          ->GetCongestionControlType();
+  profiler_.Attach(&sender_);
+  profiler_.Attach(&receiver_);
+  // The wrapped send algorithm is of the same type.
+  EXPECT_EQ(congestion_control_type,
+            sender_.connection()->sent_packet_manager().GetSendAlgorithm()
+                ->GetCongestionControlType());
+
+  const QuicByteCount kTransferSize = 2 * 1024 * 1024;
+  sender_.AddBytesToTransfer(kTransferSize);
+  ASSERT_TRUE(profiler_.RunUntilOrTimeout(
+      [this]() { return receiver_.bytes_received() == kTransferSize; },
+      QuicTime::Delta::FromSeconds(10)));
+  EXPECT_FALSE(receiver_.wrong_data_received());
+
+  const ConnectionProfile profile = profiler_.GetProfile();
+  EXPECT_EQ(kTransferSize, profile.bytes_received);
+  EXPECT_LT(QuicTime::Delta::Zero(), profile.simulated_time);
+  // Every component runs at least once during a transfer.
+  for (size_t i = 0; i < kNumProfiledComponents; ++i) {
+    EXPECT_LT(0u, profile.component_time_ns[i])
+        << ProfiledComponentToString(static_cast<ProfiledComponent>(i));
+  }
+  EXPECT_LE(profile.ProfiledTimeNs(), profile.wall_time_ns);
+  EXPECT_LT(0, profile.BytesPerCpuSecond());
+
+  // The per-second breakdown covers the simulated time and sums up to the
+  // totals.
+  EXPECT_FALSE(profile.per_simulated_second_ns.empty());
+  EXPECT_GE(static_cast<size_t>(profile.simulated_time.ToMicroseconds() /
+                                kNumMicrosPerSecond) +
+                1,
+            profile.per_simulated_second_ns.size());
+  ComponentTimes sum = {};
+  for (const ComponentTimes& second : profile.per_simulated_second_ns) {
+    for (size_t i = 0; i < kNumProfiledComponents; ++i) {
+      sum[i] += second[i];
+    }
+  }
+  EXPECT_EQ(profile.component_time_ns, sum);
+
+  const std::string report = profile.ToString();
+  for (size_t i = 0; i < kNumProfiledComponents; ++i) {
+    EXPECT_NE(std::string::npos,
+              report.find(ProfiledComponentToString(
+                  static_cast<ProfiledComponent>(i))));
+  }
+}
+
+TEST_F(ConnectionProfilerTest, Reset) {
+  profiler_.Attach(&sender_);
+  profiler_.Attach(&receiver_);
+  sender_.AddBytesToTransfer(1024 * 1024);
+  profiler_.RunFor(QuicTime::Delta::FromSeconds(1));
+  EXPECT_LT(0u, profiler_.GetProfile().bytes_received);
+
+  profiler_.Reset();
+  const ConnectionProfile profile = profiler_.GetProfile();
+  EXPECT_EQ(QuicTime::Delta::Zero(), profile.simulated_time);
+  EXPECT_EQ(0u, profile.wall_time_ns);
+  EXPECT_EQ(0u, profile.ProfiledTimeNs());
+  EXPECT_EQ(0u, profile.bytes_received);
+  EXPECT_TRUE(profile.per_simulated_second_ns.empty());
+}
+
+TEST_F(ConnectionProfilerTest, NestedTimersAreExclusive) {
+  {
+    ConnectionProfiler::ScopedTimer outer(&profiler_,
+                                          ProfiledComponent::kPacketSending);
+    ConnectionProfiler::ScopedTimer inner(&profiler_,
+                                          ProfiledComponent::kEncryption);
+  }
+  // A null profiler is ignored.
+  ConnectionProfiler::ScopedTimer unused(nullptr,
+                                         ProfiledComponent::kDecryption);
+
+  const ConnectionProfile profile = profiler_.GetProfile();
+  const ComponentTimes& times = profile.component_time_ns;
+  EXPECT_EQ(0u, times[Index(ProfiledComponent::kDecryption)]);
+  EXPECT_EQ(0u, times[Index(ProfiledComponent::kAckProcessing)]);
+  EXPECT_EQ(times[Index(ProfiledComponent::kPacketSending)] +
+                times[Index(ProfiledComponent::kEncryption)],
+            profile.ProfiledTimeNs());
+}
+
+}  // namespace
+}  // namespace simulator
+}  // namespace quic
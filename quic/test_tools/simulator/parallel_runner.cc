@@ -0,0 +1,105 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/test_tools/simulator/parallel_runner.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_mutex.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_thread.h"
+
+namespace quic {
+namespace simulator {
+
+namespace {
+
+// Hands out the run indices to the worker threads.
+class RunQueue {
+ public:
+  RunQueue(size_t run_count,
+           uint64_t base_seed,
+           const ParallelRunner::RunFunction& run)
+      : run_count_(run_count), base_seed_(base_seed), run_(run), next_run_(0) {}
+  RunQueue(const RunQueue&) = delete;
+  RunQueue& operator=(const RunQueue&) = delete;
+
+  // Executes runs until there are none left.
+  void RunAll() {
+    size_t run_index;
+    while (NextRun(&run_index)) {
+      run_(run_index, ParallelRunner::SeedForRun(base_seed_, run_index));
+    }
+  }
+
+ private:
+  bool NextRun(size_t* run_index) {
+    QuicWriterMutexLock lock(&mutex_);
+    if (next_run_ >= run_count_) {
+      return false;
+    }
+    *run_index = next_run_++;
+    return true;
+  }
+
+  const size_t run_count_;
+  const uint64_t base_seed_;
+  const ParallelRunner::RunFunction& run_;
+
+  QuicMutex mutex_;
+  size_t next_run_ GUARDED_BY(mutex_);
+};
+
+class RunnerThread : public QuicThread {
+ public:
+  explicit RunnerThread(RunQueue* queue)
+      : QuicThread("simulator_runner"), queue_(queue) {}
+
+  void Run() override { queue_->RunAll(); }
+
+ private:
+  RunQueue* queue_;
+};
+
+}  // namespace
+
+ParallelRunner::ParallelRunner(size_t thread_count, uint64_t base_seed)
+    : thread_count_(thread_count != 0
+                        ? thread_count
+                        : std::max<size_t>(std::thread::hardware_concurrency(),
+                                           1)),
+      base_seed_(base_seed) {}
+
+void ParallelRunner::Run(size_t run_count, const RunFunction& run) {
+  RunQueue queue(run_count, base_seed_, run);
+  const size_t thread_count = std::min(thread_count_, run_count);
+  if (thread_count <= 1) {
+    queue.RunAll();
+    return;
+  }
+
+  std::vector<std::unique_ptr<RunnerThread>> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.push_back(QuicMakeUnique<RunnerThread>(&queue));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads) {
+    thread->Join();
+  }
+}
+
+// static
+uint64_t ParallelRunner::SeedForRun(uint64_t base_seed, size_t run_index) {
+  // SplitMix64 of the base seed advanced by |run_index| steps, which yields
+  // well-distributed and distinct seeds for consecutive run indices.
+  uint64_t z = base_seed + (run_index + 1) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+}  // namespace simulator
+}  // namespace quic
@@ -0,0 +1,65 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_PARALLEL_RUNNER_H_
+#define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_PARALLEL_RUNNER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace quic {
+namespace simulator {
+
+// ParallelRunner executes many independent simulations concurrently.  Each
+// run has to create its own Simulator along with everything attached to it,
+// and must not share mutable state with the other runs.  Process-wide state,
+// such as QUIC flags, has to be set up before the runs start.
+//
+// Every run is identified by its index and receives a seed derived from the
+// base seed and the index only, so the results do not depend on the number of
+// threads or on the order in which the runs are picked up.
+class ParallelRunner {
+ public:
+  using RunFunction = std::function<void(size_t run_index, uint64_t seed)>;
+
+  // Uses up to |thread_count| threads.  A |thread_count| of zero uses one
+  // thread per available core.  A |thread_count| of one runs everything on
+  // the calling thread.
+  ParallelRunner(size_t thread_count, uint64_t base_seed);
+  ParallelRunner(const ParallelRunner&) = delete;
+  ParallelRunner& operator=(const ParallelRunner&) = delete;
+
+  // Calls |run| for every index in [0, run_count) and blocks until all the
+  // runs are finished.
+  void Run(size_t run_count, const RunFunction& run);
+
+  // Same as Run(), but collects the values returned by |run| into a vector
+  // ordered by the run index.
+  template <typename Result>
+  std::vector<Result> RunAndCollect(
+      size_t run_count,
+      const std::function<Result(size_t run_index, uint64_t seed)>& run) {
+    std::vector<Result> results(run_count);
+    Run(run_count, [&results, &run](size_t run_index, uint64_t seed) {
+      results[run_index] = run(run_index, seed);
+    });
+    return results;
+  }
+
+  // Returns the seed passed to the run number |run_index|.
+  static uint64_t SeedForRun(uint64_t base_seed, size_t run_index);
+
+  size_t thread_count() const { return thread_count_; }
+
+ private:
+  const size_t thread_count_;
+  const uint64_t base_seed_;
+};
+
+}  // namespace simulator
+}  // namespace quic
+
+#endif  // QUICHE_QUIC_TEST_TOOLS_SIMULATOR_PARALLEL_RUNNER_H_
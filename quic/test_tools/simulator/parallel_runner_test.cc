@@ -0,0 +1,98 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/quic/test_tools/simulator/parallel_runner.h"
+
+#include <set>
+
+#include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/actor.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/simulator.h"
+
+namespace quic {
+namespace simulator {
+namespace {
+
+// Calls itself at random intervals until the simulation is stopped.
+class RandomTicker : public Actor {
+ public:
+  RandomTicker(Simulator* simulator, std::string name)
+      : Actor(simulator, name), ticks_(0) {
+    Schedule(clock_->Now());
+  }
+  ~RandomTicker() override {}
+
+  void Act() override {
+    ++ticks_;
+    Schedule(clock_->Now() +
+             QuicTime::Delta::FromMicroseconds(
+                 1 + simulator_->GetRandomGenerator()->RandUint64() % 1000));
+  }
+
+  uint64_t ticks() const { return ticks_; }
+
+ private:
+  uint64_t ticks_;
+};
+
+// Runs a small simulation whose outcome depends on |seed| only.
+uint64_t RunTickerSimulation(uint64_t seed) {
+  test::SimpleRandom random;
+  random.set_seed(seed);
+  Simulator simulator;
+  simulator.set_random_generator(&random);
+  RandomTicker ticker(&simulator, "ticker");
+  simulator.RunFor(QuicTime::Delta::FromSeconds(1));
+  return ticker.ticks();
+}
+
+class ParallelRunnerTest : public QuicTest {};
+
+TEST_F(ParallelRunnerTest, SeedForRun) {
+  std::set<uint64_t> seeds;
+  for (size_t i = 0; i < 1000; ++i) {
+    seeds.insert(ParallelRunner::SeedForRun(1, i));
+  }
+  EXPECT_EQ(1000u, seeds.size());
+  EXPECT_NE(ParallelRunner::SeedForRun(1, 0), ParallelRunner::SeedForRun(2, 0));
+}
+
+TEST_F(ParallelRunnerTest, EveryRunExecutedOnce) {
+  ParallelRunner runner(4, 1);
+  std::vector<int> run_counts = runner.RunAndCollect<int>(
+      100, [](size_t /*run_index*/, uint64_t /*seed*/) { return 1; });
+  EXPECT_EQ(std::vector<int>(100, 1), run_counts);
+}
+
+TEST_F(ParallelRunnerTest, ResultsIndependentOfThreadCount) {
+  const size_t kRunCount = 16;
+  std::vector<uint64_t> expected;
+  for (size_t i = 0; i < kRunCount; ++i) {
+    expected.push_back(
+        RunTickerSimulation(ParallelRunner::SeedForRun(42, i)));
+  }
+
+  for (size_t thread_count : {1, 3, 8}) {
+    ParallelRunner runner(thread_count, 42);
+    EXPECT_EQ(expected,
+              runner.RunAndCollect<uint64_t>(
+                  kRunCount, [](size_t /*run_index*/, uint64_t seed) {
+                    return RunTickerSimulation(seed);
+                  }))
+        << "thread_count: " << thread_count;
+  }
+}
+
+TEST_F(ParallelRunnerTest, NoRuns) {
+  ParallelRunner runner(0, 1);
+  EXPECT_GE(runner.thread_count(), 1u);
+  runner.Run(0, [](size_t /*run_index*/, uint64_t /*seed*/) {
+    ADD_FAILURE() << "No run expected";
+  });
+}
+
+}  // namespace
+}  // namespace simulator
+}  // namespace quic
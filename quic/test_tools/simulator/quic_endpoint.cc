@@ -13,6 +13,7 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_connection_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/simulator/connection_profiler.h"
 #include "net/third_party/quiche/src/quic/test_tools/simulator/simulator.h"
 
 namespace quic {
@@ -79,7 +80,8 @@ QuicEndpoint::QuicEndpoint(Simulator* simulator,
       write_blocked_count_(0),
       wrong_data_received_(false),
       drop_next_packet_(false),
-      notifier_(nullptr) {
+      notifier_(nullptr),
+      profiler_(nullptr) {
   nic_tx_queue_.set_listener_interface(this);
 
   connection_.SetSelfAddress(GetAddressFromName(name));
@@ -158,6 +160,8 @@ QuicByteCount QuicEndpoint::bytes_transferred() const {
 }
 
 void QuicEndpoint::AddBytesToTransfer(QuicByteCount bytes) {
+  ConnectionProfiler::ScopedTimer timer(profiler_,
+                                        ProfiledComponent::kPacketSending);
   if (notifier_ != nullptr) {
     if (notifier_->HasBufferedStreamData()) {
       Schedule(clock_->Now());
@@ -192,6 +196,8 @@ void QuicEndpoint::AcceptPacket(std::unique_ptr<Packet> packet) {
     return;
   }
 
+  ConnectionProfiler::ScopedTimer timer(profiler_,
+                                        ProfiledComponent::kPacketProcessing);
   QuicReceivedPacket received_packet(packet->contents.data(),
                                      packet->contents.size(), clock_->Now());
   connection_.ProcessUdpPacket(connection_.self_address(),
@@ -212,6 +218,8 @@ void QuicEndpoint::OnPacketDequeued() {
       (nic_tx_queue_.capacity() - nic_tx_queue_.bytes_queued()) >=
           kMaxOutgoingPacketSize) {
     writer_.SetWritable();
+    ConnectionProfiler::ScopedTimer timer(profiler_,
+                                          ProfiledComponent::kPacketSending);
     connection_.OnCanWrite();
   }
 }
@@ -232,6 +240,8 @@ void QuicEndpoint::OnStreamFrame(const QuicStreamFrame& frame) {
 void QuicEndpoint::OnCryptoFrame(const QuicCryptoFrame& /*frame*/) {}
 
 void QuicEndpoint::OnCanWrite() {
+  ConnectionProfiler::ScopedTimer timer(profiler_,
+                                        ProfiledComponent::kPacketSending);
   if (notifier_ != nullptr) {
     notifier_->OnCanWrite();
     return;
@@ -20,6 +20,8 @@
 namespace quic {
 namespace simulator {
 
+class ConnectionProfiler;
+
 // Size of the TX queue used by the kernel/NIC.  1000 is the Linux
 // kernel default.
 const QuicByteCount kTxQueueSize = 1000;
@@ -67,6 +69,10 @@ class QuicEndpoint : public Endpoint,
   // Enables logging of the connection trace at the end of the unit test.
   void RecordTrace();
 
+  // Charges the time spent processing incoming packets and writing stream data
+  // to |profiler|.  Called by ConnectionProfiler::Attach().
+  void set_profiler(ConnectionProfiler* profiler) { profiler_ = profiler; }
+
   // Begin Endpoint implementation.
   UnconstrainedPortInterface* GetRxPort() override;
   void SetTxPort(ConstrainedPortInterface* port) override;
@@ -207,6 +213,9 @@ class QuicEndpoint : public Endpoint,
 
   std::unique_ptr<test::SimpleSessionNotifier> notifier_;
   std::unique_ptr<QuicTraceVisitor> trace_visitor_;
+
+  // Not owned.  May be nullptr.
+  ConnectionProfiler* profiler_;
 };
 
 // Multiplexes multiple connections at the same host on the network.
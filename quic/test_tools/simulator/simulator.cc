@@ -4,6 +4,8 @@
 
 #include "net/third_party/quiche/src/quic/test_tools/simulator/simulator.h"
 
+#include <algorithm>
+
 #include "net/third_party/quiche/src/quic/core/crypto/quic_random.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 
@@ -14,7 +16,9 @@ Simulator::Simulator()
     : random_generator_(nullptr),
       alarm_factory_(this, "Default Alarm Manager"),
       run_for_should_stop_(false),
-      enable_random_delays_(false) {
+      enable_random_delays_(false),
+      scheduled_actor_count_(0),
+      next_sequence_number_(0) {
   run_for_alarm_.reset(
       alarm_factory_.CreateAlarm(new RunForDelegate(&run_for_should_stop_)));
 }
@@ -42,7 +46,7 @@ QuicWallTime Simulator::Clock::WallNow() const {
 
 void Simulator::AddActor(Actor* actor) {
   auto emplace_times_result =
-      scheduled_times_.insert(std::make_pair(actor, QuicTime::Infinite()));
+      scheduled_times_.insert(std::make_pair(actor, ActorSchedule()));
   auto emplace_names_result = actor_names_.insert(actor->name());
 
   // Ensure that the object was actually placed into the map.
@@ -56,11 +60,13 @@ void Simulator::RemoveActor(Actor* actor) {
   DCHECK(scheduled_time_it != scheduled_times_.end());
   DCHECK(actor_names_it != actor_names_.end());
 
-  QuicTime scheduled_time = scheduled_time_it->second;
+  QuicTime scheduled_time = scheduled_time_it->second.time;
   if (scheduled_time != QuicTime::Infinite()) {
     Unschedule(actor);
   }
 
+  // The stale heap entries of |actor| are recognized by their actor not being
+  // registered anymore, or by their sequence number if the address is reused.
   scheduled_times_.erase(scheduled_time_it);
   actor_names_.erase(actor_names_it);
 }
@@ -68,7 +74,7 @@ void Simulator::RemoveActor(Actor* actor) {
 void Simulator::Schedule(Actor* actor, QuicTime new_time) {
   auto scheduled_time_it = scheduled_times_.find(actor);
   DCHECK(scheduled_time_it != scheduled_times_.end());
-  QuicTime scheduled_time = scheduled_time_it->second;
+  QuicTime scheduled_time = scheduled_time_it->second.time;
 
   if (scheduled_time <= new_time) {
     return;
@@ -78,25 +84,58 @@ void Simulator::Schedule(Actor* actor, QuicTime new_time) {
     Unschedule(actor);
   }
 
-  scheduled_time_it->second = new_time;
-  schedule_.insert(std::make_pair(new_time, actor));
+  const uint64_t sequence_number = next_sequence_number_++;
+  scheduled_time_it->second.time = new_time;
+  scheduled_time_it->second.sequence_number = sequence_number;
+  schedule_.push_back({new_time, sequence_number, actor});
+  std::push_heap(schedule_.begin(), schedule_.end(), ScheduleEntryGreater());
+  ++scheduled_actor_count_;
+
+  MaybeCompactSchedule();
 }
 
 void Simulator::Unschedule(Actor* actor) {
   auto scheduled_time_it = scheduled_times_.find(actor);
   DCHECK(scheduled_time_it != scheduled_times_.end());
-  QuicTime scheduled_time = scheduled_time_it->second;
-
-  DCHECK(scheduled_time != QuicTime::Infinite());
-  auto range = schedule_.equal_range(scheduled_time);
-  for (auto it = range.first; it != range.second; ++it) {
-    if (it->second == actor) {
-      schedule_.erase(it);
-      scheduled_time_it->second = QuicTime::Infinite();
-      return;
-    }
+  DCHECK(scheduled_time_it->second.time != QuicTime::Infinite());
+
+  // The heap entry of |actor| becomes stale and is discarded later.
+  scheduled_time_it->second.time = QuicTime::Infinite();
+  DCHECK_GT(scheduled_actor_count_, 0u);
+  --scheduled_actor_count_;
+}
+
+bool Simulator::IsCurrent(const ScheduleEntry& entry) const {
+  auto scheduled_time_it = scheduled_times_.find(entry.actor);
+  return scheduled_time_it != scheduled_times_.end() &&
+         scheduled_time_it->second.time == entry.time &&
+         scheduled_time_it->second.sequence_number == entry.sequence_number;
+}
+
+bool Simulator::HasScheduledActors() {
+  while (!schedule_.empty() && !IsCurrent(schedule_.front())) {
+    std::pop_heap(schedule_.begin(), schedule_.end(), ScheduleEntryGreater());
+    schedule_.pop_back();
+  }
+  DCHECK_EQ(schedule_.empty(), scheduled_actor_count_ == 0);
+  return !schedule_.empty();
+}
+
+void Simulator::MaybeCompactSchedule() {
+  // Allow a fixed amount of slack so that small schedules are never rebuilt.
+  const size_t kMinScheduleSizeToCompact = 64;
+  if (schedule_.size() < kMinScheduleSizeToCompact ||
+      schedule_.size() < 2 * scheduled_actor_count_) {
+    return;
   }
-  DCHECK(false);
+
+  schedule_.erase(std::remove_if(schedule_.begin(), schedule_.end(),
+                                 [this](const ScheduleEntry& entry) {
+                                   return !IsCurrent(entry);
+                                 }),
+                  schedule_.end());
+  std::make_heap(schedule_.begin(), schedule_.end(), ScheduleEntryGreater());
+  DCHECK_EQ(schedule_.size(), scheduled_actor_count_);
 }
 
 const QuicClock* Simulator::GetClock() const {
@@ -144,9 +183,11 @@ void Simulator::RunFor(QuicTime::Delta time_span) {
 }
 
 void Simulator::HandleNextScheduledActor() {
-  const auto current_event_it = schedule_.begin();
-  QuicTime event_time = current_event_it->first;
-  Actor* actor = current_event_it->second;
+  DCHECK(!schedule_.empty() && IsCurrent(schedule_.front()));
+  const QuicTime event_time = schedule_.front().time;
+  Actor* actor = schedule_.front().actor;
+  std::pop_heap(schedule_.begin(), schedule_.end(), ScheduleEntryGreater());
+  schedule_.pop_back();
   QUIC_DVLOG(3) << "At t = " << event_time.ToDebuggingValue() << ", calling "
                 << actor->name();
 
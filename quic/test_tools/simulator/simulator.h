@@ -5,7 +5,8 @@
 #ifndef QUICHE_QUIC_TEST_TOOLS_SIMULATOR_SIMULATOR_H_
 #define QUICHE_QUIC_TEST_TOOLS_SIMULATOR_SIMULATOR_H_
 
-#include <map>
+#include <cstdint>
+#include <vector>
 
 #include "net/third_party/quiche/src/quic/core/quic_connection.h"
 #include "net/third_party/quiche/src/quic/core/quic_simple_buffer_allocator.h"
@@ -101,8 +102,47 @@ class Simulator : public QuicConnectionHelperInterface {
   // Unregister an actor with the simulator. Invoked by Actor destructor.
   void RemoveActor(Actor* actor);
 
+  // An entry of |schedule_|.  Entries are never removed from the middle of the
+  // heap; instead, unscheduling an actor only updates |scheduled_times_|, and
+  // the entries that no longer match it are discarded once they reach the top.
+  struct ScheduleEntry {
+    QuicTime time;
+    // Breaks the ties between the actors scheduled for the same time, so that
+    // they are called in the order in which they were scheduled.
+    uint64_t sequence_number;
+    Actor* actor;
+  };
+
+  // Orders |schedule_| as a min-heap.
+  struct ScheduleEntryGreater {
+    bool operator()(const ScheduleEntry& a, const ScheduleEntry& b) const {
+      if (a.time != b.time) {
+        return a.time > b.time;
+      }
+      return a.sequence_number > b.sequence_number;
+    }
+  };
+
+  // The time an actor is scheduled at, along with the sequence number of its
+  // current entry in |schedule_|.
+  struct ActorSchedule {
+    QuicTime time = QuicTime::Infinite();
+    uint64_t sequence_number = 0;
+  };
+
+  // Returns true if |entry| still reflects the schedule of its actor.
+  bool IsCurrent(const ScheduleEntry& entry) const;
+
+  // Discards the stale entries at the top of |schedule_|, and returns true if
+  // there are any actors left in the schedule.
+  bool HasScheduledActors();
+
+  // Rebuilds |schedule_| without the stale entries once they outnumber the
+  // current ones.
+  void MaybeCompactSchedule();
+
   // Finds the next scheduled actor, advances time to the schedule time and
-  // notifies the actor.
+  // notifies the actor.  Must only be called if HasScheduledActors() is true.
   void HandleNextScheduledActor();
 
   Clock clock_;
@@ -119,17 +159,22 @@ class Simulator : public QuicConnectionHelperInterface {
   // order to avoid synchronization issues.
   bool enable_random_delays_;
 
-  // Schedule of when the actors will be executed via an Act() call.  The
-  // schedule is subject to the following invariants:
+  // Schedule of when the actors will be executed via an Act() call, stored as
+  // a binary min-heap ordered by ScheduleEntryGreater.  The schedule is subject
+  // to the following invariants:
   // - An actor cannot be scheduled for a later time than it's currently in the
   //   schedule.
   // - An actor is removed from schedule either immediately before Act() is
   //   called or by explicitly calling Unschedule().
-  // - Each Actor appears in the map at most once.
-  std::multimap<QuicTime, Actor*> schedule_;
+  // - Each Actor has at most one current entry in the heap; all of its other
+  //   entries are stale and are skipped.
+  std::vector<ScheduleEntry> schedule_;
   // For each actor, maintain the time it is scheduled at.  The value for
   // unscheduled actors is QuicTime::Infinite().
-  QuicUnorderedMap<Actor*, QuicTime> scheduled_times_;
+  QuicUnorderedMap<Actor*, ActorSchedule> scheduled_times_;
+  // Number of current entries in |schedule_|.
+  size_t scheduled_actor_count_;
+  uint64_t next_sequence_number_;
   QuicUnorderedSet<std::string> actor_names_;
 };
 
@@ -138,7 +183,7 @@ bool Simulator::RunUntil(TerminationPredicate termination_predicate) {
   bool predicate_value = false;
   while (true) {
     predicate_value = termination_predicate();
-    if (predicate_value || schedule_.empty()) {
+    if (predicate_value || !HasScheduledActors()) {
       break;
     }
     HandleNextScheduledActor();
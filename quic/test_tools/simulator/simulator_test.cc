@@ -7,6 +7,7 @@
 #include "net/third_party/quiche/src/quic/platform/api/quic_containers.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_str_cat.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_test_utils.h"
 #include "net/third_party/quiche/src/quic/test_tools/simulator/alarm_factory.h"
@@ -66,6 +67,89 @@ TEST_F(SimulatorTest, Counters) {
   }
 }
 
+// An actor which records its name into a shared log every time it is called.
+class ActLogger : public Actor {
+ public:
+  ActLogger(Simulator* simulator,
+            std::string name,
+            std::vector<std::string>* log)
+      : Actor(simulator, name), log_(log) {}
+  ~ActLogger() override {}
+
+  void ScheduleAt(QuicTime time) { Schedule(time); }
+  void Cancel() { Unschedule(); }
+
+  void Act() override { log_->push_back(name_); }
+
+ private:
+  std::vector<std::string>* log_;
+};
+
+// Test that the actors scheduled for the same time are called in the order in
+// which they were scheduled, and that rescheduling and unscheduling work.
+TEST_F(SimulatorTest, ScheduleOrder) {
+  Simulator simulator;
+  std::vector<std::string> log;
+  ActLogger a(&simulator, "a", &log);
+  ActLogger b(&simulator, "b", &log);
+  ActLogger c(&simulator, "c", &log);
+  ActLogger d(&simulator, "d", &log);
+
+  const QuicTime start = simulator.GetClock()->Now();
+  const QuicTime::Delta step = QuicTime::Delta::FromMilliseconds(1);
+  c.ScheduleAt(start + step);
+  a.ScheduleAt(start + step);
+  b.ScheduleAt(start + step);
+  // Scheduling for a later time has no effect.
+  a.ScheduleAt(start + 5 * step);
+  // Scheduling for an earlier time moves the actor.
+  d.ScheduleAt(start + 3 * step);
+  d.ScheduleAt(start + 2 * step);
+  // Unscheduling and rescheduling moves the actor to the end of its time slot.
+  c.Cancel();
+  c.ScheduleAt(start + step);
+  b.Cancel();
+
+  simulator.RunUntil([]() { return false; });
+  EXPECT_EQ((std::vector<std::string>{"a", "c", "d"}), log);
+  EXPECT_EQ(start + 2 * step, simulator.GetClock()->Now());
+}
+
+// Test that a schedule with a lot of rescheduled and cancelled actors still
+// calls every scheduled actor exactly once.
+TEST_F(SimulatorTest, ScheduleChurn) {
+  Simulator simulator;
+  std::vector<std::string> log;
+  std::vector<std::unique_ptr<ActLogger>> actors;
+  const size_t kActorCount = 200;
+  for (size_t i = 0; i < kActorCount; ++i) {
+    actors.push_back(QuicMakeUnique<ActLogger>(
+        &simulator, QuicStrCat("actor ", i), &log));
+  }
+
+  const QuicTime start = simulator.GetClock()->Now();
+  for (int round = 100; round > 0; --round) {
+    for (auto& actor : actors) {
+      actor->ScheduleAt(start + QuicTime::Delta::FromMilliseconds(round));
+    }
+  }
+  for (size_t i = 0; i < kActorCount; i += 2) {
+    actors[i]->Cancel();
+  }
+  // Destroy some of the cancelled actors while they still have stale entries.
+  for (size_t i = 0; i < kActorCount; i += 4) {
+    actors[i].reset();
+  }
+
+  simulator.RunUntil([]() { return false; });
+  EXPECT_EQ(kActorCount / 2, log.size());
+  for (size_t i = 0; i < log.size(); ++i) {
+    EXPECT_EQ(QuicStrCat("actor ", 2 * i + 1), log[i]);
+  }
+  EXPECT_EQ(start + QuicTime::Delta::FromMilliseconds(1),
+            simulator.GetClock()->Now());
+}
+
 // A port which counts the number of packets received on it, both total and
 // per-destination.
 class CounterPort : public UnconstrainedPortInterface {
@@ -5,6 +5,9 @@
 #ifndef QUICHE_QUIC_TOOLS_QUIC_BACKEND_RESPONSE_H_
 #define QUICHE_QUIC_TOOLS_QUIC_BACKEND_RESPONSE_H_
 
+#include <memory>
+
+#include "net/third_party/quiche/src/quic/core/quic_types.h"
 #include "net/third_party/quiche/src/quic/tools/quic_url.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
 
@@ -29,6 +32,23 @@ class QuicBackendResponse {
     std::string body;
   };
 
+  // Produces the body of a response on demand, so that it does not have to
+  // be held in memory in full.  Responses, and hence generators, may be
+  // shared by concurrent streams, which each read at their own offset.
+  class BodyGenerator {
+   public:
+    virtual ~BodyGenerator() {}
+
+    // Returns the length of the body.
+    virtual QuicByteCount length() const = 0;
+
+    // Copies |length| bytes of the body starting at |offset| to
+    // |destination|.  |offset| + |length| never exceeds length().
+    virtual void CopyBody(QuicStreamOffset offset,
+                          QuicByteCount length,
+                          char* destination) const = 0;
+  };
+
   enum SpecialResponseType {
     REGULAR_RESPONSE,      // Send the headers and body like a server should.
     CLOSE_CONNECTION,      // Close the connection (sending the close packet).
@@ -54,6 +74,12 @@ class QuicBackendResponse {
   const spdy::SpdyHeaderBlock& headers() const { return headers_; }
   const spdy::SpdyHeaderBlock& trailers() const { return trailers_; }
   const QuicStringPiece body() const { return QuicStringPiece(body_); }
+  // If not null, the body is streamed from the generator and body() is
+  // ignored.  Streams share ownership of the generator while they stream the
+  // body, so that it stays valid if the response gets replaced.
+  std::shared_ptr<const BodyGenerator> body_generator() const {
+    return body_generator_;
+  }
 
   void set_response_type(SpecialResponseType response_type) {
     response_type_ = response_type;
@@ -68,6 +94,9 @@ class QuicBackendResponse {
   void set_body(QuicStringPiece body) {
     body_.assign(body.data(), body.size());
   }
+  void set_body_generator(std::unique_ptr<BodyGenerator> body_generator) {
+    body_generator_ = std::move(body_generator);
+  }
   uint16_t stop_sending_code() const { return stop_sending_code_; }
   void set_stop_sending_code(uint16_t code) { stop_sending_code_ = code; }
 
@@ -76,6 +105,7 @@ class QuicBackendResponse {
   spdy::SpdyHeaderBlock headers_;
   spdy::SpdyHeaderBlock trailers_;
   std::string body_;
+  std::shared_ptr<const BodyGenerator> body_generator_;
   uint16_t stop_sending_code_;
 };
 
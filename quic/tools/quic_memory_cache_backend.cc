@@ -182,7 +182,7 @@ void QuicMemoryCacheBackend::AddResponse(QuicStringPiece host,
                                          QuicStringPiece response_body) {
   AddResponseImpl(host, path, QuicBackendResponse::REGULAR_RESPONSE,
                   std::move(response_headers), response_body, SpdyHeaderBlock(),
-                  0);
+                  0, nullptr);
 }
 
 void QuicMemoryCacheBackend::AddResponse(QuicStringPiece host,
@@ -192,7 +192,18 @@ void QuicMemoryCacheBackend::AddResponse(QuicStringPiece host,
                                          SpdyHeaderBlock response_trailers) {
   AddResponseImpl(host, path, QuicBackendResponse::REGULAR_RESPONSE,
                   std::move(response_headers), response_body,
-                  std::move(response_trailers), 0);
+                  std::move(response_trailers), 0, nullptr);
+}
+
+void QuicMemoryCacheBackend::AddResponseWithBodyGenerator(
+    QuicStringPiece host,
+    QuicStringPiece path,
+    SpdyHeaderBlock response_headers,
+    std::unique_ptr<QuicBackendResponse::BodyGenerator> body_generator,
+    SpdyHeaderBlock response_trailers) {
+  AddResponseImpl(host, path, QuicBackendResponse::REGULAR_RESPONSE,
+                  std::move(response_headers), "", std::move(response_trailers),
+                  0, std::move(body_generator));
 }
 
 void QuicMemoryCacheBackend::AddSpecialResponse(
@@ -200,7 +211,7 @@ void QuicMemoryCacheBackend::AddSpecialResponse(
     QuicStringPiece path,
     SpecialResponseType response_type) {
   AddResponseImpl(host, path, response_type, SpdyHeaderBlock(), "",
-                  SpdyHeaderBlock(), 0);
+                  SpdyHeaderBlock(), 0, nullptr);
 }
 
 void QuicMemoryCacheBackend::AddSpecialResponse(
@@ -210,7 +221,7 @@ void QuicMemoryCacheBackend::AddSpecialResponse(
     QuicStringPiece response_body,
     SpecialResponseType response_type) {
   AddResponseImpl(host, path, response_type, std::move(response_headers),
-                  response_body, SpdyHeaderBlock(), 0);
+                  response_body, SpdyHeaderBlock(), 0, nullptr);
 }
 
 void QuicMemoryCacheBackend::AddStopSendingResponse(
@@ -221,7 +232,7 @@ void QuicMemoryCacheBackend::AddStopSendingResponse(
     uint16_t stop_sending_code) {
   AddResponseImpl(host, path, SpecialResponseType::STOP_SENDING,
                   std::move(response_headers), response_body, SpdyHeaderBlock(),
-                  stop_sending_code);
+                  stop_sending_code, nullptr);
 }
 
 QuicMemoryCacheBackend::QuicMemoryCacheBackend() : cache_initialized_(false) {}
@@ -326,13 +337,15 @@ QuicMemoryCacheBackend::~QuicMemoryCacheBackend() {
   }
 }
 
-void QuicMemoryCacheBackend::AddResponseImpl(QuicStringPiece host,
-                                             QuicStringPiece path,
-                                             SpecialResponseType response_type,
-                                             SpdyHeaderBlock response_headers,
-                                             QuicStringPiece response_body,
-                                             SpdyHeaderBlock response_trailers,
-                                             uint16_t stop_sending_code) {
+void QuicMemoryCacheBackend::AddResponseImpl(
+    QuicStringPiece host,
+    QuicStringPiece path,
+    SpecialResponseType response_type,
+    SpdyHeaderBlock response_headers,
+    QuicStringPiece response_body,
+    SpdyHeaderBlock response_trailers,
+    uint16_t stop_sending_code,
+    std::unique_ptr<QuicBackendResponse::BodyGenerator> body_generator) {
   QuicWriterMutexLock lock(&response_mutex_);
 
   DCHECK(!host.empty()) << "Host must be populated, e.g. \"www.google.com\"";
@@ -347,6 +360,7 @@ void QuicMemoryCacheBackend::AddResponseImpl(QuicStringPiece host,
   new_response->set_body(response_body);
   new_response->set_trailers(std::move(response_trailers));
   new_response->set_stop_sending_code(stop_sending_code);
+  new_response->set_body_generator(std::move(body_generator));
   QUIC_DVLOG(1) << "Add response with key " << key;
   responses_[key] = std::move(new_response);
 }
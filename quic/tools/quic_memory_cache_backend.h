@@ -111,6 +111,16 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
                    QuicStringPiece response_body,
                    spdy::SpdyHeaderBlock response_trailers);
 
+  // Add a response whose body is streamed from |body_generator| instead of
+  // being held in memory.  |response_headers| should carry the content-length
+  // of the body.
+  void AddResponseWithBodyGenerator(
+      QuicStringPiece host,
+      QuicStringPiece path,
+      spdy::SpdyHeaderBlock response_headers,
+      std::unique_ptr<QuicBackendResponse::BodyGenerator> body_generator,
+      spdy::SpdyHeaderBlock response_trailers);
+
   // Simulate a special behavior at a particular path.
   void AddSpecialResponse(
       QuicStringPiece host,
@@ -153,13 +163,15 @@ class QuicMemoryCacheBackend : public QuicSimpleServerBackend {
       QuicSimpleServerBackend::RequestHandler* quic_server_stream) override;
 
  private:
-  void AddResponseImpl(QuicStringPiece host,
-                       QuicStringPiece path,
-                       QuicBackendResponse::SpecialResponseType response_type,
-                       spdy::SpdyHeaderBlock response_headers,
-                       QuicStringPiece response_body,
-                       spdy::SpdyHeaderBlock response_trailers,
-                       uint16_t stop_sending_code);
+  void AddResponseImpl(
+      QuicStringPiece host,
+      QuicStringPiece path,
+      QuicBackendResponse::SpecialResponseType response_type,
+      spdy::SpdyHeaderBlock response_headers,
+      QuicStringPiece response_body,
+      spdy::SpdyHeaderBlock response_trailers,
+      uint16_t stop_sending_code,
+      std::unique_ptr<QuicBackendResponse::BodyGenerator> body_generator);
 
   std::string GetKey(QuicStringPiece host, QuicStringPiece path) const;
 
@@ -4,16 +4,20 @@
 
 #include "net/third_party/quiche/src/quic/tools/quic_simple_server_stream.h"
 
+#include <algorithm>
 #include <list>
 #include <utility>
 
 #include "net/third_party/quiche/src/quic/core/http/quic_spdy_stream.h"
 #include "net/third_party/quiche/src/quic/core/http/spdy_utils.h"
+#include "net/third_party/quiche/src/quic/core/quic_send_buffer_pool.h"
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_bug_tracker.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_logging.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_map_util.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_mem_slice_span.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
 #include "net/third_party/quiche/src/quic/tools/quic_simple_server_session.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
@@ -29,7 +33,8 @@ QuicSimpleServerStream::QuicSimpleServerStream(
     QuicSimpleServerBackend* quic_simple_server_backend)
     : QuicSpdyServerStreamBase(id, session, type),
       content_length_(-1),
-      quic_simple_server_backend_(quic_simple_server_backend) {
+      quic_simple_server_backend_(quic_simple_server_backend),
+      body_generator_offset_(0) {
   DCHECK(quic_simple_server_backend_);
 }
 
@@ -40,7 +45,8 @@ QuicSimpleServerStream::QuicSimpleServerStream(
     QuicSimpleServerBackend* quic_simple_server_backend)
     : QuicSpdyServerStreamBase(pending, session, type),
       content_length_(-1),
-      quic_simple_server_backend_(quic_simple_server_backend) {
+      quic_simple_server_backend_(quic_simple_server_backend),
+      body_generator_offset_(0) {
   DCHECK(quic_simple_server_backend_);
 }
 
@@ -105,6 +111,15 @@ void QuicSimpleServerStream::OnBodyAvailable() {
   SendResponse();
 }
 
+void QuicSimpleServerStream::ReleaseStateWhileWaitingForAcks() {
+  QuicSpdyStream::ReleaseStateWhileWaitingForAcks();
+  // SpdyHeaderBlock::clear() keeps the storage for reuse, so release it by
+  // moving an empty block in.
+  request_headers_ = SpdyHeaderBlock();
+  std::string().swap(body_);
+  body_generator_ = nullptr;
+}
+
 void QuicSimpleServerStream::PushResponse(
     SpdyHeaderBlock push_request_headers) {
   if (QuicUtils::IsClientInitiatedStreamId(
@@ -260,6 +275,14 @@ void QuicSimpleServerStream::OnResponseBackendComplete(
     return;
   }
 
+  if (response->body_generator() != nullptr) {
+    QUIC_DVLOG(1) << "Stream " << id() << " streaming response.";
+    SendHeadersAndStreamedBody(response->headers().Clone(),
+                               response->body_generator(),
+                               response->trailers().Clone());
+    return;
+  }
+
   QUIC_DVLOG(1) << "Stream " << id() << " sending response.";
   SendHeadersAndBodyAndTrailers(response->headers().Clone(), response->body(),
                                 response->trailers().Clone());
@@ -344,8 +367,81 @@ void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
   WriteTrailers(std::move(response_trailers), nullptr);
 }
 
+void QuicSimpleServerStream::SendHeadersAndStreamedBody(
+    SpdyHeaderBlock response_headers,
+    std::shared_ptr<const QuicBackendResponse::BodyGenerator> body_generator,
+    SpdyHeaderBlock response_trailers) {
+  const bool send_fin =
+      body_generator->length() == 0 && response_trailers.empty();
+  QUIC_DLOG(INFO) << "Stream " << id() << " writing headers (fin = " << send_fin
+                  << ") : " << response_headers.DebugString();
+  WriteHeaders(std::move(response_headers), send_fin, nullptr);
+  if (send_fin) {
+    return;
+  }
+
+  body_generator_ = std::move(body_generator);
+  body_generator_offset_ = 0;
+  streamed_body_trailers_ = std::move(response_trailers);
+  WriteStreamedBody();
+}
+
+void QuicSimpleServerStream::OnCanWriteNewData() {
+  QuicSpdyServerStreamBase::OnCanWriteNewData();
+  WriteStreamedBody();
+}
+
+void QuicSimpleServerStream::WriteStreamedBody() {
+  // Chunks are allocated like the data the send buffer copies itself: from
+  // the session's send buffer pool if the stream uses it, in chunks of the
+  // size the pool recycles.
+  QuicBufferAllocator* allocator =
+      session()->connection()->helper()->GetStreamSendBufferAllocator();
+  QuicByteCount max_chunk_length = kStreamedBodyChunkSize;
+  QuicSendBufferPool* pool = send_buffer().pool();
+  if (pool != nullptr) {
+    allocator = pool;
+    max_chunk_length = pool->chunk_size();
+  }
+  while (body_generator_ != nullptr && !write_side_closed() &&
+         CanBufferNewData()) {
+    const QuicByteCount chunk_length =
+        std::min(max_chunk_length,
+                 body_generator_->length() - body_generator_offset_);
+    const bool body_done =
+        body_generator_offset_ + chunk_length == body_generator_->length();
+    const bool send_fin = body_done && streamed_body_trailers_.empty();
+    QUIC_DVLOG(1) << "Stream " << id() << " writing " << chunk_length
+                  << " bytes of streamed body (fin = " << send_fin << ").";
+    if (chunk_length > 0) {
+      QuicMemSlice slice(allocator, chunk_length);
+      body_generator_->CopyBody(body_generator_offset_, chunk_length,
+                                const_cast<char*>(slice.data()));
+      if (WriteBodySlices(QuicMemSliceSpan(&slice), send_fin).bytes_consumed ==
+          0) {
+        // There is no room for the DATA frame header.  The chunk is generated
+        // again once OnCanWriteNewData() is called.
+        return;
+      }
+    } else if (send_fin) {
+      WriteOrBufferBody(QuicStringPiece(), send_fin);
+    }
+    body_generator_offset_ += chunk_length;
+    if (body_done) {
+      body_generator_.reset();
+    }
+    if (body_done && !send_fin) {
+      QUIC_DLOG(INFO) << "Stream " << id()
+                      << " writing trailers (fin = true): "
+                      << streamed_body_trailers_.DebugString();
+      WriteTrailers(std::move(streamed_body_trailers_), nullptr);
+    }
+  }
+}
+
 const char* const QuicSimpleServerStream::kErrorResponseBody = "bad";
 const char* const QuicSimpleServerStream::kNotFoundResponseBody =
     "file not found";
+const QuicByteCount QuicSimpleServerStream::kStreamedBodyChunkSize = 16 * 1024;
 
 }  // namespace quic
@@ -5,6 +5,8 @@
 #ifndef QUICHE_QUIC_TOOLS_QUIC_SIMPLE_SERVER_STREAM_H_
 #define QUICHE_QUIC_TOOLS_QUIC_SIMPLE_SERVER_STREAM_H_
 
+#include <memory>
+
 #include "net/third_party/quiche/src/quic/core/http/quic_spdy_server_stream_base.h"
 #include "net/third_party/quiche/src/quic/core/quic_packets.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_string_piece.h"
@@ -43,6 +45,9 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
   // data (or a FIN) to be read.
   void OnBodyAvailable() override;
 
+  // QuicStream
+  void ReleaseStateWhileWaitingForAcks() override;
+
   // Make this stream start from as if it just finished parsing an incoming
   // request whose headers are equivalent to |push_request_headers|.
   // Doing so will trigger this toy stream to fetch response and send it back.
@@ -52,6 +57,10 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
   static const char* const kErrorResponseBody;
   static const char* const kNotFoundResponseBody;
 
+  // Size of the chunks streamed response bodies are written in, unless the
+  // stream allocates them from a send buffer pool.
+  static const QuicByteCount kStreamedBodyChunkSize;
+
   // Implements QuicSimpleServerBackend::RequestHandler callbacks
   QuicConnectionId connection_id() const override;
   QuicStreamId stream_id() const override;
@@ -84,6 +93,17 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
                                      QuicStringPiece body,
                                      spdy::SpdyHeaderBlock response_trailers);
 
+  // Sends the response headers, then writes the body from |body_generator|
+  // chunk by chunk, whenever the send buffer runs low, and finally the
+  // trailers.
+  void SendHeadersAndStreamedBody(
+      spdy::SpdyHeaderBlock response_headers,
+      std::shared_ptr<const QuicBackendResponse::BodyGenerator> body_generator,
+      spdy::SpdyHeaderBlock response_trailers);
+
+  // QuicStream
+  void OnCanWriteNewData() override;
+
   spdy::SpdyHeaderBlock* request_headers() { return &request_headers_; }
 
   const std::string& body() { return body_; }
@@ -94,7 +114,18 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase,
   std::string body_;
 
  private:
+  // Writes chunks of the streamed body until the send buffer is full or the
+  // body is done.  Chunks are generated straight into the QuicMemSlices which
+  // the send buffer takes over.
+  void WriteStreamedBody();
+
   QuicSimpleServerBackend* quic_simple_server_backend_;  // Not owned.
+
+  // The body being streamed, if any, and how much of it has been written.
+  std::shared_ptr<const QuicBackendResponse::BodyGenerator> body_generator_;
+  QuicStreamOffset body_generator_offset_;
+  // Trailers to send once the streamed body is done.
+  spdy::SpdyHeaderBlock streamed_body_trailers_;
 };
 
 }  // namespace quic
@@ -12,10 +12,13 @@
 #include "net/third_party/quiche/src/quic/core/quic_utils.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_arraysize.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_expect_bug.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_flags.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_ptr_util.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_socket_address.h"
 #include "net/third_party/quiche/src/quic/platform/api/quic_test.h"
+#include "net/third_party/quiche/src/quic/platform/api/quic_text_utils.h"
 #include "net/third_party/quiche/src/quic/test_tools/crypto_test_utils.h"
+#include "net/third_party/quiche/src/quic/test_tools/quic_flow_controller_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_session_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_spdy_session_peer.h"
 #include "net/third_party/quiche/src/quic/test_tools/quic_stream_peer.h"
@@ -80,6 +83,25 @@ class TestStream : public QuicSimpleServerStream {
 
 namespace {
 
+// Generates a body of |length| bytes cycling through the alphabet.
+class AlphabetBodyGenerator : public QuicBackendResponse::BodyGenerator {
+ public:
+  explicit AlphabetBodyGenerator(QuicByteCount length) : length_(length) {}
+
+  QuicByteCount length() const override { return length_; }
+
+  void CopyBody(QuicStreamOffset offset,
+                QuicByteCount length,
+                char* destination) const override {
+    for (QuicByteCount i = 0; i < length; ++i) {
+      destination[i] = 'a' + (offset + i) % 26;
+    }
+  }
+
+ private:
+  const QuicByteCount length_;
+};
+
 class MockQuicSimpleServerSession : public QuicSimpleServerSession {
  public:
   const size_t kMaxStreamsForTest = 100;
@@ -478,6 +500,97 @@ TEST_P(QuicSimpleServerStreamTest, SendResponseWithValidHeaders) {
   EXPECT_TRUE(stream_->write_side_closed());
 }
 
+TEST_P(QuicSimpleServerStreamTest, SendStreamedResponse) {
+  if (GetParam().handshake_protocol == PROTOCOL_TLS1_3) {
+    // Like SendResponseWithValidHeaders, this does not work with TLS yet.
+    return;
+  }
+  spdy::SpdyHeaderBlock* request_headers = stream_->mutable_headers();
+  (*request_headers)[":path"] = "/bar";
+  (*request_headers)[":authority"] = "www.google.com";
+  (*request_headers)[":version"] = "HTTP/1.1";
+  (*request_headers)[":method"] = "GET";
+
+  const QuicByteCount body_length =
+      4 * (GetQuicFlag(FLAGS_quic_buffered_data_threshold) +
+           QuicSimpleServerStream::kStreamedBodyChunkSize);
+  response_headers_[":version"] = "HTTP/1.1";
+  response_headers_[":status"] = "200";
+  response_headers_["content-length"] =
+      QuicTextUtils::Uint64ToString(body_length);
+  memory_cache_backend_.AddResponseWithBodyGenerator(
+      "www.google.com", "/bar", std::move(response_headers_),
+      QuicMakeUnique<AlphabetBodyGenerator>(body_length),
+      spdy::SpdyHeaderBlock());
+  QuicFlowControllerPeer::SetSendWindowOffset(stream_->flow_controller(),
+                                              2 * body_length);
+  QuicFlowControllerPeer::SetSendWindowOffset(session_.flow_controller(),
+                                              2 * body_length);
+  stream_->set_fin_received(true);
+
+  // While the connection is blocked, only the first chunks of the body are
+  // buffered.
+  EXPECT_CALL(*stream_, WriteHeadersMock(false));
+  EXPECT_CALL(session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Return(QuicConsumedData(0, false)));
+  stream_->DoSendResponse();
+  EXPECT_FALSE(stream_->write_side_closed());
+  EXPECT_LT(0u, stream_->BufferedDataBytes());
+  EXPECT_GT(body_length / 2, stream_->BufferedDataBytes());
+
+  // Once the connection is writable, the rest of the body follows.
+  EXPECT_CALL(session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Invoke(MockQuicSession::ConsumeData));
+  stream_->OnCanWrite();
+  EXPECT_TRUE(stream_->write_side_closed());
+  EXPECT_EQ(0u, stream_->BufferedDataBytes());
+  EXPECT_LE(body_length, stream_->stream_bytes_written());
+}
+
+TEST_P(QuicSimpleServerStreamTest, SendStreamedResponseFromSendBufferPool) {
+  if (GetParam().handshake_protocol == PROTOCOL_TLS1_3) {
+    // Like SendResponseWithValidHeaders, this does not work with TLS yet.
+    return;
+  }
+  session_.EnableSendBufferPool(1024 * 1024);
+  StrictMock<TestStream>* stream = new StrictMock<TestStream>(
+      GetNthClientInitiatedBidirectionalStreamId(
+          connection_->transport_version(), 1),
+      &session_, BIDIRECTIONAL, &memory_cache_backend_);
+  session_.ActivateStream(QuicWrapUnique(stream));
+  spdy::SpdyHeaderBlock* request_headers = stream->mutable_headers();
+  (*request_headers)[":path"] = "/bar";
+  (*request_headers)[":authority"] = "www.google.com";
+  (*request_headers)[":version"] = "HTTP/1.1";
+  (*request_headers)[":method"] = "GET";
+
+  const QuicByteCount body_length =
+      4 * (GetQuicFlag(FLAGS_quic_buffered_data_threshold) +
+           QuicSimpleServerStream::kStreamedBodyChunkSize);
+  response_headers_[":version"] = "HTTP/1.1";
+  response_headers_[":status"] = "200";
+  response_headers_["content-length"] =
+      QuicTextUtils::Uint64ToString(body_length);
+  memory_cache_backend_.AddResponseWithBodyGenerator(
+      "www.google.com", "/bar", std::move(response_headers_),
+      QuicMakeUnique<AlphabetBodyGenerator>(body_length),
+      spdy::SpdyHeaderBlock());
+  QuicFlowControllerPeer::SetSendWindowOffset(stream->flow_controller(),
+                                              2 * body_length);
+  QuicFlowControllerPeer::SetSendWindowOffset(session_.flow_controller(),
+                                              2 * body_length);
+  stream->set_fin_received(true);
+
+  // The buffered body chunks are accounted to the session's pool.
+  EXPECT_CALL(*stream, WriteHeadersMock(false));
+  EXPECT_CALL(session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Return(QuicConsumedData(0, false)));
+  stream->DoSendResponse();
+  EXPECT_LT(0u, stream->BufferedDataBytes());
+  EXPECT_EQ(stream->BufferedDataBytes(),
+            session_.send_buffer_pool()->buffered_bytes());
+}
+
 TEST_P(QuicSimpleServerStreamTest, SendResponseWithPushResources) {
   if (GetParam().handshake_protocol == PROTOCOL_TLS1_3) {
     // TODO(nharper, b/112643533): Figure out why this test fails when TLS is
@@ -524,6 +637,21 @@ TEST_P(QuicSimpleServerStreamTest, SendResponseWithPushResources) {
   EXPECT_EQ(*request_headers, session_.original_request_headers_);
 }
 
+TEST_P(QuicSimpleServerStreamTest, ReleaseStateWhileWaitingForAcks) {
+  spdy::SpdyHeaderBlock* request_headers = stream_->mutable_headers();
+  (*request_headers)[":path"] = "/bar";
+  (*request_headers)[":authority"] = "www.google.com";
+  (*request_headers)[":method"] = "GET";
+  stream_->set_body(std::string(1000, 'a'));
+  EXPECT_LT(0u, request_headers->EstimateMemoryUsage());
+
+  // The memory of the request is freed, not only cleared for reuse.
+  stream_->ReleaseStateWhileWaitingForAcks();
+  EXPECT_TRUE(request_headers->empty());
+  EXPECT_EQ(0u, request_headers->EstimateMemoryUsage());
+  EXPECT_GT(1000u, stream_->body().capacity());
+}
+
 TEST_P(QuicSimpleServerStreamTest, PushResponseOnClientInitiatedStream) {
   // EXPECT_QUIC_BUG tests are expensive so only run one instance of them.
   if (GetParam() != AllSupportedVersions()[0]) {
@@ -5,6 +5,7 @@
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_constants.h"
 
 #include <cstddef>
+#include <iterator>
 #include <memory>
 #include <vector>
 
@@ -292,75 +293,91 @@ const std::vector<HpackHuffmanSymbol>& HpackHuffmanCodeVector() {
 #define STATIC_ENTRY(name, value) \
   { name, SPDY_ARRAYSIZE(name) - 1, value, SPDY_ARRAYSIZE(value) - 1 }
 
-const std::vector<HpackStaticEntry>& HpackStaticTableVector() {
-  static const auto* kHpackStaticTable = new std::vector<HpackStaticEntry>{
-      STATIC_ENTRY(":authority", ""),                    // 1
-      STATIC_ENTRY(":method", "GET"),                    // 2
-      STATIC_ENTRY(":method", "POST"),                   // 3
-      STATIC_ENTRY(":path", "/"),                        // 4
-      STATIC_ENTRY(":path", "/index.html"),              // 5
-      STATIC_ENTRY(":scheme", "http"),                   // 6
-      STATIC_ENTRY(":scheme", "https"),                  // 7
-      STATIC_ENTRY(":status", "200"),                    // 8
-      STATIC_ENTRY(":status", "204"),                    // 9
-      STATIC_ENTRY(":status", "206"),                    // 10
-      STATIC_ENTRY(":status", "304"),                    // 11
-      STATIC_ENTRY(":status", "400"),                    // 12
-      STATIC_ENTRY(":status", "404"),                    // 13
-      STATIC_ENTRY(":status", "500"),                    // 14
-      STATIC_ENTRY("accept-charset", ""),                // 15
-      STATIC_ENTRY("accept-encoding", "gzip, deflate"),  // 16
-      STATIC_ENTRY("accept-language", ""),               // 17
-      STATIC_ENTRY("accept-ranges", ""),                 // 18
-      STATIC_ENTRY("accept", ""),                        // 19
-      STATIC_ENTRY("access-control-allow-origin", ""),   // 20
-      STATIC_ENTRY("age", ""),                           // 21
-      STATIC_ENTRY("allow", ""),                         // 22
-      STATIC_ENTRY("authorization", ""),                 // 23
-      STATIC_ENTRY("cache-control", ""),                 // 24
-      STATIC_ENTRY("content-disposition", ""),           // 25
-      STATIC_ENTRY("content-encoding", ""),              // 26
-      STATIC_ENTRY("content-language", ""),              // 27
-      STATIC_ENTRY("content-length", ""),                // 28
-      STATIC_ENTRY("content-location", ""),              // 29
-      STATIC_ENTRY("content-range", ""),                 // 30
-      STATIC_ENTRY("content-type", ""),                  // 31
-      STATIC_ENTRY("cookie", ""),                        // 32
-      STATIC_ENTRY("date", ""),                          // 33
-      STATIC_ENTRY("etag", ""),                          // 34
-      STATIC_ENTRY("expect", ""),                        // 35
-      STATIC_ENTRY("expires", ""),                       // 36
-      STATIC_ENTRY("from", ""),                          // 37
-      STATIC_ENTRY("host", ""),                          // 38
-      STATIC_ENTRY("if-match", ""),                      // 39
-      STATIC_ENTRY("if-modified-since", ""),             // 40
-      STATIC_ENTRY("if-none-match", ""),                 // 41
-      STATIC_ENTRY("if-range", ""),                      // 42
-      STATIC_ENTRY("if-unmodified-since", ""),           // 43
-      STATIC_ENTRY("last-modified", ""),                 // 44
-      STATIC_ENTRY("link", ""),                          // 45
-      STATIC_ENTRY("location", ""),                      // 46
-      STATIC_ENTRY("max-forwards", ""),                  // 47
-      STATIC_ENTRY("proxy-authenticate", ""),            // 48
-      STATIC_ENTRY("proxy-authorization", ""),           // 49
-      STATIC_ENTRY("range", ""),                         // 50
-      STATIC_ENTRY("referer", ""),                       // 51
-      STATIC_ENTRY("refresh", ""),                       // 52
-      STATIC_ENTRY("retry-after", ""),                   // 53
-      STATIC_ENTRY("server", ""),                        // 54
-      STATIC_ENTRY("set-cookie", ""),                    // 55
-      STATIC_ENTRY("strict-transport-security", ""),     // 56
-      STATIC_ENTRY("transfer-encoding", ""),             // 57
-      STATIC_ENTRY("user-agent", ""),                    // 58
-      STATIC_ENTRY("vary", ""),                          // 59
-      STATIC_ENTRY("via", ""),                           // 60
-      STATIC_ENTRY("www-authenticate", ""),              // 61
-  };
-  return *kHpackStaticTable;
-}
+namespace {
+
+constexpr HpackStaticEntry kHpackStaticTable[] = {
+    STATIC_ENTRY(":authority", ""),                    // 1
+    STATIC_ENTRY(":method", "GET"),                    // 2
+    STATIC_ENTRY(":method", "POST"),                   // 3
+    STATIC_ENTRY(":path", "/"),                        // 4
+    STATIC_ENTRY(":path", "/index.html"),              // 5
+    STATIC_ENTRY(":scheme", "http"),                   // 6
+    STATIC_ENTRY(":scheme", "https"),                  // 7
+    STATIC_ENTRY(":status", "200"),                    // 8
+    STATIC_ENTRY(":status", "204"),                    // 9
+    STATIC_ENTRY(":status", "206"),                    // 10
+    STATIC_ENTRY(":status", "304"),                    // 11
+    STATIC_ENTRY(":status", "400"),                    // 12
+    STATIC_ENTRY(":status", "404"),                    // 13
+    STATIC_ENTRY(":status", "500"),                    // 14
+    STATIC_ENTRY("accept-charset", ""),                // 15
+    STATIC_ENTRY("accept-encoding", "gzip, deflate"),  // 16
+    STATIC_ENTRY("accept-language", ""),               // 17
+    STATIC_ENTRY("accept-ranges", ""),                 // 18
+    STATIC_ENTRY("accept", ""),                        // 19
+    STATIC_ENTRY("access-control-allow-origin", ""),   // 20
+    STATIC_ENTRY("age", ""),                           // 21
+    STATIC_ENTRY("allow", ""),                         // 22
+    STATIC_ENTRY("authorization", ""),                 // 23
+    STATIC_ENTRY("cache-control", ""),                 // 24
+    STATIC_ENTRY("content-disposition", ""),           // 25
+    STATIC_ENTRY("content-encoding", ""),              // 26
+    STATIC_ENTRY("content-language", ""),              // 27
+    STATIC_ENTRY("content-length", ""),                // 28
+    STATIC_ENTRY("content-location", ""),              // 29
+    STATIC_ENTRY("content-range", ""),                 // 30
+    STATIC_ENTRY("content-type", ""),                  // 31
+    STATIC_ENTRY("cookie", ""),                        // 32
+    STATIC_ENTRY("date", ""),                          // 33
+    STATIC_ENTRY("etag", ""),                          // 34
+    STATIC_ENTRY("expect", ""),                        // 35
+    STATIC_ENTRY("expires", ""),                       // 36
+    STATIC_ENTRY("from", ""),                          // 37
+    STATIC_ENTRY("host", ""),                          // 38
+    STATIC_ENTRY("if-match", ""),                      // 39
+    STATIC_ENTRY("if-modified-since", ""),             // 40
+    STATIC_ENTRY("if-none-match", ""),                 // 41
+    STATIC_ENTRY("if-range", ""),                      // 42
+    STATIC_ENTRY("if-unmodified-since", ""),           // 43
+    STATIC_ENTRY("last-modified", ""),                 // 44
+    STATIC_ENTRY("link", ""),                          // 45
+    STATIC_ENTRY("location", ""),                      // 46
+    STATIC_ENTRY("max-forwards", ""),                  // 47
+    STATIC_ENTRY("proxy-authenticate", ""),            // 48
+    STATIC_ENTRY("proxy-authorization", ""),           // 49
+    STATIC_ENTRY("range", ""),                         // 50
+    STATIC_ENTRY("referer", ""),                       // 51
+    STATIC_ENTRY("refresh", ""),                       // 52
+    STATIC_ENTRY("retry-after", ""),                   // 53
+    STATIC_ENTRY("server", ""),                        // 54
+    STATIC_ENTRY("set-cookie", ""),                    // 55
+    STATIC_ENTRY("strict-transport-security", ""),     // 56
+    STATIC_ENTRY("transfer-encoding", ""),             // 57
+    STATIC_ENTRY("user-agent", ""),                    // 58
+    STATIC_ENTRY("vary", ""),                          // 59
+    STATIC_ENTRY("via", ""),                           // 60
+    STATIC_ENTRY("www-authenticate", ""),              // 61
+};
 
 #undef STATIC_ENTRY
 
+// Built at compile time, so that lookups do not depend on any static
+// initializer or heap allocation.
+constexpr HpackStaticIndex kHpackStaticIndex(
+    kHpackStaticTable,
+    SPDY_ARRAYSIZE(kHpackStaticTable));
+static_assert(kHpackStaticIndex.IsValid(),
+              "No perfect hash found for the HPACK static table.");
+
+}  // namespace
+
+const std::vector<HpackStaticEntry>& HpackStaticTableVector() {
+  static const auto* kHpackStaticTableVector =
+      new std::vector<HpackStaticEntry>(std::begin(kHpackStaticTable),
+                                        std::end(kHpackStaticTable));
+  return *kHpackStaticTableVector;
+}
+
 const HpackHuffmanTable& ObtainHpackHuffmanTable() {
   static const HpackHuffmanTable* const shared_huffman_table = []() {
     auto* table = new HpackHuffmanTable();
@@ -375,8 +392,7 @@ const HpackHuffmanTable& ObtainHpackHuffmanTable() {
 const HpackStaticTable& ObtainHpackStaticTable() {
   static const HpackStaticTable* const shared_static_table = []() {
     auto* table = new HpackStaticTable();
-    table->Initialize(HpackStaticTableVector().data(),
-                      HpackStaticTableVector().size());
+    table->Initialize(kHpackStaticIndex);
     CHECK(table->IsInitialized());
     return table;
   }();
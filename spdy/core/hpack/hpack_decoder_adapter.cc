@@ -11,7 +11,6 @@
 
 using ::http2::DecodeBuffer;
 using ::http2::HpackEntryType;
-using ::http2::HpackString;
 
 namespace spdy {
 namespace {
@@ -67,7 +66,8 @@ bool HpackDecoderAdapter::HandleControlFrameHeadersData(
     http2::DecodeBuffer db(headers_data, headers_data_length);
     bool ok = hpack_decoder_.DecodeFragment(&db);
     DCHECK(!ok || db.Empty()) << "Remaining=" << db.Remaining();
-    return ok;
+    return ok && listener_adapter_.header_validation_result() ==
+                     SpdyHeaderValidator::Result::kOk;
   }
   return true;
 }
@@ -83,7 +83,8 @@ bool HpackDecoderAdapter::HandleControlFrameHeadersComplete(
     return false;
   }
   header_block_started_ = false;
-  return true;
+  return listener_adapter_.header_validation_result() ==
+         SpdyHeaderValidator::Result::kOk;
 }
 
 const SpdyHeaderBlock& HpackDecoderAdapter::decoded_block() const {
@@ -113,7 +114,10 @@ size_t HpackDecoderAdapter::EstimateMemoryUsage() const {
   return SpdyEstimateMemoryUsage(hpack_decoder_);
 }
 
-HpackDecoderAdapter::ListenerAdapter::ListenerAdapter() : handler_(nullptr) {}
+HpackDecoderAdapter::ListenerAdapter::ListenerAdapter()
+    : handler_(nullptr),
+      validate_header_fields_(false),
+      header_validation_result_(SpdyHeaderValidator::Result::kOk) {}
 HpackDecoderAdapter::ListenerAdapter::~ListenerAdapter() = default;
 
 void HpackDecoderAdapter::ListenerAdapter::set_handler(
@@ -130,6 +134,8 @@ void HpackDecoderAdapter::ListenerAdapter::OnHeaderListStart() {
   SPDY_DVLOG(2) << "HpackDecoderAdapter::ListenerAdapter::OnHeaderListStart";
   total_hpack_bytes_ = 0;
   total_uncompressed_bytes_ = 0;
+  header_validator_.StartHeaderBlock();
+  header_validation_result_ = SpdyHeaderValidator::Result::kOk;
   decoded_block_.clear();
   if (handler_ != nullptr) {
     handler_->OnHeaderBlockStart();
@@ -137,18 +143,29 @@ void HpackDecoderAdapter::ListenerAdapter::OnHeaderListStart() {
 }
 
 void HpackDecoderAdapter::ListenerAdapter::OnHeader(HpackEntryType entry_type,
-                                                    const HpackString& name,
-                                                    const HpackString& value) {
+                                                    SpdyStringPiece name,
+                                                    SpdyStringPiece value) {
   SPDY_DVLOG(2) << "HpackDecoderAdapter::ListenerAdapter::OnHeader:\n name: "
                 << name << "\n value: " << value;
+  if (header_validation_result_ != SpdyHeaderValidator::Result::kOk) {
+    return;
+  }
+  if (validate_header_fields_) {
+    header_validation_result_ = header_validator_.ValidateHeader(name, value);
+    if (header_validation_result_ != SpdyHeaderValidator::Result::kOk) {
+      SPDY_VLOG(1) << "Invalid header field: "
+                   << SpdyHeaderValidator::ResultToString(
+                          header_validation_result_);
+      return;
+    }
+  }
   total_uncompressed_bytes_ += name.size() + value.size();
   if (handler_ == nullptr) {
     SPDY_DVLOG(3) << "Adding to decoded_block";
-    decoded_block_.AppendValueOrAddHeader(name.ToStringPiece(),
-                                          value.ToStringPiece());
+    decoded_block_.AppendValueOrAddHeader(name, value);
   } else {
     SPDY_DVLOG(3) << "Passing to handler";
-    handler_->OnHeader(name.ToStringPiece(), value.ToStringPiece());
+    handler_->OnHeader(name, value);
   }
 }
 
@@ -157,7 +174,10 @@ void HpackDecoderAdapter::ListenerAdapter::OnHeaderListEnd() {
   // We don't clear the SpdyHeaderBlock here to allow access to it until the
   // next HPACK block is decoded.
   if (handler_ != nullptr) {
-    handler_->OnHeaderBlockEnd(total_uncompressed_bytes_, total_hpack_bytes_);
+    // The handler has not seen the whole block if a field was invalid.
+    if (header_validation_result_ == SpdyHeaderValidator::Result::kOk) {
+      handler_->OnHeaderBlockEnd(total_uncompressed_bytes_, total_hpack_bytes_);
+    }
     handler_ = nullptr;
   }
 }
@@ -20,6 +20,7 @@
 #include "net/third_party/quiche/src/http2/hpack/http2_hpack_constants.h"
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_header_table.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_header_block.h"
+#include "net/third_party/quiche/src/spdy/core/spdy_header_validator.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_headers_handler_interface.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
@@ -79,6 +80,19 @@ class SPDY_EXPORT_PRIVATE HpackDecoderAdapter {
   // of individual transport buffers.
   void set_max_decode_buffer_size_bytes(size_t max_decode_buffer_size_bytes);
 
+  // If true, each decoded header field is checked with SpdyHeaderValidator,
+  // and decoding the block fails at the first invalid field, which is not
+  // passed on.  False by default.
+  void set_validate_header_fields(bool validate_header_fields) {
+    listener_adapter_.set_validate_header_fields(validate_header_fields);
+  }
+
+  // Result of validating the fields of the current (or most recent) HPACK
+  // block.
+  SpdyHeaderValidator::Result header_validation_result() const {
+    return listener_adapter_.header_validation_result();
+  }
+
   size_t EstimateMemoryUsage() const;
 
  private:
@@ -102,8 +116,8 @@ class SPDY_EXPORT_PRIVATE HpackDecoderAdapter {
     // Override the HpackDecoderListener methods:
     void OnHeaderListStart() override;
     void OnHeader(http2::HpackEntryType entry_type,
-                  const http2::HpackString& name,
-                  const http2::HpackString& value) override;
+                  SpdyStringPiece name,
+                  SpdyStringPiece value) override;
     void OnHeaderListEnd() override;
     void OnHeaderErrorDetected(SpdyStringPiece error_message) override;
 
@@ -117,6 +131,13 @@ class SPDY_EXPORT_PRIVATE HpackDecoderAdapter {
     void AddToTotalHpackBytes(size_t delta) { total_hpack_bytes_ += delta; }
     size_t total_hpack_bytes() const { return total_hpack_bytes_; }
 
+    void set_validate_header_fields(bool validate_header_fields) {
+      validate_header_fields_ = validate_header_fields;
+    }
+    SpdyHeaderValidator::Result header_validation_result() const {
+      return header_validation_result_;
+    }
+
    private:
     // If the caller doesn't provide a handler, the header list is stored in
     // this SpdyHeaderBlock.
@@ -132,6 +153,12 @@ class SPDY_EXPORT_PRIVATE HpackDecoderAdapter {
     // Total bytes of the name and value strings in the current HPACK block.
     size_t total_uncompressed_bytes_;
 
+    // Checks each decoded field if |validate_header_fields_|.  Once a field is
+    // invalid, later fields of the block are no longer passed on.
+    bool validate_header_fields_;
+    SpdyHeaderValidator header_validator_;
+    SpdyHeaderValidator::Result header_validation_result_;
+
     // visitor_ is used by a QUIC experiment regarding HPACK; remove
     // when the experiment is done.
     std::unique_ptr<HpackHeaderTable::DebugVisitorInterface> visitor_;
@@ -27,7 +27,6 @@
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_test.h"
 
 using ::http2::HpackEntryType;
-using ::http2::HpackString;
 using ::http2::HpackStringPair;
 using ::http2::test::HpackBlockBuilder;
 using ::http2::test::HpackDecoderPeer;
@@ -67,7 +66,7 @@ class HpackDecoderAdapterPeer {
 
   void HandleHeaderRepresentation(SpdyStringPiece name, SpdyStringPiece value) {
     decoder_->listener_adapter_.OnHeader(HpackEntryType::kIndexedLiteralHeader,
-                                         HpackString(name), HpackString(value));
+                                         name, value);
   }
 
   http2::HpackDecoderTables* GetDecoderTables() {
@@ -1083,6 +1082,25 @@ TEST_P(HpackDecoderAdapterTest, ReuseNameOfEvictedEntry) {
 }
 
 // Regression test for https://crbug.com/747395.
+TEST_P(HpackDecoderAdapterTest, ValidateHeaderFields) {
+  decoder_.set_validate_header_fields(true);
+
+  HpackBlockBuilder hbb;
+  hbb.AppendLiteralNameAndValue(HpackEntryType::kNeverIndexedLiteralHeader,
+                                false, "alpha", false, "beta");
+  hbb.AppendLiteralNameAndValue(HpackEntryType::kNeverIndexedLiteralHeader,
+                                false, "Gamma", false, "delta");
+  hbb.AppendLiteralNameAndValue(HpackEntryType::kNeverIndexedLiteralHeader,
+                                false, "epsilon", false, "zeta");
+  EXPECT_FALSE(DecodeHeaderBlock(hbb.buffer()));
+  EXPECT_EQ(SpdyHeaderValidator::Result::kUpperCaseName,
+            decoder_.header_validation_result());
+  // Neither the invalid field nor the fields after it are passed on.
+  SpdyHeaderBlock expected_header_set;
+  expected_header_set["alpha"] = "beta";
+  EXPECT_EQ(expected_header_set, decoded_block());
+}
+
 TEST_P(HpackDecoderAdapterTest, Cookies) {
   SpdyHeaderBlock expected_header_set;
   expected_header_set["cookie"] = "foo; bar";
@@ -124,10 +124,19 @@ void HpackEncoder::ApplyHeaderTableSizeSetting(size_t size_setting) {
   should_emit_table_size_ = true;
 }
 
+void HpackEncoder::EnableAdaptiveIndexing() {
+  if (adaptive_indexing_policy_ == nullptr) {
+    adaptive_indexing_policy_ = SpdyMakeUnique<HpackAdaptiveIndexingPolicy>();
+  }
+}
+
 size_t HpackEncoder::EstimateMemoryUsage() const {
   // |huffman_table_| is a singleton. It's accounted for in spdy_session_pool.cc
   return SpdyEstimateMemoryUsage(header_table_) +
-         SpdyEstimateMemoryUsage(output_stream_);
+         SpdyEstimateMemoryUsage(output_stream_) +
+         (adaptive_indexing_policy_ == nullptr
+              ? 0
+              : sizeof(HpackAdaptiveIndexingPolicy));
 }
 
 void HpackEncoder::EncodeRepresentations(RepresentationIterator* iter,
@@ -137,15 +146,7 @@ void HpackEncoder::EncodeRepresentations(RepresentationIterator* iter,
     const auto header = iter->Next();
     listener_(header.first, header.second);
     if (enable_compression_) {
-      const HpackEntry* entry =
-          header_table_.GetByNameAndValue(header.first, header.second);
-      if (entry != nullptr) {
-        EmitIndex(entry);
-      } else if (should_index_(header.first, header.second)) {
-        EmitIndexedLiteral(header);
-      } else {
-        EmitNonIndexedLiteral(header);
-      }
+      EncodeRepresentation(header);
     } else {
       EmitNonIndexedLiteral(header);
     }
@@ -154,6 +155,41 @@ void HpackEncoder::EncodeRepresentations(RepresentationIterator* iter,
   output_stream_.TakeString(output);
 }
 
+void HpackEncoder::EncodeRepresentation(const Representation& representation) {
+  const HpackEntry* entry = header_table_.GetByNameAndValue(
+      representation.first, representation.second);
+  if (entry != nullptr) {
+    if (adaptive_indexing_policy_ != nullptr && !entry->IsStatic()) {
+      adaptive_indexing_policy_->OnDynamicTableHit(representation.first);
+    }
+    EmitIndex(entry);
+    return;
+  }
+
+  if (adaptive_indexing_policy_ == nullptr) {
+    if (should_index_(representation.first, representation.second)) {
+      EmitIndexedLiteral(representation);
+    } else {
+      EmitNonIndexedLiteral(representation);
+    }
+    return;
+  }
+
+  switch (adaptive_indexing_policy_->Decide(representation.first,
+                                            representation.second,
+                                            header_table_.max_size())) {
+    case HpackAdaptiveIndexingPolicy::Decision::kIndex:
+      EmitIndexedLiteral(representation);
+      return;
+    case HpackAdaptiveIndexingPolicy::Decision::kNoIndex:
+      EmitNonIndexedLiteral(representation);
+      return;
+    case HpackAdaptiveIndexingPolicy::Decision::kNeverIndex:
+      EmitNeverIndexedLiteral(representation);
+      return;
+  }
+}
+
 void HpackEncoder::EmitIndex(const HpackEntry* entry) {
   SPDY_DVLOG(2) << "Emitting index " << header_table_.IndexOf(entry);
   output_stream_.AppendPrefix(kIndexedOpcode);
@@ -177,6 +213,14 @@ void HpackEncoder::EmitNonIndexedLiteral(const Representation& representation) {
   EmitString(representation.second);
 }
 
+void HpackEncoder::EmitNeverIndexedLiteral(
+    const Representation& representation) {
+  SPDY_DVLOG(2) << "Emitting never indexed literal: (" << representation.first
+                << ", " << representation.second << ")";
+  output_stream_.AppendPrefix(kLiteralNeverIndexOpcode);
+  EmitLiteral(representation);
+}
+
 void HpackEncoder::EmitLiteral(const Representation& representation) {
   const HpackEntry* name_entry = header_table_.GetByName(representation.first);
   if (name_entry != nullptr) {
@@ -190,7 +234,7 @@ void HpackEncoder::EmitLiteral(const Representation& representation) {
 
 void HpackEncoder::EmitString(SpdyStringPiece str) {
   size_t encoded_size =
-      enable_compression_ ? huffman_table_.EncodedSize(str) : str.size();
+      enable_compression_ ? huffman_table_.BoundedEncodedSize(str) : str.size();
   if (encoded_size < str.size()) {
     SPDY_DVLOG(2) << "Emitted Huffman-encoded string of length "
                   << encoded_size;
@@ -340,15 +384,7 @@ void HpackEncoder::Encoderator::Next(size_t max_encoded_bytes,
     const Representation header = header_it_->Next();
     encoder_->listener_(header.first, header.second);
     if (use_compression) {
-      const HpackEntry* entry = encoder_->header_table_.GetByNameAndValue(
-          header.first, header.second);
-      if (entry != nullptr) {
-        encoder_->EmitIndex(entry);
-      } else if (encoder_->should_index_(header.first, header.second)) {
-        encoder_->EmitIndexedLiteral(header);
-      } else {
-        encoder_->EmitNonIndexedLiteral(header);
-      }
+      encoder_->EncodeRepresentation(header);
     } else {
       encoder_->EmitNonIndexedLiteral(header);
     }
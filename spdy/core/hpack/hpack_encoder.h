@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_header_table.h"
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_indexing_policy.h"
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_output_stream.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
@@ -82,9 +83,16 @@ class SPDY_EXPORT_PRIVATE HpackEncoder {
   }
 
   // This HpackEncoder will use |policy| to determine whether to insert header
-  // name-value pairs into the dynamic table.
+  // name-value pairs into the dynamic table.  Has no effect while adaptive
+  // indexing is enabled.
   void SetIndexingPolicy(IndexingPolicy policy) { should_index_ = policy; }
 
+  // This HpackEncoder will use an HpackAdaptiveIndexingPolicy instead of the
+  // IndexingPolicy: header fields are only inserted into the dynamic table if
+  // they are likely to be reused on this connection, and credentials and
+  // random looking values are emitted as never indexed literals.
+  void EnableAdaptiveIndexing();
+
   // |listener| will be invoked for each header name-value pair processed by
   // this encoder.
   void SetHeaderListener(HeaderListener listener) { listener_ = listener; }
@@ -108,12 +116,17 @@ class SPDY_EXPORT_PRIVATE HpackEncoder {
   // Encodes a sequence of header name-value pairs as a single header block.
   void EncodeRepresentations(RepresentationIterator* iter, SpdyString* output);
 
+  // Emits the representation of a single header field, using the indexing
+  // policy if it is not in the header table.
+  void EncodeRepresentation(const Representation& representation);
+
   // Emits a static/dynamic indexed representation (Section 7.1).
   void EmitIndex(const HpackEntry* entry);
 
   // Emits a literal representation (Section 7.2).
   void EmitIndexedLiteral(const Representation& representation);
   void EmitNonIndexedLiteral(const Representation& representation);
+  void EmitNeverIndexedLiteral(const Representation& representation);
   void EmitLiteral(const Representation& representation);
 
   // Emits a Huffman or identity string (whichever is smaller).
@@ -142,6 +155,7 @@ class SPDY_EXPORT_PRIVATE HpackEncoder {
   size_t min_table_size_setting_received_;
   HeaderListener listener_;
   IndexingPolicy should_index_;
+  std::unique_ptr<HpackAdaptiveIndexingPolicy> adaptive_indexing_policy_;
   bool enable_compression_;
   bool should_emit_table_size_;
 };
@@ -160,6 +160,18 @@ class HpackEncoderTest : public ::testing::TestWithParam<bool> {
     ExpectString(&expected_, name);
     ExpectString(&expected_, value);
   }
+  void ExpectNeverIndexedLiteral(const HpackEntry* key_entry,
+                                 SpdyStringPiece value) {
+    expected_.AppendPrefix(kLiteralNeverIndexOpcode);
+    expected_.AppendUint32(IndexOf(key_entry));
+    ExpectString(&expected_, value);
+  }
+  void ExpectNeverIndexedLiteral(SpdyStringPiece name, SpdyStringPiece value) {
+    expected_.AppendPrefix(kLiteralNeverIndexOpcode);
+    expected_.AppendUint32(0);
+    ExpectString(&expected_, name);
+    ExpectString(&expected_, value);
+  }
   void ExpectString(HpackOutputStream* stream, SpdyStringPiece str) {
     const HpackHuffmanTable& huffman_table = peer_.huffman_table();
     size_t encoded_size = peer_.compression_enabled()
@@ -582,6 +594,42 @@ TEST_P(HpackEncoderTest, HeaderTableSizeUpdatesWithGreaterSize) {
   EXPECT_EQ(new_entry->value(), "value3");
 }
 
+TEST_P(HpackEncoderTest, AdaptiveIndexingNeverIndexed) {
+  encoder_.EnableAdaptiveIndexing();
+  const HpackEntry* authorization = peer_.table()->GetByName("authorization");
+  ASSERT_NE(nullptr, authorization);
+  ExpectNeverIndexedLiteral(authorization, "Basic Zm9vOmJhcg==");
+  ExpectNeverIndexedLiteral("x-session", "3f2a9c1e7b4d8a6f");
+
+  SpdyHeaderBlock headers;
+  headers["authorization"] = "Basic Zm9vOmJhcg==";
+  headers["x-session"] = "3f2a9c1e7b4d8a6f";
+  CompareWithExpectedEncoding(headers);
+
+  EXPECT_EQ(4u, peer_.table_peer().dynamic_entries()->size());
+}
+
+TEST_P(HpackEncoderTest, AdaptiveIndexingOneOffValues) {
+  encoder_.EnableAdaptiveIndexing();
+  peer_.table()->SetMaxSize(kDefaultHeaderTableSizeSetting);
+
+  SpdyString output;
+  for (const char* value : {"1", "2", "3", "2"}) {
+    SpdyHeaderBlock headers;
+    headers["x-request-id"] = value;
+    EXPECT_TRUE(test::HpackEncoderPeer::EncodeHeaderSet(
+        &encoder_, headers, &output, use_incremental_));
+  }
+
+  // Only the first value, and the value that recurred, were inserted.
+  const HpackHeaderTable::EntryTable* entries =
+      peer_.table_peer().dynamic_entries();
+  ASSERT_EQ(6u, entries->size());
+  EXPECT_EQ("2", (*entries)[0].value());
+  EXPECT_EQ("1", (*entries)[1].value());
+  EXPECT_EQ("x-request-id", (*entries)[1].name());
+}
+
 }  // namespace
 
 }  // namespace spdy
@@ -33,7 +33,6 @@ bool HpackHeaderTable::EntriesEq::operator()(const HpackEntry* lhs,
 HpackHeaderTable::HpackHeaderTable()
     : static_entries_(ObtainHpackStaticTable().GetStaticEntries()),
       static_index_(ObtainHpackStaticTable().GetStaticIndex()),
-      static_name_index_(ObtainHpackStaticTable().GetStaticNameIndex()),
       settings_size_bound_(kDefaultHeaderTableSizeSetting),
       size_(0),
       max_size_(kDefaultHeaderTableSizeSetting),
@@ -62,9 +61,9 @@ const HpackEntry* HpackHeaderTable::GetByIndex(size_t index) {
 
 const HpackEntry* HpackHeaderTable::GetByName(SpdyStringPiece name) {
   {
-    auto it = static_name_index_.find(name);
-    if (it != static_name_index_.end()) {
-      return it->second;
+    size_t index = static_index_.FindName(name);
+    if (index != HpackStaticIndex::kNotFound) {
+      return &static_entries_[index];
     }
   }
   {
@@ -82,14 +81,14 @@ const HpackEntry* HpackHeaderTable::GetByName(SpdyStringPiece name) {
 
 const HpackEntry* HpackHeaderTable::GetByNameAndValue(SpdyStringPiece name,
                                                       SpdyStringPiece value) {
-  HpackEntry query(name, value);
   {
-    auto it = static_index_.find(&query);
-    if (it != static_index_.end()) {
-      return *it;
+    size_t index = static_index_.Find(name, value);
+    if (index != HpackStaticIndex::kNotFound) {
+      return &static_entries_[index];
     }
   }
   {
+    HpackEntry query(name, value);
     auto it = dynamic_index_.find(&query);
     if (it != dynamic_index_.end()) {
       const HpackEntry* result = *it;
@@ -247,13 +246,9 @@ void HpackHeaderTable::DebugLogTableState() const {
   for (auto it = dynamic_entries_.begin(); it != dynamic_entries_.end(); ++it) {
     SPDY_DVLOG(2) << "  " << it->GetDebugString();
   }
-  SPDY_DVLOG(2) << "Full Static Index:";
-  for (const auto* entry : static_index_) {
-    SPDY_DVLOG(2) << "  " << entry->GetDebugString();
-  }
-  SPDY_DVLOG(2) << "Full Static Name Index:";
-  for (const auto it : static_name_index_) {
-    SPDY_DVLOG(2) << "  " << it.first << ": " << it.second->GetDebugString();
+  SPDY_DVLOG(2) << "Static table:";
+  for (const auto& entry : static_entries_) {
+    SPDY_DVLOG(2) << "  " << entry.GetDebugString();
   }
   SPDY_DVLOG(2) << "Full Dynamic Index:";
   for (const auto* entry : dynamic_index_) {
@@ -24,6 +24,8 @@ namespace test {
 class HpackHeaderTablePeer;
 }  // namespace test
 
+class HpackStaticIndex;
+
 // A data structure for the static table (2.3.1) and the dynamic table (2.3.2).
 class SPDY_EXPORT_PRIVATE HpackHeaderTable {
  public:
@@ -139,18 +141,16 @@ class SPDY_EXPORT_PRIVATE HpackHeaderTable {
   // Evicts |count| oldest entries from the table.
   void Evict(size_t count);
 
-  // |static_entries_|, |static_index_|, and |static_name_index_| are owned by
-  // HpackStaticTable singleton.
+  // |static_entries_| and |static_index_| are owned by HpackStaticTable
+  // singleton.
 
   // Tracks HpackEntries by index.
   const EntryTable& static_entries_;
   EntryTable dynamic_entries_;
 
-  // Tracks the unique HpackEntry for a given header name and value.
-  const UnorderedEntrySet& static_index_;
-
-  // Tracks the first static entry for each name in the static table.
-  const NameToEntryMap& static_name_index_;
+  // Tracks the unique static entry for a given header name and value, and the
+  // first static entry for each name in the static table.
+  const HpackStaticIndex& static_index_;
 
   // Tracks the most recently inserted HpackEntry for a given header name and
   // value.
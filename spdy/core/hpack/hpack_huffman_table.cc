@@ -28,9 +28,14 @@ bool SymbolIdCompare(const HpackHuffmanSymbol& a, const HpackHuffmanSymbol& b) {
   return a.id < b.id;
 }
 
+// Size of the stack buffer EncodeString() collects output bytes in before
+// appending them to the output stream.
+const size_t kEncodeBufferSize = 64;
+
 }  // namespace
 
-HpackHuffmanTable::HpackHuffmanTable() : pad_bits_(0), failed_symbol_id_(0) {}
+HpackHuffmanTable::HpackHuffmanTable()
+    : min_length_(0), pad_bits_(0), failed_symbol_id_(0) {}
 
 HpackHuffmanTable::~HpackHuffmanTable() = default;
 
@@ -89,6 +94,21 @@ void HpackHuffmanTable::BuildEncodeTable(const std::vector<Symbol>& symbols) {
     CHECK_EQ(i, symbol.id);
     code_by_id_.push_back(symbol.code);
     length_by_id_.push_back(symbol.length);
+    const uint64_t right_aligned_code = symbol.code >> (32 - symbol.length);
+    code_and_length_by_id_.push_back((right_aligned_code << 8) |
+                                     symbol.length);
+  }
+  min_length_ = *std::min_element(length_by_id_.begin(), length_by_id_.end());
+}
+
+void HpackHuffmanTable::CheckSymbols(SpdyStringPiece in) const {
+  // Every octet has a code in tables with more than 256 symbols, like the HPACK
+  // table, so that only smaller tables need to check the input.
+  if (code_by_id_.size() > std::numeric_limits<uint8_t>::max()) {
+    return;
+  }
+  for (const char c : in) {
+    CHECK_GT(code_by_id_.size(), static_cast<uint8_t>(c));
   }
 }
 
@@ -98,54 +118,115 @@ bool HpackHuffmanTable::IsInitialized() const {
 
 void HpackHuffmanTable::EncodeString(SpdyStringPiece in,
                                      HpackOutputStream* out) const {
-  size_t bit_remnant = 0;
-  for (size_t i = 0; i != in.size(); i++) {
-    uint16_t symbol_id = static_cast<uint8_t>(in[i]);
-    CHECK_GT(code_by_id_.size(), symbol_id);
-
-    // Load, and shift code to low bits.
-    unsigned length = length_by_id_[symbol_id];
-    uint32_t code = code_by_id_[symbol_id] >> (32 - length);
-
-    bit_remnant = (bit_remnant + length) % 8;
-
-    if (length > 24) {
-      out->AppendBits(static_cast<uint8_t>(code >> 24), length - 24);
-      length = 24;
-    }
-    if (length > 16) {
-      out->AppendBits(static_cast<uint8_t>(code >> 16), length - 16);
-      length = 16;
+  CheckSymbols(in);
+
+  // Codes are accumulated in the low bits of |bits|, and written out 32 bits at
+  // a time.  Since at most 31 bits are pending before a code of at most 32 bits
+  // is added, |bits| never overflows.
+  char buffer[kEncodeBufferSize];
+  size_t buffer_used = 0;
+  uint64_t bits = 0;
+  size_t bit_count = 0;
+  for (const char c : in) {
+    const uint64_t code_and_length =
+        code_and_length_by_id_[static_cast<uint8_t>(c)];
+    const size_t length = code_and_length & 0xff;
+    bits = (bits << length) | (code_and_length >> 8);
+    bit_count += length;
+    if (bit_count < 32) {
+      continue;
     }
-    if (length > 8) {
-      out->AppendBits(static_cast<uint8_t>(code >> 8), length - 8);
-      length = 8;
+    bit_count -= 32;
+    const uint32_t word = static_cast<uint32_t>(bits >> bit_count);
+    buffer[buffer_used] = static_cast<char>(word >> 24);
+    buffer[buffer_used + 1] = static_cast<char>(word >> 16);
+    buffer[buffer_used + 2] = static_cast<char>(word >> 8);
+    buffer[buffer_used + 3] = static_cast<char>(word);
+    buffer_used += 4;
+    if (buffer_used > kEncodeBufferSize - 4) {
+      out->AppendBytes(SpdyStringPiece(buffer, buffer_used));
+      buffer_used = 0;
     }
-    out->AppendBits(static_cast<uint8_t>(code), length);
   }
-  if (bit_remnant != 0) {
-    // Pad current byte as required.
-    out->AppendBits(pad_bits_ >> bit_remnant, 8 - bit_remnant);
+
+  // At least 4 bytes are free in |buffer|, enough for the remaining bits.
+  while (bit_count >= 8) {
+    bit_count -= 8;
+    buffer[buffer_used++] = static_cast<char>(bits >> bit_count);
+  }
+  if (bit_count != 0) {
+    // Pad last byte as required.
+    buffer[buffer_used++] = static_cast<char>((bits << (8 - bit_count)) |
+                                              (pad_bits_ >> bit_count));
   }
+  out->AppendBytes(SpdyStringPiece(buffer, buffer_used));
 }
 
 size_t HpackHuffmanTable::EncodedSize(SpdyStringPiece in) const {
-  size_t bit_count = 0;
-  for (size_t i = 0; i != in.size(); i++) {
-    uint16_t symbol_id = static_cast<uint8_t>(in[i]);
-    CHECK_GT(code_by_id_.size(), symbol_id);
+  CheckSymbols(in);
+
+  // Sum code lengths with independent accumulators, so that table lookups of
+  // consecutive octets do not depend on each other.
+  const uint8_t* lengths = length_by_id_.data();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(in.data());
+  const size_t size = in.size();
+  size_t bit_count0 = 0;
+  size_t bit_count1 = 0;
+  size_t bit_count2 = 0;
+  size_t bit_count3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    bit_count0 += lengths[data[i]];
+    bit_count1 += lengths[data[i + 1]];
+    bit_count2 += lengths[data[i + 2]];
+    bit_count3 += lengths[data[i + 3]];
+  }
+  for (; i < size; ++i) {
+    bit_count0 += lengths[data[i]];
+  }
+  const size_t bit_count = bit_count0 + bit_count1 + bit_count2 + bit_count3;
+  return (bit_count + 7) / 8;
+}
+
+size_t HpackHuffmanTable::BoundedEncodedSize(SpdyStringPiece in) const {
+  CheckSymbols(in);
 
-    bit_count += length_by_id_[symbol_id];
+  if (in.empty()) {
+    return 0;
+  }
+  // The encoding is smaller than the input if it takes at most this many bits.
+  const size_t limit = (in.size() - 1) * 8;
+  if (in.size() * min_length_ > limit) {
+    return in.size();
+  }
+
+  // Sum code lengths eight octets at a time, and stop as soon as the remaining
+  // octets cannot bring the encoding below the limit, even if they all have the
+  // shortest code.
+  const uint8_t* lengths = length_by_id_.data();
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(in.data());
+  const size_t size = in.size();
+  size_t bit_count = 0;
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    bit_count += lengths[data[i]] + lengths[data[i + 1]] +
+                 lengths[data[i + 2]] + lengths[data[i + 3]] +
+                 lengths[data[i + 4]] + lengths[data[i + 5]] +
+                 lengths[data[i + 6]] + lengths[data[i + 7]];
+    if (bit_count + (size - i - 8) * min_length_ > limit) {
+      return size;
+    }
   }
-  if (bit_count % 8 != 0) {
-    bit_count += 8 - bit_count % 8;
+  for (; i < size; ++i) {
+    bit_count += lengths[data[i]];
   }
-  return bit_count / 8;
+  return (bit_count + 7) / 8;
 }
 
 size_t HpackHuffmanTable::EstimateMemoryUsage() const {
   return SpdyEstimateMemoryUsage(code_by_id_) +
-         SpdyEstimateMemoryUsage(length_by_id_);
+         SpdyEstimateMemoryUsage(length_by_id_) +
+         SpdyEstimateMemoryUsage(code_and_length_by_id_);
 }
 
 }  // namespace spdy
@@ -45,12 +45,18 @@ class SPDY_EXPORT_PRIVATE HpackHuffmanTable {
   bool IsInitialized() const;
 
   // Encodes the input string to the output stream using the table's Huffman
-  // context.
+  // context.  |out| must end on a byte boundary, as it does after
+  // HpackOutputStream::AppendUint32().
   void EncodeString(SpdyStringPiece in, HpackOutputStream* out) const;
 
   // Returns the encoded size of the input string.
   size_t EncodedSize(SpdyStringPiece in) const;
 
+  // Returns the encoded size of the input string if it is smaller than
+  // in.size(), or a value greater than or equal to in.size() otherwise.  Stops
+  // reading the input as soon as the encoding is known not to be smaller.
+  size_t BoundedEncodedSize(SpdyStringPiece in) const;
+
   // Returns the estimate of dynamically allocated memory in bytes.
   size_t EstimateMemoryUsage() const;
 
@@ -58,11 +64,21 @@ class SPDY_EXPORT_PRIVATE HpackHuffmanTable {
   // Expects symbols ordered on ID ascending.
   void BuildEncodeTable(const std::vector<Symbol>& symbols);
 
+  // CHECKs that every octet of |in| has a code.
+  void CheckSymbols(SpdyStringPiece in) const;
+
   // Symbol code and code length, in ascending symbol ID order.
   // Codes are stored in the most-significant bits of the word.
   std::vector<uint32_t> code_by_id_;
   std::vector<uint8_t> length_by_id_;
 
+  // Symbol code in the least-significant bits of the upper 56 bits, and code
+  // length in the lowest 8 bits, so that EncodeString() loads both at once.
+  std::vector<uint64_t> code_and_length_by_id_;
+
+  // Length of the shortest code.
+  uint8_t min_length_;
+
   // The first 8 bits of the longest code. Applied when generating padding bits.
   uint8_t pad_bits_;
 
@@ -300,6 +300,37 @@ TEST_F(HpackHuffmanTableTest, EncodedSizeAgreesWithEncodeString) {
   }
 }
 
+TEST_F(HpackHuffmanTableTest, BoundedEncodedSize) {
+  // Compressible strings.
+  for (const SpdyString& input :
+       {SpdyString("www.example.com"), SpdyString(100, 'a'),
+        SpdyString("custom-value")}) {
+    EXPECT_EQ(table_.EncodedSize(input), table_.BoundedEncodedSize(input));
+    EXPECT_LT(table_.BoundedEncodedSize(input), input.size());
+  }
+
+  // Strings that Huffman encoding does not make shorter.
+  for (const SpdyString& input :
+       {SpdyString(), SpdyString("a"), SpdyString(100, '\xff'),
+        SpdyString(7, 'a') + SpdyString(20, '\0')}) {
+    EXPECT_GE(table_.EncodedSize(input), input.size());
+    EXPECT_GE(table_.BoundedEncodedSize(input), input.size());
+  }
+}
+
+TEST_F(HpackHuffmanTableTest, RoundTripLongStrings) {
+  // Longer than the buffer EncodeString() collects output in, covering every
+  // alignment of codes to output bytes.
+  SpdyString input;
+  for (size_t i = 0; i != 4000; ++i) {
+    input.push_back(static_cast<char>((i * 7) % 256));
+  }
+  SpdyString buffer_in = EncodeString(input);
+  SpdyString buffer_out;
+  DecodeString(buffer_in, &buffer_out);
+  EXPECT_EQ(input, buffer_out);
+}
+
 }  // namespace
 
 }  // namespace test
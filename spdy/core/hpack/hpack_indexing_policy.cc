@@ -0,0 +1,133 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_indexing_policy.h"
+
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_entry.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_containers.h"
+
+namespace spdy {
+
+namespace {
+
+enum class CharClass { kDigit, kLower, kUpper, kWhitespace, kOther };
+
+CharClass Classify(char c) {
+  if (c >= '0' && c <= '9') {
+    return CharClass::kDigit;
+  }
+  if (c >= 'a' && c <= 'z') {
+    return CharClass::kLower;
+  }
+  if (c >= 'A' && c <= 'Z') {
+    return CharClass::kUpper;
+  }
+  if (c == ' ' || c == '\t') {
+    return CharClass::kWhitespace;
+  }
+  return CharClass::kOther;
+}
+
+// Credentials are never indexed, as recommended by Section 7.1.3.
+bool IsSensitiveName(SpdyStringPiece name) {
+  return name == "authorization" || name == "proxy-authorization";
+}
+
+}  // namespace
+
+const size_t HpackAdaptiveIndexingPolicy::kMinHighEntropyLength;
+const size_t HpackAdaptiveIndexingPolicy::kRecentFieldSlots;
+const size_t HpackAdaptiveIndexingPolicy::kNameStatsSlots;
+const uint16_t HpackAdaptiveIndexingPolicy::kMaxNameStatsCount;
+
+HpackAdaptiveIndexingPolicy::HpackAdaptiveIndexingPolicy() = default;
+
+HpackAdaptiveIndexingPolicy::~HpackAdaptiveIndexingPolicy() = default;
+
+HpackAdaptiveIndexingPolicy::Decision HpackAdaptiveIndexingPolicy::Decide(
+    SpdyStringPiece name,
+    SpdyStringPiece value,
+    size_t max_table_size) {
+  if (IsSensitiveName(name) || IsHighEntropy(value)) {
+    return Decision::kNeverIndex;
+  }
+
+  NameStats* stats = GetNameStats(SpdyStringPieceHash()(name));
+  const bool seen_before = RecordField(SpdyHashStringPair(name, value));
+  Count(seen_before ? &stats->reused_values : &stats->new_values, stats);
+
+  // Inserting an entry this large would evict a large part of the table for
+  // a single field.
+  if (HpackEntry::Size(name, value) > max_table_size / 4) {
+    return Decision::kNoIndex;
+  }
+  if (seen_before) {
+    return Decision::kIndex;
+  }
+  // A new value is worth indexing if values of this name have been reused
+  // about as often as they were new.  The first value of a name is always
+  // indexed.
+  return stats->reused_values + 1 >= stats->new_values ? Decision::kIndex
+                                                       : Decision::kNoIndex;
+}
+
+void HpackAdaptiveIndexingPolicy::OnDynamicTableHit(SpdyStringPiece name) {
+  NameStats* stats = GetNameStats(SpdyStringPieceHash()(name));
+  Count(&stats->reused_values, stats);
+}
+
+// static
+bool HpackAdaptiveIndexingPolicy::IsHighEntropy(SpdyStringPiece value) {
+  if (value.size() < kMinHighEntropyLength) {
+    return false;
+  }
+  // Number of adjacent letters and digits of a different class.  Words and
+  // numbers have few, random alphanumeric strings have one every two or three
+  // characters.
+  size_t class_changes = 0;
+  CharClass previous = CharClass::kOther;
+  for (char c : value) {
+    const CharClass current = Classify(c);
+    if (current == CharClass::kWhitespace) {
+      return false;
+    }
+    if (current != CharClass::kOther && previous != CharClass::kOther &&
+        current != previous) {
+      ++class_changes;
+    }
+    previous = current;
+  }
+  return class_changes * 4 > value.size();
+}
+
+bool HpackAdaptiveIndexingPolicy::RecordField(size_t field_hash) {
+  RecentField* recent_field = &recent_fields_[field_hash % kRecentFieldSlots];
+  const bool seen_before =
+      recent_field->occupied && recent_field->field_hash == field_hash;
+  recent_field->occupied = true;
+  recent_field->field_hash = field_hash;
+  return seen_before;
+}
+
+HpackAdaptiveIndexingPolicy::NameStats*
+HpackAdaptiveIndexingPolicy::GetNameStats(size_t name_hash) {
+  NameStats* stats = &name_stats_[name_hash % kNameStatsSlots];
+  if (!stats->occupied || stats->name_hash != name_hash) {
+    *stats = NameStats();
+    stats->occupied = true;
+    stats->name_hash = name_hash;
+  }
+  return stats;
+}
+
+// static
+void HpackAdaptiveIndexingPolicy::Count(uint16_t* counter, NameStats* stats) {
+  ++*counter;
+  if (stats->new_values + stats->reused_values >= kMaxNameStatsCount) {
+    stats->new_values /= 2;
+    stats->reused_values /= 2;
+  }
+}
+
+}  // namespace spdy
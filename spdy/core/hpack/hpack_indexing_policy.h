@@ -0,0 +1,114 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_SPDY_CORE_HPACK_HPACK_INDEXING_POLICY_H_
+#define QUICHE_SPDY_CORE_HPACK_HPACK_INDEXING_POLICY_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
+
+// All section references below are to https://httpwg.org/specs/rfc7541.html.
+
+namespace spdy {
+
+namespace test {
+class HpackAdaptiveIndexingPolicyPeer;
+}  // namespace test
+
+// HpackAdaptiveIndexingPolicy decides how an HpackEncoder emits a header field
+// that is not already in the header table.  It learns from the header fields
+// encoded on a connection: a field is inserted into the dynamic table only if
+// it has been seen before, or if the values of its name have tended to recur,
+// so that one-off values such as request IDs do not evict useful entries.
+// Credentials and values that look like random tokens are emitted as never
+// indexed literals (Section 6.2.3), which also tells intermediaries not to
+// index them.
+//
+// An instance must only be used by one encoder.  It keeps a bounded, fixed
+// amount of state and never allocates.
+class SPDY_EXPORT_PRIVATE HpackAdaptiveIndexingPolicy {
+ public:
+  enum class Decision {
+    // Literal with incremental indexing (Section 6.2.1).
+    kIndex,
+    // Literal without indexing (Section 6.2.2).
+    kNoIndex,
+    // Literal never indexed (Section 6.2.3).
+    kNeverIndex,
+  };
+
+  // Values shorter than this are never considered high-entropy.
+  static const size_t kMinHighEntropyLength = 16;
+
+  HpackAdaptiveIndexingPolicy();
+  HpackAdaptiveIndexingPolicy(const HpackAdaptiveIndexingPolicy&) = delete;
+  HpackAdaptiveIndexingPolicy& operator=(const HpackAdaptiveIndexingPolicy&) =
+      delete;
+  ~HpackAdaptiveIndexingPolicy();
+
+  // Returns how to emit a header field that has no exact match in the static
+  // or dynamic table, and records it.  |max_table_size| is the current
+  // maximum size of the encoder's dynamic table.
+  Decision Decide(SpdyStringPiece name,
+                  SpdyStringPiece value,
+                  size_t max_table_size);
+
+  // Records that a header field named |name| was emitted as a reference to a
+  // dynamic table entry.
+  void OnDynamicTableHit(SpdyStringPiece name);
+
+  // Returns true if |value| looks like a random token, for instance a session
+  // identifier or a hash: it has no whitespace, and changes frequently between
+  // digits, lower case and upper case letters.
+  static bool IsHighEntropy(SpdyStringPiece value);
+
+ private:
+  friend class test::HpackAdaptiveIndexingPolicyPeer;
+
+  // A header field recently emitted as a literal.
+  struct RecentField {
+    bool occupied = false;
+    size_t field_hash = 0;
+  };
+
+  // Reuse statistics of the values of a header name.
+  struct NameStats {
+    bool occupied = false;
+    size_t name_hash = 0;
+    // Number of values emitted as literals for the first time.
+    uint16_t new_values = 0;
+    // Number of values emitted again, either as a dynamic table reference or
+    // as a literal seen before.
+    uint16_t reused_values = 0;
+  };
+
+  // Number of slots in |recent_fields_| and |name_stats_|, indexed by the low
+  // bits of the hashes.  Colliding fields or names replace each other.
+  static const size_t kRecentFieldSlots = 256;
+  static const size_t kNameStatsSlots = 64;
+
+  // NameStats counters are halved when their sum reaches this value, so that
+  // recent behavior weighs more.
+  static const uint16_t kMaxNameStatsCount = 64;
+
+  // Records a header field emitted as a literal, and returns true if it was
+  // among the recent ones already.
+  bool RecordField(size_t field_hash);
+
+  // Returns the statistics slot of the name hashing to |name_hash|, resetting
+  // it if it was used by another name.
+  NameStats* GetNameStats(size_t name_hash);
+
+  static void Count(uint16_t* counter, NameStats* stats);
+
+  RecentField recent_fields_[kRecentFieldSlots];
+  NameStats name_stats_[kNameStatsSlots];
+};
+
+}  // namespace spdy
+
+#endif  // QUICHE_SPDY_CORE_HPACK_HPACK_INDEXING_POLICY_H_
@@ -0,0 +1,133 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_indexing_policy.h"
+
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_constants.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_string.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_test.h"
+
+namespace spdy {
+namespace test {
+
+class HpackAdaptiveIndexingPolicyPeer {
+ public:
+  static bool RecordField(HpackAdaptiveIndexingPolicy* policy,
+                          size_t field_hash) {
+    return policy->RecordField(field_hash);
+  }
+
+  static void CountNewValue(HpackAdaptiveIndexingPolicy* policy,
+                            size_t name_hash) {
+    auto* stats = policy->GetNameStats(name_hash);
+    HpackAdaptiveIndexingPolicy::Count(&stats->new_values, stats);
+  }
+
+  static uint16_t NewValues(HpackAdaptiveIndexingPolicy* policy,
+                            size_t name_hash) {
+    return policy->GetNameStats(name_hash)->new_values;
+  }
+};
+
+namespace {
+
+using Decision = HpackAdaptiveIndexingPolicy::Decision;
+
+const size_t kTableSize = kDefaultHeaderTableSizeSetting;
+
+TEST(HpackAdaptiveIndexingPolicyTest, IsHighEntropy) {
+  // Random identifiers and hashes.
+  EXPECT_TRUE(HpackAdaptiveIndexingPolicy::IsHighEntropy(
+      "de4d9ba3-1f4a-41de-8c55-1b42e7b1e6e0"));
+  EXPECT_TRUE(HpackAdaptiveIndexingPolicy::IsHighEntropy(
+      "\"33a64df551425fcc55e4d42a148795d9f25f89d4\""));
+  EXPECT_TRUE(HpackAdaptiveIndexingPolicy::IsHighEntropy(
+      "Zx9QbE2kLm4TyR7wVn1Pa8Hc"));
+
+  // Too short.
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicy::IsHighEntropy("3f2a9c1e7b4d8a6"));
+  // Words, numbers, and whitespace.
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicy::IsHighEntropy("max-age=31536000"));
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicy::IsHighEntropy(
+      "application/x-www-form-urlencoded"));
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicy::IsHighEntropy(
+      "/api/v1/users/12345/profile"));
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicy::IsHighEntropy("1572530000123456"));
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicy::IsHighEntropy(
+      "a1 b2 c3 d4 e5 f6 g7 h8"));
+}
+
+TEST(HpackAdaptiveIndexingPolicyTest, NeverIndex) {
+  HpackAdaptiveIndexingPolicy policy;
+  EXPECT_EQ(Decision::kNeverIndex,
+            policy.Decide("authorization", "Basic Zm9vOmJhcg==", kTableSize));
+  EXPECT_EQ(Decision::kNeverIndex,
+            policy.Decide("proxy-authorization", "foo", kTableSize));
+  // Even if the value recurs.
+  EXPECT_EQ(Decision::kNeverIndex,
+            policy.Decide("x-session", "3f2a9c1e7b4d8a6f", kTableSize));
+  EXPECT_EQ(Decision::kNeverIndex,
+            policy.Decide("x-session", "3f2a9c1e7b4d8a6f", kTableSize));
+}
+
+TEST(HpackAdaptiveIndexingPolicyTest, OneOffValues) {
+  HpackAdaptiveIndexingPolicy policy;
+  // The first value of a name is indexed.
+  EXPECT_EQ(Decision::kIndex, policy.Decide("x-request-id", "1", kTableSize));
+  // Later values are not, as long as values do not recur.
+  EXPECT_EQ(Decision::kNoIndex,
+            policy.Decide("x-request-id", "2", kTableSize));
+  EXPECT_EQ(Decision::kNoIndex,
+            policy.Decide("x-request-id", "3", kTableSize));
+  // Unless they were seen before.
+  EXPECT_EQ(Decision::kIndex, policy.Decide("x-request-id", "2", kTableSize));
+
+  // Other names are not affected.
+  EXPECT_EQ(Decision::kIndex, policy.Decide("x-other", "2", kTableSize));
+}
+
+TEST(HpackAdaptiveIndexingPolicyTest, RecurringValues) {
+  HpackAdaptiveIndexingPolicy policy;
+  EXPECT_EQ(Decision::kIndex, policy.Decide("accept", "a", kTableSize));
+  EXPECT_EQ(Decision::kNoIndex, policy.Decide("accept", "b", kTableSize));
+
+  // Values of this name are reused through the dynamic table, so new values
+  // are indexed again.
+  policy.OnDynamicTableHit("accept");
+  policy.OnDynamicTableHit("accept");
+  EXPECT_EQ(Decision::kIndex, policy.Decide("accept", "c", kTableSize));
+}
+
+TEST(HpackAdaptiveIndexingPolicyTest, HashesDifferingInLowBit) {
+  HpackAdaptiveIndexingPolicy policy;
+  // Such hashes use different slots, and neither is mistaken for the other.
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicyPeer::RecordField(&policy, 0x100));
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicyPeer::RecordField(&policy, 0x101));
+  EXPECT_TRUE(HpackAdaptiveIndexingPolicyPeer::RecordField(&policy, 0x100));
+  EXPECT_TRUE(HpackAdaptiveIndexingPolicyPeer::RecordField(&policy, 0x101));
+
+  HpackAdaptiveIndexingPolicyPeer::CountNewValue(&policy, 0x200);
+  HpackAdaptiveIndexingPolicyPeer::CountNewValue(&policy, 0x200);
+  HpackAdaptiveIndexingPolicyPeer::CountNewValue(&policy, 0x201);
+  EXPECT_EQ(2u, HpackAdaptiveIndexingPolicyPeer::NewValues(&policy, 0x200));
+  EXPECT_EQ(1u, HpackAdaptiveIndexingPolicyPeer::NewValues(&policy, 0x201));
+
+  // A hash of 0 is not mistaken for an unused slot.
+  EXPECT_FALSE(HpackAdaptiveIndexingPolicyPeer::RecordField(&policy, 0));
+  EXPECT_TRUE(HpackAdaptiveIndexingPolicyPeer::RecordField(&policy, 0));
+}
+
+TEST(HpackAdaptiveIndexingPolicyTest, LargeEntries) {
+  HpackAdaptiveIndexingPolicy policy;
+  const SpdyString value(kTableSize / 4, 'a');
+  EXPECT_EQ(Decision::kNoIndex, policy.Decide("foo", value, kTableSize));
+  EXPECT_EQ(Decision::kNoIndex, policy.Decide("foo", value, kTableSize));
+
+  // The same entry is indexed if the table is large enough.
+  EXPECT_EQ(Decision::kIndex, policy.Decide("foo", value, 8 * kTableSize));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace spdy
@@ -4,14 +4,12 @@
 
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_output_stream.h"
 
-#include <utility>
-
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_estimate_memory_usage.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_logging.h"
 
 namespace spdy {
 
-HpackOutputStream::HpackOutputStream() : bit_offset_(0) {}
+HpackOutputStream::HpackOutputStream() : bit_offset_(0), read_offset_(0) {}
 
 HpackOutputStream::~HpackOutputStream() = default;
 
@@ -67,24 +65,34 @@ void HpackOutputStream::TakeString(SpdyString* output) {
   // This must hold, since all public functions cause the buffer to
   // end on a byte boundary.
   DCHECK_EQ(bit_offset_, 0u);
+  if (read_offset_ > 0) {
+    buffer_.erase(0, read_offset_);
+    read_offset_ = 0;
+  }
   buffer_.swap(*output);
   buffer_.clear();
   bit_offset_ = 0;
 }
 
 void HpackOutputStream::BoundedTakeString(size_t max_size, SpdyString* output) {
-  if (buffer_.size() > max_size) {
-    // Save off overflow bytes to temporary string (causes a copy).
-    SpdyString overflow(buffer_.data() + max_size, buffer_.size() - max_size);
-
-    // Resize buffer down to the given limit.
-    buffer_.resize(max_size);
-
-    // Give buffer to output string.
-    *output = std::move(buffer_);
-
-    // Reset to contain overflow.
-    buffer_ = std::move(overflow);
+  const size_t remaining = size();
+  if (remaining > max_size) {
+    // Copy the next |max_size| bytes into the capacity of |output| and only
+    // advance the read offset, so that taking a large buffer in bounded
+    // pieces does not move the overflow each time.
+    output->assign(buffer_.data() + read_offset_, max_size);
+    read_offset_ += max_size;
+    // Drop the bytes already taken once they outweigh the overflow, so that
+    // the bytes moved by compaction never exceed the bytes taken.
+    if (read_offset_ >= remaining - max_size) {
+      buffer_.erase(0, read_offset_);
+      read_offset_ = 0;
+    }
+  } else if (read_offset_ > 0) {
+    output->assign(buffer_.data() + read_offset_, remaining);
+    buffer_.clear();
+    read_offset_ = 0;
+    bit_offset_ = 0;
   } else {
     TakeString(output);
   }
@@ -51,12 +51,13 @@ class SPDY_EXPORT_PRIVATE HpackOutputStream {
   // Swaps the internal buffer with |output|, then resets state.
   void TakeString(SpdyString* output);
 
-  // Gives up to |max_size| bytes of the internal buffer to |output|. Resets
-  // internal state with the overflow.
+  // Gives up to |max_size| bytes of the internal buffer to |output|, keeping
+  // the overflow for the next call. Reuses the capacity of |output| and of
+  // the internal buffer when there is overflow.
   void BoundedTakeString(size_t max_size, SpdyString* output);
 
-  // Size in bytes of stream's internal buffer.
-  size_t size() const { return buffer_.size(); }
+  // Size in bytes of the internal buffer not yet taken.
+  size_t size() const { return buffer_.size() - read_offset_; }
 
   // Returns the estimate of dynamically allocated memory in bytes.
   size_t EstimateMemoryUsage() const;
@@ -68,6 +69,10 @@ class SPDY_EXPORT_PRIVATE HpackOutputStream {
   // If 0, the buffer ends on a byte boundary. If non-zero, the buffer
   // ends on the nth most significant bit. Guaranteed to be < 8.
   size_t bit_offset_;
+
+  // Number of bytes at the front of |buffer_| already given out by
+  // BoundedTakeString().
+  size_t read_offset_;
 };
 
 }  // namespace spdy
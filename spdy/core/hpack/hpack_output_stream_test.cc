@@ -271,6 +271,54 @@ TEST(HpackOutputStreamTest, BoundedTakeString) {
   EXPECT_EQ("\x10", str);
 }
 
+TEST(HpackOutputStreamTest, BoundedTakeStringReusesOutput) {
+  HpackOutputStream output_stream;
+  output_stream.AppendBytes(SpdyString(150, 'a'));
+
+  SpdyString str;
+  str.reserve(100);
+  const char* const data = str.data();
+  output_stream.BoundedTakeString(100, &str);
+  EXPECT_EQ(SpdyString(100, 'a'), str);
+  EXPECT_EQ(data, str.data());
+  EXPECT_EQ(50u, output_stream.size());
+
+  output_stream.BoundedTakeString(100, &str);
+  EXPECT_EQ(SpdyString(50, 'a'), str);
+  EXPECT_EQ(0u, output_stream.size());
+}
+
+TEST(HpackOutputStreamTest, BoundedTakeStringInManyPieces) {
+  HpackOutputStream output_stream;
+  SpdyString expected;
+  for (int i = 0; i < 1000; ++i) {
+    expected.append(1, static_cast<char>('a' + i % 26));
+  }
+  output_stream.AppendBytes(expected);
+
+  // Appending between bounded takes extends the data not yet taken.
+  SpdyString taken;
+  SpdyString str;
+  for (int i = 0; output_stream.size() > 0; ++i) {
+    output_stream.BoundedTakeString(7, &str);
+    EXPECT_GE(7u, str.size());
+    taken.append(str);
+    if (i == 50) {
+      output_stream.AppendBytes("appended");
+      expected.append("appended");
+    }
+  }
+  EXPECT_EQ(expected, taken);
+
+  // TakeString() gives only the data not yet taken.
+  output_stream.AppendBytes("0123456789abcdefghijklmnopqrst");
+  output_stream.BoundedTakeString(10, &str);
+  EXPECT_EQ("0123456789", str);
+  output_stream.TakeString(&str);
+  EXPECT_EQ("abcdefghijklmnopqrst", str);
+  EXPECT_EQ(0u, output_stream.size());
+}
+
 }  // namespace
 
 }  // namespace spdy
@@ -149,6 +149,20 @@ TEST_P(HpackRoundTripTest, RequestFixtures) {
   }
 }
 
+TEST_P(HpackRoundTripTest, AdaptiveIndexing) {
+  encoder_.EnableAdaptiveIndexing();
+  for (size_t i = 0; i != 100; ++i) {
+    SpdyHeaderBlock headers;
+    headers[":method"] = "GET";
+    headers[":authority"] = "www.example.com";
+    headers[":path"] = i % 3 == 0 ? "/index.html" : "/api/items";
+    headers["authorization"] = "Bearer 3f2a9c1e7b4d8a6f";
+    headers["x-request-id"] = random_.RandString(16);
+    headers["x-sequence"] = SpdyString(1 + i % 10, 'a');
+    EXPECT_TRUE(RoundTrip(headers));
+  }
+}
+
 TEST_P(HpackRoundTripTest, RandomizedExamples) {
   // Grow vectors of names & values, which are seeded with fixtures and then
   // expanded with dynamically generated data. Samples are taken using the
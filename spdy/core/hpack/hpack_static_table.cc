@@ -4,47 +4,70 @@
 
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_static_table.h"
 
-#include "net/third_party/quiche/src/spdy/core/hpack/hpack_constants.h"
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_entry.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_estimate_memory_usage.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_logging.h"
-#include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
 
 namespace spdy {
 
-HpackStaticTable::HpackStaticTable() = default;
+constexpr size_t HpackStaticIndex::kNotFound;
+constexpr size_t HpackStaticIndex::kMaxEntries;
+
+size_t HpackStaticIndex::FindName(SpdyStringPiece name) const {
+  const uint8_t id = name_slots_[Slot(HashName(name.data(), name.size()),
+                                      name_seed_, kNameSlotBits)];
+  if (id == kEmptySlot) {
+    return kNotFound;
+  }
+  const HpackStaticEntry& entry = entries_[id];
+  if (name != SpdyStringPiece(entry.name, entry.name_len)) {
+    return kNotFound;
+  }
+  return id;
+}
+
+size_t HpackStaticIndex::Find(SpdyStringPiece name,
+                              SpdyStringPiece value) const {
+  const uint32_t hash = HashEntry(HashName(name.data(), name.size()),
+                                  value.data(), value.size());
+  const uint8_t id = entry_slots_[Slot(hash, entry_seed_, kEntrySlotBits)];
+  if (id == kEmptySlot) {
+    return kNotFound;
+  }
+  const HpackStaticEntry& entry = entries_[id];
+  if (name != SpdyStringPiece(entry.name, entry.name_len) ||
+      value != SpdyStringPiece(entry.value, entry.value_len)) {
+    return kNotFound;
+  }
+  return id;
+}
+
+HpackStaticTable::HpackStaticTable() : static_index_(nullptr) {}
 
 HpackStaticTable::~HpackStaticTable() = default;
 
-void HpackStaticTable::Initialize(const HpackStaticEntry* static_entry_table,
-                                  size_t static_entry_count) {
+void HpackStaticTable::Initialize(const HpackStaticIndex& static_index) {
   CHECK(!IsInitialized());
+  CHECK(static_index.IsValid());
 
-  int total_insertions = 0;
-  for (const HpackStaticEntry* it = static_entry_table;
-       it != static_entry_table + static_entry_count; ++it) {
+  static_index_ = &static_index;
+  const HpackStaticEntry* static_entry_table = static_index.entries();
+  for (size_t i = 0; i < static_index.size(); ++i) {
+    const HpackStaticEntry& it = static_entry_table[i];
     static_entries_.push_back(
-        HpackEntry(SpdyStringPiece(it->name, it->name_len),
-                   SpdyStringPiece(it->value, it->value_len),
+        HpackEntry(SpdyStringPiece(it.name, it.name_len),
+                   SpdyStringPiece(it.value, it.value_len),
                    true,  // is_static
-                   total_insertions));
-    HpackEntry* entry = &static_entries_.back();
-    CHECK(static_index_.insert(entry).second);
-    // Multiple static entries may have the same name, so inserts may fail.
-    static_name_index_.insert(std::make_pair(entry->name(), entry));
-
-    ++total_insertions;
+                   i));
   }
 }
 
 bool HpackStaticTable::IsInitialized() const {
-  return !static_entries_.empty();
+  return static_index_ != nullptr;
 }
 
 size_t HpackStaticTable::EstimateMemoryUsage() const {
-  return SpdyEstimateMemoryUsage(static_entries_) +
-         SpdyEstimateMemoryUsage(static_index_) +
-         SpdyEstimateMemoryUsage(static_name_index_);
+  return SpdyEstimateMemoryUsage(static_entries_);
 }
 
 }  // namespace spdy
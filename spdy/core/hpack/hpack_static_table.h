@@ -5,12 +5,183 @@
 #ifndef QUICHE_SPDY_CORE_HPACK_HPACK_STATIC_TABLE_H_
 #define QUICHE_SPDY_CORE_HPACK_HPACK_STATIC_TABLE_H_
 
+#include <cstddef>
+#include <cstdint>
+
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_constants.h"
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_header_table.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
 
 namespace spdy {
 
-struct HpackStaticEntry;
+// HpackStaticIndex maps header names, and header name and value pairs, to
+// their position in an array of struct HpackStaticEntry.  It is meant to be
+// built at compile time from a constexpr array: keys are assigned slots by a
+// perfect hash, therefore a lookup hashes its key once and compares it to at
+// most one entry.  An instance does not own any heap memory.
+class SPDY_EXPORT_PRIVATE HpackStaticIndex {
+ public:
+  // Returned by the lookup methods if there is no match.
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  // Maximum number of entries that can be indexed.
+  static constexpr size_t kMaxEntries = 255;
+
+  // |static_entry_table| must outlive this object.  If it has more than
+  // kMaxEntries entries, has duplicate entries, or no perfect hash is found,
+  // then IsValid() returns false, which is a compile time error if the
+  // instance is constexpr and checked with static_assert.
+  constexpr HpackStaticIndex(const HpackStaticEntry* static_entry_table,
+                             size_t static_entry_count)
+      : entries_(static_entry_table),
+        entry_count_(static_entry_count),
+        name_count_(0),
+        name_seed_(0),
+        entry_seed_(0),
+        name_slots_(),
+        entry_slots_(),
+        is_valid_(false) {
+    is_valid_ = Build();
+  }
+
+  constexpr bool IsValid() const { return is_valid_; }
+
+  const HpackStaticEntry* entries() const { return entries_; }
+
+  // Number of entries, and number of distinct names.
+  size_t size() const { return entry_count_; }
+  size_t name_count() const { return name_count_; }
+
+  // Returns the position of the first entry with |name|, or kNotFound.
+  size_t FindName(SpdyStringPiece name) const;
+
+  // Returns the position of the entry with |name| and |value|, or kNotFound.
+  size_t Find(SpdyStringPiece name, SpdyStringPiece value) const;
+
+ private:
+  static constexpr size_t kNameSlotBits = 8;
+  static constexpr size_t kEntrySlotBits = 10;
+  static constexpr uint8_t kEmptySlot = 0xff;
+  // Number of seeds tried before giving up.
+  static constexpr uint32_t kMaxSeeds = 4096;
+
+  // 32-bit FNV-1a, seeded with |hash|.
+  static constexpr uint32_t Hash(const char* data, size_t len, uint32_t hash) {
+    for (size_t i = 0; i < len; ++i) {
+      hash ^= static_cast<uint8_t>(data[i]);
+      hash *= 16777619u;
+    }
+    return hash;
+  }
+  static constexpr uint32_t HashName(const char* name, size_t name_len) {
+    return Hash(name, name_len, 2166136261u);
+  }
+  // Hashes |value| after |name_hash| and a separator.
+  static constexpr uint32_t HashEntry(uint32_t name_hash,
+                                      const char* value,
+                                      size_t value_len) {
+    return Hash(value, value_len, (name_hash ^ 0xff) * 16777619u);
+  }
+
+  static constexpr size_t Slot(uint32_t hash, uint32_t seed, size_t bits) {
+    return static_cast<uint32_t>((hash ^ (seed * 0x9e3779b9u)) * 0x85ebca6bu) >>
+           (32 - bits);
+  }
+
+  static constexpr bool Equals(const char* a,
+                               size_t a_len,
+                               const char* b,
+                               size_t b_len) {
+    if (a_len != b_len) {
+      return false;
+    }
+    for (size_t i = 0; i < a_len; ++i) {
+      if (a[i] != b[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Finds a seed for which every one of |count| |hashes| maps to a different
+  // slot among 2^|bits|, and fills |slots| with |ids| accordingly.  Returns
+  // false if there is no such seed below kMaxSeeds.
+  static constexpr bool FindSeed(const uint32_t* hashes,
+                                 const uint8_t* ids,
+                                 size_t count,
+                                 size_t bits,
+                                 uint32_t* seed,
+                                 uint8_t* slots) {
+    // Number of the last attempt that used each slot, to detect collisions
+    // without clearing the array between attempts.
+    uint16_t last_used[size_t{1} << kEntrySlotBits] = {};
+    for (uint32_t attempt = 1; attempt <= kMaxSeeds; ++attempt) {
+      bool collision = false;
+      for (size_t i = 0; i < count && !collision; ++i) {
+        const size_t slot = Slot(hashes[i], attempt, bits);
+        collision = last_used[slot] == attempt;
+        last_used[slot] = attempt;
+      }
+      if (collision) {
+        continue;
+      }
+      *seed = attempt;
+      for (size_t i = 0; i < (size_t{1} << bits); ++i) {
+        slots[i] = kEmptySlot;
+      }
+      for (size_t i = 0; i < count; ++i) {
+        slots[Slot(hashes[i], attempt, bits)] = ids[i];
+      }
+      return true;
+    }
+    return false;
+  }
+
+  constexpr bool Build() {
+    if (entry_count_ > kMaxEntries) {
+      return false;
+    }
+    uint32_t name_hashes[kMaxEntries] = {};
+    uint8_t name_ids[kMaxEntries] = {};
+    uint32_t entry_hashes[kMaxEntries] = {};
+    uint8_t entry_ids[kMaxEntries] = {};
+    for (size_t i = 0; i < entry_count_; ++i) {
+      const HpackStaticEntry& entry = entries_[i];
+      const uint32_t name_hash = HashName(entry.name, entry.name_len);
+      entry_hashes[i] = HashEntry(name_hash, entry.value, entry.value_len);
+      entry_ids[i] = static_cast<uint8_t>(i);
+      // Multiple entries may have the same name, only the first one is
+      // indexed by name.
+      bool is_new_name = true;
+      for (size_t j = 0; j < name_count_ && is_new_name; ++j) {
+        const HpackStaticEntry& other = entries_[name_ids[j]];
+        is_new_name = name_hashes[j] != name_hash ||
+                      !Equals(entry.name, entry.name_len, other.name,
+                              other.name_len);
+      }
+      if (is_new_name) {
+        name_hashes[name_count_] = name_hash;
+        name_ids[name_count_] = static_cast<uint8_t>(i);
+        ++name_count_;
+      }
+    }
+    // Duplicate entries have the same hash, therefore no seed is found.
+    return FindSeed(name_hashes, name_ids, name_count_, kNameSlotBits,
+                    &name_seed_, name_slots_) &&
+           FindSeed(entry_hashes, entry_ids, entry_count_, kEntrySlotBits,
+                    &entry_seed_, entry_slots_);
+  }
+
+  const HpackStaticEntry* entries_;
+  size_t entry_count_;
+  size_t name_count_;
+  uint32_t name_seed_;
+  uint32_t entry_seed_;
+  uint8_t name_slots_[size_t{1} << kNameSlotBits];
+  uint8_t entry_slots_[size_t{1} << kEntrySlotBits];
+  bool is_valid_;
+};
 
 // HpackStaticTable provides |static_entries_| and |static_index_| for HPACK
 // encoding and decoding contexts.  Once initialized, an instance is read only
@@ -21,10 +192,10 @@ class SPDY_EXPORT_PRIVATE HpackStaticTable {
   HpackStaticTable();
   ~HpackStaticTable();
 
-  // Prepares HpackStaticTable by filling up static_entries_ and static_index_
-  // from an array of struct HpackStaticEntry.  Must be called exactly once.
-  void Initialize(const HpackStaticEntry* static_entry_table,
-                  size_t static_entry_count);
+  // Prepares HpackStaticTable by filling up static_entries_ from the entries
+  // of |static_index|, which must be valid and outlive this object.  Must be
+  // called exactly once.
+  void Initialize(const HpackStaticIndex& static_index);
 
   // Returns whether Initialize() has been called.
   bool IsInitialized() const;
@@ -33,20 +204,14 @@ class SPDY_EXPORT_PRIVATE HpackStaticTable {
   const HpackHeaderTable::EntryTable& GetStaticEntries() const {
     return static_entries_;
   }
-  const HpackHeaderTable::UnorderedEntrySet& GetStaticIndex() const {
-    return static_index_;
-  }
-  const HpackHeaderTable::NameToEntryMap& GetStaticNameIndex() const {
-    return static_name_index_;
-  }
+  const HpackStaticIndex& GetStaticIndex() const { return *static_index_; }
 
   // Returns the estimate of dynamically allocated memory in bytes.
   size_t EstimateMemoryUsage() const;
 
  private:
   HpackHeaderTable::EntryTable static_entries_;
-  HpackHeaderTable::UnorderedEntrySet static_index_;
-  HpackHeaderTable::NameToEntryMap static_name_index_;
+  const HpackStaticIndex* static_index_;
 };
 
 }  // namespace spdy
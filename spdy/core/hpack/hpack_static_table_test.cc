@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "net/third_party/quiche/src/spdy/core/hpack/hpack_constants.h"
+#include "net/third_party/quiche/src/spdy/core/hpack/hpack_entry.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_test.h"
 
@@ -27,23 +28,58 @@ class HpackStaticTableTest : public ::testing::Test {
 // Check that an initialized instance has the right number of entries.
 TEST_F(HpackStaticTableTest, Initialize) {
   EXPECT_FALSE(table_.IsInitialized());
-  table_.Initialize(HpackStaticTableVector().data(),
-                    HpackStaticTableVector().size());
+  HpackStaticIndex static_index(HpackStaticTableVector().data(),
+                                HpackStaticTableVector().size());
+  ASSERT_TRUE(static_index.IsValid());
+  table_.Initialize(static_index);
   EXPECT_TRUE(table_.IsInitialized());
 
   HpackHeaderTable::EntryTable static_entries = table_.GetStaticEntries();
   EXPECT_EQ(HpackStaticTableVector().size(), static_entries.size());
 
-  HpackHeaderTable::UnorderedEntrySet static_index = table_.GetStaticIndex();
-  EXPECT_EQ(HpackStaticTableVector().size(), static_index.size());
+  const HpackStaticIndex& index = table_.GetStaticIndex();
+  EXPECT_EQ(HpackStaticTableVector().size(), index.size());
 
-  HpackHeaderTable::NameToEntryMap static_name_index =
-      table_.GetStaticNameIndex();
   std::set<SpdyStringPiece> names;
-  for (auto* entry : static_index) {
-    names.insert(entry->name());
+  for (const HpackEntry& entry : static_entries) {
+    names.insert(entry.name());
   }
-  EXPECT_EQ(names.size(), static_name_index.size());
+  EXPECT_EQ(names.size(), index.name_count());
+}
+
+TEST_F(HpackStaticTableTest, Find) {
+  const HpackStaticIndex& index = ObtainHpackStaticTable().GetStaticIndex();
+  const std::vector<HpackStaticEntry>& entries = HpackStaticTableVector();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    SpdyStringPiece name(entries[i].name, entries[i].name_len);
+    SpdyStringPiece value(entries[i].value, entries[i].value_len);
+    EXPECT_EQ(i, index.Find(name, value));
+
+    size_t first = index.FindName(name);
+    ASSERT_NE(HpackStaticIndex::kNotFound, first);
+    EXPECT_LE(first, i);
+    EXPECT_EQ(name, SpdyStringPiece(entries[first].name,
+                                    entries[first].name_len));
+  }
+
+  // The first entry with a given name is returned.
+  EXPECT_EQ(1u, index.FindName(":method"));
+  EXPECT_EQ(7u, index.FindName(":status"));
+
+  EXPECT_EQ(HpackStaticIndex::kNotFound, index.Find(":method", "PUT"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, index.Find(":method", ""));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, index.Find("x-method", "GET"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, index.FindName(":METHOD"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, index.FindName("x-forwarded-for"));
+  EXPECT_EQ(HpackStaticIndex::kNotFound, index.FindName(""));
+}
+
+TEST_F(HpackStaticTableTest, IndexRejectsDuplicateEntries) {
+  const HpackStaticEntry entries[] = {{"foo", 3, "bar", 3},
+                                      {"foo", 3, "baz", 3},
+                                      {"foo", 3, "bar", 3}};
+  EXPECT_TRUE(HpackStaticIndex(entries, 2).IsValid());
+  EXPECT_FALSE(HpackStaticIndex(entries, 3).IsValid());
 }
 
 // Test that ObtainHpackStaticTable returns the same instance every time.
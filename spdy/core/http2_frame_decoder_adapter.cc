@@ -367,6 +367,26 @@ void Http2DecoderAdapter::OnDataEnd() {
   opt_pad_length_.reset();
 }
 
+void Http2DecoderAdapter::OnDataFrame(const Http2FrameHeader& header,
+                                      const char* data,
+                                      size_t len) {
+  SPDY_DVLOG(1) << "OnDataFrame: " << header << "; len=" << len;
+  if (!IsOkToStartFrame(header) || !HasRequiredStreamId(header)) {
+    return;
+  }
+  frame_header_ = header;
+  has_frame_header_ = true;
+  visitor()->OnDataFrameHeader(header.stream_id, header.payload_length,
+                               header.IsEndStream());
+  if (len > 0) {
+    visitor()->OnStreamFrameData(header.stream_id, data, len);
+  }
+  if (header.IsEndStream()) {
+    visitor()->OnStreamEnd(header.stream_id);
+  }
+  opt_pad_length_.reset();
+}
+
 void Http2DecoderAdapter::OnHeadersStart(const Http2FrameHeader& header) {
   SPDY_DVLOG(1) << "OnHeadersStart: " << header;
   if (IsOkToStartFrame(header) && HasRequiredStreamId(header)) {
@@ -952,6 +972,7 @@ void Http2DecoderAdapter::ReportReceiveCompressedFrame(
 HpackDecoderAdapter* Http2DecoderAdapter::GetHpackDecoder() {
   if (hpack_decoder_ == nullptr) {
     hpack_decoder_ = SpdyMakeUnique<HpackDecoderAdapter>();
+    hpack_decoder_->set_validate_header_fields(true);
   }
   return hpack_decoder_.get();
 }
@@ -13,7 +13,6 @@
 #include <utility>
 #include <vector>
 
-#include "net/third_party/quiche/src/http2/platform/api/http2_containers.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
 #include "net/third_party/quiche/src/spdy/core/write_scheduler.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_bug_tracker.h"
@@ -65,7 +64,8 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
       SPDY_BUG << "Stream " << root_stream_id_ << " already registered";
       return;
     }
-    StreamInfo stream_info = {precedence.spdy3_priority(), stream_id, false};
+    StreamInfo stream_info = {precedence.spdy3_priority(), stream_id, false,
+                              nullptr, nullptr};
     bool inserted =
         stream_infos_.insert(std::make_pair(stream_id, stream_info)).second;
     SPDY_BUG_IF(!inserted) << "Stream " << stream_id << " already registered";
@@ -79,9 +79,7 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
     }
     StreamInfo& stream_info = it->second;
     if (stream_info.ready) {
-      bool erased =
-          Erase(&priority_infos_[stream_info.priority].ready_list, stream_info);
-      DCHECK(erased);
+      RemoveFromReadyList(&stream_info);
     }
     stream_infos_.erase(it);
   }
@@ -124,11 +122,10 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
       return;
     }
     if (stream_info.ready) {
-      bool erased =
-          Erase(&priority_infos_[stream_info.priority].ready_list, stream_info);
-      DCHECK(erased);
-      priority_infos_[new_priority].ready_list.push_back(&stream_info);
-      ++num_ready_streams_;
+      RemoveFromReadyList(&stream_info);
+      stream_info.priority = new_priority;
+      AddToReadyList(&stream_info, /*add_to_front=*/false);
+      return;
     }
     stream_info.priority = new_priority;
   }
@@ -172,21 +169,17 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
   // Returns the next ready stream and its precedence.
   std::tuple<StreamIdType, StreamPrecedenceType>
   PopNextReadyStreamAndPrecedence() override {
-    for (SpdyPriority p = kV3HighestPriority; p <= kV3LowestPriority; ++p) {
-      ReadyList& ready_list = priority_infos_[p].ready_list;
-      if (!ready_list.empty()) {
-        StreamInfo* info = ready_list.front();
-        ready_list.pop_front();
-        --num_ready_streams_;
-
-        DCHECK(stream_infos_.find(info->stream_id) != stream_infos_.end());
-        info->ready = false;
-        return std::make_tuple(info->stream_id,
-                               StreamPrecedenceType(info->priority));
-      }
+    if (ready_priorities_ == 0) {
+      SPDY_BUG << "No ready streams available";
+      return std::make_tuple(0, StreamPrecedenceType(kV3LowestPriority));
     }
-    SPDY_BUG << "No ready streams available";
-    return std::make_tuple(0, StreamPrecedenceType(kV3LowestPriority));
+    StreamInfo* info =
+        priority_infos_[HighestReadyPriority(ready_priorities_)]
+            .ready_list.front();
+    DCHECK(stream_infos_.find(info->stream_id) != stream_infos_.end());
+    RemoveFromReadyList(info);
+    return std::make_tuple(info->stream_id,
+                           StreamPrecedenceType(info->priority));
   }
 
   bool ShouldYield(StreamIdType stream_id) const override {
@@ -198,10 +191,8 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
 
     // If there's a higher priority stream, this stream should yield.
     const StreamInfo& stream_info = it->second;
-    for (SpdyPriority p = kV3HighestPriority; p < stream_info.priority; ++p) {
-      if (!priority_infos_[p].ready_list.empty()) {
-        return true;
-      }
+    if ((ready_priorities_ & ((1u << stream_info.priority) - 1)) != 0) {
+      return true;
     }
 
     // If this priority level is empty, or this stream is the next up, there's
@@ -226,14 +217,7 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
     if (stream_info.ready) {
       return;
     }
-    ReadyList& ready_list = priority_infos_[stream_info.priority].ready_list;
-    if (add_to_front) {
-      ready_list.push_front(&stream_info);
-    } else {
-      ready_list.push_back(&stream_info);
-    }
-    ++num_ready_streams_;
-    stream_info.ready = true;
+    AddToReadyList(&stream_info, add_to_front);
   }
 
   void MarkStreamNotReady(StreamIdType stream_id) override {
@@ -246,10 +230,7 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
     if (!stream_info.ready) {
       return;
     }
-    bool erased =
-        Erase(&priority_infos_[stream_info.priority].ready_list, stream_info);
-    DCHECK(erased);
-    stream_info.ready = false;
+    RemoveFromReadyList(&stream_info);
   }
 
   // Returns true iff the number of ready streams is non-zero.
@@ -283,10 +264,66 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
     SpdyPriority priority;
     StreamIdType stream_id;
     bool ready;
+    // Neighbors in the ready list, if ready.
+    StreamInfo* prev;
+    StreamInfo* next;
   };
 
-  // O(1) size lookup, O(1) insert at front or back (amortized).
-  using ReadyList = http2::Http2Deque<StreamInfo*>;
+  // Intrusive doubly linked list of the StreamInfos of ready streams, which
+  // are owned by |stream_infos_|.  O(1) size lookup, insert at front or back,
+  // and removal of any element.
+  class ReadyList {
+   public:
+    bool empty() const { return head_ == nullptr; }
+    size_t size() const { return size_; }
+    StreamInfo* front() const { return head_; }
+
+    void push_front(StreamInfo* info) {
+      info->prev = nullptr;
+      info->next = head_;
+      if (head_ == nullptr) {
+        tail_ = info;
+      } else {
+        head_->prev = info;
+      }
+      head_ = info;
+      ++size_;
+    }
+
+    void push_back(StreamInfo* info) {
+      info->prev = tail_;
+      info->next = nullptr;
+      if (tail_ == nullptr) {
+        head_ = info;
+      } else {
+        tail_->next = info;
+      }
+      tail_ = info;
+      ++size_;
+    }
+
+    // |info| must be in this list.
+    void erase(StreamInfo* info) {
+      if (info->prev == nullptr) {
+        head_ = info->next;
+      } else {
+        info->prev->next = info->next;
+      }
+      if (info->next == nullptr) {
+        tail_ = info->prev;
+      } else {
+        info->next->prev = info->prev;
+      }
+      info->prev = nullptr;
+      info->next = nullptr;
+      --size_;
+    }
+
+   private:
+    StreamInfo* head_ = nullptr;
+    StreamInfo* tail_ = nullptr;
+    size_t size_ = 0;
+  };
 
   // State kept for each priority level.
   struct PriorityInfo {
@@ -298,21 +335,50 @@ class PriorityWriteScheduler : public WriteScheduler<StreamIdType> {
 
   typedef std::unordered_map<StreamIdType, StreamInfo> StreamInfoMap;
 
-  // Erases first occurrence (which should be the only one) of |info| in
-  // |ready_list|, returning true if found (and erased), or false otherwise.
-  // Decrements |num_ready_streams_| if an entry is erased.
-  bool Erase(ReadyList* ready_list, const StreamInfo& info) {
-    auto it = std::find(ready_list->begin(), ready_list->end(), &info);
-    if (it == ready_list->end()) {
-      return false;
+  static_assert(kV3LowestPriority < 8,
+                "Priority levels must fit in |ready_priorities_|");
+
+  // Returns the highest priority, i.e. the lowest set bit, in the non-zero
+  // bitmap |priorities|.
+  static SpdyPriority HighestReadyPriority(uint8_t priorities) {
+    // Index of the lowest set bit of every non-zero nibble.
+    static const uint8_t kLowestBit[16] = {0, 0, 1, 0, 2, 0, 1, 0,
+                                           3, 0, 1, 0, 2, 0, 1, 0};
+    DCHECK_NE(0u, priorities);
+    return (priorities & 0x0f) != 0 ? kLowestBit[priorities & 0x0f]
+                                    : 4 + kLowestBit[priorities >> 4];
+  }
+
+  // Appends or prepends |info|, which must not be ready, to the ready list of
+  // its priority.
+  void AddToReadyList(StreamInfo* info, bool add_to_front) {
+    ReadyList& ready_list = priority_infos_[info->priority].ready_list;
+    if (add_to_front) {
+      ready_list.push_front(info);
+    } else {
+      ready_list.push_back(info);
+    }
+    ready_priorities_ |= 1u << info->priority;
+    ++num_ready_streams_;
+    info->ready = true;
+  }
+
+  // Removes |info|, which must be ready, from the ready list of its priority.
+  void RemoveFromReadyList(StreamInfo* info) {
+    DCHECK(info->ready);
+    ReadyList& ready_list = priority_infos_[info->priority].ready_list;
+    ready_list.erase(info);
+    if (ready_list.empty()) {
+      ready_priorities_ &= ~(1u << info->priority);
     }
-    ready_list->erase(it);
     --num_ready_streams_;
-    return true;
+    info->ready = false;
   }
 
   // Number of ready streams.
   size_t num_ready_streams_ = 0;
+  // Bit p is set iff priority_infos_[p].ready_list is not empty.
+  uint8_t ready_priorities_ = 0;
   // Per-priority state, including ready lists.
   PriorityInfo priority_infos_[kV3LowestPriority + 1];
   // StreamInfos for all registered streams.
@@ -320,6 +320,48 @@ TEST_F(PriorityWriteSchedulerTest, UnregisterRemovesStream) {
                   "No ready streams available");
 }
 
+TEST_F(PriorityWriteSchedulerTest, RemoveFromMiddleOfReadyList) {
+  for (SpdyStreamId id = 1; id <= 5; ++id) {
+    scheduler_.RegisterStream(id, SpdyStreamPrecedence(3));
+    scheduler_.MarkStreamReady(id, false);
+  }
+  EXPECT_EQ(5u, peer_.NumReadyStreams(3));
+
+  // Streams can be removed from anywhere in the ready list, keeping the order
+  // of the others.
+  scheduler_.MarkStreamNotReady(3);
+  scheduler_.UnregisterStream(5);
+  scheduler_.UpdateStreamPrecedence(1, SpdyStreamPrecedence(6));
+  EXPECT_EQ(2u, peer_.NumReadyStreams(3));
+  EXPECT_EQ(1u, peer_.NumReadyStreams(6));
+  EXPECT_EQ(3u, scheduler_.NumReadyStreams());
+
+  scheduler_.MarkStreamReady(3, true);
+  EXPECT_EQ(3u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(2u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(4u, scheduler_.PopNextReadyStream());
+  EXPECT_EQ(1u, scheduler_.PopNextReadyStream());
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+}
+
+TEST_F(PriorityWriteSchedulerTest, PopsEveryPriorityLevel) {
+  // Mark one stream ready per priority, in reverse order.
+  for (SpdyPriority p = kV3HighestPriority; p <= kV3LowestPriority; ++p) {
+    scheduler_.RegisterStream(10 + p, SpdyStreamPrecedence(p));
+  }
+  for (int p = kV3LowestPriority; p >= kV3HighestPriority; --p) {
+    scheduler_.MarkStreamReady(10 + p, false);
+  }
+
+  for (SpdyPriority p = kV3HighestPriority; p <= kV3LowestPriority; ++p) {
+    EXPECT_FALSE(scheduler_.ShouldYield(10 + p));
+    auto id_and_precedence = scheduler_.PopNextReadyStreamAndPrecedence();
+    EXPECT_EQ(10u + p, std::get<0>(id_and_precedence));
+    EXPECT_EQ(p, std::get<1>(id_and_precedence).spdy3_priority());
+  }
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+}
+
 TEST_F(PriorityWriteSchedulerTest, ShouldYield) {
   scheduler_.RegisterStream(1, SpdyStreamPrecedence(1));
   scheduler_.RegisterStream(4, SpdyStreamPrecedence(4));
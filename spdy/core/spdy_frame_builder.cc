@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <new>
 
@@ -159,6 +160,30 @@ bool SpdyFrameBuilder::WriteBytes(const void* data, uint32_t data_len) {
   return true;
 }
 
+bool SpdyFrameBuilder::WriteZeros(size_t length) {
+  if (!CanWrite(length)) {
+    return false;
+  }
+
+  if (output_ == nullptr) {
+    memset(GetWritableBuffer(length), 0, length);
+    Seek(length);
+    return true;
+  }
+  size_t size = 0;
+  while (length > 0) {
+    char* dest = GetWritableOutput(length, &size);
+    if (dest == nullptr || size == 0) {
+      // Unable to make progress.
+      return false;
+    }
+    memset(dest, 0, size);
+    Seek(size);
+    length -= size;
+  }
+  return true;
+}
+
 bool SpdyFrameBuilder::CanWrite(size_t length) const {
   if (length > kLengthMask) {
     DCHECK(false);
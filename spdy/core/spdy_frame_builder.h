@@ -102,6 +102,9 @@ class SPDY_EXPORT_PRIVATE SpdyFrameBuilder {
   }
   bool WriteStringPiece32(const SpdyStringPiece value);
   bool WriteBytes(const void* data, uint32_t data_len);
+  // Appends |length| zero bytes, for instance frame padding, without
+  // allocating a temporary buffer.
+  bool WriteZeros(size_t length);
 
  private:
   friend class test::SpdyFrameBuilderPeer;
@@ -4,12 +4,14 @@
 
 #include "net/third_party/quiche/src/spdy/core/spdy_frame_builder.h"
 
+#include <cstring>
 #include <memory>
 
 #include "net/third_party/quiche/src/spdy/core/array_output_buffer.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_framer.h"
 #include "net/third_party/quiche/src/spdy/core/spdy_protocol.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_string.h"
 #include "net/third_party/quiche/src/spdy/platform/api/spdy_test.h"
 
 namespace spdy {
@@ -83,5 +85,27 @@ TEST(SpdyFrameBuilderTest, GetWritableOutputNegative) {
   EXPECT_EQ(nullptr, writable_buffer);
 }
 
+// Verifies that SpdyFrameBuilder::WriteZeros() writes zeros both to its own
+// buffer and to the output buffer.
+TEST(SpdyFrameBuilderTest, WriteZeros) {
+  const size_t kBuilderSize = 300;
+  const SpdyString expected(kBuilderSize, '\0');
+
+  SpdyFrameBuilder builder(kBuilderSize);
+  EXPECT_TRUE(builder.WriteZeros(kBuilderSize));
+  SpdySerializedFrame frame(builder.take());
+  EXPECT_EQ(expected, SpdyStringPiece(frame.data(), kBuilderSize));
+
+  memset(output_buffer, ~1, kBuilderSize);
+  ArrayOutputBuffer output(output_buffer, kSize);
+  SpdyFrameBuilder output_builder(kBuilderSize, &output);
+  EXPECT_TRUE(output_builder.WriteZeros(kBuilderSize));
+  EXPECT_EQ(kBuilderSize, output.Size());
+  EXPECT_EQ(expected, SpdyStringPiece(output_buffer, kBuilderSize));
+
+  // Not enough space left in the output.
+  EXPECT_FALSE(output_builder.WriteZeros(kSize));
+}
+
 }  // namespace test
 }  // namespace spdy
@@ -124,8 +124,7 @@ bool SerializeHeadersGivenEncoding(const SpdyHeadersIR& headers,
   }
 
   if (ret && headers.padding_payload_len() > 0) {
-    SpdyString padding(headers.padding_payload_len(), 0);
-    ret &= builder.WriteBytes(padding.data(), padding.length());
+    ret &= builder.WriteZeros(headers.padding_payload_len());
   }
 
   if (!ret) {
@@ -155,8 +154,7 @@ bool SerializePushPromiseGivenEncoding(const SpdyPushPromiseIR& push_promise,
   ok = ok && builder.WriteUInt32(push_promise.promised_stream_id()) &&
        builder.WriteBytes(encoding.data(), encoding.size());
   if (ok && push_promise.padding_payload_len() > 0) {
-    SpdyString padding(push_promise.padding_payload_len(), 0);
-    ok = builder.WriteBytes(padding.data(), padding.length());
+    ok = builder.WriteZeros(push_promise.padding_payload_len());
   }
 
   SPDY_DLOG_IF(ERROR, !ok)
@@ -165,6 +163,23 @@ bool SerializePushPromiseGivenEncoding(const SpdyPushPromiseIR& push_promise,
   return ok;
 }
 
+// Serializes a CONTINUATION frame carrying |encoding|, a fragment of a header
+// block, for the given stream.
+bool SerializeContinuationGivenEncoding(SpdyStreamId stream_id,
+                                        SpdyStringPiece encoding,
+                                        const bool end_headers,
+                                        ZeroCopyOutputBuffer* output) {
+  const size_t frame_size = kContinuationFrameMinimumSize + encoding.size();
+  SpdyFrameBuilder builder(frame_size, output);
+  uint8_t flags = end_headers ? HEADERS_FLAG_END_HEADERS : 0;
+  bool ok = builder.BeginNewFrame(SpdyFrameType::CONTINUATION, flags,
+                                  stream_id, frame_size - kFrameHeaderSize);
+  DCHECK_EQ(kFrameHeaderSize, builder.length());
+
+  ok = ok && builder.WriteBytes(encoding.data(), encoding.size());
+  return ok;
+}
+
 bool WritePayloadWithContinuation(SpdyFrameBuilder* builder,
                                   const SpdyString& hpack_encoding,
                                   SpdyStreamId stream_id,
@@ -191,8 +206,7 @@ bool WritePayloadWithContinuation(SpdyFrameBuilder* builder,
   bool ret = builder->WriteBytes(&hpack_encoding[0],
                                  hpack_encoding.size() - bytes_remaining);
   if (padding_payload_len > 0) {
-    SpdyString padding = SpdyString(padding_payload_len, 0);
-    ret &= builder->WriteBytes(padding.data(), padding.length());
+    ret &= builder->WriteZeros(padding_payload_len);
   }
 
   // Tack on CONTINUATION frames for the overflow.
@@ -301,9 +315,8 @@ size_t SpdyFramer::SpdyFrameIterator::NextFrame(ZeroCopyOutputBuffer* output) {
 
   const size_t size_without_block =
       is_first_frame_ ? GetFrameSizeSansBlock() : kContinuationFrameMinimumSize;
-  auto encoding = SpdyMakeUnique<SpdyString>();
   encoder_->Next(kHttp2MaxControlFrameSendSize - size_without_block,
-                 encoding.get());
+                 &encoding_);
   has_next_frame_ = encoder_->HasNext();
 
   if (framer_->debug_visitor_ != nullptr) {
@@ -314,19 +327,17 @@ size_t SpdyFramer::SpdyFrameIterator::NextFrame(ZeroCopyOutputBuffer* output) {
     framer_->debug_visitor_->OnSendCompressedFrame(
         frame_ir.stream_id(),
         is_first_frame_ ? frame_ir.frame_type() : SpdyFrameType::CONTINUATION,
-        header_list_size, size_without_block + encoding->size());
+        header_list_size, size_without_block + encoding_.size());
   }
 
   const size_t free_bytes_before = output->BytesFree();
   bool ok = false;
   if (is_first_frame_) {
     is_first_frame_ = false;
-    ok = SerializeGivenEncoding(*encoding, output);
+    ok = SerializeGivenEncoding(encoding_, output);
   } else {
-    SpdyContinuationIR continuation_ir(frame_ir.stream_id());
-    continuation_ir.take_encoding(std::move(encoding));
-    continuation_ir.set_end_headers(!has_next_frame_);
-    ok = framer_->SerializeContinuation(continuation_ir, output);
+    ok = SerializeContinuationGivenEncoding(frame_ir.stream_id(), encoding_,
+                                            !has_next_frame_, output);
   }
   return ok ? free_bytes_before - output->BytesFree() : 0;
 }
@@ -446,8 +457,7 @@ SpdySerializedFrame SpdyFramer::SerializeData(const SpdyDataIR& data_ir) {
   }
   builder.WriteBytes(data_ir.data(), data_ir.data_len());
   if (data_ir.padding_payload_len() > 0) {
-    SpdyString padding(data_ir.padding_payload_len(), 0);
-    builder.WriteBytes(padding.data(), padding.length());
+    builder.WriteZeros(data_ir.padding_payload_len());
   }
   DCHECK_EQ(size_with_padding, builder.length());
   return builder.take();
@@ -608,10 +618,9 @@ SpdySerializedFrame SpdyFramer::SerializeHeaders(const SpdyHeadersIR& headers) {
   // The size of this frame, including padding (if there is any) and
   // variable-length header block.
   size_t size = 0;
-  SpdyString hpack_encoding;
   int weight = 0;
   size_t length_field = 0;
-  SerializeHeadersBuilderHelper(headers, &flags, &size, &hpack_encoding,
+  SerializeHeadersBuilderHelper(headers, &flags, &size, &hpack_encoding_,
                                 &weight, &length_field);
 
   SpdyFrameBuilder builder(size);
@@ -631,7 +640,7 @@ SpdySerializedFrame SpdyFramer::SerializeHeaders(const SpdyHeadersIR& headers) {
     // Per RFC 7540 section 6.3, serialized weight value is actual value - 1.
     builder.WriteUInt8(weight - 1);
   }
-  WritePayloadWithContinuation(&builder, hpack_encoding, headers.stream_id(),
+  WritePayloadWithContinuation(&builder, hpack_encoding_, headers.stream_id(),
                                SpdyFrameType::HEADERS, padding_payload_len);
 
   if (debug_visitor_) {
@@ -686,8 +695,7 @@ SpdySerializedFrame SpdyFramer::SerializePushPromise(
     const SpdyPushPromiseIR& push_promise) {
   uint8_t flags = 0;
   size_t size = 0;
-  SpdyString hpack_encoding;
-  SerializePushPromiseBuilderHelper(push_promise, &flags, &hpack_encoding,
+  SerializePushPromiseBuilderHelper(push_promise, &flags, &hpack_encoding_,
                                     &size);
 
   SpdyFrameBuilder builder(size);
@@ -709,7 +717,7 @@ SpdySerializedFrame SpdyFramer::SerializePushPromise(
   }
 
   WritePayloadWithContinuation(
-      &builder, hpack_encoding, push_promise.stream_id(),
+      &builder, hpack_encoding_, push_promise.stream_id(),
       SpdyFrameType::PUSH_PROMISE, padding_payload_len);
 
   if (debug_visitor_) {
@@ -942,9 +950,7 @@ bool SpdyFramer::SerializeData(const SpdyDataIR& data_ir,
 
   ok = ok && builder.WriteBytes(data_ir.data(), data_ir.data_len());
   if (data_ir.padding_payload_len() > 0) {
-    SpdyString padding;
-    padding = SpdyString(data_ir.padding_payload_len(), 0);
-    ok = ok && builder.WriteBytes(padding.data(), padding.length());
+    ok = ok && builder.WriteZeros(data_ir.padding_payload_len());
   }
   DCHECK_EQ(size_with_padding, builder.length());
   return ok;
@@ -1054,10 +1060,9 @@ bool SpdyFramer::SerializeHeaders(const SpdyHeadersIR& headers,
   // The size of this frame, including padding (if there is any) and
   // variable-length header block.
   size_t size = 0;
-  SpdyString hpack_encoding;
   int weight = 0;
   size_t length_field = 0;
-  SerializeHeadersBuilderHelper(headers, &flags, &size, &hpack_encoding,
+  SerializeHeadersBuilderHelper(headers, &flags, &size, &hpack_encoding_,
                                 &weight, &length_field);
 
   bool ok = true;
@@ -1079,7 +1084,7 @@ bool SpdyFramer::SerializeHeaders(const SpdyHeadersIR& headers,
          builder.WriteUInt8(weight - 1);
   }
   ok = ok && WritePayloadWithContinuation(
-                 &builder, hpack_encoding, headers.stream_id(),
+                 &builder, hpack_encoding_, headers.stream_id(),
                  SpdyFrameType::HEADERS, padding_payload_len);
 
   if (debug_visitor_) {
@@ -1107,8 +1112,7 @@ bool SpdyFramer::SerializePushPromise(const SpdyPushPromiseIR& push_promise,
                                       ZeroCopyOutputBuffer* output) {
   uint8_t flags = 0;
   size_t size = 0;
-  SpdyString hpack_encoding;
-  SerializePushPromiseBuilderHelper(push_promise, &flags, &hpack_encoding,
+  SerializePushPromiseBuilderHelper(push_promise, &flags, &hpack_encoding_,
                                     &size);
 
   bool ok = true;
@@ -1132,7 +1136,7 @@ bool SpdyFramer::SerializePushPromise(const SpdyPushPromiseIR& push_promise,
   }
 
   ok = ok && WritePayloadWithContinuation(
-                 &builder, hpack_encoding, push_promise.stream_id(),
+                 &builder, hpack_encoding_, push_promise.stream_id(),
                  SpdyFrameType::PUSH_PROMISE, padding_payload_len);
 
   if (debug_visitor_) {
@@ -1148,17 +1152,9 @@ bool SpdyFramer::SerializePushPromise(const SpdyPushPromiseIR& push_promise,
 
 bool SpdyFramer::SerializeContinuation(const SpdyContinuationIR& continuation,
                                        ZeroCopyOutputBuffer* output) const {
-  const SpdyString& encoding = continuation.encoding();
-  size_t frame_size = kContinuationFrameMinimumSize + encoding.size();
-  SpdyFrameBuilder builder(frame_size, output);
-  uint8_t flags = continuation.end_headers() ? HEADERS_FLAG_END_HEADERS : 0;
-  bool ok = builder.BeginNewFrame(SpdyFrameType::CONTINUATION, flags,
-                                  continuation.stream_id(),
-                                  frame_size - kFrameHeaderSize);
-  DCHECK_EQ(kFrameHeaderSize, builder.length());
-
-  ok = ok && builder.WriteBytes(encoding.data(), encoding.size());
-  return ok;
+  return SerializeContinuationGivenEncoding(continuation.stream_id(),
+                                            continuation.encoding(),
+                                            continuation.end_headers(), output);
 }
 
 bool SpdyFramer::SerializeAltSvc(const SpdyAltSvcIR& altsvc_ir,
@@ -1294,7 +1290,8 @@ void SpdyFramer::SetEncoderHeaderTableDebugVisitor(
 }
 
 size_t SpdyFramer::EstimateMemoryUsage() const {
-  return SpdyEstimateMemoryUsage(hpack_encoder_);
+  return SpdyEstimateMemoryUsage(hpack_encoder_) +
+         SpdyEstimateMemoryUsage(hpack_encoding_);
 }
 
 }  // namespace spdy
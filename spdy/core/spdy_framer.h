@@ -273,6 +273,8 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
    private:
     SpdyFramer* const framer_;
     std::unique_ptr<HpackEncoder::ProgressiveEncoder> encoder_;
+    // Header block fragment of the current frame, reused across frames.
+    SpdyString encoding_;
     bool is_first_frame_;
     bool has_next_frame_;
   };
@@ -354,6 +356,12 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
 
   std::unique_ptr<HpackEncoder> hpack_encoder_;
 
+  // Encoded header block of the HEADERS or PUSH_PROMISE frame being
+  // serialized.  Kept across frames so that its capacity is reused: the
+  // encoder swaps it with its own buffer, and the frames are written from it
+  // directly to the output.
+  SpdyString hpack_encoding_;
+
   SpdyFramerDebugVisitorInterface* debug_visitor_;
 
   // Determines whether HPACK compression is used.
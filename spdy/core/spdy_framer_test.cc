@@ -2609,6 +2609,32 @@ TEST_P(SpdyFramerTest, ReadCompressedHeadersHeaderBlockWithHalfClose) {
   EXPECT_EQ(headers_ir.header_block(), visitor.headers_);
 }
 
+// Header fields that are invalid in HTTP/2 fail the header block with
+// SPDY_DECOMPRESS_FAILURE, and are not delivered to the visitor.
+TEST_P(SpdyFramerTest, ReadHeadersWithInvalidHeaderField) {
+  const std::pair<SpdyString, SpdyString> kInvalidHeaders[] = {
+      {"Alpha", "beta"},
+      {"alpha beta", "gamma"},
+      {"alpha", "beta\r\ngamma: delta"},
+  };
+  for (const auto& header : kInvalidHeaders) {
+    SpdyHeadersIR headers_ir(/* stream_id = */ 1);
+    headers_ir.SetHeader(header.first, header.second);
+    SpdySerializedFrame control_frame(SpdyFramerPeer::SerializeHeaders(
+        &framer_, headers_ir, use_output_ ? &output_ : nullptr));
+    TestSpdyVisitor visitor(SpdyFramer::ENABLE_COMPRESSION);
+    visitor.SimulateInFramer(
+        reinterpret_cast<unsigned char*>(control_frame.data()),
+        control_frame.size());
+    EXPECT_EQ(1, visitor.error_count_) << header.first;
+    EXPECT_EQ(Http2DecoderAdapter::SPDY_DECOMPRESS_FAILURE,
+              visitor.deframer_.spdy_framer_error())
+        << Http2DecoderAdapter::SpdyFramerErrorToString(
+               visitor.deframer_.spdy_framer_error());
+    EXPECT_TRUE(visitor.headers_.empty());
+  }
+}
+
 TEST_P(SpdyFramerTest, TooLargeHeadersFrameUsesContinuation) {
   SpdyFramer framer(SpdyFramer::DISABLE_COMPRESSION);
   SpdyHeadersIR headers(/* stream_id = */ 1);
@@ -2764,6 +2790,64 @@ TEST_P(SpdyFramerTest, PushPromiseFramesWithIterator) {
   EXPECT_FALSE(frame_it.HasNextFrame());
 }
 
+// ZeroCopyOutputBuffer that hands out its memory in small segments, to verify
+// that frames are written across segment boundaries.
+class SegmentedOutputBuffer : public ZeroCopyOutputBuffer {
+ public:
+  explicit SegmentedOutputBuffer(int segment_size)
+      : segment_size_(segment_size) {}
+
+  void Next(char** data, int* size) override {
+    *data = &buffer_[written_];
+    *size = std::min<int>(segment_size_, kSize - written_);
+  }
+  void AdvanceWritePtr(int64_t count) override { written_ += count; }
+  uint64_t BytesFree() const override { return kSize - written_; }
+
+  SpdyStringPiece contents() const { return SpdyStringPiece(buffer_, written_); }
+
+ private:
+  static const int64_t kSize = 64 * 1024;
+
+  const int segment_size_;
+  char buffer_[kSize];
+  int64_t written_ = 0;
+};
+
+// Verifies that HEADERS and PUSH_PROMISE frames written to a segmented output
+// buffer, with padding and CONTINUATION frames, are identical to the frames
+// built in a SpdySerializedFrame.
+TEST_P(SpdyFramerTest, HeaderFramesWithContinuationToSegmentedOutput) {
+  SpdyHeadersIR headers(/* stream_id = */ 1);
+  headers.set_padding_len(256);
+  headers.set_has_priority(true);
+  headers.set_weight(42);
+  headers.SetHeader("aa", SpdyString(kHttp2MaxControlFrameSendSize, 'x'));
+  headers.SetHeader("bb", "foo");
+  SpdyPushPromiseIR push_promise(/* stream_id = */ 1,
+                                 /* promised_stream_id = */ 2);
+  push_promise.set_padding_len(17);
+  push_promise.SetHeader("cc", SpdyString(kHttp2MaxControlFrameSendSize, 'z'));
+
+  SpdyFramer expected_framer(SpdyFramer::ENABLE_COMPRESSION);
+  SpdySerializedFrame expected_headers =
+      expected_framer.SerializeHeaders(headers);
+  SpdySerializedFrame expected_push_promise =
+      expected_framer.SerializePushPromise(push_promise);
+
+  SpdyFramer framer(SpdyFramer::ENABLE_COMPRESSION);
+  SegmentedOutputBuffer output(/* segment_size = */ 1000);
+  EXPECT_TRUE(framer.SerializeHeaders(headers, &output));
+  EXPECT_EQ(SpdyStringPiece(expected_headers.data(), expected_headers.size()),
+            output.contents());
+
+  SegmentedOutputBuffer push_promise_output(/* segment_size = */ 7);
+  EXPECT_TRUE(framer.SerializePushPromise(push_promise, &push_promise_output));
+  EXPECT_EQ(SpdyStringPiece(expected_push_promise.data(),
+                            expected_push_promise.size()),
+            push_promise_output.contents());
+}
+
 class SpdyControlFrameIteratorTest : public ::testing::Test {
  public:
   SpdyControlFrameIteratorTest() : output_(output_buffer, kSize) {}
@@ -102,8 +102,7 @@ SpdyHeaderBlock::HeaderValue::HeaderValue(Storage* storage,
                                           SpdyStringPiece key,
                                           SpdyStringPiece initial_value)
     : storage_(storage),
-      fragments_({initial_value}),
-      pair_({key, {}}),
+      pair_({key, initial_value}),
       size_(initial_value.size()),
       separator_size_(SeparatorForKey(key).size()) {}
 
@@ -127,18 +126,19 @@ SpdyHeaderBlock::HeaderValue& SpdyHeaderBlock::HeaderValue::operator=(
 SpdyHeaderBlock::HeaderValue::~HeaderValue() = default;
 
 SpdyStringPiece SpdyHeaderBlock::HeaderValue::ConsolidatedValue() const {
-  if (fragments_.empty()) {
-    return SpdyStringPiece();
-  }
-  if (fragments_.size() > 1) {
-    fragments_ = {
-        storage_->WriteFragments(fragments_, SeparatorForKey(pair_.first))};
+  if (!fragments_.empty()) {
+    pair_.second =
+        storage_->WriteFragments(fragments_, SeparatorForKey(pair_.first));
+    fragments_.clear();
   }
-  return fragments_[0];
+  return pair_.second;
 }
 
 void SpdyHeaderBlock::HeaderValue::Append(SpdyStringPiece fragment) {
   size_ += (fragment.size() + separator_size_);
+  if (fragments_.empty()) {
+    fragments_.push_back(pair_.second);
+  }
   fragments_.push_back(fragment);
 }
 
@@ -289,7 +289,11 @@ void SpdyHeaderBlock::clear() {
   key_size_ = 0;
   value_size_ = 0;
   block_.clear();
-  storage_.reset();
+  // Keep the storage, so that a block that is cleared and refilled, like the
+  // one HpackDecoderAdapter decodes into, reuses its memory.
+  if (storage_ != nullptr) {
+    storage_->Clear();
+  }
 }
 
 void SpdyHeaderBlock::insert(const SpdyHeaderBlock::value_type& value) {
@@ -74,8 +74,11 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
     SpdyStringPiece ConsolidatedValue() const;
 
     mutable Storage* storage_;
+    // All value fragments if there is more than one, empty otherwise, so that
+    // single-valued headers do not allocate.
     mutable std::vector<SpdyStringPiece> fragments_;
-    // The first element is the key; the second is the consolidated value.
+    // The first element is the key; the second is the consolidated value if
+    // |fragments_| is empty.
     mutable std::pair<SpdyStringPiece, SpdyStringPiece> pair_;
     size_t size_ = 0;
     size_t separator_size_ = 0;
@@ -163,7 +166,8 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
   }
   void erase(SpdyStringPiece key);
 
-  // Clears both our MapType member and the memory used to hold headers.
+  // Clears our MapType member and invalidates the memory used to hold headers,
+  // which is kept for reuse.
   void clear();
 
   // The next few methods copy data into our backing storage.
@@ -177,6 +177,35 @@ TEST(SpdyHeaderBlockTest, AppendHeaders) {
   EXPECT_EQ("singleton", block["h4"]);
 }
 
+// Values can be appended to after being read, which joins their fragments.
+TEST(SpdyHeaderBlockTest, AppendAfterRead) {
+  SpdyHeaderBlock block;
+  block.AppendValueOrAddHeader("cookie", "key1=value1");
+  EXPECT_EQ("key1=value1", block["cookie"]);
+  block.AppendValueOrAddHeader("cookie", "key2=value2");
+  EXPECT_EQ("key1=value1; key2=value2", block["cookie"]);
+  block.AppendValueOrAddHeader("cookie", "key3=value3");
+  EXPECT_EQ("key1=value1; key2=value2; key3=value3", block["cookie"]);
+}
+
+// A cleared block can be refilled.
+TEST(SpdyHeaderBlockTest, ClearAndRefill) {
+  SpdyHeaderBlock block;
+  for (int i = 0; i < 3; ++i) {
+    block.AppendValueOrAddHeader("foo", "bar");
+    block.AppendValueOrAddHeader("foo", "baz");
+    block[":path"] = SpdyString(3000, 'a');
+    EXPECT_EQ(2u, block.size());
+    EXPECT_EQ(SpdyString("bar\0baz", 7), block["foo"]);
+    EXPECT_EQ(SpdyString(3000, 'a'), block[":path"]);
+
+    block.clear();
+    EXPECT_TRUE(block.empty());
+    EXPECT_EQ(0u, block.TotalBytesUsed());
+    EXPECT_EQ(block.end(), block.find("foo"));
+  }
+}
+
 TEST(JoinTest, JoinEmpty) {
   std::vector<SpdyStringPiece> empty;
   SpdyStringPiece separator = ", ";
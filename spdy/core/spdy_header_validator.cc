@@ -0,0 +1,189 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/spdy/core/spdy_header_validator.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace spdy {
+
+namespace {
+
+const uint64_t kOnes = 0x0101010101010101;
+const uint64_t kHighBits = 0x8080808080808080;
+
+// Lower case token characters, RFC 7230 Section 3.2.6.
+bool IsLowerCaseTokenChar(uint8_t c) {
+  if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+    return true;
+  }
+  switch (c) {
+    case '!':
+    case '#':
+    case '$':
+    case '%':
+    case '&':
+    case '\'':
+    case '*':
+    case '+':
+    case '-':
+    case '.':
+    case '^':
+    case '_':
+    case '`':
+    case '|':
+    case '~':
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsInvalidValueChar(uint8_t c) {
+  return c == '\r' || c == '\n';
+}
+
+uint64_t LoadWord(const char* p) {
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+// Returns the high bit of each octet of |word| that is at least |c|.  All
+// octets of |word| must be below 0x80, so that the addition does not carry
+// from one octet into the next.
+uint64_t OctetsAtLeast(uint64_t word, uint8_t c) {
+  return (word + kOnes * (0x80 - c)) & kHighBits;
+}
+
+// Returns the high bit of each octet of |word| that is equal to |c|.  Same
+// requirement as OctetsAtLeast().
+uint64_t OctetsEqual(uint64_t word, uint8_t c) {
+  const uint64_t nonzero = ((word ^ (kOnes * c)) + kOnes * 0x7f) & kHighBits;
+  return ~nonzero & kHighBits;
+}
+
+// Returns true if the eight octets of |word| are lower case letters, digits
+// or '-', which covers almost all header field names.  Other token
+// characters are left to IsLowerCaseTokenChar().
+bool IsCommonNameWord(uint64_t word) {
+  if ((word & kHighBits) != 0) {
+    return false;
+  }
+  const uint64_t lower =
+      OctetsAtLeast(word, 'a') & ~OctetsAtLeast(word, 'z' + 1);
+  const uint64_t digit =
+      OctetsAtLeast(word, '0') & ~OctetsAtLeast(word, '9' + 1);
+  return (lower | digit | OctetsEqual(word, '-')) == kHighBits;
+}
+
+// Returns nonzero if any octet of |word| is zero.
+uint64_t HasZeroOctet(uint64_t word) {
+  return (word - kOnes) & ~word & kHighBits;
+}
+
+bool HasInvalidValueChar(uint64_t word) {
+  return HasZeroOctet(word ^ (kOnes * '\r')) |
+         HasZeroOctet(word ^ (kOnes * '\n'));
+}
+
+}  // namespace
+
+SpdyHeaderValidator::Result SpdyHeaderValidator::ValidateHeader(
+    SpdyStringPiece name,
+    SpdyStringPiece value) {
+  if (name.empty()) {
+    return Result::kEmptyName;
+  }
+  if (IsPseudoHeaderName(name)) {
+    if (seen_regular_header_) {
+      return Result::kPseudoHeaderAfterRegularHeader;
+    }
+    name.remove_prefix(1);
+    if (name.empty()) {
+      return Result::kEmptyName;
+    }
+  } else {
+    seen_regular_header_ = true;
+  }
+
+  const size_t invalid = FindInvalidNameCharacter(name);
+  if (invalid < name.size()) {
+    return name[invalid] >= 'A' && name[invalid] <= 'Z'
+               ? Result::kUpperCaseName
+               : Result::kInvalidNameCharacter;
+  }
+  if (FindInvalidValueCharacter(value) < value.size()) {
+    return Result::kInvalidValueCharacter;
+  }
+  return Result::kOk;
+}
+
+// static
+size_t SpdyHeaderValidator::FindInvalidNameCharacter(SpdyStringPiece name) {
+  const char* const data = name.data();
+  const size_t size = name.size();
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    if (IsCommonNameWord(LoadWord(data + i))) {
+      continue;
+    }
+    for (size_t j = i; j < i + sizeof(uint64_t); ++j) {
+      if (!IsLowerCaseTokenChar(data[j])) {
+        return j;
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    if (!IsLowerCaseTokenChar(data[i])) {
+      return i;
+    }
+  }
+  return size;
+}
+
+// static
+size_t SpdyHeaderValidator::FindInvalidValueCharacter(SpdyStringPiece value) {
+  const char* const data = value.data();
+  const size_t size = value.size();
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    if (!HasInvalidValueChar(LoadWord(data + i))) {
+      continue;
+    }
+    for (size_t j = i;; ++j) {
+      if (IsInvalidValueChar(data[j])) {
+        return j;
+      }
+    }
+  }
+  for (; i < size; ++i) {
+    if (IsInvalidValueChar(data[i])) {
+      return i;
+    }
+  }
+  return size;
+}
+
+// static
+const char* SpdyHeaderValidator::ResultToString(Result result) {
+  switch (result) {
+    case Result::kOk:
+      return "OK";
+    case Result::kEmptyName:
+      return "empty header name";
+    case Result::kUpperCaseName:
+      return "upper case character in header name";
+    case Result::kInvalidNameCharacter:
+      return "invalid character in header name";
+    case Result::kInvalidValueCharacter:
+      return "invalid character in header value";
+    case Result::kPseudoHeaderAfterRegularHeader:
+      return "pseudo-header after regular header";
+  }
+  return "UNKNOWN";
+}
+
+}  // namespace spdy
@@ -0,0 +1,69 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef QUICHE_SPDY_CORE_SPDY_HEADER_VALIDATOR_H_
+#define QUICHE_SPDY_CORE_SPDY_HEADER_VALIDATOR_H_
+
+#include <cstddef>
+
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_export.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_string_piece.h"
+
+namespace spdy {
+
+// SpdyHeaderValidator checks the header fields of a decoded header block, in
+// the order in which they were decoded, against the rules of RFC 7540 Section
+// 8.1.2, which also apply to HTTP/3:
+//   * Field names are non-empty tokens (RFC 7230 Section 3.2.6) without upper
+//     case characters, optionally preceded by a ':' for pseudo-header fields.
+//   * Pseudo-header fields precede all regular header fields.
+//   * Field values contain no CR or LF (Section 10.3).  NUL is accepted,
+//     because SpdyHeaderBlock represents repeated fields as a single value
+//     with NUL separators, and such values are passed through.
+//
+// Names and values are scanned a machine word at a time, so that long values
+// such as cookies are checked with a few operations per eight octets.
+class SPDY_EXPORT_PRIVATE SpdyHeaderValidator {
+ public:
+  enum class Result {
+    kOk,
+    kEmptyName,
+    kUpperCaseName,
+    kInvalidNameCharacter,
+    kInvalidValueCharacter,
+    kPseudoHeaderAfterRegularHeader,
+  };
+
+  SpdyHeaderValidator() = default;
+  SpdyHeaderValidator(const SpdyHeaderValidator&) = delete;
+  SpdyHeaderValidator& operator=(const SpdyHeaderValidator&) = delete;
+
+  // Prepares for validating the fields of a new header block.
+  void StartHeaderBlock() { seen_regular_header_ = false; }
+
+  // Validates the next field of the current header block.
+  Result ValidateHeader(SpdyStringPiece name, SpdyStringPiece value);
+
+  // Returns true if |name| starts with ':'.
+  static bool IsPseudoHeaderName(SpdyStringPiece name) {
+    return !name.empty() && name[0] == ':';
+  }
+
+  // Returns the offset of the first octet of |name| that is not a lower case
+  // token character, or |name.size()| if there is none.
+  static size_t FindInvalidNameCharacter(SpdyStringPiece name);
+
+  // Returns the offset of the first CR or LF in |value|, or |value.size()| if
+  // there is none.
+  static size_t FindInvalidValueCharacter(SpdyStringPiece value);
+
+  static const char* ResultToString(Result result);
+
+ private:
+  bool seen_regular_header_ = false;
+};
+
+}  // namespace spdy
+
+#endif  // QUICHE_SPDY_CORE_SPDY_HEADER_VALIDATOR_H_
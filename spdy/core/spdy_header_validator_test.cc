@@ -0,0 +1,79 @@
+// Copyright 2019 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/third_party/quiche/src/spdy/core/spdy_header_validator.h"
+
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_string.h"
+#include "net/third_party/quiche/src/spdy/platform/api/spdy_test.h"
+
+namespace spdy {
+namespace test {
+namespace {
+
+using Result = SpdyHeaderValidator::Result;
+
+TEST(SpdyHeaderValidatorTest, FindInvalidNameCharacter) {
+  EXPECT_EQ(0u, SpdyHeaderValidator::FindInvalidNameCharacter(""));
+  EXPECT_EQ(14u,
+            SpdyHeaderValidator::FindInvalidNameCharacter("content-length"));
+  EXPECT_EQ(22u, SpdyHeaderValidator::FindInvalidNameCharacter(
+                     "x-forwarded-for_v2.0!~"));
+
+  // Invalid characters at every offset of a name that spans several words.
+  const SpdyString valid = "accept-encoding-0123456789";
+  for (size_t i = 0; i < valid.size(); ++i) {
+    for (char c : {'A', 'Z', ' ', ':', '\0', '\x7f', '\x80', '\xff'}) {
+      SpdyString name = valid;
+      name[i] = c;
+      EXPECT_EQ(i, SpdyHeaderValidator::FindInvalidNameCharacter(name))
+          << "offset " << i << ", character " << static_cast<int>(c);
+    }
+  }
+}
+
+TEST(SpdyHeaderValidatorTest, FindInvalidValueCharacter) {
+  EXPECT_EQ(0u, SpdyHeaderValidator::FindInvalidValueCharacter(""));
+  const SpdyString valid =
+      SpdyString("text/html; q=0.9, \t*/*\x7f\x80\xff") + SpdyString(1, '\0');
+  EXPECT_EQ(valid.size(),
+            SpdyHeaderValidator::FindInvalidValueCharacter(valid));
+
+  for (size_t i = 0; i < valid.size(); ++i) {
+    for (char c : {'\r', '\n'}) {
+      SpdyString value = valid;
+      value[i] = c;
+      EXPECT_EQ(i, SpdyHeaderValidator::FindInvalidValueCharacter(value))
+          << "offset " << i << ", character " << static_cast<int>(c);
+    }
+  }
+}
+
+TEST(SpdyHeaderValidatorTest, ValidateHeader) {
+  SpdyHeaderValidator validator;
+  validator.StartHeaderBlock();
+  EXPECT_EQ(Result::kOk, validator.ValidateHeader(":method", "GET"));
+  EXPECT_EQ(Result::kOk, validator.ValidateHeader(":path", "/"));
+  EXPECT_EQ(Result::kOk, validator.ValidateHeader("cookie", "a=b; c=d"));
+  EXPECT_EQ(Result::kOk, validator.ValidateHeader("empty", ""));
+  EXPECT_EQ(Result::kEmptyName, validator.ValidateHeader("", "foo"));
+  EXPECT_EQ(Result::kUpperCaseName, validator.ValidateHeader("Host", "foo"));
+  EXPECT_EQ(Result::kInvalidNameCharacter,
+            validator.ValidateHeader("foo bar", "baz"));
+  EXPECT_EQ(Result::kInvalidValueCharacter,
+            validator.ValidateHeader("foo", "bar\r\nbaz: 1"));
+  EXPECT_EQ(Result::kPseudoHeaderAfterRegularHeader,
+            validator.ValidateHeader(":authority", "www.example.com"));
+
+  // Pseudo-header names are checked after the ':'.
+  validator.StartHeaderBlock();
+  EXPECT_EQ(Result::kEmptyName, validator.ValidateHeader(":", "foo"));
+  EXPECT_EQ(Result::kUpperCaseName, validator.ValidateHeader(":Path", "/"));
+  EXPECT_EQ(Result::kInvalidNameCharacter,
+            validator.ValidateHeader("::path", "/"));
+  EXPECT_EQ(Result::kOk, validator.ValidateHeader(":path", "/"));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace spdy
@@ -65,8 +65,14 @@ void SpdySimpleArena::Free(char* data, size_t size) {
 }
 
 void SpdySimpleArena::Reset() {
-  blocks_.clear();
-  status_.bytes_allocated_ = 0;
+  if (blocks_.empty() || blocks_.front().size != block_size_) {
+    blocks_.clear();
+    status_.bytes_allocated_ = 0;
+    return;
+  }
+  blocks_.erase(blocks_.begin() + 1, blocks_.end());
+  blocks_.front().used = 0;
+  status_.bytes_allocated_ = block_size_;
 }
 
 void SpdySimpleArena::Reserve(size_t additional_space) {
@@ -47,6 +47,9 @@ class SPDY_EXPORT_PRIVATE SpdySimpleArena {
   // arena, the memory is reclaimed. Otherwise, this method is a no-op.
   void Free(char* data, size_t size);
 
+  // Invalidates all allocations.  The first block is kept for reuse if it has
+  // the default block size, so that an arena that is repeatedly filled and
+  // reset does not allocate each time.
   void Reset();
 
   Status status() const { return status_; }
@@ -61,6 +61,27 @@ TEST(SpdySimpleArenaTest, UseAfterReset) {
   EXPECT_EQ(SpdyStringPiece(c, length), kTestString);
 }
 
+TEST(SpdySimpleArenaTest, ResetKeepsFirstBlock) {
+  SpdySimpleArena arena(40 /* block size */);
+  const size_t length = strlen(kTestString);
+  char* c1 = arena.Memdup(kTestString, length);
+  // Does not fit in the first block.
+  arena.Memdup(kTestString, length);
+  EXPECT_EQ(80u, arena.status().bytes_allocated());
+
+  arena.Reset();
+  EXPECT_EQ(40u, arena.status().bytes_allocated());
+  char* c2 = arena.Memdup(kTestString, length);
+  EXPECT_EQ(c1, c2);
+  EXPECT_EQ(SpdyStringPiece(c2, length), kTestString);
+
+  // An oversized first block is not kept.
+  SpdySimpleArena small_arena(10 /* block size */);
+  small_arena.Memdup(kTestString, length);
+  small_arena.Reset();
+  EXPECT_EQ(0u, small_arena.status().bytes_allocated());
+}
+
 TEST(SpdySimpleArenaTest, Free) {
   SpdySimpleArena arena(kDefaultBlockSize);
   const size_t length = strlen(kTestString);